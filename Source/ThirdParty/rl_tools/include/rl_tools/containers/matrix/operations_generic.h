@@ -52,15 +52,23 @@ void free(DEVICE& device, matrix::MatrixStatic<T, TI, SIZE>& matrix) {
     template<typename DEVICE, typename T, typename T_TI, T_TI SIZE_BYTES, bool T_CONST>
     void malloc(DEVICE& device, matrix::MatrixDynamic<T, T_TI, SIZE_BYTES, T_CONST>& matrix){
         using TI = typename DEVICE::index_t;
-#ifdef RL_TOOLS_DEBUG_CONTAINER_CHECK_MALLOC
-        utils::assert_exit(device, matrix._data == nullptr, "Matrix is already allocated");
-#endif
 #ifndef RL_TOOLS_DISABLE_ALIGNED_MEMORY_ALLOCATIONS
         static constexpr TI POINTER_SIZE = sizeof(void*);
         static constexpr TI BYTE_ALIGNMENT = 64;
         static constexpr TI ALIGNED_SIZE = SIZE_BYTES + BYTE_ALIGNMENT + POINTER_SIZE;
 #else
         static constexpr TI ALIGNED_SIZE = SPEC::SIZE_BYTES;
+#endif
+        if(void* arena_pointer = arena_allocate(device, (TI)SIZE_BYTES, (TI)64)){
+            // Arena memory is already aligned and never freed on its own, so it needs no original pointer in front
+            matrix._data = reinterpret_cast<T*>(arena_pointer);
+            count_malloc(device, SIZE_BYTES);
+            return;
+        }
+#ifdef RL_TOOLS_DEBUG_CONTAINER_CHECK_MALLOC
+        // Only heap memory can leak: an arena hands every container out twice (measuring, then allocating), so an arena
+        // container still holds the measuring pass' address when it is allocated for real
+        utils::assert_exit(device, matrix._data == nullptr, "Matrix is already allocated");
 #endif
 #ifdef RL_TOOLS_CONTAINERS_USE_MALLOC
         void* original_pointer = ::malloc(ALIGNED_SIZE);
@@ -95,6 +103,10 @@ void free(DEVICE& device, matrix::MatrixStatic<T, TI, SIZE>& matrix) {
 #ifdef RL_TOOLS_DEBUG_CONTAINER_CHECK_MALLOC
         utils::assert_exit(device, matrix._data != nullptr, "Matrix has not been allocated");
 #endif
+        if(arena_owns(device, matrix._data)){
+            matrix._data = nullptr;
+            return;
+        }
 #ifndef RL_TOOLS_DISABLE_ALIGNED_MEMORY_ALLOCATIONS
         char* aligned_byte_pointer = reinterpret_cast<char*>(matrix._data);
         static constexpr TI POINTER_SIZE = sizeof(void*);
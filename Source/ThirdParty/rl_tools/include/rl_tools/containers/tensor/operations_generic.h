@@ -28,6 +28,12 @@ namespace rl_tools{
 #if !defined(RL_TOOLS_DISABLE_DYNAMIC_MEMORY_ALLOCATIONS)
     template<typename DEVICE, typename T, typename T_TI, T_TI SIZE, bool CONST>
     void malloc(DEVICE& device, tensor::TensorDynamic<T, T_TI, SIZE, CONST>& tensor){
+        using TI = typename DEVICE::index_t;
+        if(void* arena_pointer = arena_allocate(device, (TI)(SIZE * sizeof(T)), (TI)64)){
+            // As for matrices: the measuring pass of an arena hands out addresses that cannot be written
+            *data_pointer(tensor) = reinterpret_cast<T*>(arena_pointer);
+            return;
+        }
         T* temp = (T*) new T[SIZE];
         *data_pointer(tensor) = temp;
 #if RL_TOOLS_DEBUG_CONTAINER_MALLOC_INIT_NAN
@@ -38,6 +44,9 @@ namespace rl_tools{
     }
     template <typename DEVICE, typename T, typename T_TI, T_TI SIZE, bool CONST>
     void free(DEVICE& device, tensor::TensorDynamic<T, T_TI, SIZE, CONST>& tensor){
+        if(arena_owns(device, data(tensor))){
+            return;
+        }
         delete[] data(tensor);
     }
 #endif
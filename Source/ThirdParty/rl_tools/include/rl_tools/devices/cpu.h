@@ -11,9 +11,34 @@
 #include <algorithm>
 #include <ctime>
 #include <limits>
+#include <memory>
+#include <vector>
 RL_TOOLS_NAMESPACE_WRAPPER_START
 namespace rl_tools::devices{
     namespace cpu{
+        class ThreadPool; // defined in cpu_thread_pool.h, only needed when the execution hints ask for multiple threads
+        // Bump allocator the container mallocs of a device draw from while device.arena points at it. Nothing is handed
+        // back individually: free() on a container living in the arena only clears its pointer and the owner releases
+        // the whole block at once. Without a block (data == nullptr) the arena only measures: allocations advance used
+        // and return addresses that must never be dereferenced, so a dry run of the mallocs sizes the block exactly.
+        struct Arena{
+            char* data = nullptr;
+            size_t capacity = 0;
+            size_t used = 0;
+            size_t allocations = 0;
+        };
+        // Per-owner storage that survives across dispatches (e.g. one RNG stream per environment of a runner). It lives
+        // next to the thread pool rather than in it, so resizing the pool keeps the streams and results stay reproducible.
+        // Entries are dropped by release_persistent_state, which the runners call from free().
+        struct PersistentStates{
+            struct Entry{
+                const void* owner;
+                const void* type;
+                size_t count;
+                std::shared_ptr<void> data;
+            };
+            std::vector<Entry> entries;
+        };
         template <typename T_MATH, typename T_RANDOM, typename T_LOGGING>
         struct Specification{
             using EXECUTION_HINTS = ExecutionHints;
@@ -54,6 +79,9 @@ namespace rl_tools::devices{
         std::string runs_path;
         std::string run_path;
         bool initialized = false;
+        std::shared_ptr<cpu::ThreadPool> thread_pool; // created lazily by rl_tools::thread_pool(device, num_threads)
+        std::shared_ptr<cpu::PersistentStates> persistent_states; // created lazily by rl_tools::persistent_state
+        cpu::Arena* arena = nullptr;
 #ifdef RL_TOOLS_DEBUG_CONTAINER_COUNT_MALLOC
         index_t malloc_counter = 0;
 #endif
@@ -98,6 +126,74 @@ namespace rl_tools{
         device.malloc_counter += size;
 #endif
     }
+    // Memory for a container from the device's arena. nullptr if the device has none or it is exhausted, in which case
+    // the container falls back to the heap.
+    template <typename DEV_SPEC, typename TI>
+    void* arena_allocate(devices::CPU<DEV_SPEC>& device, TI size, TI alignment){
+        devices::cpu::Arena* arena = device.arena;
+        if(arena == nullptr){
+            return nullptr;
+        }
+        arena->allocations++;
+        const size_t offset = (arena->used + alignment - 1) / alignment * alignment;
+        if(arena->data == nullptr){
+            arena->used = offset + size;
+            return reinterpret_cast<void*>(alignment + offset);
+        }
+        if(offset + size > arena->capacity){
+            return nullptr;
+        }
+        arena->used = offset + size;
+        return arena->data + offset;
+    }
+    template <typename DEV_SPEC>
+    bool arena_owns(devices::CPU<DEV_SPEC>& device, const void* pointer){
+        const devices::cpu::Arena* arena = device.arena;
+        if(arena == nullptr){
+            return false;
+        }
+        if(arena->data == nullptr){
+            return true;
+        }
+        const char* byte_pointer = static_cast<const char*>(pointer);
+        return byte_pointer >= arena->data && byte_pointer < arena->data + arena->capacity;
+    }
+    // Returns the existing block if the owner already has one of the same type and size, otherwise creates COUNT
+    // default-constructed elements and sets created = true so the caller can seed them. Copies of a device share the
+    // blocks, like they share the thread pool.
+    template <typename STATE, typename DEV_SPEC>
+    STATE* persistent_state(devices::CPU<DEV_SPEC>& device, const void* owner, size_t count, bool& created){
+        if(!device.persistent_states){
+            device.persistent_states = std::make_shared<devices::cpu::PersistentStates>();
+        }
+        auto allocate = [count](){
+            return std::shared_ptr<void>(new STATE[count], [](void* data){ delete[] static_cast<STATE*>(data); });
+        };
+        // address of a per-type static, avoids requiring RTTI
+        static const char type_tag = 0;
+        for(auto& entry: device.persistent_states->entries){
+            if(entry.owner == owner && entry.type == &type_tag){
+                created = entry.count != count;
+                if(created){
+                    entry.data = allocate();
+                    entry.count = count;
+                }
+                return static_cast<STATE*>(entry.data.get());
+            }
+        }
+        device.persistent_states->entries.push_back({owner, &type_tag, count, allocate()});
+        created = true;
+        return static_cast<STATE*>(device.persistent_states->entries.back().data.get());
+    }
+    // Drops every block of the owner, so a later owner at the same address starts from freshly seeded state
+    template <typename DEV_SPEC>
+    void release_persistent_state(devices::CPU<DEV_SPEC>& device, const void* owner){
+        if(!device.persistent_states){
+            return;
+        }
+        auto& entries = device.persistent_states->entries;
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [owner](const devices::cpu::PersistentStates::Entry& entry){ return entry.owner == owner; }), entries.end());
+    }
     template <typename SPEC>
     void check_status(devices::CPU<SPEC>& device){ }
 }
@@ -0,0 +1,172 @@
+#include "../version.h"
+#if (defined(RL_TOOLS_DISABLE_INCLUDE_GUARDS) || !defined(RL_TOOLS_DEVICES_CPU_SIMD_H)) && (RL_TOOLS_USE_THIS_VERSION == 1)
+#pragma once
+#define RL_TOOLS_DEVICES_CPU_SIMD_H
+
+#include "../rl_tools.h"
+#include "../numeric_types/half.h"
+
+// Minimal vector abstraction for the hand-written CPU kernels. The instruction set is picked at compile time from the
+// flags the translation unit is built with (AVX2+FMA > SSE2 > NEON on AArch64 > scalar). Define RL_TOOLS_DISABLE_SIMD
+// to force the scalar path.
+#if !defined(RL_TOOLS_DISABLE_SIMD)
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define RL_TOOLS_DEVICES_CPU_SIMD_AVX2
+#include <immintrin.h>
+#if defined(__F16C__) || defined(_MSC_VER)
+#define RL_TOOLS_DEVICES_CPU_SIMD_F16C
+#endif
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RL_TOOLS_DEVICES_CPU_SIMD_SSE
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RL_TOOLS_DEVICES_CPU_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::devices::cpu::simd{
+    // One lane, used for double, for strided (non unit column pitch) data and when no vector unit is available
+    template <typename T>
+    struct Scalar{
+        using SCALAR = T;
+        using TYPE = T;
+        static constexpr int WIDTH = 1;
+        static inline TYPE zero(){ return 0; }
+        static inline TYPE set1(T value){ return value; }
+        static inline TYPE load(const T* data){ return *data; }
+        static inline void store(T* data, TYPE value){ *data = value; }
+        static inline TYPE add(TYPE a, TYPE b){ return a + b; }
+        static inline TYPE mul(TYPE a, TYPE b){ return a * b; }
+        static inline TYPE fmadd(TYPE a, TYPE b, TYPE c){ return a * b + c; }
+        static inline T reduce_add(TYPE value){ return value; }
+    };
+
+    template <typename T>
+    struct Vector: Scalar<T>{};
+
+#if defined(RL_TOOLS_DEVICES_CPU_SIMD_AVX2)
+    template <>
+    struct Vector<float>{
+        using SCALAR = float;
+        using TYPE = __m256;
+        static constexpr int WIDTH = 8;
+        static inline TYPE zero(){ return _mm256_setzero_ps(); }
+        static inline TYPE set1(float value){ return _mm256_set1_ps(value); }
+        static inline TYPE load(const float* data){ return _mm256_loadu_ps(data); }
+        static inline void store(float* data, TYPE value){ _mm256_storeu_ps(data, value); }
+        static inline TYPE add(TYPE a, TYPE b){ return _mm256_add_ps(a, b); }
+        static inline TYPE mul(TYPE a, TYPE b){ return _mm256_mul_ps(a, b); }
+        static inline TYPE fmadd(TYPE a, TYPE b, TYPE c){ return _mm256_fmadd_ps(a, b, c); }
+        static inline float reduce_add(TYPE value){
+            __m128 sum = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+            __m128 shuffled = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+            sum = _mm_add_ps(sum, shuffled);
+            shuffled = _mm_movehl_ps(shuffled, sum);
+            sum = _mm_add_ss(sum, shuffled);
+            return _mm_cvtss_f32(sum);
+        }
+    };
+#elif defined(RL_TOOLS_DEVICES_CPU_SIMD_SSE)
+    template <>
+    struct Vector<float>{
+        using SCALAR = float;
+        using TYPE = __m128;
+        static constexpr int WIDTH = 4;
+        static inline TYPE zero(){ return _mm_setzero_ps(); }
+        static inline TYPE set1(float value){ return _mm_set1_ps(value); }
+        static inline TYPE load(const float* data){ return _mm_loadu_ps(data); }
+        static inline void store(float* data, TYPE value){ _mm_storeu_ps(data, value); }
+        static inline TYPE add(TYPE a, TYPE b){ return _mm_add_ps(a, b); }
+        static inline TYPE mul(TYPE a, TYPE b){ return _mm_mul_ps(a, b); }
+        static inline TYPE fmadd(TYPE a, TYPE b, TYPE c){ return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        static inline float reduce_add(TYPE value){
+            __m128 shuffled = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 sum = _mm_add_ps(value, shuffled);
+            shuffled = _mm_movehl_ps(shuffled, sum);
+            sum = _mm_add_ss(sum, shuffled);
+            return _mm_cvtss_f32(sum);
+        }
+    };
+#elif defined(RL_TOOLS_DEVICES_CPU_SIMD_NEON)
+    template <>
+    struct Vector<float>{
+        using SCALAR = float;
+        using TYPE = float32x4_t;
+        static constexpr int WIDTH = 4;
+        static inline TYPE zero(){ return vdupq_n_f32(0); }
+        static inline TYPE set1(float value){ return vdupq_n_f32(value); }
+        static inline TYPE load(const float* data){ return vld1q_f32(data); }
+        static inline void store(float* data, TYPE value){ vst1q_f32(data, value); }
+        static inline TYPE add(TYPE a, TYPE b){ return vaddq_f32(a, b); }
+        static inline TYPE mul(TYPE a, TYPE b){ return vmulq_f32(a, b); }
+        static inline TYPE fmadd(TYPE a, TYPE b, TYPE c){ return vfmaq_f32(c, a, b); }
+        static inline float reduce_add(TYPE value){ return vaddvq_f32(value); }
+    };
+#endif
+
+    // Vector<float>::WIDTH values of a 16 bit storage type (numeric_types/half.h), up-converted. The generic version
+    // converts lane by lane; the overloads below widen the raw bits in registers.
+    template <typename STORAGE_T>
+    inline typename Vector<float>::TYPE load_widened(const STORAGE_T* data){
+        float values[Vector<float>::WIDTH];
+        for(int lane_i = 0; lane_i < Vector<float>::WIDTH; lane_i++){
+            values[lane_i] = data[lane_i];
+        }
+        return Vector<float>::load(values);
+    }
+#if defined(RL_TOOLS_DEVICES_CPU_SIMD_AVX2)
+    // bfloat16 is the upper half of a float
+    inline __m256 load_widened(const numeric_types::bfloat16* data){
+        const __m256i bits = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 16));
+    }
+#if defined(RL_TOOLS_DEVICES_CPU_SIMD_F16C)
+    inline __m256 load_widened(const numeric_types::float16* data){
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+    }
+#endif
+#elif defined(RL_TOOLS_DEVICES_CPU_SIMD_SSE)
+    inline __m128 load_widened(const numeric_types::bfloat16* data){
+        const __m128i bits = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+        return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), bits));
+    }
+#elif defined(RL_TOOLS_DEVICES_CPU_SIMD_NEON)
+    inline float32x4_t load_widened(const numeric_types::bfloat16* data){
+        return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(reinterpret_cast<const uint16_t*>(data)), 16));
+    }
+    inline float32x4_t load_widened(const numeric_types::float16* data){
+        return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const uint16_t*>(data))));
+    }
+#endif
+    // target[i] = source[i] for count values, a vector at a time
+    template <typename STORAGE_T, typename TI>
+    inline void widen(const STORAGE_T* source, float* target, TI count){
+        using V = Vector<float>;
+        const TI vector_end = count - count % V::WIDTH;
+        TI value_i = 0;
+        for(; value_i < vector_end; value_i += V::WIDTH){
+            V::store(target + value_i, load_widened(source + value_i));
+        }
+        for(; value_i < count; value_i++){
+            target[value_i] = source[value_i];
+        }
+    }
+    // Hints that the bytes at [address, address + size) are about to be read, one cache line at a time
+    constexpr int CACHE_LINE_SIZE = 64;
+    inline void prefetch(const void* address, size_t size){
+        const char* line = static_cast<const char*>(address);
+        const char* end = line + size;
+        for(; line < end; line += CACHE_LINE_SIZE){
+#if defined(RL_TOOLS_DEVICES_CPU_SIMD_AVX2) || defined(RL_TOOLS_DEVICES_CPU_SIMD_SSE)
+            _mm_prefetch(line, _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(line);
+#endif
+        }
+    }
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+#endif
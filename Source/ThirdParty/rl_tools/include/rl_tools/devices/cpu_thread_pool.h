@@ -0,0 +1,137 @@
+#include "../version.h"
+#if (defined(RL_TOOLS_DISABLE_INCLUDE_GUARDS) || !defined(RL_TOOLS_DEVICES_CPU_THREAD_POOL_H)) && (RL_TOOLS_USE_THIS_VERSION == 1)
+#pragma once
+#define RL_TOOLS_DEVICES_CPU_THREAD_POOL_H
+
+#include "cpu.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::devices::cpu{
+    // Fixed set of worker threads that stay alive across dispatches. Workers spin briefly on a generation counter and
+    // then park on a condition variable, so back-to-back environment steps don't pay for thread creation or a full
+    // sleep/wake cycle. The dispatching thread participates as worker 0.
+    class ThreadPool{
+    public:
+        using TI = std::size_t;
+        using JOB = void(*)(void* context, TI thread_i);
+        static constexpr TI SPIN_ITERATIONS = 4096;
+
+        explicit ThreadPool(TI num_threads): num_threads_(num_threads > 0 ? num_threads : 1){
+            workers.reserve(num_threads_ - 1);
+            for(TI thread_i = 1; thread_i < num_threads_; thread_i++){
+                workers.emplace_back([this, thread_i](){ worker_loop(thread_i); });
+            }
+        }
+        ~ThreadPool(){
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop.store(true, std::memory_order_release);
+                generation.fetch_add(1, std::memory_order_release);
+            }
+            wake.notify_all();
+            for(auto& worker: workers){
+                worker.join();
+            }
+        }
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        TI num_threads() const{
+            return num_threads_;
+        }
+
+        // Runs job(context, thread_i) for every thread_i in [0, num_threads) and blocks until all of them returned
+        void run(JOB job, void* context){
+            if(num_threads_ == 1){
+                job(context, 0);
+                return;
+            }
+            current_job = job;
+            current_context = context;
+            pending.store(num_threads_ - 1, std::memory_order_relaxed);
+            {
+                // bumping the generation under the mutex guarantees parked workers can't miss the wake-up
+                std::lock_guard<std::mutex> lock(mutex);
+                generation.fetch_add(1, std::memory_order_release);
+            }
+            wake.notify_all();
+            job(context, 0);
+            TI spins = 0;
+            while(pending.load(std::memory_order_acquire) != 0){
+                if(++spins > SPIN_ITERATIONS){
+                    std::this_thread::yield();
+                }
+            }
+        }
+        template <typename FN>
+        void run(FN& fn){
+            run([](void* context, TI thread_i){ (*static_cast<FN*>(context))(thread_i); }, &fn);
+        }
+
+    private:
+        void worker_loop(TI thread_i){
+            std::uint64_t seen = 0;
+            while(true){
+                std::uint64_t current = generation.load(std::memory_order_acquire);
+                for(TI spins = 0; current == seen && spins < SPIN_ITERATIONS; spins++){
+                    current = generation.load(std::memory_order_acquire);
+                }
+                if(current == seen){
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [this, seen](){ return generation.load(std::memory_order_acquire) != seen; });
+                    current = generation.load(std::memory_order_acquire);
+                }
+                seen = current;
+                if(stop.load(std::memory_order_acquire)){
+                    return;
+                }
+                current_job(current_context, thread_i);
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+
+        TI num_threads_;
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::atomic<std::uint64_t> generation{0};
+        std::atomic<TI> pending{0};
+        std::atomic<bool> stop{false};
+        JOB current_job = nullptr;
+        void* current_context = nullptr;
+    };
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools{
+    // Returns the device's persistent pool, (re)creating it if it does not exist yet or has a different size.
+    // Copies of a device share the same pool. Persistent state is kept by the device, not the pool, so it survives this.
+    template <typename DEV_SPEC>
+    devices::cpu::ThreadPool& thread_pool(devices::CPU<DEV_SPEC>& device, typename devices::CPU<DEV_SPEC>::index_t num_threads){
+        if(!device.thread_pool || device.thread_pool->num_threads() != num_threads){
+            device.thread_pool = std::make_shared<devices::cpu::ThreadPool>(num_threads);
+        }
+        return *device.thread_pool;
+    }
+    // Like thread_pool, but keeps an existing pool that has at least min_threads threads. For jobs with a fixed number of
+    // lanes (e.g. one per critic) that should share the pool the runners sized instead of resizing it on every call.
+    template <typename DEV_SPEC>
+    devices::cpu::ThreadPool& thread_pool_at_least(devices::CPU<DEV_SPEC>& device, typename devices::CPU<DEV_SPEC>::index_t min_threads){
+        if(!device.thread_pool || device.thread_pool->num_threads() < min_threads){
+            device.thread_pool = std::make_shared<devices::cpu::ThreadPool>(min_threads);
+        }
+        return *device.thread_pool;
+    }
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+#endif
@@ -65,6 +65,12 @@ namespace rl_tools{
     void init(devices::Device<DEV_SPEC>& device){ };
     template <typename DEV_SPEC, typename T>
     void count_malloc(devices::Device<DEV_SPEC>& device, T){ };
+    template <typename DEV_SPEC, typename TI>
+    void* arena_allocate(devices::Device<DEV_SPEC>& device, TI size, TI alignment){ return nullptr; };
+    template <typename DEV_SPEC>
+    bool arena_owns(devices::Device<DEV_SPEC>& device, const void* pointer){ return false; };
+    template <typename DEV_SPEC>
+    void release_persistent_state(devices::Device<DEV_SPEC>& device, const void* owner){ };
     template <typename DEV_SPEC>
     void free(devices::Device<DEV_SPEC>& device){};
 }
@@ -4,9 +4,250 @@
 #define RL_TOOLS_NN_LAYERS_DENSE_OPERATIONS_CPU_H
 
 #include "operations_generic.h"
+#include "../../../devices/cpu.h"
+#include "../../../devices/cpu_simd.h"
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::nn::layers::dense::cpu{
+    // Register-blocked kernels for the plain CPU device (no BLAS). Everything is expressed in terms of (pointer, row
+    // pitch, col pitch) so the same kernels run on strided views: in that case V is simd::Scalar and the vector loads
+    // degenerate to single element loads.
+    template <typename T, typename TI>
+    struct Strided{
+        T* data;
+        TI row_pitch;
+        TI col_pitch;
+        T& operator()(TI row_i, TI col_i) const{
+            return data[row_i * row_pitch + col_i * col_pitch];
+        }
+    };
+    template <typename SPEC>
+    Strided<typename SPEC::T, typename SPEC::TI> strided(const Matrix<SPEC>& m){
+        // const views (e.g. of a const input tensor) are only ever read by the kernels
+        return {const_cast<typename SPEC::T*>(m._data), SPEC::ROW_PITCH, SPEC::COL_PITCH};
+    }
+    template <typename T, bool CONTIGUOUS>
+    using VectorFor = utils::typing::conditional_t<CONTIGUOUS, devices::cpu::simd::Vector<T>, devices::cpu::simd::Scalar<T>>;
+
+    // Forward micro-kernel: ROWS x COLS outputs, accumulated as dot products over the input dimension (weights are
+    // stored OUTPUT_DIM x INPUT_DIM, so both operands are contiguous along the reduction). Bias and activation are
+    // applied on the reduced values before anything is written back.
+    constexpr int FORWARD_ROWS = 2;
+    constexpr int FORWARD_COLS = 4;
+    template <typename V, typename MATH, typename LAYER_SPEC, bool STORE_PRE_ACTIVATIONS, int ROWS, int COLS, typename T, typename TI>
+    inline void forward_block(Strided<T, TI> input, Strided<T, TI> weights, Strided<T, TI> biases, Strided<T, TI> pre_activations, Strided<T, TI> output, TI row_start, TI col_start){
+        constexpr TI INPUT_DIM = LAYER_SPEC::INPUT_DIM;
+        typename V::TYPE acc[ROWS][COLS];
+        for(int row_i = 0; row_i < ROWS; row_i++){
+            for(int col_i = 0; col_i < COLS; col_i++){
+                acc[row_i][col_i] = V::zero();
+            }
+        }
+        TI input_i = 0;
+        for(; input_i + V::WIDTH <= INPUT_DIM; input_i += V::WIDTH){
+            typename V::TYPE x[ROWS];
+            for(int row_i = 0; row_i < ROWS; row_i++){
+                x[row_i] = V::load(&input(row_start + row_i, input_i));
+            }
+            for(int col_i = 0; col_i < COLS; col_i++){
+                typename V::TYPE w = V::load(&weights(col_start + col_i, input_i));
+                for(int row_i = 0; row_i < ROWS; row_i++){
+                    acc[row_i][col_i] = V::fmadd(x[row_i], w, acc[row_i][col_i]);
+                }
+            }
+        }
+        for(int row_i = 0; row_i < ROWS; row_i++){
+            for(int col_i = 0; col_i < COLS; col_i++){
+                T sum = V::reduce_add(acc[row_i][col_i]);
+                for(TI tail_i = input_i; tail_i < INPUT_DIM; tail_i++){
+                    sum += input(row_start + row_i, tail_i) * weights(col_start + col_i, tail_i);
+                }
+                sum += biases(0, col_start + col_i);
+                if constexpr(STORE_PRE_ACTIVATIONS){
+                    pre_activations(row_start + row_i, col_start + col_i) = sum;
+                }
+                output(row_start + row_i, col_start + col_i) = activation<MATH, T, LAYER_SPEC::ACTIVATION_FUNCTION>(sum);
+            }
+        }
+    }
+    template <typename V, typename MATH, typename LAYER_SPEC, bool STORE_PRE_ACTIVATIONS, int ROWS, typename T, typename TI>
+    inline void forward_rows(Strided<T, TI> input, Strided<T, TI> weights, Strided<T, TI> biases, Strided<T, TI> pre_activations, Strided<T, TI> output, TI row_start){
+        constexpr TI OUTPUT_DIM = LAYER_SPEC::OUTPUT_DIM;
+        TI col_i = 0;
+        for(; col_i + FORWARD_COLS <= OUTPUT_DIM; col_i += FORWARD_COLS){
+            forward_block<V, MATH, LAYER_SPEC, STORE_PRE_ACTIVATIONS, ROWS, FORWARD_COLS>(input, weights, biases, pre_activations, output, row_start, col_i);
+        }
+        for(; col_i < OUTPUT_DIM; col_i++){
+            forward_block<V, MATH, LAYER_SPEC, STORE_PRE_ACTIVATIONS, ROWS, 1>(input, weights, biases, pre_activations, output, row_start, col_i);
+        }
+    }
+    template <typename V, typename MATH, typename LAYER_SPEC, bool STORE_PRE_ACTIVATIONS, typename T, typename TI>
+    void forward(TI batch_size, Strided<T, TI> input, Strided<T, TI> weights, Strided<T, TI> biases, Strided<T, TI> pre_activations, Strided<T, TI> output){
+        TI row_i = 0;
+        for(; row_i + FORWARD_ROWS <= batch_size; row_i += FORWARD_ROWS){
+            forward_rows<V, MATH, LAYER_SPEC, STORE_PRE_ACTIVATIONS, FORWARD_ROWS>(input, weights, biases, pre_activations, output, row_i);
+        }
+        for(; row_i < batch_size; row_i++){
+            forward_rows<V, MATH, LAYER_SPEC, STORE_PRE_ACTIVATIONS, 1>(input, weights, biases, pre_activations, output, row_i);
+        }
+    }
+
+    // C (M x N) = [C +] A (M x K) * B (K x N). B and C are contiguous along N, A is addressed through its pitches so
+    // the same kernel serves d_input = d_pre_activations * W and d_W += d_pre_activations^T * input.
+    constexpr int MULTIPLY_ROWS = 4;
+    constexpr int MULTIPLY_VECTORS = 2;
+    template <typename V, bool ACCUMULATE, int ROWS, int VECTORS, typename T, typename TI>
+    inline void multiply_block(TI k_dim, Strided<T, TI> a, Strided<T, TI> b, Strided<T, TI> c, TI row_start, TI col_start){
+        typename V::TYPE acc[ROWS][VECTORS];
+        for(int row_i = 0; row_i < ROWS; row_i++){
+            for(int vector_i = 0; vector_i < VECTORS; vector_i++){
+                acc[row_i][vector_i] = ACCUMULATE ? V::load(&c(row_start + row_i, col_start + vector_i * V::WIDTH)) : V::zero();
+            }
+        }
+        for(TI k_i = 0; k_i < k_dim; k_i++){
+            typename V::TYPE b_k[VECTORS];
+            for(int vector_i = 0; vector_i < VECTORS; vector_i++){
+                b_k[vector_i] = V::load(&b(k_i, col_start + vector_i * V::WIDTH));
+            }
+            for(int row_i = 0; row_i < ROWS; row_i++){
+                typename V::TYPE a_rk = V::set1(a(row_start + row_i, k_i));
+                for(int vector_i = 0; vector_i < VECTORS; vector_i++){
+                    acc[row_i][vector_i] = V::fmadd(a_rk, b_k[vector_i], acc[row_i][vector_i]);
+                }
+            }
+        }
+        for(int row_i = 0; row_i < ROWS; row_i++){
+            for(int vector_i = 0; vector_i < VECTORS; vector_i++){
+                V::store(&c(row_start + row_i, col_start + vector_i * V::WIDTH), acc[row_i][vector_i]);
+            }
+        }
+    }
+    template <typename V, bool ACCUMULATE, int ROWS, typename T, typename TI>
+    inline void multiply_rows(TI n_dim, TI k_dim, Strided<T, TI> a, Strided<T, TI> b, Strided<T, TI> c, TI row_start){
+        using SCALAR = devices::cpu::simd::Scalar<T>;
+        TI col_i = 0;
+        for(; col_i + MULTIPLY_VECTORS * V::WIDTH <= n_dim; col_i += MULTIPLY_VECTORS * V::WIDTH){
+            multiply_block<V, ACCUMULATE, ROWS, MULTIPLY_VECTORS>(k_dim, a, b, c, row_start, col_i);
+        }
+        for(; col_i + V::WIDTH <= n_dim; col_i += V::WIDTH){
+            multiply_block<V, ACCUMULATE, ROWS, 1>(k_dim, a, b, c, row_start, col_i);
+        }
+        for(; col_i < n_dim; col_i++){
+            multiply_block<SCALAR, ACCUMULATE, ROWS, 1>(k_dim, a, b, c, row_start, col_i);
+        }
+    }
+    template <typename V, bool ACCUMULATE, typename T, typename TI>
+    void multiply(TI m_dim, TI n_dim, TI k_dim, Strided<T, TI> a, Strided<T, TI> b, Strided<T, TI> c){
+        TI row_i = 0;
+        for(; row_i + MULTIPLY_ROWS <= m_dim; row_i += MULTIPLY_ROWS){
+            multiply_rows<V, ACCUMULATE, MULTIPLY_ROWS>(n_dim, k_dim, a, b, c, row_i);
+        }
+        for(; row_i < m_dim; row_i++){
+            multiply_rows<V, ACCUMULATE, 1>(n_dim, k_dim, a, b, c, row_i);
+        }
+    }
+
+    // Backward pass over blocks of BATCH_BLOCK rows: the pre-activation gradient of a block is computed once into a
+    // stack buffer (fused with the bias gradient) and then feeds both the input and the weight gradient products.
+    // d_output is left untouched (unlike the BLAS path, which uses it as scratch space).
+    constexpr int D_PRE_ACTIVATIONS_BUFFER_ELEMENTS = 4096;
+    template <typename V, typename MATH, typename LAYER_SPEC, bool D_INPUT, bool GRADIENT, typename T, typename TI>
+    void backward(TI batch_size, Strided<T, TI> input, Strided<T, TI> pre_activations, Strided<T, TI> d_output, Strided<T, TI> weights, Strided<T, TI> d_input, Strided<T, TI> weights_gradient, Strided<T, TI> biases_gradient){
+        constexpr TI INPUT_DIM = LAYER_SPEC::INPUT_DIM;
+        constexpr TI OUTPUT_DIM = LAYER_SPEC::OUTPUT_DIM;
+        constexpr TI BATCH_BLOCK_MAX = D_PRE_ACTIVATIONS_BUFFER_ELEMENTS / OUTPUT_DIM;
+        constexpr TI BATCH_BLOCK = BATCH_BLOCK_MAX < 1 ? 1 : (BATCH_BLOCK_MAX > 32 ? 32 : BATCH_BLOCK_MAX);
+        T d_pre_activations_buffer[BATCH_BLOCK * OUTPUT_DIM];
+        for(TI block_start = 0; block_start < batch_size; block_start += BATCH_BLOCK){
+            const TI block_rows = batch_size - block_start < BATCH_BLOCK ? batch_size - block_start : BATCH_BLOCK;
+            for(TI row_i = 0; row_i < block_rows; row_i++){
+                for(TI output_i = 0; output_i < OUTPUT_DIM; output_i++){
+                    T d_pre_activation = d_activation_d_x<MATH, T, LAYER_SPEC::ACTIVATION_FUNCTION>(pre_activations(block_start + row_i, output_i)) * d_output(block_start + row_i, output_i);
+                    d_pre_activations_buffer[row_i * OUTPUT_DIM + output_i] = d_pre_activation;
+                    if constexpr(GRADIENT){
+                        biases_gradient(0, output_i) += d_pre_activation;
+                    }
+                }
+            }
+            if constexpr(D_INPUT){
+                // d_input[block] = d_pre_activations[block] (rows x OUTPUT_DIM) * W (OUTPUT_DIM x INPUT_DIM)
+                Strided<T, TI> d_pre_activations{d_pre_activations_buffer, OUTPUT_DIM, 1};
+                Strided<T, TI> d_input_block{&d_input(block_start, 0), d_input.row_pitch, d_input.col_pitch};
+                multiply<V, false>(block_rows, INPUT_DIM, OUTPUT_DIM, d_pre_activations, weights, d_input_block);
+            }
+            if constexpr(GRADIENT){
+                // d_W += d_pre_activations[block]^T (OUTPUT_DIM x rows) * input[block] (rows x INPUT_DIM)
+                Strided<T, TI> d_pre_activations_transposed{d_pre_activations_buffer, 1, OUTPUT_DIM};
+                Strided<T, TI> input_block{&input(block_start, 0), input.row_pitch, input.col_pitch};
+                multiply<V, true>(OUTPUT_DIM, INPUT_DIM, block_rows, d_pre_activations_transposed, input_block, weights_gradient);
+            }
+        }
+    }
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
 
 RL_TOOLS_NAMESPACE_WRAPPER_START
 namespace rl_tools{
+    // Selected over the generic (scalar triple loop) implementations by overload resolution for devices::CPU. The BLAS
+    // devices derive from devices::CPU but have their own, more specific overloads.
+    template<typename DEV_SPEC, typename LAYER_SPEC, typename INPUT_SPEC, typename OUTPUT_SPEC, typename RNG, typename MODE = mode::Default<>>
+    void evaluate(devices::CPU<DEV_SPEC>& device, const nn::layers::dense::LayerForward<LAYER_SPEC>& layer, const Matrix<INPUT_SPEC>& input, Matrix<OUTPUT_SPEC>& output, nn::layers::dense::Buffer&, RNG& rng, const Mode<MODE>& mode = Mode<mode::Default<>>{}) {
+        static_assert(nn::layers::dense::check_input_output<LAYER_SPEC, INPUT_SPEC, OUTPUT_SPEC>);
+        // Warning do not use the same buffer for input and output!
+        using T = typename LAYER_SPEC::T;
+        using WEIGHTS_SPEC = typename decltype(layer.weights.parameters)::SPEC;
+        constexpr bool CONTIGUOUS = INPUT_SPEC::COL_PITCH == 1 && WEIGHTS_SPEC::COL_PITCH == 1;
+        using V = nn::layers::dense::cpu::VectorFor<T, CONTIGUOUS>;
+        auto output_strided = nn::layers::dense::cpu::strided(output);
+        nn::layers::dense::cpu::forward<V, typename DEV_SPEC::MATH, LAYER_SPEC, false>(INPUT_SPEC::ROWS, nn::layers::dense::cpu::strided(input), nn::layers::dense::cpu::strided(layer.weights.parameters), nn::layers::dense::cpu::strided(layer.biases.parameters), output_strided, output_strided);
+    }
+
+    template<typename DEV_SPEC, typename LAYER_SPEC, typename INPUT_SPEC, typename OUTPUT_SPEC, typename RNG, typename MODE = mode::Default<>>
+    void forward(devices::CPU<DEV_SPEC>& device, nn::layers::dense::LayerBackward<LAYER_SPEC>& layer, const Matrix<INPUT_SPEC>& input, Matrix<OUTPUT_SPEC>& output, nn::layers::dense::Buffer&, RNG& rng, const Mode<MODE>& mode = Mode<mode::Default<>>{}){
+        static_assert(nn::layers::dense::check_input_output<LAYER_SPEC, INPUT_SPEC, OUTPUT_SPEC>);
+        // Warning do not use the same buffer for input and output!
+        using T = typename LAYER_SPEC::T;
+        using WEIGHTS_SPEC = typename decltype(layer.weights.parameters)::SPEC;
+        constexpr bool CONTIGUOUS = INPUT_SPEC::COL_PITCH == 1 && WEIGHTS_SPEC::COL_PITCH == 1;
+        using V = nn::layers::dense::cpu::VectorFor<T, CONTIGUOUS>;
+        nn::layers::dense::cpu::forward<V, typename DEV_SPEC::MATH, LAYER_SPEC, true>(INPUT_SPEC::ROWS, nn::layers::dense::cpu::strided(input), nn::layers::dense::cpu::strided(layer.weights.parameters), nn::layers::dense::cpu::strided(layer.biases.parameters), nn::layers::dense::cpu::strided(layer.pre_activations), nn::layers::dense::cpu::strided(output));
+    }
+
+    template<typename DEV_SPEC, typename LAYER_SPEC, typename D_OUTPUT_SPEC, typename D_INPUT_SPEC, typename MODE = mode::Default<>>
+    void backward_input(devices::CPU<DEV_SPEC>& device, const nn::layers::dense::LayerBackward<LAYER_SPEC>& layer, const Matrix<D_OUTPUT_SPEC>& d_output, Matrix<D_INPUT_SPEC>& d_input, nn::layers::dense::Buffer&, const Mode<MODE>& mode = Mode<mode::Default<>>{}){
+        static_assert(nn::layers::dense::check_input_output<LAYER_SPEC, D_INPUT_SPEC, D_OUTPUT_SPEC>);
+        using T = typename LAYER_SPEC::T;
+        using TI = typename devices::CPU<DEV_SPEC>::index_t;
+        using WEIGHTS_SPEC = typename decltype(layer.weights.parameters)::SPEC;
+        constexpr bool CONTIGUOUS = D_INPUT_SPEC::COL_PITCH == 1 && WEIGHTS_SPEC::COL_PITCH == 1;
+        using V = nn::layers::dense::cpu::VectorFor<T, CONTIGUOUS>;
+        nn::layers::dense::cpu::Strided<T, TI> none{nullptr, 0, 0};
+        nn::layers::dense::cpu::backward<V, typename DEV_SPEC::MATH, LAYER_SPEC, true, false>(D_OUTPUT_SPEC::ROWS, none, nn::layers::dense::cpu::strided(layer.pre_activations), nn::layers::dense::cpu::strided(d_output), nn::layers::dense::cpu::strided(layer.weights.parameters), nn::layers::dense::cpu::strided(d_input), none, none);
+    }
+
+    template<typename DEV_SPEC, typename LAYER_SPEC, typename INPUT_SPEC, typename D_OUTPUT_SPEC, typename MODE = mode::Default<>>
+    void backward(devices::CPU<DEV_SPEC>& device, nn::layers::dense::LayerGradient<LAYER_SPEC>& layer, const Matrix<INPUT_SPEC>& input, Matrix<D_OUTPUT_SPEC>& d_output, nn::layers::dense::Buffer&, const Mode<MODE>& mode = Mode<mode::Default<>>{}) {
+        static_assert(nn::layers::dense::check_input_output<LAYER_SPEC, INPUT_SPEC, D_OUTPUT_SPEC>);
+        using T = typename LAYER_SPEC::T;
+        using TI = typename devices::CPU<DEV_SPEC>::index_t;
+        using WEIGHTS_GRADIENT_SPEC = typename decltype(layer.weights.gradient)::SPEC;
+        constexpr bool CONTIGUOUS = INPUT_SPEC::COL_PITCH == 1 && WEIGHTS_GRADIENT_SPEC::COL_PITCH == 1;
+        using V = nn::layers::dense::cpu::VectorFor<T, CONTIGUOUS>;
+        nn::layers::dense::cpu::Strided<T, TI> none{nullptr, 0, 0};
+        nn::layers::dense::cpu::backward<V, typename DEV_SPEC::MATH, LAYER_SPEC, false, true>(INPUT_SPEC::ROWS, nn::layers::dense::cpu::strided(input), nn::layers::dense::cpu::strided(layer.pre_activations), nn::layers::dense::cpu::strided(d_output), none, none, nn::layers::dense::cpu::strided(layer.weights.gradient), nn::layers::dense::cpu::strided(layer.biases.gradient));
+    }
+
+    template<typename DEV_SPEC, typename LAYER_SPEC, typename INPUT_SPEC, typename D_OUTPUT_SPEC, typename D_INPUT_SPEC, typename MODE = mode::Default<>>
+    void backward_full(devices::CPU<DEV_SPEC>& device, nn::layers::dense::LayerGradient<LAYER_SPEC>& layer, const Matrix<INPUT_SPEC>& input, Matrix<D_OUTPUT_SPEC>& d_output, Matrix<D_INPUT_SPEC>& d_input, nn::layers::dense::Buffer&, const Mode<MODE>& mode = Mode<mode::Default<>>{}) {
+        static_assert(nn::layers::dense::check_input_output<LAYER_SPEC, D_INPUT_SPEC, D_OUTPUT_SPEC>);
+        static_assert(nn::layers::dense::check_input_output<LAYER_SPEC, INPUT_SPEC, D_OUTPUT_SPEC>);
+        using T = typename LAYER_SPEC::T;
+        using WEIGHTS_SPEC = typename decltype(layer.weights.parameters)::SPEC;
+        using WEIGHTS_GRADIENT_SPEC = typename decltype(layer.weights.gradient)::SPEC;
+        constexpr bool CONTIGUOUS = INPUT_SPEC::COL_PITCH == 1 && D_INPUT_SPEC::COL_PITCH == 1 && WEIGHTS_SPEC::COL_PITCH == 1 && WEIGHTS_GRADIENT_SPEC::COL_PITCH == 1;
+        using V = nn::layers::dense::cpu::VectorFor<T, CONTIGUOUS>;
+        nn::layers::dense::cpu::backward<V, typename DEV_SPEC::MATH, LAYER_SPEC, true, true>(INPUT_SPEC::ROWS, nn::layers::dense::cpu::strided(input), nn::layers::dense::cpu::strided(layer.pre_activations), nn::layers::dense::cpu::strided(d_output), nn::layers::dense::cpu::strided(layer.weights.parameters), nn::layers::dense::cpu::strided(d_input), nn::layers::dense::cpu::strided(layer.weights.gradient), nn::layers::dense::cpu::strided(layer.biases.gradient));
+    }
 }
 RL_TOOLS_NAMESPACE_WRAPPER_END
 
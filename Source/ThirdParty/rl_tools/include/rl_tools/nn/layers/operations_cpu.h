@@ -1 +1,2 @@
 #include "dense/operations_cpu.h"
+#include "gru/operations_generic.h"
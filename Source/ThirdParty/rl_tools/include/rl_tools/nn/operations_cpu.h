@@ -1 +1,2 @@
+#include "operations_generic.h"
 #include "layers/operations_cpu.h"
\ No newline at end of file
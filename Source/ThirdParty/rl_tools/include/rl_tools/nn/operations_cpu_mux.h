@@ -7,7 +7,7 @@
 #if defined(RL_TOOLS_BACKEND_ENABLE_OPENBLAS) && !defined(RL_TOOLS_BACKEND_DISABLE_BLAS)
 #include "../nn/operations_cpu_openblas.h"
 #else
-#include "../nn/operations_generic.h"
+#include "../nn/operations_cpu.h"
 #endif
 #endif
 #endif
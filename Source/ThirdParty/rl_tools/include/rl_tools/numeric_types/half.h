@@ -0,0 +1,98 @@
+#include "../version.h"
+#if (defined(RL_TOOLS_DISABLE_INCLUDE_GUARDS) || !defined(RL_TOOLS_NUMERIC_TYPES_HALF_H)) && (RL_TOOLS_USE_THIS_VERSION == 1)
+#pragma once
+#define RL_TOOLS_NUMERIC_TYPES_HALF_H
+
+#include <cstdint>
+#include <cstring>
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::numeric_types{
+    // 16 bit storage types. They only convert to and from float (round to nearest even), so containers of them can be
+    // filled and read through the generic get/set/copy operations; arithmetic happens after up-conversion. The bit
+    // patterns are the standard ones, so the SIMD loads in devices/cpu_simd.h widen them without a table.
+    namespace half{
+        inline uint32_t float_bits(float value){
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+        inline float bits_float(uint32_t bits){
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        inline uint16_t float_to_bfloat16(float value){
+            const uint32_t bits = float_bits(value);
+            if((bits & 0x7FFFFFFF) > 0x7F800000){
+                return (uint16_t)((bits >> 16) | 0x0040); // keep NaNs quiet instead of rounding them to infinity
+            }
+            return (uint16_t)((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16);
+        }
+        inline float bfloat16_to_float(uint16_t bits){
+            return bits_float((uint32_t)bits << 16);
+        }
+        inline uint16_t float_to_float16(float value){
+            uint32_t bits = float_bits(value);
+            const uint32_t sign = (bits >> 16) & 0x8000;
+            bits &= 0x7FFFFFFF;
+            if(bits >= 0x7F800000){
+                return (uint16_t)(sign | 0x7C00 | (bits > 0x7F800000 ? 0x0200 : 0));
+            }
+            if(bits >= 0x47800000){
+                return (uint16_t)(sign | 0x7C00); // beyond 65504 after rounding
+            }
+            if(bits < 0x38800000){
+                // Subnormal in half precision (or zero): the mantissa is shifted into units of 2^-24
+                if(bits < 0x33000000){
+                    return (uint16_t)sign;
+                }
+                const uint32_t exponent = bits >> 23;
+                const uint32_t mantissa = (bits & 0x7FFFFF) | 0x800000;
+                const uint32_t shift = 126 - exponent;
+                uint32_t result = mantissa >> shift;
+                const uint32_t remainder = mantissa & ((1u << shift) - 1);
+                const uint32_t halfway = 1u << (shift - 1);
+                if(remainder > halfway || (remainder == halfway && (result & 1))){
+                    result++;
+                }
+                return (uint16_t)(sign | result);
+            }
+            uint32_t result = (bits >> 13) - (112 << 10);
+            const uint32_t remainder = bits & 0x1FFF;
+            if(remainder > 0x1000 || (remainder == 0x1000 && (result & 1))){
+                result++; // may carry into the exponent, up to infinity
+            }
+            return (uint16_t)(sign | result);
+        }
+        inline float float16_to_float(uint16_t bits){
+            const uint32_t sign = (uint32_t)(bits & 0x8000) << 16;
+            const uint32_t exponent = (bits >> 10) & 0x1F;
+            const uint32_t mantissa = bits & 0x3FF;
+            if(exponent == 0){
+                const float magnitude = (float)mantissa * 5.9604644775390625e-8f; // 2^-24
+                return bits_float(float_bits(magnitude) | sign);
+            }
+            if(exponent == 31){
+                return bits_float(sign | 0x7F800000 | (mantissa << 13));
+            }
+            return bits_float(sign | ((exponent + 112) << 23) | (mantissa << 13));
+        }
+    }
+    struct bfloat16{
+        uint16_t bits;
+        bfloat16() = default;
+        bfloat16(float value): bits(half::float_to_bfloat16(value)){}
+        operator float() const{ return half::bfloat16_to_float(bits); }
+    };
+    struct float16{
+        uint16_t bits;
+        float16() = default;
+        float16(float value): bits(half::float_to_float16(value)){}
+        operator float() const{ return half::float16_to_float(bits); }
+    };
+    static_assert(sizeof(bfloat16) == 2 && sizeof(float16) == 2);
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+#endif
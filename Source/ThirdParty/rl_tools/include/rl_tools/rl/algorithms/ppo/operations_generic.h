@@ -87,6 +87,48 @@ namespace rl_tools{
             }
         }
     }
+    // Same estimate for a dataset filled by a batched rollout over a number of environments (lanes) that is only known at
+    // runtime: row pos holds a step of lane pos % n_lanes, the first n_rows rows are filled (the last step may be partial)
+    // and lane_values holds each lane's value after its last filled row. Instead of walking one lane at a time, the steps
+    // are visited backwards with the lanes in the inner loop, so each step reads one contiguous block of rows and the lanes'
+    // recurrences (carried in lane_values and lane_advantages) are independent iterations. gamma and lambda are taken at
+    // runtime; PPO_PARAMETERS only supplies IGNORE_TERMINATION.
+    template <typename DEVICE, typename DATASET_SPEC, typename LANE_SPEC, typename PPO_PARAMETERS>
+    void estimate_generalized_advantages(DEVICE& device, rl::components::on_policy_runner::Dataset<DATASET_SPEC>& dataset, Matrix<LANE_SPEC>& lane_values, Matrix<LANE_SPEC>& lane_advantages, typename DEVICE::index_t n_rows, typename DEVICE::index_t n_lanes, typename DATASET_SPEC::SPEC::T gamma, typename DATASET_SPEC::SPEC::T lambda, PPO_PARAMETERS ppo_parameters_tag){
+        using T = typename DATASET_SPEC::SPEC::T;
+        using TI = typename DEVICE::index_t;
+        static_assert(LANE_SPEC::ROWS == 1);
+        utils::assert_exit(device, n_lanes > 0 && n_lanes <= LANE_SPEC::COLS, "estimate_generalized_advantages: lane count exceeds the lane state");
+        utils::assert_exit(device, n_rows <= DATASET_SPEC::STEPS_TOTAL, "estimate_generalized_advantages: more rows than the dataset holds");
+        set_all(device, lane_advantages, 0);
+        TI step_end = n_rows;
+        while(step_end > 0){
+            TI step_begin = ((step_end - 1) / n_lanes) * n_lanes;
+            for(TI pos = step_begin; pos < step_end; pos++){
+                TI lane_i = pos - step_begin;
+                bool terminated = get(dataset.terminated, pos, 0);
+                bool truncated = get(dataset.truncated, pos, 0);
+                T current_step_value = get(dataset.values, pos, 0);
+                bool terminated_actual = terminated && !PPO_PARAMETERS::IGNORE_TERMINATION;
+                T next_step_value = terminated_actual ? 0 : get(lane_values, 0, lane_i);
+                T previous_advantage = get(lane_advantages, 0, lane_i);
+
+                T td_error = get(dataset.rewards, pos, 0) + gamma * next_step_value - current_step_value;
+                if(truncated){
+                    if(!terminated){
+                        td_error = 0;
+                    }
+                    previous_advantage = 0;
+                }
+                T advantage = lambda * gamma * previous_advantage + td_error;
+                set(dataset.advantages, pos, 0, advantage);
+                set(dataset.target_values, pos, 0, advantage + current_step_value);
+                set(lane_advantages, 0, lane_i, advantage);
+                set(lane_values, 0, lane_i, current_step_value);
+            }
+            step_end = step_begin;
+        }
+    }
     template <typename DEVICE, typename PPO_SPEC, typename DATASET_SPEC, typename ACTOR_OPTIMIZER, typename CRITIC_OPTIMIZER, typename BUFFERS_SPEC, typename ACTOR_BUFFER, typename CRITIC_BUFFER, typename RNG>
     void train(DEVICE& device, rl::algorithms::PPO<PPO_SPEC>& ppo, rl::components::on_policy_runner::Dataset<DATASET_SPEC>& dataset, ACTOR_OPTIMIZER& actor_optimizer, CRITIC_OPTIMIZER& critic_optimizer, rl::algorithms::ppo::Buffers<BUFFERS_SPEC>& ppo_buffers, ACTOR_BUFFER& actor_buffers, CRITIC_BUFFER& critic_buffers, RNG& rng){
 #ifdef RL_TOOLS_DEBUG_RL_ALGORITHMS_PPO_CHECK_INIT
@@ -291,7 +333,9 @@ namespace rl_tools{
                 T critic_loss = nn::loss_functions::mse::evaluate(device, output_matrix_view, batch_target_values);
                 add_scalar(device, device.logger, "ppo/critic_loss", critic_loss);
                 step(device, actor_optimizer, ppo.actor);
-                step(device, actor_optimizer, ppo.critic); // todo: evaluate switch to critic_optimizer
+                // Each network has its own optimizer: the critic keeps its learning rate when the adaptive one above moves
+                // the actor's, and each Adam bias correction advances once per minibatch
+                step(device, critic_optimizer, ppo.critic);
             }
         }
         if(PPO_SPEC::PARAMETERS::ADAPTIVE_LEARNING_RATE) {
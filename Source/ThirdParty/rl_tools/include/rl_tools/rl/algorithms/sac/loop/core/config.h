@@ -38,6 +38,10 @@ namespace rl_tools::rl::algorithms::sac::loop::core{
         static constexpr TI EPISODE_STATS_BUFFER_SIZE = 1000;
 
         static constexpr bool SHARED_BATCH = true;
+        // Train the twin critics concurrently, one per thread of the device's thread pool, on targets computed once per
+        // step. Requires SHARED_BATCH and a CPU device with loop/core/operations_cpu.h included (other devices fail to
+        // compile). The second critic trains on a device of its own, so only the first critic's loss is logged.
+        static constexpr bool PARALLEL_CRITIC_TRAINING = false;
         static constexpr bool SAMPLE_ENVIRONMENT_PARAMETERS = true;
 
         using INITIALIZER = nn::layers::dense::DefaultInitializer<T, TI>;
@@ -83,11 +87,13 @@ namespace rl_tools::rl::algorithms::sac::loop::core{
             static constexpr TI EPISODE_STATS_BUFFER_SIZE = CORE_PARAMETERS::EPISODE_STATS_BUFFER_SIZE;
             static constexpr T EXPLORATION_NOISE = 0.1;
             static constexpr bool SAMPLE_PARAMETERS = CORE_PARAMETERS::SAMPLE_ENVIRONMENT_PARAMETERS;
+            static constexpr bool DEDUPLICATE_OBSERVATIONS = false;
         };
         using POLICIES = rl_tools::utils::Tuple<TI, EXPLORATION_POLICY, typename NN::ACTOR_TYPE>;
 
         using OFF_POLICY_RUNNER_SPEC = rl::components::off_policy_runner::Specification<T, TI, ENVIRONMENT, POLICIES, OFF_POLICY_RUNNER_PARAMETERS, DYNAMIC_ALLOCATION>;
         static_assert(ACTOR_CRITIC_TYPE::SPEC::PARAMETERS::ACTOR_BATCH_SIZE == ACTOR_CRITIC_TYPE::SPEC::PARAMETERS::CRITIC_BATCH_SIZE);
+        static_assert(!CORE_PARAMETERS::PARALLEL_CRITIC_TRAINING || CORE_PARAMETERS::SHARED_BATCH, "Parallel critic training shares one batch and one set of targets between the critics");
         template <typename CONFIG>
         using State = State<CONFIG>;
     };
@@ -0,0 +1,51 @@
+#include "../../../../../version.h"
+#if (defined(RL_TOOLS_DISABLE_INCLUDE_GUARDS) || !defined(RL_TOOLS_RL_ALGORITHMS_SAC_LOOP_CORE_OPERATIONS_CPU_H)) && (RL_TOOLS_USE_THIS_VERSION == 1)
+#pragma once
+#define RL_TOOLS_RL_ALGORITHMS_SAC_LOOP_CORE_OPERATIONS_CPU_H
+
+#include "../../../../../devices/cpu_thread_pool.h"
+#include "../../../../../rl/components/off_policy_runner/operations_cpu.h"
+#include "../../../../../nn/optimizers/adam/instance/operations_generic.h"
+#include "../../../../../nn/layers/sample_and_squash/operations_generic.h"
+#include "../../../../../nn_models/mlp/operations_generic.h"
+#include "../../../../../nn_models/sequential/operations_generic.h"
+#include "../../../../../nn_models/random_uniform/operations_generic.h"
+#include "../../../../../rl/algorithms/sac/operations_generic.h"
+#include "../../../../../nn/optimizers/adam/operations_generic.h"
+#include "config.h"
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::rl::algorithms::sac::loop::core{
+    // CPU version of train_critics_parallel, called by train_critics (operations_generic.h) with PARALLEL_CRITIC_TRAINING.
+    // The targets are computed once on the calling thread and the two critic regressions run on the first two lanes of
+    // the device's thread pool, each with its own critic and training buffers. The targets are the ones either critic
+    // would have computed itself, so the result equals the sequential loop. The second lane runs on a device of its own,
+    // so the lanes share no logger or other device state; only the first critic's scalars reach device.logger.
+    template <typename DEV_SPEC, typename T_CONFIG>
+    void train_critics_parallel(devices::CPU<DEV_SPEC>& device, State<T_CONFIG>& ts){
+        using CONFIG = T_CONFIG;
+        using DEVICE = devices::CPU<DEV_SPEC>;
+        using TI = typename DEVICE::index_t;
+        critic_targets(device, ts.actor_critic, ts.critic_batch, ts.actor_buffers[0], ts.critic_buffers[0], ts.critic_training_buffers[0], ts.action_noise_critic, ts.rng);
+        copy(device, device, ts.critic_training_buffers[0].target_action_value, ts.critic_training_buffers[1].target_action_value);
+
+        // Dense critics draw nothing from the rng; the second lane gets its own copy so the lanes never share state
+        typename CONFIG::RNG critic_rngs[2] = {ts.rng, ts.rng};
+        DEVICE lane_device;
+        auto job = [&device, &lane_device, &ts, &critic_rngs](TI thread_i){
+            if(thread_i == 0){
+                train_critic_on_targets(device, ts.actor_critic, ts.actor_critic.critic_1, ts.critic_batch, ts.critic_optimizers[0], ts.critic_buffers[0], ts.critic_training_buffers[0], critic_rngs[0]);
+            }
+            else if(thread_i == 1){
+                train_critic_on_targets(lane_device, ts.actor_critic, ts.actor_critic.critic_2, ts.critic_batch, ts.critic_optimizers[1], ts.critic_buffers[1], ts.critic_training_buffers[1], critic_rngs[1]);
+            }
+        };
+        thread_pool_at_least(device, 2).run(job);
+        ts.rng = critic_rngs[0];
+    }
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+#include "operations_generic.h"
+
+#endif
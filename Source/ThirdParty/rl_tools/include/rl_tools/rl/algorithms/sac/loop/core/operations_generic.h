@@ -96,6 +96,34 @@ namespace rl_tools{
         }
     }
 
+    namespace rl::algorithms::sac::loop::core{
+        // Trains critic_1 and critic_2 one after the other. With SHARED_BATCH the batch and the critic action noise have
+        // already been drawn by step.
+        template <typename DEVICE, typename T_CONFIG>
+        void train_critics_sequential(DEVICE& device, State<T_CONFIG>& ts){
+            using CONFIG = T_CONFIG;
+            for(int critic_i = 0; critic_i < 2; critic_i++){
+                if constexpr(!CONFIG::CORE_PARAMETERS::SHARED_BATCH) {
+                    gather_batch(device, ts.off_policy_runner, ts.critic_batch, ts.rng);
+                    randn(device, ts.action_noise_critic, ts.rng);
+                }
+                train_critic(device, ts.actor_critic, critic_i == 0 ? ts.actor_critic.critic_1 : ts.actor_critic.critic_2, ts.critic_batch, ts.critic_optimizers[critic_i], ts.actor_buffers[critic_i], ts.critic_buffers[critic_i], ts.critic_training_buffers[critic_i], ts.action_noise_critic, ts.rng);
+            }
+        }
+        // With PARALLEL_CRITIC_TRAINING the two critics run concurrently through train_critics_parallel, which is found
+        // by argument-dependent lookup at instantiation (the CPU version lives in operations_cpu.h), so the choice does
+        // not depend on include order and a device without it fails to compile instead of falling back silently
+        template <typename DEVICE, typename T_CONFIG>
+        void train_critics(DEVICE& device, State<T_CONFIG>& ts){
+            if constexpr(T_CONFIG::CORE_PARAMETERS::PARALLEL_CRITIC_TRAINING){
+                train_critics_parallel(device, ts);
+            }
+            else{
+                train_critics_sequential(device, ts);
+            }
+        }
+    }
+
     template <typename DEVICE, typename T_CONFIG>
     bool step(DEVICE& device, rl::algorithms::sac::loop::core::State<T_CONFIG>& ts){
         using CONFIG = T_CONFIG;
@@ -117,13 +145,7 @@ namespace rl_tools{
             randn(device, ts.action_noise_critic, ts.rng);
         }
         if(train_critic_flag){
-            for(int critic_i = 0; critic_i < 2; critic_i++){
-                if constexpr(!CONFIG::CORE_PARAMETERS::SHARED_BATCH) {
-                    gather_batch(device, ts.off_policy_runner, ts.critic_batch, ts.rng);
-                    randn(device, ts.action_noise_critic, ts.rng);
-                }
-                train_critic(device, ts.actor_critic, critic_i == 0 ? ts.actor_critic.critic_1 : ts.actor_critic.critic_2, ts.critic_batch, ts.critic_optimizers[critic_i], ts.actor_buffers[critic_i], ts.critic_buffers[critic_i], ts.critic_training_buffers[critic_i], ts.action_noise_critic, ts.rng);
-            }
+            rl::algorithms::sac::loop::core::train_critics(device, ts);
         }
         if(update_critic_targets_flag){
             update_critic_targets(device, ts.actor_critic);
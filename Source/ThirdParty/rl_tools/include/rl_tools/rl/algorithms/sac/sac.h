@@ -145,6 +145,8 @@ namespace rl_tools::rl::algorithms::sac {
         typename SPEC::ACTOR_OPTIMIZER actor_optimizer;
         typename SPEC::CRITIC_OPTIMIZER critic_optimizers[2];
         typename SPEC::ALPHA_OPTIMIZER alpha_optimizer;
+
+        T gamma = SPEC::PARAMETERS::GAMMA;
 //        ActorCritic(): actor_view(actor){};
     };
 }
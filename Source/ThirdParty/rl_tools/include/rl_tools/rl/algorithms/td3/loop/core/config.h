@@ -78,6 +78,7 @@ namespace rl_tools::rl::algorithms::td3::loop::core{
             static constexpr TI EPISODE_STATS_BUFFER_SIZE = CORE_PARAMETERS::EPISODE_STATS_BUFFER_SIZE;
             static constexpr T EXPLORATION_NOISE = CORE_PARAMETERS::EXPLORATION_NOISE;
             static constexpr bool SAMPLE_PARAMETERS = true;
+            static constexpr bool DEDUPLICATE_OBSERVATIONS = false;
         };
         using POLICIES = rl_tools::utils::Tuple<TI, EXPLORATION_POLICY, typename NN::ACTOR_TYPE>;
 
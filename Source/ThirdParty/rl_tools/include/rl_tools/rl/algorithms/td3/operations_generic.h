@@ -159,18 +159,13 @@ namespace rl_tools{
             }
         }
     }
-    template <typename DEVICE, typename SPEC, typename CRITIC_TYPE, typename BATCH_SPEC, typename OPTIMIZER, typename ACTOR_BUFFERS, typename CRITIC_BUFFERS, typename TRAINING_BUFFERS_SPEC, typename RNG>
-    void train_critic(DEVICE& device, const rl::algorithms::td3::ActorCritic<SPEC>& actor_critic, CRITIC_TYPE& critic, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, OPTIMIZER& optimizer, ACTOR_BUFFERS& actor_buffers, CRITIC_BUFFERS& critic_buffers, rl::algorithms::td3::CriticTrainingBuffers<TRAINING_BUFFERS_SPEC>& training_buffers, RNG& rng) {
-        // requires training_buffers.target_next_action_noise to be populated
-        using T = typename SPEC::T;
+    // First half of train_critic: the clipped double-Q targets r + gamma * min(Q'_1, Q'_2)(s', mu'(s') + noise) for the
+    // batch, written to training_buffers.target_action_value. Requires training_buffers.target_next_action_noise to be
+    // populated. The targets do not depend on which critic is trained, so with a shared batch they can be computed once
+    // and handed to both critics (see train_critic_on_targets).
+    template <typename DEVICE, typename SPEC, typename BATCH_SPEC, typename ACTOR_BUFFERS, typename CRITIC_BUFFERS, typename TRAINING_BUFFERS_SPEC, typename RNG>
+    void critic_targets(DEVICE& device, const rl::algorithms::td3::ActorCritic<SPEC>& actor_critic, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, ACTOR_BUFFERS& actor_buffers, CRITIC_BUFFERS& critic_buffers, rl::algorithms::td3::CriticTrainingBuffers<TRAINING_BUFFERS_SPEC>& training_buffers, RNG& rng) {
         using TI = typename DEVICE::index_t;
-        constexpr TI SEQUENCE_LENGTH = BATCH_SPEC::SEQUENCE_LENGTH;
-        constexpr TI BATCH_SIZE = BATCH_SPEC::BATCH_SIZE;
-//        static_assert(BATCH_SIZE == SPEC::PARAMETERS::CRITIC_BATCH_SIZE);
-//        static_assert(BATCH_SIZE == CRITIC_BUFFERS::BATCH_SIZE);
-//        static_assert(BATCH_SIZE == ACTOR_BUFFERS::BATCH_SIZE);
-        zero_gradient(device, critic);
-
         using RESET_MODE_SPEC = nn::layers::gru::ResetModeSpecification<TI, decltype(batch.reset)>;
         using RESET_MODE = nn::layers::gru::ResetMode<mode::Default<>, RESET_MODE_SPEC>;
         Mode<RESET_MODE> reset_mode;
@@ -185,6 +180,22 @@ namespace rl_tools{
         evaluate(device, actor_critic.critic_target_2, training_buffers.next_state_action_value_input, training_buffers.next_state_action_value_critic_2, critic_buffers, rng, reset_mode);
 
         target_action_values(device, actor_critic, batch, training_buffers);
+    }
+    // Second half of train_critic: regresses critic onto training_buffers.target_action_value (filled by critic_targets)
+    // and steps its optimizer. Only touches critic, its optimizer, critic_buffers and training_buffers, so the two
+    // critics can be trained concurrently as long as each has its own buffers.
+    template <typename DEVICE, typename SPEC, typename CRITIC_TYPE, typename BATCH_SPEC, typename OPTIMIZER, typename CRITIC_BUFFERS, typename TRAINING_BUFFERS_SPEC, typename RNG>
+    void train_critic_on_targets(DEVICE& device, const rl::algorithms::td3::ActorCritic<SPEC>& actor_critic, CRITIC_TYPE& critic, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, OPTIMIZER& optimizer, CRITIC_BUFFERS& critic_buffers, rl::algorithms::td3::CriticTrainingBuffers<TRAINING_BUFFERS_SPEC>& training_buffers, RNG& rng) {
+        using T = typename SPEC::T;
+        using TI = typename DEVICE::index_t;
+        constexpr TI SEQUENCE_LENGTH = BATCH_SPEC::SEQUENCE_LENGTH;
+        constexpr TI BATCH_SIZE = BATCH_SPEC::BATCH_SIZE;
+        zero_gradient(device, critic);
+
+        using RESET_MODE_SPEC = nn::layers::gru::ResetModeSpecification<TI, decltype(batch.reset)>;
+        using RESET_MODE = nn::layers::gru::ResetMode<mode::Default<>, RESET_MODE_SPEC>;
+        Mode<RESET_MODE> reset_mode;
+        reset_mode.reset_container = batch.reset;
         forward(device, critic, batch.observations_and_actions, critic_buffers, rng, reset_mode);
         {
             T loss_weight = 1;
@@ -216,6 +227,61 @@ namespace rl_tools{
         backward(device, critic, batch.observations_and_actions, training_buffers.d_output, critic_buffers, reset_mode);
         step(device, optimizer, critic);
     }
+    // Prioritized replay variant: each sample's squared error is scaled by its importance weight, and the TD errors
+    // (Q(s, a) - target) are written to td_errors ([SEQUENCE_LENGTH, BATCH_SIZE, 1], like the weights) so the caller can
+    // update the priorities.
+    template <typename DEVICE, typename SPEC, typename CRITIC_TYPE, typename BATCH_SPEC, typename OPTIMIZER, typename CRITIC_BUFFERS, typename TRAINING_BUFFERS_SPEC, typename WEIGHTS_SPEC, typename TD_ERRORS_SPEC, typename RNG>
+    void train_critic_on_targets(DEVICE& device, const rl::algorithms::td3::ActorCritic<SPEC>& actor_critic, CRITIC_TYPE& critic, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, OPTIMIZER& optimizer, CRITIC_BUFFERS& critic_buffers, rl::algorithms::td3::CriticTrainingBuffers<TRAINING_BUFFERS_SPEC>& training_buffers, const Tensor<WEIGHTS_SPEC>& importance_weights, Tensor<TD_ERRORS_SPEC>& td_errors, RNG& rng) {
+        using T = typename SPEC::T;
+        using TI = typename DEVICE::index_t;
+        constexpr TI SEQUENCE_LENGTH = BATCH_SPEC::SEQUENCE_LENGTH;
+        constexpr TI BATCH_SIZE = BATCH_SPEC::BATCH_SIZE;
+        zero_gradient(device, critic);
+
+        using RESET_MODE_SPEC = nn::layers::gru::ResetModeSpecification<TI, decltype(batch.reset)>;
+        using RESET_MODE = nn::layers::gru::ResetMode<mode::Default<>, RESET_MODE_SPEC>;
+        Mode<RESET_MODE> reset_mode;
+        reset_mode.reset_container = batch.reset;
+        forward(device, critic, batch.observations_and_actions, critic_buffers, rng, reset_mode);
+        {
+            T loss_weight = 1;
+            if constexpr(SPEC::PARAMETERS::MASK_NON_TERMINAL){
+                T num_final_steps = cast_sum<T>(device, batch.final_step_mask);
+                utils::assert_exit(device, num_final_steps > 0, "No reset in critic training");
+                loss_weight *= SEQUENCE_LENGTH * BATCH_SIZE / num_final_steps; // reweight the loss by the number of non-masked outputs
+            }
+            auto critic_output = output(device, critic);
+            // Gradient of mean(w * (Q - target)^2), matching nn::loss_functions::mse for w = 1
+            const T gradient_scale = (T)2 / ((T)SEQUENCE_LENGTH * BATCH_SIZE) * loss_weight;
+            T loss = 0;
+            for(TI seq_step_i = 0; seq_step_i < SEQUENCE_LENGTH; seq_step_i++){
+                for(TI batch_step_i = 0; batch_step_i < BATCH_SIZE; batch_step_i++){
+                    const bool active = !SPEC::PARAMETERS::MASK_NON_TERMINAL || get(device, batch.final_step_mask, seq_step_i, batch_step_i, 0);
+                    const T td_error = active ? get(device, critic_output, seq_step_i, batch_step_i, 0) - get(device, training_buffers.target_action_value, seq_step_i, batch_step_i, 0) : 0;
+                    const T weight = get(device, importance_weights, seq_step_i, batch_step_i, 0);
+                    set(device, td_errors, td_error, seq_step_i, batch_step_i, 0);
+                    set(device, training_buffers.d_output, gradient_scale * weight * td_error, seq_step_i, batch_step_i, 0);
+                    loss += weight * td_error * td_error;
+                }
+            }
+            add_scalar(device, device.logger, "critic_loss", loss * loss_weight / (SEQUENCE_LENGTH * BATCH_SIZE), 1000);
+            add_scalar(device, device.logger, "critic_value", get(device, critic_output, 0, 0, 0), 1000);
+        }
+        backward(device, critic, batch.observations_and_actions, training_buffers.d_output, critic_buffers, reset_mode);
+        step(device, optimizer, critic);
+    }
+    template <typename DEVICE, typename SPEC, typename CRITIC_TYPE, typename BATCH_SPEC, typename OPTIMIZER, typename ACTOR_BUFFERS, typename CRITIC_BUFFERS, typename TRAINING_BUFFERS_SPEC, typename RNG>
+    void train_critic(DEVICE& device, const rl::algorithms::td3::ActorCritic<SPEC>& actor_critic, CRITIC_TYPE& critic, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, OPTIMIZER& optimizer, ACTOR_BUFFERS& actor_buffers, CRITIC_BUFFERS& critic_buffers, rl::algorithms::td3::CriticTrainingBuffers<TRAINING_BUFFERS_SPEC>& training_buffers, RNG& rng) {
+        // requires training_buffers.target_next_action_noise to be populated
+        critic_targets(device, actor_critic, batch, actor_buffers, critic_buffers, training_buffers, rng);
+        train_critic_on_targets(device, actor_critic, critic, batch, optimizer, critic_buffers, training_buffers, rng);
+    }
+    template <typename DEVICE, typename SPEC, typename CRITIC_TYPE, typename BATCH_SPEC, typename OPTIMIZER, typename ACTOR_BUFFERS, typename CRITIC_BUFFERS, typename TRAINING_BUFFERS_SPEC, typename WEIGHTS_SPEC, typename TD_ERRORS_SPEC, typename RNG>
+    void train_critic(DEVICE& device, const rl::algorithms::td3::ActorCritic<SPEC>& actor_critic, CRITIC_TYPE& critic, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, OPTIMIZER& optimizer, ACTOR_BUFFERS& actor_buffers, CRITIC_BUFFERS& critic_buffers, rl::algorithms::td3::CriticTrainingBuffers<TRAINING_BUFFERS_SPEC>& training_buffers, const Tensor<WEIGHTS_SPEC>& importance_weights, Tensor<TD_ERRORS_SPEC>& td_errors, RNG& rng) {
+        // requires training_buffers.target_next_action_noise to be populated
+        critic_targets(device, actor_critic, batch, actor_buffers, critic_buffers, training_buffers, rng);
+        train_critic_on_targets(device, actor_critic, critic, batch, optimizer, critic_buffers, training_buffers, importance_weights, td_errors, rng);
+    }
     template <typename DEVICE, typename SPEC, typename BATCH_SPEC, typename OPTIMIZER, typename ACTOR_BUFFERS, typename CRITIC_BUFFERS, typename TRAINING_BUFFER_SPEC, typename RNG>
     void train_actor(DEVICE& device, rl::algorithms::td3::ActorCritic<SPEC>& actor_critic, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, OPTIMIZER& optimizer, ACTOR_BUFFERS& actor_buffers, CRITIC_BUFFERS& critic_buffers, rl::algorithms::td3::ActorTrainingBuffers<TRAINING_BUFFER_SPEC>& training_buffers, RNG& rng) {
         using T = typename SPEC::T;
@@ -17,9 +17,12 @@
 
 RL_TOOLS_NAMESPACE_WRAPPER_START
 namespace rl_tools::rl::components::off_policy_runner {
-    template <typename TI, TI T_NUM_THREADS>
+    // T_PERSISTENT_THREAD_POOL: dispatch the per-environment work to the device's persistent thread pool (default).
+    // If false, threads are spawned and joined on every prologue/epilogue (legacy behaviour, kept for benchmarking).
+    template <typename TI, TI T_NUM_THREADS, bool T_PERSISTENT_THREAD_POOL = true>
     struct ExecutionHints{
         static constexpr TI NUM_THREADS = T_NUM_THREADS;
+        static constexpr bool PERSISTENT_THREAD_POOL = T_PERSISTENT_THREAD_POOL;
     };
     template <typename T_T, typename T_TI>
     struct ParametersDefault{
@@ -32,6 +35,8 @@ namespace rl_tools::rl::components::off_policy_runner {
         static constexpr bool COLLECT_EPISODE_STATS = false;
         static constexpr TI EPISODE_STATS_BUFFER_SIZE = 0;
         static constexpr bool SAMPLE_PARAMETERS = true;
+        // Store each observation once in the replay buffers (see replay_buffer::Specification)
+        static constexpr bool DEDUPLICATE_OBSERVATIONS = false;
 
         static constexpr T EXPLORATION_NOISE = 0.1;
     };
@@ -190,7 +195,7 @@ namespace rl_tools::rl::components{
             using CONTENT = typename INPUT::template State<SPEC::DYNAMIC_ALLOCATION>;
         };
         using POLICY_STATES = rl_tools::utils::MapTuple<POLICIES, GET_STATE>;
-        using REPLAY_BUFFER_SPEC = replay_buffer::Specification<typename SPEC::T, typename SPEC::TI, SPEC::ENVIRONMENT::Observation::DIM, ENVIRONMENT::ObservationPrivileged::DIM, SPEC::PARAMETERS::ASYMMETRIC_OBSERVATIONS, SPEC::ENVIRONMENT::ACTION_DIM, SPEC::PARAMETERS::REPLAY_BUFFER_CAPACITY, SPEC::DYNAMIC_ALLOCATION>;
+        using REPLAY_BUFFER_SPEC = replay_buffer::Specification<typename SPEC::T, typename SPEC::TI, SPEC::ENVIRONMENT::Observation::DIM, ENVIRONMENT::ObservationPrivileged::DIM, SPEC::PARAMETERS::ASYMMETRIC_OBSERVATIONS, SPEC::ENVIRONMENT::ACTION_DIM, SPEC::PARAMETERS::REPLAY_BUFFER_CAPACITY, SPEC::DYNAMIC_ALLOCATION, typename SPEC::T, SPEC::PARAMETERS::DEDUPLICATE_OBSERVATIONS>;
         using REPLAY_BUFFER_WITH_STATES_SPEC = replay_buffer::SpecificationWithStates<ENVIRONMENT, REPLAY_BUFFER_SPEC>;
         using REPLAY_BUFFER_TYPE = ReplayBufferWithStates<REPLAY_BUFFER_WITH_STATES_SPEC>;
         static constexpr TI N_ENVIRONMENTS = SPEC::PARAMETERS::N_ENVIRONMENTS;
@@ -4,36 +4,72 @@
 #define RL_TOOLS_RL_COMPONENTS_OFF_POLICY_RUNNER_OPERATIONS_CPU_H
 
 #include <thread>
+#include <vector>
 
+#include "../../../devices/cpu_thread_pool.h"
 #include "operations_generic_per_env.h"
 RL_TOOLS_NAMESPACE_WRAPPER_START
 namespace rl_tools::rl::components::off_policy_runner{
     constexpr auto get_num_threads(devices::ExecutionHints hints) {
         return 1;
     }
-    template<typename TI, TI NUM_THREADS>
-    constexpr TI get_num_threads(rl::components::off_policy_runner::ExecutionHints<TI, NUM_THREADS> hints) {
+    template<typename TI, TI NUM_THREADS, bool PERSISTENT_THREAD_POOL>
+    constexpr TI get_num_threads(rl::components::off_policy_runner::ExecutionHints<TI, NUM_THREADS, PERSISTENT_THREAD_POOL> hints) {
         return NUM_THREADS;
     }
+    constexpr bool use_thread_pool(devices::ExecutionHints hints) {
+        return false;
+    }
+    template<typename TI, TI NUM_THREADS, bool PERSISTENT_THREAD_POOL>
+    constexpr bool use_thread_pool(rl::components::off_policy_runner::ExecutionHints<TI, NUM_THREADS, PERSISTENT_THREAD_POOL> hints) {
+        return PERSISTENT_THREAD_POOL;
+    }
+
+    // One RNG stream per environment, seeded once from the runner's rng and kept by the device so the streams continue
+    // across steps and pool resizes (and results don't depend on how environments are distributed over threads)
+    template<typename DEV_SPEC, typename SPEC, typename RNG>
+    RNG* per_env_rngs(devices::CPU<DEV_SPEC>& device, rl::components::OffPolicyRunner<SPEC>& runner, RNG& rng) {
+        using TI = typename devices::CPU<DEV_SPEC>::index_t;
+        constexpr TI N_ENVIRONMENTS = SPEC::PARAMETERS::N_ENVIRONMENTS;
+        bool created;
+        RNG* rngs = persistent_state<RNG>(device, &runner, N_ENVIRONMENTS, created);
+        if(created){
+            auto base = random::uniform_int_distribution(typename DEV_SPEC::RANDOM(), 0, 1000000, rng);
+            for (TI env_i = 0; env_i < N_ENVIRONMENTS; env_i++) {
+                rngs[env_i] = rl_tools::random::default_engine(typename DEV_SPEC::RANDOM(), base + env_i);
+            }
+        }
+        return rngs;
+    }
 
     template<typename DEV_SPEC, typename SPEC, typename RNG>
     void prologue(devices::CPU<DEV_SPEC>& device, rl::components::OffPolicyRunner<SPEC>& runner, RNG &rng) {
         using DEVICE = devices::CPU<DEV_SPEC>;
         using TI = typename DEVICE::index_t;
-        std::vector<std::thread> threads;
-
+        constexpr TI N_ENVIRONMENTS = SPEC::PARAMETERS::N_ENVIRONMENTS;
         constexpr TI NUM_THREADS = get_num_threads(typename DEVICE::EXECUTION_HINTS());
 
-        if(NUM_THREADS > 1){
-            RNG rngs[SPEC::PARAMETERS::N_ENVIRONMENTS];
+        if constexpr(NUM_THREADS > 1 && use_thread_pool(typename DEVICE::EXECUTION_HINTS())){
+            auto& pool = thread_pool(device, NUM_THREADS);
+            RNG* rngs = per_env_rngs(device, runner, rng);
+            auto job = [&device, &runner, rngs](TI thread_i){
+                for (TI env_i = thread_i; env_i < N_ENVIRONMENTS; env_i += NUM_THREADS) {
+                    prologue_per_env(device, runner, rngs[env_i], env_i);
+                }
+            };
+            pool.run(job);
+        }
+        else if constexpr(NUM_THREADS > 1){
+            std::vector<std::thread> threads;
+            std::vector<RNG> rngs(N_ENVIRONMENTS);
             auto base = random::uniform_int_distribution(typename DEV_SPEC::RANDOM(), 0, 1000000, rng);
-            for (TI env_i = 0; env_i < SPEC::PARAMETERS::N_ENVIRONMENTS; env_i++) {
+            for (TI env_i = 0; env_i < N_ENVIRONMENTS; env_i++) {
                 rngs[env_i] = rl_tools::random::default_engine(typename DEV_SPEC::RANDOM(), base + env_i);
             }
 
             for (TI thread_i = 0; thread_i < NUM_THREADS; thread_i++) {
-                threads.emplace_back([NUM_THREADS, &device, thread_i, &runner, &rngs](){
-                    for (TI env_i = thread_i; env_i < SPEC::PARAMETERS::N_ENVIRONMENTS; env_i += NUM_THREADS) {
+                threads.emplace_back([&device, thread_i, &runner, &rngs](){
+                    for (TI env_i = thread_i; env_i < N_ENVIRONMENTS; env_i += NUM_THREADS) {
                         prologue_per_env(device, runner, rngs[env_i], env_i);
                     }
                 });
@@ -44,32 +80,41 @@ namespace rl_tools::rl::components::off_policy_runner{
             }
         }
         else{
-            for (TI env_i = 0; env_i < SPEC::PARAMETERS::N_ENVIRONMENTS; env_i++) {
+            for (TI env_i = 0; env_i < N_ENVIRONMENTS; env_i++) {
                 prologue_per_env(device, runner, rng, env_i);
             }
         }
-
     }
 
-    template<typename DEV_SPEC, typename SPEC, typename RNG>
-    void epilogue(devices::CPU<DEV_SPEC>& device, rl::components::OffPolicyRunner<SPEC>& runner, RNG &rng) {
+    template<typename DEV_SPEC, typename SPEC, typename POLICY, typename RNG>
+    void epilogue(devices::CPU<DEV_SPEC>& device, rl::components::OffPolicyRunner<SPEC>& runner, const POLICY& policy, RNG &rng) {
         using DEVICE = devices::CPU<DEV_SPEC>;
         using TI = typename DEVICE::index_t;
-        std::vector<std::thread> threads;
-
+        constexpr TI N_ENVIRONMENTS = SPEC::PARAMETERS::N_ENVIRONMENTS;
         constexpr TI NUM_THREADS = get_num_threads(typename DEVICE::EXECUTION_HINTS());
 
-        if(NUM_THREADS > 1){
-            RNG rngs[SPEC::N_ENVIRONMENTS];
+        if constexpr(NUM_THREADS > 1 && use_thread_pool(typename DEVICE::EXECUTION_HINTS())){
+            auto& pool = thread_pool(device, NUM_THREADS);
+            RNG* rngs = per_env_rngs(device, runner, rng);
+            auto job = [&device, &runner, &policy, rngs](TI thread_i){
+                for (TI env_i = thread_i; env_i < N_ENVIRONMENTS; env_i += NUM_THREADS) {
+                    epilogue_per_env(device, runner, policy, rngs[env_i], env_i);
+                }
+            };
+            pool.run(job);
+        }
+        else if constexpr(NUM_THREADS > 1){
+            std::vector<std::thread> threads;
+            std::vector<RNG> rngs(N_ENVIRONMENTS);
             auto base = random::uniform_int_distribution(typename DEV_SPEC::RANDOM(), 0, 1000000, rng);
-            for (TI env_i = 0; env_i < SPEC::N_ENVIRONMENTS; env_i++) {
+            for (TI env_i = 0; env_i < N_ENVIRONMENTS; env_i++) {
                 rngs[env_i] = rl_tools::random::default_engine(typename DEV_SPEC::RANDOM(), base + env_i);
             }
 
             for (TI thread_i = 0; thread_i < NUM_THREADS; thread_i++) {
-                threads.emplace_back([NUM_THREADS, &device, thread_i, &runner, &rngs](){
-                    for (TI env_i = thread_i; env_i < SPEC::N_ENVIRONMENTS; env_i += NUM_THREADS) {
-                        epilogue_per_env(device, runner, rngs[env_i], env_i);
+                threads.emplace_back([&device, thread_i, &runner, &policy, &rngs](){
+                    for (TI env_i = thread_i; env_i < N_ENVIRONMENTS; env_i += NUM_THREADS) {
+                        epilogue_per_env(device, runner, policy, rngs[env_i], env_i);
                     }
                 });
             }
@@ -79,11 +124,10 @@ namespace rl_tools::rl::components::off_policy_runner{
             }
         }
         else{
-            for (TI env_i = 0; env_i < SPEC::N_ENVIRONMENTS; env_i++) {
-                epilogue_per_env(device, runner, rng, env_i);
+            for (TI env_i = 0; env_i < N_ENVIRONMENTS; env_i++) {
+                epilogue_per_env(device, runner, policy, rng, env_i);
             }
         }
-
     }
 }
 RL_TOOLS_NAMESPACE_WRAPPER_END
@@ -131,6 +131,7 @@ namespace rl_tools{
         free(device, runner.replay_buffers);
         free(device, runner.episode_stats);
         free(device, runner.policy_states);
+        release_persistent_state(device, &runner);
     }
     template <typename DEVICE, typename SPEC>
     void free(DEVICE& device, rl::components::off_policy_runner::Batch<SPEC>& batch){
@@ -261,7 +262,10 @@ namespace rl_tools{
         utils::assert_exit(device, replay_buffer.position > 0 || replay_buffer.full, "Replay buffer is empty");
 #endif
         typename DEVICE::index_t sample_index_max = (replay_buffer.full ? SPEC::CAPACITY : replay_buffer.position) - 1;
-        typename DEVICE::index_t sample_index = DETERMINISTIC ? batch_step_i : random::uniform_int_distribution( typename DEVICE::SPEC::RANDOM(), (typename DEVICE::index_t) 0, sample_index_max, rng);
+        typename DEVICE::index_t sample_index;
+        do{
+            sample_index = DETERMINISTIC ? batch_step_i : random::uniform_int_distribution( typename DEVICE::SPEC::RANDOM(), (typename DEVICE::index_t) 0, sample_index_max, rng);
+        } while(!DETERMINISTIC && !rl::components::replay_buffer::sampleable(device, replay_buffer, sample_index));
 
         auto observation_target = row(device, batch.observations, batch_step_i);
         auto observation_source = row(device, replay_buffer.observations, sample_index);
@@ -331,7 +335,9 @@ namespace rl_tools{
         bool previous_step_truncated = true;
         for(typename DEVICE::index_t seq_step_i=0; seq_step_i < SEQUENCE_LENGTH; seq_step_i++) {
             if(previous_step_truncated){
-                sample_index = DETERMINISTIC ? batch_step_i : random::uniform_int_distribution(device.random, (TI) 0, sample_index_max, rng);
+                do{
+                    sample_index = DETERMINISTIC ? batch_step_i : random::uniform_int_distribution(device.random, (TI) 0, sample_index_max, rng);
+                } while(!DETERMINISTIC && !rl::components::replay_buffer::sampleable(device, replay_buffer, sample_index));
             }
 
             auto observation_target_sequence = view<0>(device, batch.observations, seq_step_i);
@@ -399,7 +405,7 @@ namespace rl_tools{
             set(device, batch.truncated, truncated, seq_step_i, batch_step_i, 0);
             sample_index = sample_index + 1;
             sample_index = sample_index % (replay_buffer.full ? SPEC::CAPACITY : replay_buffer.position);
-            previous_step_truncated = truncated || sample_index == 0;
+            previous_step_truncated = truncated || sample_index == 0 || !rl::components::replay_buffer::sampleable(device, replay_buffer, sample_index);
             if constexpr(RANDOM_SEQ_LENGTH) {
                 if (current_seq_step == current_seq_length - 1) {
                     if(SEQUENCE_LENGTH > 1){
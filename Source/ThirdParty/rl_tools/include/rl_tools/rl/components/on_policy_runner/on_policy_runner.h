@@ -63,9 +63,11 @@ namespace rl_tools::rl::components{
             DATA_VIEW<1> advantages;
             DATA_VIEW<1> target_values;
         };
-        template <typename TI, TI T_NUM_THREADS>
+        // T_PERSISTENT_THREAD_POOL: see off_policy_runner::ExecutionHints
+        template <typename TI, TI T_NUM_THREADS, bool T_PERSISTENT_THREAD_POOL = true>
         struct ExecutionHints{
             static constexpr TI NUM_THREADS = T_NUM_THREADS;
+            static constexpr bool PERSISTENT_THREAD_POOL = T_PERSISTENT_THREAD_POOL;
         };
     }
 
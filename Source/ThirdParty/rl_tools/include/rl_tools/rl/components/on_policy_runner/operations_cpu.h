@@ -1,15 +1,29 @@
+#include "../../../version.h"
+#if (defined(RL_TOOLS_DISABLE_INCLUDE_GUARDS) || !defined(RL_TOOLS_RL_COMPONENTS_ON_POLICY_RUNNER_OPERATIONS_CPU_H)) && (RL_TOOLS_USE_THIS_VERSION == 1)
+#pragma once
+#define RL_TOOLS_RL_COMPONENTS_ON_POLICY_RUNNER_OPERATIONS_CPU_H
+
 #include "on_policy_runner.h"
 #include "operations_generic_per_env.h"
+#include "../../../devices/cpu_thread_pool.h"
 #include <thread>
+#include <vector>
 RL_TOOLS_NAMESPACE_WRAPPER_START
 namespace rl_tools::rl::components::on_policy_runner{
     constexpr auto get_num_threads(devices::ExecutionHints hints) {
         return 1;
     }
-    template<typename TI, TI NUM_THREADS>
-    constexpr TI get_num_threads(rl::components::on_policy_runner::ExecutionHints<TI, NUM_THREADS> hints) {
+    template<typename TI, TI NUM_THREADS, bool PERSISTENT_THREAD_POOL>
+    constexpr TI get_num_threads(rl::components::on_policy_runner::ExecutionHints<TI, NUM_THREADS, PERSISTENT_THREAD_POOL> hints) {
         return NUM_THREADS;
     }
+    constexpr bool use_thread_pool(devices::ExecutionHints hints) {
+        return false;
+    }
+    template<typename TI, TI NUM_THREADS, bool PERSISTENT_THREAD_POOL>
+    constexpr bool use_thread_pool(rl::components::on_policy_runner::ExecutionHints<TI, NUM_THREADS, PERSISTENT_THREAD_POOL> hints) {
+        return PERSISTENT_THREAD_POOL;
+    }
     template <typename DEV_SPEC, typename OBSERVATIONS_PRIVILEGED_SPEC, typename OBSERVATIONS_SPEC, typename SPEC, typename RNG> // todo: make this not PPO but general policy with output distribution
     void prologue(devices::CPU<DEV_SPEC>& device, Matrix<OBSERVATIONS_PRIVILEGED_SPEC>& observations_privileged, Matrix<OBSERVATIONS_SPEC>& observations, rl::components::OnPolicyRunner<SPEC>& runner, RNG& rng, const typename devices::CPU<DEV_SPEC>::index_t step_i){
         static_assert(OBSERVATIONS_SPEC::ROWS == SPEC::N_ENVIRONMENTS);
@@ -30,13 +44,32 @@ namespace rl_tools::rl::components::on_policy_runner{
         using TI = typename DEVICE::index_t;
 
         constexpr TI NUM_THREADS = get_num_threads(typename DEVICE::EXECUTION_HINTS());
-        std::vector<std::thread> threads;
 
-        if(NUM_THREADS > 1){
+        if constexpr(NUM_THREADS > 1 && use_thread_pool(typename DEVICE::EXECUTION_HINTS())){
+            auto& pool = thread_pool(device, NUM_THREADS);
+            // per-env RNG streams persist across steps instead of being re-seeded every epilogue
+            bool created;
+            RNG* rngs = persistent_state<RNG>(device, &runner, SPEC::N_ENVIRONMENTS, created);
+            if(created){
+                auto base = random::uniform_int_distribution(typename DEV_SPEC::RANDOM(), 0, 1000000, rng);
+                for (TI env_i = 0; env_i < SPEC::N_ENVIRONMENTS; env_i++) {
+                    rngs[env_i] = rl_tools::random::default_engine(typename DEV_SPEC::RANDOM(), base + env_i);
+                }
+            }
+            auto job = [&device, &dataset, &runner, &actions_mean, &actions, &action_log_std, step_i, rngs](TI thread_i){
+                for (TI env_i = thread_i; env_i < SPEC::N_ENVIRONMENTS; env_i += NUM_THREADS) {
+                    TI pos = step_i * SPEC::N_ENVIRONMENTS + env_i;
+                    per_env::epilogue(device, dataset, runner, actions_mean, actions, action_log_std, rngs[env_i], pos, env_i);
+                }
+            };
+            pool.run(job);
+        }
+        else if constexpr(NUM_THREADS > 1){
+            std::vector<std::thread> threads;
             auto base = random::uniform_int_distribution(typename DEV_SPEC::RANDOM(), 0, 1000000, rng);
 
             for (TI thread_i = 0; thread_i < NUM_THREADS; thread_i++) {
-                threads.emplace_back([NUM_THREADS, &device, thread_i, &dataset, &runner, &actions_mean, &actions, &action_log_std, &step_i, &base](){
+                threads.emplace_back([&device, thread_i, &dataset, &runner, &actions_mean, &actions, &action_log_std, &step_i, &base](){
                     for (TI env_i = thread_i; env_i < SPEC::N_ENVIRONMENTS; env_i += NUM_THREADS) {
                         auto rng = rl_tools::random::default_engine(typename DEV_SPEC::RANDOM(), base + env_i);
                         TI pos = step_i * SPEC::N_ENVIRONMENTS + env_i;
@@ -61,3 +94,5 @@ RL_TOOLS_NAMESPACE_WRAPPER_END
 #ifndef RL_TOOLS_RL_COMPONENTS_ON_POLICY_RUNNER_OPERATIONS_CPU_DELAY_OPERATIONS_GENERIC_INCLUDE
 #include "operations_generic.h"
 #endif
+
+#endif
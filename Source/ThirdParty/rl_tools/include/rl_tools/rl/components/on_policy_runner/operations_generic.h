@@ -60,6 +60,7 @@ namespace rl_tools{
         free(device, runner.episode_step);
         free(device, runner.episode_return);
         free(device, runner.truncated);
+        release_persistent_state(device, &runner);
     }
     template <typename DEVICE, typename SPEC, typename RNG>
     void init(DEVICE& device, rl::components::OnPolicyRunner<SPEC>& runner, typename SPEC::ENVIRONMENT environments[SPEC::N_ENVIRONMENTS], typename SPEC::ENVIRONMENT::Parameters parameters[SPEC::N_ENVIRONMENTS], RNG& rng){
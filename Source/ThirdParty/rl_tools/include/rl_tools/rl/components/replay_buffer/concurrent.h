@@ -0,0 +1,32 @@
+#include "../../../version.h"
+#if (defined(RL_TOOLS_DISABLE_INCLUDE_GUARDS) || !defined(RL_TOOLS_RL_COMPONENTS_REPLAY_BUFFER_CONCURRENT_H)) && (RL_TOOLS_USE_THIS_VERSION == 1)
+#pragma once
+#define RL_TOOLS_RL_COMPONENTS_REPLAY_BUFFER_CONCURRENT_H
+
+#include "replay_buffer.h"
+
+#include <atomic>
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::rl::components {
+    // Multi-writer variant of ReplayBuffer for the CPU (operations in operations_cpu.h). The rows and views are the
+    // ReplayBuffer's, so the DATA_COLS layout is unchanged. Writers reserve a slot with a fetch-add on next_ticket
+    // (ticket t goes to row t % CAPACITY, lap t / CAPACITY) and publish it through the row's sequence number:
+    // 2 * lap + 1 while the row is being written, 2 * lap + 2 once it is complete, 0 if it was never written.
+    // Readers treat a row as a seqlock: they only keep a copy if the sequence was even and unchanged around it.
+    // position and full of the base are not maintained; use size() for the reserved rows and published_size() for the
+    // rows a reader can get.
+    template <typename T_SPEC>
+    struct ConcurrentReplayBuffer: ReplayBuffer<T_SPEC> {
+        using SPEC = T_SPEC;
+        using TI = typename SPEC::TI;
+        static_assert(!SPEC::DEDUPLICATE_OBSERVATIONS, "Interleaved writers cannot share observations between consecutive rows");
+        std::atomic<TI> next_ticket{0};
+        std::atomic<TI>* sequence = nullptr;
+        // Rows published at least once, counted by the commits of the first lap and saturating at CAPACITY
+        std::atomic<TI> published_rows{0};
+    };
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+#endif
@@ -4,6 +4,333 @@
 #define RL_TOOLS_RL_COMPONENTS_REPLAY_BUFFER_OPERATIONS_CPU_H
 
 #include "replay_buffer.h"
+#include "concurrent.h"
+#include "../off_policy_runner/off_policy_runner.h"
 #include "operations_generic.h"
+#include "../../../devices/cpu_simd.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools {
+    template <typename DEV_SPEC, typename SPEC>
+    void malloc(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& rb) {
+        using TI = typename SPEC::TI;
+        malloc(device, static_cast<rl::components::ReplayBuffer<SPEC>&>(rb));
+        // The sequence numbers are only ever stored and loaded, so arena memory needs no construction (init stores 0)
+        static_assert(std::is_trivially_destructible_v<std::atomic<TI>>);
+        void* arena_pointer = arena_allocate(device, (size_t)(SPEC::CAPACITY * sizeof(std::atomic<TI>)), (size_t)64);
+        rb.sequence = arena_pointer != nullptr ? static_cast<std::atomic<TI>*>(arena_pointer) : new std::atomic<TI>[SPEC::CAPACITY];
+    }
+    template <typename DEV_SPEC, typename SPEC>
+    void free(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& rb) {
+        free(device, static_cast<rl::components::ReplayBuffer<SPEC>&>(rb));
+        if(!arena_owns(device, rb.sequence)){
+            delete[] rb.sequence;
+        }
+        rb.sequence = nullptr;
+    }
+    // Not thread-safe: no writer or reader may be active
+    template <typename DEV_SPEC, typename SPEC>
+    void init(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& rb) {
+        using TI = typename SPEC::TI;
+        init(device, static_cast<rl::components::ReplayBuffer<SPEC>&>(rb));
+        for(TI row_i = 0; row_i < SPEC::CAPACITY; row_i++){
+            rb.sequence[row_i].store(0, std::memory_order_relaxed);
+        }
+        rb.published_rows.store(0, std::memory_order_relaxed);
+        rb.next_ticket.store(0, std::memory_order_release);
+    }
+    // Rows that have been reserved so far, saturating at the capacity. A reserved row may still be in flight; readers
+    // skip it until it is published.
+    template <typename DEV_SPEC, typename SPEC>
+    typename SPEC::TI size(const devices::CPU<DEV_SPEC>& device, const rl::components::ConcurrentReplayBuffer<SPEC>& rb) {
+        using TI = typename SPEC::TI;
+        TI reserved = rb.next_ticket.load(std::memory_order_acquire);
+        return reserved < SPEC::CAPACITY ? reserved : SPEC::CAPACITY;
+    }
+    // Rows that have been published at least once, saturating at the capacity. Unlike size() this does not count rows
+    // still in flight, so gate sampling on it. Once the buffer has wrapped, the rows being rewritten are counted but
+    // rejected by gather_row until they are published again.
+    template <typename DEV_SPEC, typename SPEC>
+    typename SPEC::TI published_size(const devices::CPU<DEV_SPEC>& device, const rl::components::ConcurrentReplayBuffer<SPEC>& rb) {
+        return rb.published_rows.load(std::memory_order_acquire);
+    }
+    // Reserves the next row and marks it as being written. Returns the ticket; the row is ticket % CAPACITY. The row's
+    // views (rb.observations etc.) may be written freely until the ticket is handed to add_commit.
+    template <typename DEV_SPEC, typename SPEC>
+    typename SPEC::TI add_begin(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& rb) {
+        using TI = typename SPEC::TI;
+        const TI ticket = rb.next_ticket.fetch_add(1, std::memory_order_relaxed);
+        const TI lap = ticket / SPEC::CAPACITY;
+        std::atomic<TI>& sequence = rb.sequence[ticket % SPEC::CAPACITY];
+        // Only a writer that is a whole lap ahead can get here before the row's previous writer has published
+        while(sequence.load(std::memory_order_acquire) != 2 * lap){
+            std::this_thread::yield();
+        }
+        sequence.store(2 * lap + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return ticket;
+    }
+    template <typename DEV_SPEC, typename SPEC>
+    void add_commit(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& rb, typename SPEC::TI ticket) {
+        rb.sequence[ticket % SPEC::CAPACITY].store(2 * (ticket / SPEC::CAPACITY) + 2, std::memory_order_release);
+        if(ticket < SPEC::CAPACITY){
+            rb.published_rows.fetch_add(1, std::memory_order_release);
+        }
+    }
+    template <typename DEV_SPEC, typename SPEC, typename OBSERVATION_SPEC, typename OBSERVATION_PRIVILEGED_SPEC, typename ACTION_SPEC, typename NEXT_OBSERVATION_SPEC, typename NEXT_OBSERVATION_PRIVILEGED_SPEC>
+    void add(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& buffer, const Matrix<OBSERVATION_SPEC>& observation, const Matrix<OBSERVATION_PRIVILEGED_SPEC>& observation_privileged, const Matrix<ACTION_SPEC>& action, const typename SPEC::T reward, const Matrix<NEXT_OBSERVATION_SPEC>& next_observation, const Matrix<NEXT_OBSERVATION_PRIVILEGED_SPEC>& next_observation_privileged, const bool terminated, const bool truncated) {
+        using TI = typename SPEC::TI;
+        const TI ticket = add_begin(device, buffer);
+        const TI position = ticket % SPEC::CAPACITY;
+        for(TI i = 0; i < SPEC::OBSERVATION_DIM; i++) {
+            set(buffer.observations, position, i, get(observation, 0, i));
+            set(buffer.next_observations, position, i, get(next_observation, 0, i));
+        }
+        for(TI i = 0; i < SPEC::OBSERVATION_DIM_PRIVILEGED; i++) {
+            set(buffer.observations_privileged, position, i, get(observation_privileged, 0, i));
+            set(buffer.next_observations_privileged, position, i, get(next_observation_privileged, 0, i));
+        }
+        for(TI i = 0; i < SPEC::ACTION_DIM; i++) {
+            set(buffer.actions, position, i, get(action, 0, i));
+        }
+        set(buffer.rewards, position, 0, reward);
+        set(buffer.terminated, position, 0, terminated);
+        set(buffer.truncated, position, 0, truncated);
+        add_commit(device, buffer, ticket);
+    }
+    // Rebuilds next_ticket from the sequence numbers of rows that outlived their writers, e.g. after rebinding
+    // rb.data and rb.sequence to a memory-mapped file written by a process that exited or crashed. Rows whose write was
+    // interrupted (or never started although a later ticket was taken) are replaced by a copy of a published row and
+    // given the sequence number their next writer waits for, so they can neither be read torn nor stall add_begin.
+    // Not thread-safe: no writer or reader may be active.
+    template <typename DEV_SPEC, typename SPEC>
+    void recover(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& rb) {
+        using TI = typename SPEC::TI;
+        TI next_ticket = 0;
+        TI published_row = SPEC::CAPACITY;
+        for(TI row_i = 0; row_i < SPEC::CAPACITY; row_i++){
+            const TI sequence = rb.sequence[row_i].load(std::memory_order_relaxed);
+            if(sequence == 0){
+                continue;
+            }
+            const TI ticket = (sequence - 1) / 2 * SPEC::CAPACITY + row_i;
+            next_ticket = ticket + 1 > next_ticket ? ticket + 1 : next_ticket;
+            if(sequence % 2 == 0){
+                published_row = row_i;
+            }
+        }
+        if(published_row == SPEC::CAPACITY){
+            // Nothing was ever completed
+            init(device, rb);
+            return;
+        }
+        auto source = row(device, rb.data, published_row);
+        for(TI row_i = 0; row_i < SPEC::CAPACITY; row_i++){
+            // Lap of the first ticket >= next_ticket that maps to this row
+            const TI next_lap = next_ticket / SPEC::CAPACITY + (row_i < next_ticket % SPEC::CAPACITY ? 1 : 0);
+            if(rb.sequence[row_i].load(std::memory_order_relaxed) != 2 * next_lap){
+                auto target = row(device, rb.data, row_i);
+                copy(device, device, source, target);
+                if constexpr(rl::components::ReplayBuffer<SPEC>::SEPARATE_SCALARS){
+                    auto source_scalars = row(device, rb.scalars, published_row);
+                    auto target_scalars = row(device, rb.scalars, row_i);
+                    copy(device, device, source_scalars, target_scalars);
+                }
+                rb.sequence[row_i].store(2 * next_lap, std::memory_order_relaxed);
+            }
+        }
+        // Every row below next_ticket is published now
+        rb.published_rows.store(next_ticket < SPEC::CAPACITY ? next_ticket : SPEC::CAPACITY, std::memory_order_relaxed);
+        rb.next_ticket.store(next_ticket, std::memory_order_release);
+    }
+    // True once the row reserved with ticket has been published (and possibly overwritten since)
+    template <typename DEV_SPEC, typename SPEC>
+    bool published(const devices::CPU<DEV_SPEC>& device, const rl::components::ConcurrentReplayBuffer<SPEC>& rb, typename SPEC::TI ticket) {
+        return rb.sequence[ticket % SPEC::CAPACITY].load(std::memory_order_acquire) >= 2 * (ticket / SPEC::CAPACITY) + 2;
+    }
+    namespace rl::components::replay_buffer{
+        // Draws a sample of the concurrent gather_batch functions may take before they give up on it
+        constexpr unsigned GATHER_MAX_ATTEMPTS = 64;
+        // Row row_i of a replay buffer column view into a dense batch vector, as one block copy. Storage narrower than
+        // the batch (e.g. numeric_types::bfloat16) is up-converted a SIMD vector at a time.
+        template <typename DEV_SPEC, typename SOURCE_SPEC, typename TARGET_SPEC>
+        void gather_columns(devices::CPU<DEV_SPEC>& device, Matrix<SOURCE_SPEC>& source, typename devices::CPU<DEV_SPEC>::index_t row_i, Tensor<TARGET_SPEC>& target){
+            static_assert(get<0>(typename TARGET_SPEC::STRIDE{}) == 1, "gather_columns copies into contiguous batch rows");
+            if constexpr(utils::typing::is_same_v<typename SOURCE_SPEC::T, typename TARGET_SPEC::T>){
+                std::memcpy(data(target), &get(source, row_i, 0), SOURCE_SPEC::COLS * sizeof(typename SOURCE_SPEC::T));
+            }
+            else{
+                devices::cpu::simd::widen(&get(source, row_i, 0), data(target), SOURCE_SPEC::COLS);
+            }
+        }
+        // Pulls everything gather_row reads for row_i towards the cache
+        template <typename DEV_SPEC, typename SPEC>
+        void prefetch_row(devices::CPU<DEV_SPEC>& device, const ConcurrentReplayBuffer<SPEC>& replay_buffer, typename devices::CPU<DEV_SPEC>::index_t row_i){
+            using BUFFER = ConcurrentReplayBuffer<SPEC>;
+            devices::cpu::simd::prefetch(&replay_buffer.sequence[row_i], sizeof(replay_buffer.sequence[row_i]));
+            devices::cpu::simd::prefetch(&get(replay_buffer.data, row_i, 0), BUFFER::DATA_COLS * sizeof(typename BUFFER::STORAGE_T));
+            if constexpr(BUFFER::SEPARATE_SCALARS){
+                devices::cpu::simd::prefetch(&get(replay_buffer.scalars, row_i, 0), BUFFER::SCALAR_COLS * sizeof(typename SPEC::T));
+            }
+        }
+    }
+    // Copies row sample_index into sample batch_step_i of a SEQUENCE_LENGTH == 1 batch (rows from concurrent writers are
+    // not contiguous trajectories). Returns false, leaving the sample partially written, if the row is unpublished or
+    // was overwritten during the copy; the caller then draws another row.
+    template <typename DEV_SPEC, typename SPEC, typename BATCH_SPEC>
+    bool gather_row(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& replay_buffer, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, typename devices::CPU<DEV_SPEC>::index_t batch_step_i, typename devices::CPU<DEV_SPEC>::index_t sample_index) {
+        using TI = typename devices::CPU<DEV_SPEC>::index_t;
+        using T = typename SPEC::T;
+        static_assert(BATCH_SPEC::SEQUENCE_LENGTH == 1, "ConcurrentReplayBuffer only supports SEQUENCE_LENGTH == 1");
+        constexpr TI seq_step_i = 0;
+
+        const TI sequence = replay_buffer.sequence[sample_index].load(std::memory_order_acquire);
+        if(sequence == 0 || sequence % 2 == 1){
+            return false;
+        }
+
+        auto observation_target_sequence = view<0>(device, batch.observations, seq_step_i);
+        auto observation_target = view<0>(device, observation_target_sequence, batch_step_i);
+        rl::components::replay_buffer::gather_columns(device, replay_buffer.observations, sample_index, observation_target);
+        if constexpr(SPEC::ASYMMETRIC_OBSERVATIONS){
+            auto observation_privileged_target_sequence = view<0>(device, batch.observations_privileged, seq_step_i);
+            auto observation_privileged_target = view<0>(device, observation_privileged_target_sequence, batch_step_i);
+            rl::components::replay_buffer::gather_columns(device, replay_buffer.observations_privileged, sample_index, observation_privileged_target);
+        }
+        auto action_target_sequence = view<0>(device, batch.actions, seq_step_i);
+        auto action_target = view<0>(device, action_target_sequence, batch_step_i);
+        rl::components::replay_buffer::gather_columns(device, replay_buffer.actions, sample_index, action_target);
+        auto next_observation_target_sequence = view<0>(device, batch.next_observations, seq_step_i);
+        auto next_observation_target = view<0>(device, next_observation_target_sequence, batch_step_i);
+        rl::components::replay_buffer::gather_columns(device, replay_buffer.next_observations, sample_index, next_observation_target);
+        if constexpr(SPEC::ASYMMETRIC_OBSERVATIONS){
+            auto next_observation_privileged_target_sequence = view<0>(device, batch.next_observations_privileged, seq_step_i);
+            auto next_observation_privileged_target = view<0>(device, next_observation_privileged_target_sequence, batch_step_i);
+            rl::components::replay_buffer::gather_columns(device, replay_buffer.next_observations_privileged, sample_index, next_observation_privileged_target);
+        }
+        const T reward = get(replay_buffer.rewards, sample_index, 0);
+        const bool terminated = get(replay_buffer.terminated, sample_index, 0);
+        const bool truncated = get(replay_buffer.truncated, sample_index, 0);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(replay_buffer.sequence[sample_index].load(std::memory_order_relaxed) != sequence){
+            return false;
+        }
+
+        set(device, batch.rewards, reward, seq_step_i, batch_step_i, 0);
+        set(device, batch.terminated, terminated, seq_step_i, batch_step_i, 0);
+        set(device, batch.truncated, truncated, seq_step_i, batch_step_i, 0);
+        // Every sample is a sequence of one step: it starts with a reset, ends the sequence, and its next action is
+        // filled in by the current actor
+        auto next_action_target_sequence = view<0>(device, batch.next_actions, seq_step_i);
+        auto next_action_target = view<0>(device, next_action_target_sequence, batch_step_i);
+        set_all(device, next_action_target, math::nan<T>(device.math));
+        set(device, batch.reset, true, seq_step_i, batch_step_i, 0);
+        set(device, batch.final_step_mask, true, seq_step_i, batch_step_i, 0);
+        return true;
+    }
+    // Counterpart of the ReplayBuffer gather_batch in off_policy_runner/operations_generic.h. Safe to run while writers
+    // insert: rows that gather_row rejects are replaced by another uniform draw. Returns false, leaving the sample
+    // partially written, if no draw lands on a published row within GATHER_MAX_ATTEMPTS; gate on published_size() so
+    // that this only happens when the buffer is mostly in flight.
+    template <typename DEV_SPEC, typename SPEC, typename BATCH_SPEC, typename RNG, bool DETERMINISTIC = false>
+    bool gather_batch(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& replay_buffer, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, typename devices::CPU<DEV_SPEC>::index_t batch_step_i, RNG& rng) {
+        using TI = typename devices::CPU<DEV_SPEC>::index_t;
+        const TI num_rows = size(device, replay_buffer);
+        if(num_rows == 0){
+            return false;
+        }
+        const TI sample_index_max = num_rows - 1;
+        for(TI attempt_i = 0; attempt_i < rl::components::replay_buffer::GATHER_MAX_ATTEMPTS; attempt_i++){
+            const TI sample_index = DETERMINISTIC ? (batch_step_i + attempt_i) % num_rows : random::uniform_int_distribution(device.random, (TI) 0, sample_index_max, rng);
+            if(gather_row(device, replay_buffer, batch, batch_step_i, sample_index)){
+                return true;
+            }
+        }
+        return false;
+    }
+    // Whole-batch counterpart: draws every row first and gathers them front to back, prefetching PREFETCH_DISTANCE rows
+    // ahead, so the misses of a buffer larger than the caches (or of a memory-mapped one) overlap instead of being taken
+    // one row at a time. The rows are ordered by a counting sort over BATCH_SIZE equal ranges of the filled part, which
+    // is linear in BATCH_SIZE. The samples are independent, so their order in the batch carries no information. Rows
+    // that gather_row rejects are redrawn one at a time; returns false if a redraw gives up (see above).
+    template <typename DEV_SPEC, typename SPEC, typename BATCH_SPEC, typename RNG>
+    bool gather_batch(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& replay_buffer, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, RNG& rng) {
+        using TI = typename devices::CPU<DEV_SPEC>::index_t;
+        constexpr TI BATCH_SIZE = BATCH_SPEC::BATCH_SIZE;
+        constexpr TI PREFETCH_DISTANCE = 4;
+        const TI sample_index_max = size(device, replay_buffer) - 1;
+        const TI bucket_size = sample_index_max / BATCH_SIZE + 1;
+        TI drawn_indices[BATCH_SIZE];
+        TI bucket_offsets[BATCH_SIZE + 1] = {};
+        for(TI batch_step_i = 0; batch_step_i < BATCH_SIZE; batch_step_i++){
+            drawn_indices[batch_step_i] = random::uniform_int_distribution(device.random, (TI) 0, sample_index_max, rng);
+            bucket_offsets[drawn_indices[batch_step_i] / bucket_size + 1]++;
+        }
+        for(TI bucket_i = 1; bucket_i <= BATCH_SIZE; bucket_i++){
+            bucket_offsets[bucket_i] += bucket_offsets[bucket_i - 1];
+        }
+        TI sample_indices[BATCH_SIZE];
+        for(TI batch_step_i = 0; batch_step_i < BATCH_SIZE; batch_step_i++){
+            sample_indices[bucket_offsets[drawn_indices[batch_step_i] / bucket_size]++] = drawn_indices[batch_step_i];
+        }
+        for(TI batch_step_i = 0; batch_step_i < PREFETCH_DISTANCE && batch_step_i < BATCH_SIZE; batch_step_i++){
+            rl::components::replay_buffer::prefetch_row(device, replay_buffer, sample_indices[batch_step_i]);
+        }
+        for(TI batch_step_i = 0; batch_step_i < BATCH_SIZE; batch_step_i++){
+            if(batch_step_i + PREFETCH_DISTANCE < BATCH_SIZE){
+                rl::components::replay_buffer::prefetch_row(device, replay_buffer, sample_indices[batch_step_i + PREFETCH_DISTANCE]);
+            }
+            if(!gather_row(device, replay_buffer, batch, batch_step_i, sample_indices[batch_step_i]) && !gather_batch(device, replay_buffer, batch, batch_step_i, rng)){
+                return false;
+            }
+        }
+        return true;
+    }
+    // Prioritized counterpart: fills the whole batch with rows drawn proportionally to their priority in tree, one per
+    // stratum of [0, total), so the descents visit the tree in order. indices receives the sampled rows (for
+    // update_priority) and importance_weights the bias correction (N * P(i))^-beta, normalized by the batch maximum.
+    // Only rows with a nonzero priority are drawn; the caller assigns them once they are published. A row being
+    // rewritten is redrawn from the same stratum; returns false if that gives up after GATHER_MAX_ATTEMPTS draws.
+    template <typename DEV_SPEC, typename SPEC, typename TREE_SPEC, typename BATCH_SPEC, typename INDICES_SPEC, typename WEIGHTS_SPEC, typename RNG>
+    bool gather_batch(devices::CPU<DEV_SPEC>& device, rl::components::ConcurrentReplayBuffer<SPEC>& replay_buffer, const rl::components::SumTree<TREE_SPEC>& tree, rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>& batch, Matrix<INDICES_SPEC>& indices, Tensor<WEIGHTS_SPEC>& importance_weights, typename SPEC::T beta, RNG& rng) {
+        using TI = typename devices::CPU<DEV_SPEC>::index_t;
+        using T = typename SPEC::T;
+        constexpr TI BATCH_SIZE = BATCH_SPEC::BATCH_SIZE;
+        static_assert(TREE_SPEC::CAPACITY == SPEC::CAPACITY);
+        static_assert(INDICES_SPEC::COLS == BATCH_SIZE);
+        const T total_priority = total(device, tree);
+        utils::assert_exit(device, total_priority > 0, "Prioritized gather_batch on an empty SumTree");
+        const T stratum = total_priority / BATCH_SIZE;
+        const T num_rows = size(device, replay_buffer);
+        T max_weight = 0;
+        for(TI batch_step_i = 0; batch_step_i < BATCH_SIZE; batch_step_i++){
+            TI sample_index;
+            TI attempt_i = 0;
+            do{
+                if(attempt_i++ == rl::components::replay_buffer::GATHER_MAX_ATTEMPTS){
+                    return false;
+                }
+                const T value = (batch_step_i + random::uniform_real_distribution(device.random, (T)0, (T)1, rng)) * stratum;
+                sample_index = sample(device, tree, value);
+            } while(!gather_row(device, replay_buffer, batch, batch_step_i, sample_index));
+            const T probability = get_priority(device, tree, sample_index) / total_priority;
+            const T weight = math::pow(device.math, num_rows * probability, -beta);
+            set(indices, 0, batch_step_i, sample_index);
+            set(device, importance_weights, weight, 0, batch_step_i, 0);
+            max_weight = math::max(device.math, max_weight, weight);
+        }
+        for(TI batch_step_i = 0; batch_step_i < BATCH_SIZE; batch_step_i++){
+            set(device, importance_weights, get(device, importance_weights, 0, batch_step_i, 0) / max_weight, 0, batch_step_i, 0);
+        }
+        return true;
+    }
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
 
 #endif
@@ -4,27 +4,147 @@
 #define RL_TOOLS_RL_COMPONENTS_REPLAY_BUFFER_OPERATIONS_GENERIC_H
 
 #include "replay_buffer.h"
+#include "prioritized.h"
 #include "../../../utils/generic/memcpy.h"
 
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::rl::components::replay_buffer {
+    // Whether row index holds a complete transition. With DEDUPLICATE_OBSERVATIONS the rows flagged in boundary only
+    // hold a final observation, and once the buffer is full the row at position has had its observation overwritten by
+    // the next observation of the newest transition. Every row below the fill level is a transition otherwise.
+    template <typename DEVICE, typename SPEC>
+    RL_TOOLS_FUNCTION_PLACEMENT bool sampleable(DEVICE& device, const ReplayBuffer<SPEC>& buffer, typename DEVICE::index_t index) {
+        if constexpr(ReplayBuffer<SPEC>::DEDUPLICATE_OBSERVATIONS){
+            return !get(buffer.boundary, index, 0) && !(buffer.full && index == buffer.position);
+        }
+        else{
+            return true;
+        }
+    }
+    // With DEDUPLICATE_OBSERVATIONS the row at position already holds the next observation of the previous transition.
+    // If the episode ended there (truncated) or the new observation is not that one (the environment was reset without
+    // truncated being set, e.g. on a policy switch) the previous transition is marked truncated and the row is kept as
+    // a boundary, so the transition goes to the next one. After the last row the extra row holds the next observation.
+    template <typename DEVICE, typename SPEC, typename OBSERVATION_SPEC, typename OBSERVATION_PRIVILEGED_SPEC>
+    RL_TOOLS_FUNCTION_PLACEMENT void begin_transition(DEVICE& device, ReplayBuffer<SPEC>& buffer, const Matrix<OBSERVATION_SPEC>& observation, const Matrix<OBSERVATION_PRIVILEGED_SPEC>& observation_privileged) {
+        using TI = typename DEVICE::index_t;
+        using STORAGE_T = typename SPEC::STORAGE_T;
+        if constexpr(ReplayBuffer<SPEC>::DEDUPLICATE_OBSERVATIONS){
+            if(buffer.position == 0 && !buffer.full){
+                return;
+            }
+            const TI previous = (buffer.position + SPEC::CAPACITY - 1) % SPEC::CAPACITY;
+            if(get(buffer.boundary, previous, 0)){
+                return;
+            }
+            bool continues = !get(buffer.truncated, previous, 0);
+            for(TI i = 0; continues && i < SPEC::OBSERVATION_DIM; i++){
+                continues = get(buffer.next_observations, previous, i) == (STORAGE_T)get(observation, 0, i);
+            }
+            if constexpr(SPEC::ASYMMETRIC_OBSERVATIONS){
+                for(TI i = 0; continues && i < SPEC::OBSERVATION_DIM_PRIVILEGED; i++){
+                    continues = get(buffer.next_observations_privileged, previous, i) == (STORAGE_T)get(observation_privileged, 0, i);
+                }
+            }
+            if(continues){
+                return;
+            }
+            set(buffer.truncated, previous, 0, true);
+            if(buffer.position == 0){
+                return;
+            }
+            set(buffer.boundary, buffer.position, 0, true);
+            set(buffer.rewards, buffer.position, 0, 0);
+            set(buffer.terminated, buffer.position, 0, false);
+            set(buffer.truncated, buffer.position, 0, true);
+            buffer.position = (buffer.position + 1) % SPEC::CAPACITY;
+            if(buffer.position == 0 && !buffer.full) {
+                buffer.full = true;
+            }
+        }
+    }
+    // Writes the transition to the row at position and advances it. With DEDUPLICATE_OBSERVATIONS the next observation
+    // lands in the observation columns of the following row.
+    template <typename DEVICE, typename SPEC, typename OBSERVATION_SPEC, typename OBSERVATION_PRIVILEGED_SPEC, typename ACTION_SPEC, typename NEXT_OBSERVATION_SPEC, typename NEXT_OBSERVATION_PRIVILEGED_SPEC>
+    RL_TOOLS_FUNCTION_PLACEMENT void write_transition(DEVICE& device, ReplayBuffer<SPEC>& buffer, const Matrix<OBSERVATION_SPEC>& observation, const Matrix<OBSERVATION_PRIVILEGED_SPEC>& observation_privileged, const Matrix<ACTION_SPEC>& action, const typename SPEC::T reward, const Matrix<NEXT_OBSERVATION_SPEC>& next_observation, const Matrix<NEXT_OBSERVATION_PRIVILEGED_SPEC>& next_observation_privileged, const bool terminated, const bool truncated) {
+        // todo: change to memcpy?
+        for(typename DEVICE::index_t i = 0; i < SPEC::OBSERVATION_DIM; i++) {
+            set(buffer.observations, buffer.position, i, get(observation, 0, i));
+            set(buffer.next_observations, buffer.position, i, get(next_observation, 0, i));
+        }
+        for(typename DEVICE::index_t i = 0; i < SPEC::OBSERVATION_DIM_PRIVILEGED; i++) {
+            set(buffer.observations_privileged, buffer.position, i, get(observation_privileged, 0, i));
+            set(buffer.next_observations_privileged, buffer.position, i, get(next_observation_privileged, 0, i));
+        }
+        for(typename DEVICE::index_t i = 0; i < SPEC::ACTION_DIM; i++) {
+            set(buffer.actions, buffer.position, i, get(action, 0, i));
+        }
+        set(buffer.rewards, buffer.position, 0, reward);
+        set(buffer.terminated, buffer.position, 0, terminated);
+        set(buffer.truncated, buffer.position, 0, truncated);
+        if constexpr(ReplayBuffer<SPEC>::DEDUPLICATE_OBSERVATIONS){
+            set(buffer.boundary, buffer.position, 0, false);
+        }
+        buffer.position = (buffer.position + 1) % SPEC::CAPACITY;
+        if(buffer.position == 0 && !buffer.full) {
+            buffer.full = true;
+        }
+//        add_scalar(device, device.logger, "replay_buffer/position", (typename SPEC::T)(buffer.full ? SPEC::CAPACITY : buffer.position), 1000);
+    }
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
 RL_TOOLS_NAMESPACE_WRAPPER_START
 namespace rl_tools {
+    // Points the column views at rb.data (and rb.scalars). malloc calls it; call it again after rebinding the matrices'
+    // _data to external storage (e.g. a memory-mapped file) of the same layout.
     template <typename DEVICE, typename SPEC>
-    void malloc(DEVICE& device, rl::components::ReplayBuffer<SPEC>& rb) {
-        using DATA_SPEC = typename decltype(rb.data)::SPEC;
-        malloc(device, rb.data);
+    void update_views(DEVICE& device, rl::components::ReplayBuffer<SPEC>& rb) {
+        constexpr bool SEPARATE_SCALARS = rl::components::ReplayBuffer<SPEC>::SEPARATE_SCALARS;
         typename DEVICE::index_t offset = 0;
         rb.observations                 = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, SPEC::OBSERVATION_DIM           >{}, 0, offset); offset += SPEC::ASYMMETRIC_OBSERVATIONS ? SPEC::OBSERVATION_DIM : 0;
         rb.observations_privileged      = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, SPEC::OBSERVATION_DIM_PRIVILEGED>{}, 0, offset); offset += SPEC::OBSERVATION_DIM_PRIVILEGED;
         rb.actions                      = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, SPEC::ACTION_DIM                >{}, 0, offset); offset += SPEC::ACTION_DIM;
-        rb.rewards                      = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, 1                               >{}, 0, offset); offset += 1;
-        rb.next_observations            = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, SPEC::OBSERVATION_DIM           >{}, 0, offset); offset += SPEC::ASYMMETRIC_OBSERVATIONS ? SPEC::OBSERVATION_DIM : 0;
-        rb.next_observations_privileged = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, SPEC::OBSERVATION_DIM_PRIVILEGED>{}, 0, offset); offset += SPEC::OBSERVATION_DIM_PRIVILEGED;
-        rb.terminated                   = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, 1                               >{}, 0, offset); offset += 1;
-        rb.truncated                    = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, 1                               >{}, 0, offset);
+        if constexpr(SEPARATE_SCALARS){
+            rb.rewards                  = view(device, rb.scalars, matrix::ViewSpec<SPEC::CAPACITY, 1                            >{}, 0, 0);
+            rb.terminated               = view(device, rb.scalars, matrix::ViewSpec<SPEC::CAPACITY, 1                            >{}, 0, 1);
+            rb.truncated                = view(device, rb.scalars, matrix::ViewSpec<SPEC::CAPACITY, 1                            >{}, 0, 2);
+        }
+        else{
+            rb.rewards                  = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, 1                               >{}, 0, offset); offset += 1;
+        }
+        if constexpr(rl::components::ReplayBuffer<SPEC>::DEDUPLICATE_OBSERVATIONS){
+            rb.next_observations            = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, SPEC::OBSERVATION_DIM           >{}, 1, 0);
+            rb.next_observations_privileged = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, SPEC::OBSERVATION_DIM_PRIVILEGED>{}, 1, SPEC::ASYMMETRIC_OBSERVATIONS ? SPEC::OBSERVATION_DIM : 0);
+        }
+        else{
+            rb.next_observations            = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, SPEC::OBSERVATION_DIM           >{}, 0, offset); offset += SPEC::ASYMMETRIC_OBSERVATIONS ? SPEC::OBSERVATION_DIM : 0;
+            rb.next_observations_privileged = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, SPEC::OBSERVATION_DIM_PRIVILEGED>{}, 0, offset); offset += SPEC::OBSERVATION_DIM_PRIVILEGED;
+        }
+        if constexpr(!SEPARATE_SCALARS){
+            rb.terminated               = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, 1                               >{}, 0, offset); offset += 1;
+            rb.truncated                = view(device, rb.data, matrix::ViewSpec<SPEC::CAPACITY, 1                               >{}, 0, offset);
+        }
+    }
+    template <typename DEVICE, typename SPEC>
+    void malloc(DEVICE& device, rl::components::ReplayBuffer<SPEC>& rb) {
+        malloc(device, rb.data);
+        if constexpr(rl::components::ReplayBuffer<SPEC>::SEPARATE_SCALARS){
+            malloc(device, rb.scalars);
+        }
+        if constexpr(rl::components::ReplayBuffer<SPEC>::DEDUPLICATE_OBSERVATIONS){
+            malloc(device, rb.boundary);
+        }
+        update_views(device, rb);
     }
     template <typename DEVICE, typename SPEC>
     void free(DEVICE& device, rl::components::ReplayBuffer<SPEC>& rb) {
         free(device, rb.data);
+        if constexpr(rl::components::ReplayBuffer<SPEC>::SEPARATE_SCALARS){
+            free(device, rb.scalars);
+        }
+        if constexpr(rl::components::ReplayBuffer<SPEC>::DEDUPLICATE_OBSERVATIONS){
+            free(device, rb.boundary);
+        }
     }
     template <typename DEVICE, typename SPEC>
     void malloc(DEVICE& device, rl::components::ReplayBufferWithStates<SPEC>& rb) {
@@ -45,36 +165,26 @@ namespace rl_tools {
     }
     template <typename DEVICE, typename SPEC, typename STATE, typename OBSERVATION_SPEC, typename OBSERVATION_PRIVILEGED_SPEC, typename ACTION_SPEC, typename NEXT_OBSERVATION_SPEC, typename NEXT_OBSERVATION_PRIVILEGED_SPEC>
     RL_TOOLS_FUNCTION_PLACEMENT void add(DEVICE& device, rl::components::ReplayBuffer<SPEC>& buffer, const STATE& state, const Matrix<OBSERVATION_SPEC>& observation, const Matrix<OBSERVATION_PRIVILEGED_SPEC>& observation_privileged, const Matrix<ACTION_SPEC>& action, const typename SPEC::T reward, const STATE& next_state, const Matrix<NEXT_OBSERVATION_SPEC>& next_observation, const Matrix<NEXT_OBSERVATION_PRIVILEGED_SPEC>& next_observation_privileged, const bool terminated, const bool truncated) {
-        // todo: change to memcpy?
-        for(typename DEVICE::index_t i = 0; i < SPEC::OBSERVATION_DIM; i++) {
-            set(buffer.observations, buffer.position, i, get(observation, 0, i));
-            set(buffer.next_observations, buffer.position, i, get(next_observation, 0, i));
-        }
-        for(typename DEVICE::index_t i = 0; i < SPEC::OBSERVATION_DIM_PRIVILEGED; i++) {
-            set(buffer.observations_privileged, buffer.position, i, get(observation_privileged, 0, i));
-            set(buffer.next_observations_privileged, buffer.position, i, get(next_observation_privileged, 0, i));
-        }
-        for(typename DEVICE::index_t i = 0; i < SPEC::ACTION_DIM; i++) {
-            set(buffer.actions, buffer.position, i, get(action, 0, i));
-        }
-        set(buffer.rewards, buffer.position, 0, reward);
-        set(buffer.terminated, buffer.position, 0, terminated);
-        set(buffer.truncated, buffer.position, 0, truncated);
-        buffer.position = (buffer.position + 1) % SPEC::CAPACITY;
-        if(buffer.position == 0 && !buffer.full) {
-            buffer.full = true;
-        }
-//        add_scalar(device, device.logger, "replay_buffer/position", (typename SPEC::T)(buffer.full ? SPEC::CAPACITY : buffer.position), 1000);
+        rl::components::replay_buffer::begin_transition(device, buffer, observation, observation_privileged);
+        rl::components::replay_buffer::write_transition(device, buffer, observation, observation_privileged, action, reward, next_observation, next_observation_privileged, terminated, truncated);
     }
     template <typename DEVICE, typename SPEC, typename STATE, typename OBSERVATION_SPEC, typename OBSERVATION_PRIVILEGED_SPEC, typename ACTION_SPEC, typename NEXT_OBSERVATION_SPEC, typename NEXT_OBSERVATION_PRIVILEGED_SPEC>
     RL_TOOLS_FUNCTION_PLACEMENT void add(DEVICE& device, rl::components::ReplayBufferWithStates<SPEC>& buffer, const STATE& state, const Matrix<OBSERVATION_SPEC>& observation, const Matrix<OBSERVATION_PRIVILEGED_SPEC>& observation_privileged, const Matrix<ACTION_SPEC>& action, const typename SPEC::T reward, const STATE& next_state, const Matrix<NEXT_OBSERVATION_SPEC>& next_observation, const Matrix<NEXT_OBSERVATION_PRIVILEGED_SPEC>& next_observation_privileged, const bool terminated, const bool truncated) {
+        auto& base = (rl::components::ReplayBuffer<typename SPEC::BASE_SPEC>&) buffer;
+        rl::components::replay_buffer::begin_transition(device, base, observation, observation_privileged);
         set(buffer.states, buffer.position, 0, state);
         set(buffer.next_states, buffer.position, 0, next_state);
-        add(device, (rl::components::ReplayBuffer<typename SPEC::BASE_SPEC>&) buffer, state, observation, observation_privileged, action, reward, next_state, next_observation, next_observation_privileged, terminated, truncated);
+        rl::components::replay_buffer::write_transition(device, base, observation, observation_privileged, action, reward, next_observation, next_observation_privileged, terminated, truncated);
     }
     template <typename SOURCE_DEVICE, typename TARGET_DEVICE, typename SOURCE_SPEC, typename TARGET_SPEC>
     void copy(SOURCE_DEVICE& source_device, TARGET_DEVICE& target_device, rl::components::ReplayBuffer<SOURCE_SPEC>& source, rl::components::ReplayBuffer<TARGET_SPEC>& target) {
         copy(source_device, target_device, source.data, target.data);
+        if constexpr(rl::components::ReplayBuffer<SOURCE_SPEC>::SEPARATE_SCALARS){
+            copy(source_device, target_device, source.scalars, target.scalars);
+        }
+        if constexpr(rl::components::ReplayBuffer<SOURCE_SPEC>::DEDUPLICATE_OBSERVATIONS){
+            copy(source_device, target_device, source.boundary, target.boundary);
+        }
         target.full = source.full;
         target.position = source.position;
     }
@@ -92,6 +202,87 @@ namespace rl_tools {
         acc += abs_diff(device, b1.truncated, b2.truncated);
         return acc;
     }
+    template <typename DEVICE, typename SPEC>
+    void malloc(DEVICE& device, rl::components::SumTree<SPEC>& tree) {
+        malloc(device, tree.nodes);
+    }
+    template <typename DEVICE, typename SPEC>
+    void free(DEVICE& device, rl::components::SumTree<SPEC>& tree) {
+        free(device, tree.nodes);
+    }
+    template <typename DEVICE, typename SPEC>
+    void init(DEVICE& device, rl::components::SumTree<SPEC>& tree) {
+        set_all(device, tree.nodes, 0);
+        tree.max_priority = 1;
+    }
+    template <typename DEVICE, typename SPEC>
+    typename SPEC::T total(DEVICE& device, const rl::components::SumTree<SPEC>& tree) {
+        using T = typename SPEC::T;
+        using TI = typename DEVICE::index_t;
+        T sum = 0;
+        for(TI child_i = 0; child_i < SPEC::FANOUT; child_i++){
+            sum += get(tree.nodes, 0, child_i);
+        }
+        return sum;
+    }
+    template <typename DEVICE, typename SPEC>
+    typename SPEC::T get_priority(DEVICE& device, const rl::components::SumTree<SPEC>& tree, typename DEVICE::index_t index) {
+        return get(tree.nodes, 0, rl::components::SumTree<SPEC>::LEAF_OFFSET + index);
+    }
+    // O(LEVELS * FANOUT): the leaf is written and each ancestor is recomputed as the sum of its block
+    template <typename DEVICE, typename SPEC>
+    void set_priority(DEVICE& device, rl::components::SumTree<SPEC>& tree, typename DEVICE::index_t index, typename SPEC::T priority) {
+        using TREE = rl::components::SumTree<SPEC>;
+        using T = typename SPEC::T;
+        using TI = typename DEVICE::index_t;
+        utils::assert_exit(device, index < SPEC::CAPACITY, "SumTree index out of range");
+        set(tree.nodes, 0, TREE::LEAF_OFFSET + index, priority);
+        for(TI level_i = TREE::LEVELS - 1; level_i > 0; level_i--){
+            const TI block = index / SPEC::FANOUT;
+            const T* children = &get(tree.nodes, 0, TREE::LEVEL_OFFSETS.values[level_i] + block * SPEC::FANOUT);
+            T sum = 0;
+            for(TI child_i = 0; child_i < SPEC::FANOUT; child_i++){
+                sum += children[child_i];
+            }
+            set(tree.nodes, 0, TREE::LEVEL_OFFSETS.values[level_i - 1] + block, sum);
+            index = block;
+        }
+    }
+    // Index of the leaf whose priority interval contains value, for value in [0, total). Values at or beyond the end of
+    // a block (float round-off) fall back to its last nonzero child, so zero-priority leaves are never returned.
+    template <typename DEVICE, typename SPEC>
+    typename DEVICE::index_t sample(DEVICE& device, const rl::components::SumTree<SPEC>& tree, typename SPEC::T value) {
+        using TREE = rl::components::SumTree<SPEC>;
+        using T = typename SPEC::T;
+        using TI = typename DEVICE::index_t;
+        TI block = 0;
+        for(TI level_i = 0; level_i < TREE::LEVELS; level_i++){
+            const T* children = &get(tree.nodes, 0, TREE::LEVEL_OFFSETS.values[level_i] + block * SPEC::FANOUT);
+            TI selected = SPEC::FANOUT;
+            TI last_nonzero = 0;
+            for(TI child_i = 0; child_i < SPEC::FANOUT; child_i++){
+                const T child = children[child_i];
+                if(child > 0){
+                    last_nonzero = child_i;
+                    if(value < child){
+                        selected = child_i;
+                        break;
+                    }
+                }
+                value -= child;
+            }
+            block = block * SPEC::FANOUT + (selected == SPEC::FANOUT ? last_nonzero : selected);
+        }
+        return block < SPEC::CAPACITY ? block : SPEC::CAPACITY - 1;
+    }
+    // Proportional prioritization: p = (|td_error| + epsilon)^alpha
+    template <typename DEVICE, typename SPEC>
+    void update_priority(DEVICE& device, rl::components::SumTree<SPEC>& tree, typename DEVICE::index_t index, typename SPEC::T td_error, typename SPEC::T alpha, typename SPEC::T epsilon) {
+        using T = typename SPEC::T;
+        const T priority = math::pow(device.math, math::abs(device.math, td_error) + epsilon, alpha);
+        set_priority(device, tree, index, priority);
+        tree.max_priority = math::max(device.math, tree.max_priority, priority);
+    }
     template <typename DEVICE, typename SPEC, typename RNG>
     RL_TOOLS_FUNCTION_PLACEMENT void recalculate_rewards(DEVICE& device, rl::components::ReplayBufferWithStates<SPEC>& buffer, const typename SPEC::ENVIRONMENT& env, RNG& rng) {
         using TI = typename DEVICE::index_t;
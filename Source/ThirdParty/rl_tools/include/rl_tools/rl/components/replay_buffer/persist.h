@@ -22,6 +22,9 @@ namespace rl_tools{
         save(device, rb.next_observations, group, "next_observations");
         save(device, rb.terminated, group, "terminated");
         save(device, rb.truncated, group, "truncated");
+        if constexpr(rl::components::ReplayBuffer<SPEC>::DEDUPLICATE_OBSERVATIONS){
+            save(device, rb.boundary, group, "boundary");
+        }
 
         std::vector<decltype(rb.position)> position;
         position.push_back(rb.position);
@@ -42,6 +45,9 @@ namespace rl_tools{
         load(device, rb.next_observations, group, "next_observations");
         load(device, rb.terminated, group, "terminated");
         load(device, rb.truncated, group, "truncated");
+        if constexpr(rl::components::ReplayBuffer<SPEC>::DEDUPLICATE_OBSERVATIONS){
+            load(device, rb.boundary, group, "boundary");
+        }
 
         std::vector<decltype(rb.position)> position;
         group.getDataSet("position").read(position);
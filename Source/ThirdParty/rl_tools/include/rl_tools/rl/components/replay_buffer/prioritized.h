@@ -0,0 +1,93 @@
+#include "../../../version.h"
+#if (defined(RL_TOOLS_DISABLE_INCLUDE_GUARDS) || !defined(RL_TOOLS_RL_COMPONENTS_REPLAY_BUFFER_PRIORITIZED_H)) && (RL_TOOLS_USE_THIS_VERSION == 1)
+#pragma once
+#define RL_TOOLS_RL_COMPONENTS_REPLAY_BUFFER_PRIORITIZED_H
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::rl::components::replay_buffer{
+    // FANOUT children per node, stored contiguously so that a node's children span one cache line for FANOUT = 16 and
+    // T = float. The descent scans them linearly (vectorizable) instead of chasing a binary tree through memory.
+    template<typename T_T, typename T_TI, T_TI T_CAPACITY, T_TI T_FANOUT = 16, bool T_DYNAMIC_ALLOCATION=true>
+    struct SumTreeSpecification{
+        using T = T_T;
+        using TI = T_TI;
+        static constexpr TI CAPACITY = T_CAPACITY;
+        static constexpr TI FANOUT = T_FANOUT;
+        static constexpr bool DYNAMIC_ALLOCATION = T_DYNAMIC_ALLOCATION;
+        static_assert(CAPACITY > 0);
+        static_assert(FANOUT > 1);
+    };
+    namespace sum_tree{
+        template <typename TI>
+        constexpr TI round_up(TI value, TI multiple){
+            return ((value + multiple - 1) / multiple) * multiple;
+        }
+        // Number of entries at a level, counted from the leaves (level 0). Every level is padded to whole blocks of
+        // FANOUT; the top level is a single block whose sum is the total priority.
+        template <typename TI>
+        constexpr TI level_size(TI capacity, TI fanout, TI level_from_bottom){
+            TI size = round_up(capacity, fanout);
+            for(TI level_i = 0; level_i < level_from_bottom; level_i++){
+                size = round_up(size / fanout, fanout);
+            }
+            return size;
+        }
+        template <typename TI>
+        constexpr TI num_levels(TI capacity, TI fanout){
+            TI levels = 1;
+            while(level_size(capacity, fanout, levels - 1) > fanout){
+                levels++;
+            }
+            return levels;
+        }
+        // Levels are stored top-down: the top block first, the leaves last
+        template <typename TI>
+        constexpr TI level_offset(TI capacity, TI fanout, TI level_from_top){
+            const TI levels = num_levels(capacity, fanout);
+            TI offset = 0;
+            for(TI level_i = 0; level_i < level_from_top; level_i++){
+                offset += level_size(capacity, fanout, levels - 1 - level_i);
+            }
+            return offset;
+        }
+        template <typename TI, TI LEVELS>
+        struct LevelOffsets{
+            TI values[LEVELS];
+        };
+        template <typename TI, TI LEVELS>
+        constexpr LevelOffsets<TI, LEVELS> level_offsets(TI capacity, TI fanout){
+            LevelOffsets<TI, LEVELS> offsets{};
+            for(TI level_i = 0; level_i < LEVELS; level_i++){
+                offsets.values[level_i] = level_offset(capacity, fanout, level_i);
+            }
+            return offsets;
+        }
+    }
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::rl::components {
+    // Flat sum-tree over CAPACITY leaf priorities for prioritized experience replay. Entry c of block j at level d is
+    // the sum of block (j * FANOUT + c) at level d + 1; the leaves are the priorities themselves. Parents are recomputed
+    // from their children on every update rather than adjusted by a delta, so float sums do not drift.
+    template <typename T_SPEC>
+    struct SumTree{
+        using SPEC = T_SPEC;
+        using T = typename SPEC::T;
+        using TI = typename SPEC::TI;
+        static constexpr TI CAPACITY = SPEC::CAPACITY;
+        static constexpr TI FANOUT = SPEC::FANOUT;
+        static constexpr TI LEVELS = replay_buffer::sum_tree::num_levels(CAPACITY, FANOUT);
+        static constexpr replay_buffer::sum_tree::LevelOffsets<TI, LEVELS> LEVEL_OFFSETS = replay_buffer::sum_tree::level_offsets<TI, LEVELS>(CAPACITY, FANOUT);
+        static constexpr TI LEAF_OFFSET = LEVEL_OFFSETS.values[LEVELS - 1];
+        static constexpr TI NODES = LEAF_OFFSET + replay_buffer::sum_tree::level_size(CAPACITY, FANOUT, (TI)0);
+
+        Matrix<matrix::Specification<T, TI, 1, NODES, SPEC::DYNAMIC_ALLOCATION>> nodes;
+        // Priority given to new transitions, so that each is replayed at least once before its TD error is known
+        T max_priority = 1;
+    };
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+#endif
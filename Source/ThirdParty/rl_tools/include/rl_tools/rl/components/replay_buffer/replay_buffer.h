@@ -2,9 +2,17 @@
 #if (defined(RL_TOOLS_DISABLE_INCLUDE_GUARDS) || !defined(RL_TOOLS_RL_COMPONENTS_REPLAY_BUFFER_REPLAY_BUFFER_H)) && (RL_TOOLS_USE_THIS_VERSION == 1)
 #pragma once
 #define RL_TOOLS_RL_COMPONENTS_REPLAY_BUFFER_REPLAY_BUFFER_H
+
+#include "../../../utils/generic/typing.h"
+
 RL_TOOLS_NAMESPACE_WRAPPER_START
 namespace rl_tools::rl::components::replay_buffer{
-    template<typename T_T, typename T_TI, T_TI T_OBSERVATION_DIM, T_TI T_OBSERVATION_DIM_PRIVILEGED, bool T_ASYMMETRIC_OBSERVATIONS, T_TI T_ACTION_DIM, T_TI T_CAPACITY, bool T_DYNAMIC_ALLOCATION=true>
+    // T_STORAGE_T is the element type of the observation and action columns, e.g. numeric_types::bfloat16 to halve the
+    // buffer and the bandwidth of gathering from it. Batches are still T; rewards and flags are always stored as T.
+    // T_DEDUPLICATE_OBSERVATIONS stores each observation once and reads next_observations from the following row, which
+    // requires the transitions of an episode to be added in order (one buffer per environment, as the runner does).
+    // ConcurrentReplayBuffer, whose writers interleave episodes, rejects it.
+    template<typename T_T, typename T_TI, T_TI T_OBSERVATION_DIM, T_TI T_OBSERVATION_DIM_PRIVILEGED, bool T_ASYMMETRIC_OBSERVATIONS, T_TI T_ACTION_DIM, T_TI T_CAPACITY, bool T_DYNAMIC_ALLOCATION=true, typename T_STORAGE_T=T_T, bool T_DEDUPLICATE_OBSERVATIONS=false>
     struct Specification{
         using T = T_T;
         using TI = T_TI;
@@ -16,6 +24,8 @@ namespace rl_tools::rl::components::replay_buffer{
         static constexpr TI ACTION_DIM = T_ACTION_DIM;
         static constexpr TI CAPACITY = T_CAPACITY;
         static constexpr bool DYNAMIC_ALLOCATION = T_DYNAMIC_ALLOCATION;
+        using STORAGE_T = T_STORAGE_T;
+        static constexpr bool DEDUPLICATE_OBSERVATIONS = T_DEDUPLICATE_OBSERVATIONS;
     };
 
     template<typename T_ENVIRONMENT, typename T_BASE_SPEC>
@@ -35,10 +45,24 @@ namespace rl_tools::rl::components {
         using T = typename SPEC::T;
         using TI = typename SPEC::TI;
         static constexpr TI CAPACITY = SPEC::CAPACITY;
-        static constexpr TI DATA_COLS = SPEC::OBSERVATION_DIM + SPEC::OBSERVATION_DIM_PRIVILEGED_ACTUAL + SPEC::ACTION_DIM + 1 + SPEC::OBSERVATION_DIM + SPEC::OBSERVATION_DIM_PRIVILEGED_ACTUAL + 1 + 1;
+        using STORAGE_T = typename SPEC::STORAGE_T;
+        // With a narrower STORAGE_T the rewards and termination flags move out of data into scalars, which keeps them T
+        static constexpr bool SEPARATE_SCALARS = !utils::typing::is_same_v<STORAGE_T, T>;
+        static constexpr TI SCALAR_COLS = 3;
+        // With DEDUPLICATE_OBSERVATIONS the next_observations view is the observation columns shifted down by one row.
+        // data gets an extra row for the successor of the last row, and the final observation of an episode takes a
+        // row of its own that is flagged in boundary and never sampled (see add in operations_generic.h).
+        static constexpr bool DEDUPLICATE_OBSERVATIONS = SPEC::DEDUPLICATE_OBSERVATIONS;
+        static constexpr TI OBSERVATION_COLS = SPEC::OBSERVATION_DIM + SPEC::OBSERVATION_DIM_PRIVILEGED_ACTUAL;
+        static constexpr TI DATA_ROWS = SPEC::CAPACITY + (DEDUPLICATE_OBSERVATIONS ? 1 : 0);
+        static constexpr TI DATA_COLS = OBSERVATION_COLS + SPEC::ACTION_DIM + (DEDUPLICATE_OBSERVATIONS ? 0 : OBSERVATION_COLS) + (SEPARATE_SCALARS ? 0 : SCALAR_COLS);
 
         // mem
-        Matrix<matrix::Specification<T, TI, SPEC::CAPACITY, DATA_COLS, SPEC::DYNAMIC_ALLOCATION>> data;
+        Matrix<matrix::Specification<STORAGE_T, TI, DATA_ROWS, DATA_COLS, SPEC::DYNAMIC_ALLOCATION>> data;
+        // [reward | terminated | truncated], only allocated if SEPARATE_SCALARS
+        Matrix<matrix::Specification<T, TI, SEPARATE_SCALARS ? SPEC::CAPACITY : 1, SCALAR_COLS, SPEC::DYNAMIC_ALLOCATION>> scalars;
+        // Rows holding only the final observation of an episode, only allocated if DEDUPLICATE_OBSERVATIONS
+        Matrix<matrix::Specification<bool, TI, DEDUPLICATE_OBSERVATIONS ? SPEC::CAPACITY : 1, 1, SPEC::DYNAMIC_ALLOCATION>> boundary;
 
         TI position = 0;
         bool full = false;
@@ -46,15 +70,16 @@ namespace rl_tools::rl::components {
         // views
         template<typename SPEC::TI DIM>
         using DATA_VIEW = typename decltype(data)::template VIEW<CAPACITY, DIM>;
+        using SCALAR_VIEW = utils::typing::conditional_t<SEPARATE_SCALARS, typename decltype(scalars)::template VIEW<CAPACITY, 1>, DATA_VIEW<1>>;
 
         DATA_VIEW<SPEC::OBSERVATION_DIM> observations;
         DATA_VIEW<SPEC::OBSERVATION_DIM_PRIVILEGED> observations_privileged;
         DATA_VIEW<SPEC::ACTION_DIM> actions;
-        DATA_VIEW<1> rewards;
+        SCALAR_VIEW rewards;
         DATA_VIEW<SPEC::OBSERVATION_DIM> next_observations;
         DATA_VIEW<SPEC::OBSERVATION_DIM_PRIVILEGED> next_observations_privileged;
-        DATA_VIEW<1> terminated;
-        DATA_VIEW<1> truncated;
+        SCALAR_VIEW terminated;
+        SCALAR_VIEW truncated;
     };
 
     template <typename T_SPEC>
@@ -0,0 +1,1112 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+#include <atomic>
+#include <type_traits>
+
+#include "RLConfigTypes.h"
+#include "RLNormalizationPlan.h"
+#include "RLPolicyFile.h"
+#include "RLReplayBufferFile.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "rl_tools/operations/cpu_mux.h"
+#include "rl_tools/nn/optimizers/adam/instance/operations_generic.h"
+#include "rl_tools/nn/operations_cpu_mux.h"
+#include "rl_tools/nn/layers/td3_sampling/layer.h"
+#include "rl_tools/nn/layers/sample_and_squash/layer.h"
+#include "rl_tools/nn/optimizers/adam/adam.h"
+#include "rl_tools/nn_models/mlp/network.h"
+#include "rl_tools/nn_models/mlp_unconditional_stddev/network.h"
+#include "rl_tools/nn_models/sequential/model.h"
+#include "rl_tools/rl/algorithms/td3/td3.h"
+#include "rl_tools/rl/algorithms/sac/sac.h"
+#include "rl_tools/rl/algorithms/sac/loop/core/approximators_mlp.h"
+#include "rl_tools/rl/algorithms/ppo/ppo.h"
+#include "rl_tools/rl/components/on_policy_runner/on_policy_runner.h"
+// Operation order follows rl_tools' TD3, SAC and PPO loops: optimizer instance operations before any model, every
+// model's operations before the sequential model dispatches to them (rl_tools only finds overloads declared earlier),
+// the optimizer itself after the sequential model, then the algorithms on top. TRLSACAgentBackend and
+// TRLPPOAgentBackend live in their own headers but their operations are included here so the order holds wherever
+// this header comes first.
+#include "rl_tools/nn/layers/td3_sampling/operations_generic.h"
+#include "rl_tools/nn/layers/sample_and_squash/operations_generic.h"
+#include "rl_tools/nn_models/mlp/operations_generic.h"
+#include "rl_tools/nn_models/mlp_unconditional_stddev/operations_generic.h"
+#include "rl_tools/nn_models/sequential/operations_generic.h"
+#include "rl_tools/nn/optimizers/adam/operations_generic.h"
+#include "rl_tools/rl/components/replay_buffer/operations_generic.h"
+#include "rl_tools/rl/components/off_policy_runner/operations_generic.h"
+#include "rl_tools/rl/components/replay_buffer/operations_cpu.h"
+#include "rl_tools/rl/components/on_policy_runner/operations_generic.h"
+#include "rl_tools/rl/algorithms/td3/operations_generic.h"
+#include "rl_tools/rl/algorithms/sac/operations_generic.h"
+#include "rl_tools/rl/algorithms/ppo/operations_generic.h"
+THIRD_PARTY_INCLUDES_END
+
+// Store replay buffer observations and actions as bfloat16 (see TRLAgentBackend::REPLAY_BUFFER_STORAGE_T). Halves the
+// buffer and the bandwidth of sampling it, but observations are stored raw, before normalization, with 8 significant
+// bits: only enable it for observations of a moderate dynamic range.
+#ifndef UERL_HALF_PRECISION_REPLAY_BUFFER
+#define UERL_HALF_PRECISION_REPLAY_BUFFER 0
+#endif
+
+/**
+ * Type-erased agent backend.
+ *
+ * rl_tools networks are fully static: observation/action/hidden dimensions are template parameters so the dense
+ * kernels are unrolled at compile time. URLAgentManager only knows the dimensions at runtime (from the environment
+ * component), so it talks to the network through this interface and FRLAgentBackendRegistry picks the matching
+ * pre-instantiated backend for the agent's algorithm: TRLAgentBackend (TD3), TRLSACAgentBackend (SAC) or
+ * TRLPPOAgentBackend (PPO).
+ */
+class IRLAgentBackend
+{
+public:
+	virtual ~IRLAgentBackend() = default;
+
+	virtual ERLAlgorithm GetAlgorithm() const = 0;
+
+	virtual int32 GetObservationDim() const = 0;
+	virtual int32 GetActionDim() const = 0;
+	virtual int32 GetHiddenDim() const = 0;
+
+	// Runs the actor on a single observation (ObservationDim floats) and writes ActionDim floats
+	virtual void Evaluate(const float* Observation, float* OutAction) = 0;
+
+	// Runs the actor on NumRows row-major observations and writes NumRows rows of actions
+	virtual void EvaluateBatch(const float* Observations, int32 NumRows, float* OutActions) = 0;
+
+	// The inference actor's parameters as row-major blocks, weights then biases of each layer from the input layer on;
+	// the order and shapes a policy file stores
+	virtual void GetPolicyParameterBlocks(TArray<FRLPolicyParameterBlock>& OutBlocks) const = 0;
+
+	// Points the inference actor at externally owned blocks laid out like GetPolicyParameterBlocks (e.g. the pages of a
+	// memory-mapped policy file), without copying them. The memory must stay valid until UnbindPolicyParameters or the
+	// next Train call. The trained actor and its target are set to the same parameters so training continues from them.
+	virtual void BindPolicyParameters(TConstArrayView<const float*> BlockData) = 0;
+
+	// Copies the bound parameters back into the actor's own storage and points it there again
+	virtual void UnbindPolicyParameters() = 0;
+
+	// Training. Off-policy (TD3, SAC): observations passed here are raw; Train normalizes the sampled batch with the
+	// plan it is given, so the replay buffer stays valid while running observation statistics move. On-policy (PPO):
+	// the "replay buffer" is the rollout being collected, see TRLPPOAgentBackend for how the calls below map onto it.
+
+	// Compile-time sizes of the replay buffer (the rollout) and of the batch every update trains on
+	virtual int32 GetReplayBufferCapacity() const = 0;
+	virtual int32 GetTrainingBatchSize() const = 0;
+
+	// Transitions stored so far, saturating at the capacity. Counts rows as soon as AddTransition reserves them, so some
+	// may still be being written.
+	virtual int32 GetReplayBufferSize() const = 0;
+
+	// Bytes of the blocks the backend's rl_tools containers live in (see FRLAgentArena), and how many containers were
+	// allocated since they were carved out. The replay buffer rows have a block of their own that only exists while no
+	// replay buffer file is open. The count only moves in the constructor and when the file is opened or closed.
+	virtual SIZE_T GetArenaSize() const = 0;
+	virtual int64 GetArenaAllocations() const = 0;
+
+	// Re-initializes the actor, twin critics, their targets and optimizers and empties the replay buffer
+	virtual void ResetTraining() = 0;
+
+	// Moves the replay buffer into a memory-mapped file (see FRLReplayBufferFile), creating it or resuming from the
+	// transitions it holds. The in-memory rows are freed, so only the file's resident pages cost memory. The file holds
+	// GetReplayBufferCapacity() rows like the in-memory buffer: it replaces the memory, it does not add capacity.
+	// Returns false, keeping the current buffer, if the file cannot be mapped or was written by a backend of other
+	// dimensions. No training thread may run.
+	virtual bool OpenReplayBufferFile(const FString& FilePath) = 0;
+
+	// Flushes and unmaps the file and returns to an empty in-memory replay buffer, allocating its rows again. No training
+	// thread may run.
+	virtual void CloseReplayBufferFile() = 0;
+
+	// Writes the transitions added so far back to the file, if one is open
+	virtual void FlushReplayBufferFile() = 0;
+
+	virtual void SetTrainingParameters(float ActorLearningRate, float CriticLearningRate, float Gamma) = 0;
+
+	// Train the two critics of each update on two task graph workers instead of one after the other
+	virtual void SetParallelCriticTraining(bool bParallel) = 0;
+
+	// Prioritized experience replay: transitions are drawn proportionally to (|TD error| + epsilon)^Alpha, and the
+	// critic loss is importance weighted with an exponent annealed linearly from Beta to 1 over BetaAnnealingUpdates
+	virtual void SetPrioritizedReplay(bool bEnabled, float Alpha, float Beta, int32 BetaAnnealingUpdates) = 0;
+
+	// PPO: passes over each full rollout and the GAE lambda its advantages are estimated with
+	virtual void SetPPOParameters(int32 Epochs, float GAELambda) = 0;
+
+	// Exploration actions in policy space ([-1, 1]): uniform noise, or the actor's action for each already normalized
+	// observation plus clipped Gaussian noise
+	virtual void SampleTrainingActions(const float* NormalizedObservations, int32 NumRows, float* OutActions, bool bUniform) = 0;
+
+	// Appends one transition; Action is the policy-space action the environment was driven with. Safe to call from
+	// several threads at once and concurrently with Train.
+	virtual void AddTransition(const float* Observation, const float* Action, float Reward, const float* NextObservation, bool bTerminated, bool bTruncated) = 0;
+
+	// Runs NumUpdates TD3 or SAC updates on batches sampled from the replay buffer. Returns false if fewer than
+	// GetTrainingBatchSize() transitions have been published, or if a batch could not be gathered because the rows drawn
+	// were still being written; the remaining updates are then skipped.
+	virtual bool Train(int32 NumUpdates, const FRLNormalizationPlan& ObservationNormalization) = 0;
+
+	// Actor/learner split (see FRLAsyncTrainingTask). The learner thread owns training (AddTransition, Train); the
+	// rollout thread only calls SampleRolloutActions, which acts on a snapshot of the trained actor. Snapshots are
+	// published through a double-buffered parameter block: the learner fills the buffer the rollout thread is not
+	// reading and swaps the published index atomically.
+
+	// While set, Train publishes a snapshot instead of refreshing the inference actor, so Evaluate on the game thread
+	// never races the learner. Clearing it (learner stopped) refreshes the inference actor from the trained one.
+	virtual void SetAsyncLearner(bool bAsync) = 0;
+
+	// Learner thread: copies the trained actor and the observation normalization it trains with into the back buffer
+	// and publishes it. Returns false, publishing nothing, while the rollout thread still holds the back buffer.
+	virtual bool PublishPolicySnapshot(const FRLNormalizationPlan& ObservationNormalization) = 0;
+
+	// Rollout thread: exploration actions in policy space for raw observations, from the latest published snapshot
+	// plus clipped Gaussian noise. Uniform until a snapshot has been published since ResetTraining.
+	virtual void SampleRolloutActions(const float* Observations, int32 NumRows, float* OutActions) = 0;
+};
+
+/**
+ * Type-level description of an environment shape, standing in for an rl_tools environment in the TD3, PPO and replay
+ * buffer specifications. Transitions come from URLEnvironmentComponent, so no rl_tools environment is ever stepped.
+ */
+template <typename T_T, typename T_TI, T_TI T_OBSERVATION_DIM, T_TI T_ACTION_DIM>
+struct TRLEnvironmentShape
+{
+	using T = T_T;
+	using TI = T_TI;
+	struct Observation
+	{
+		static constexpr TI DIM = T_OBSERVATION_DIM;
+	};
+	using ObservationPrivileged = Observation;
+	static constexpr TI ACTION_DIM = T_ACTION_DIM;
+	static constexpr TI N_AGENTS = 1;
+};
+
+/**
+ * What rl_tools' SequentialBatch needs to know about the source of its transitions: the environment shape and the
+ * replay buffer layout (no privileged observations).
+ */
+template <typename T_T, typename T_TI, typename T_ENVIRONMENT>
+struct TRLTransitionSourceSpec
+{
+	using T = T_T;
+	using TI = T_TI;
+	using ENVIRONMENT = T_ENVIRONMENT;
+	struct PARAMETERS
+	{
+		static constexpr bool ASYMMETRIC_OBSERVATIONS = false;
+	};
+	static constexpr TI OBSERVATION_DIM_PRIVILEGED = ENVIRONMENT::Observation::DIM;
+	static constexpr TI OBSERVATION_DIM_PRIVILEGED_ACTUAL = 0;
+};
+
+/**
+ * Normalizes the observations and next observations of a gathered off-policy batch in place, for the TD3 and SAC
+ * backends, whose replay buffers store raw observations.
+ */
+template <typename BATCH_TYPE>
+void NormalizeRLBatchObservations(BATCH_TYPE& Batch, const FRLNormalizationPlan& ObservationNormalization)
+{
+	if (ObservationNormalization.IsIdentity())
+	{
+		return;
+	}
+
+	using T = typename BATCH_TYPE::T;
+	using TI = typename BATCH_TYPE::TI;
+
+	// Batch rows are [observation | action | next observation | next action]
+	T* BatchData = rl_tools::data(Batch.observations_actions_next_observations);
+	for (TI BatchRow = 0; BatchRow < BATCH_TYPE::BATCH_SIZE; ++BatchRow)
+	{
+		T* Row = BatchData + BatchRow * BATCH_TYPE::DATA_DIM;
+		ObservationNormalization.ApplyInPlace(MakeArrayView(Row, BATCH_TYPE::OBSERVATION_DIM));
+		ObservationNormalization.ApplyInPlace(MakeArrayView(Row + BATCH_TYPE::OBSERVATION_DIM + BATCH_TYPE::ACTION_DIM, BATCH_TYPE::OBSERVATION_DIM));
+	}
+}
+
+/**
+ * The one block of memory behind every rl_tools container of a backend: networks, optimizer state, buffers, batches
+ * and the replay buffer. Allocate runs the backend's mallocs twice, first against a measuring arena to size the block
+ * to the byte, then against the block itself, so a backend costs a single heap allocation and tearing it down is one
+ * free however many containers it has. Devices keep pointing at the arena afterwards; a container malloc'd later (there
+ * should be none) no longer fits and falls back to the heap, which GetAllocations makes visible.
+ */
+class FRLAgentArena
+{
+public:
+	FRLAgentArena() = default;
+
+	~FRLAgentArena()
+	{
+		FMemory::Free(Arena.data);
+	}
+
+	FRLAgentArena(const FRLAgentArena&) = delete;
+	FRLAgentArena& operator=(const FRLAgentArena&) = delete;
+
+	// Points each device at the arena and calls MallocContainers once to measure and once to allocate. MallocContainers
+	// must only malloc: the measuring pass hands out addresses that cannot be written.
+	template <typename... DEVICES, typename FUNC>
+	void Allocate(FUNC&& MallocContainers, DEVICES&... Devices)
+	{
+		check(Arena.data == nullptr);
+		((Devices.arena = &Arena), ...);
+		MallocContainers();
+
+		Arena.capacity = Arena.used;
+		Arena.data = static_cast<char*>(FMemory::Malloc(FMath::Max<SIZE_T>(Arena.capacity, 1), PLATFORM_CACHE_LINE_SIZE));
+		Arena.used = 0;
+		Arena.allocations = 0;
+		MallocContainers();
+	}
+
+	SIZE_T GetSize() const { return Arena.capacity; }
+
+	// Containers allocated since Allocate measured the arena, including its own second pass
+	int64 GetAllocations() const { return Arena.allocations; }
+
+private:
+	rl_tools::devices::cpu::Arena Arena;
+};
+
+/**
+ * rl_tools backend for one (observation, action, hidden) shape.
+ * All rl_tools containers are allocated in the constructor, out of one FRLAgentArena block, except for the replay
+ * buffer rows: they get a block of their own, which a replay buffer file replaces. Evaluate/EvaluateBatch/
+ * AddTransition/Train allocate no rl_tools container (GetArenaAllocations stays put); parallel critic training still
+ * goes through the task graph, which allocates its tasks.
+ *
+ * Training follows the TD3 loop of rl_tools (rl/algorithms/td3/loop/core) with a shared batch: every update gathers
+ * one batch and one set of target action noise, trains both critics on it and, every ACTOR_TRAINING_INTERVAL updates,
+ * the actor too. The inference actor is a Forward-only copy of the trained actor, refreshed after each Train call.
+ * With prioritized replay the batch is drawn from a sum-tree over the replay buffer rows instead of uniformly, and the
+ * critics' TD errors on it become the rows' new priorities.
+ *
+ * The rollout actor is a second Forward-only copy with its own device, buffers and rng. Its parameter matrices point
+ * into whichever of the two PolicySnapshots the rollout thread has pinned, so picking up a new snapshot is a pointer
+ * swap rather than a copy.
+ */
+template <int32 T_OBSERVATION_DIM, int32 T_ACTION_DIM, int32 T_HIDDEN_DIM>
+class TRLAgentBackend final : public IRLAgentBackend
+{
+public:
+	using DEVICE = rl_tools::devices::DefaultCPU;
+	using T = float;
+	using TI = typename DEVICE::index_t;
+	using RNG = decltype(rl_tools::random::default_engine(typename DEVICE::SPEC::RANDOM{}));
+
+	static constexpr TI OBSERVATION_DIM = T_OBSERVATION_DIM;
+	static constexpr TI ACTION_DIM = T_ACTION_DIM;
+	static constexpr TI HIDDEN_DIM = T_HIDDEN_DIM;
+	static constexpr TI NUM_LAYERS = 3; // rl_tools counts the input and output layers towards the total
+	static constexpr int32 NUM_PARAMETER_BLOCKS = 2 * NUM_LAYERS; // Weights and biases per layer
+	static constexpr auto ACTIVATION_FUNCTION = rl_tools::nn::activation_functions::ActivationFunction::RELU;
+
+	// The actor is evaluated through a preallocated input/output pair sized for INFERENCE_BATCH_SIZE rows, so batched
+	// inference is a single forward pass per chunk. Single observations use a one-row input against the same model/buffers.
+	static constexpr TI INFERENCE_BATCH_SIZE = 64;
+
+	// Replay buffer and batch sizes are template parameters of the rl_tools containers; the matching
+	// FLocalRLTrainingConfig fields are clamped to them
+	static constexpr TI REPLAY_BUFFER_CAPACITY = 100000;
+	static constexpr TI TRAINING_BATCH_SIZE = 256;
+
+	// Std of the Gaussian noise added to the actor's actions while collecting experience (rl_tools' TD3 default)
+	static constexpr T EXPLORATION_NOISE = 0.1;
+
+	// Keeps transitions with a zero TD error sampleable under prioritized replay
+	static constexpr T PRIORITY_EPSILON = 1e-6;
+
+	using ACTOR_CONFIG = rl_tools::nn_models::mlp::Configuration<T, TI, ACTION_DIM, NUM_LAYERS, HIDDEN_DIM, ACTIVATION_FUNCTION, rl_tools::nn::activation_functions::TANH>; // Actor output usually tanh
+	using ACTOR_CAPABILITY = rl_tools::nn::capability::Forward<>;
+	using ACTOR_INPUT_SHAPE = rl_tools::tensor::Shape<TI, 1, INFERENCE_BATCH_SIZE, OBSERVATION_DIM>;
+	using ACTOR_TYPE = rl_tools::nn_models::mlp::NeuralNetwork<ACTOR_CONFIG, ACTOR_CAPABILITY, ACTOR_INPUT_SHAPE>;
+	using ACTOR_BUFFER_TYPE = typename ACTOR_TYPE::template Buffer<>;
+	using ACTOR_SINGLE_INPUT_SHAPE = rl_tools::tensor::Shape<TI, 1, 1, OBSERVATION_DIM>;
+	using INFERENCE_INPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, ACTOR_INPUT_SHAPE>>;
+	using INFERENCE_OUTPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, typename ACTOR_TYPE::OUTPUT_SHAPE>>;
+	using INFERENCE_SINGLE_INPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, ACTOR_SINGLE_INPUT_SHAPE>>;
+	using INFERENCE_SINGLE_OUTPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, typename ACTOR_TYPE::template OUTPUT_SHAPE_FACTORY<ACTOR_SINGLE_INPUT_SHAPE>>>;
+
+	// TD3 networks, mirroring rl_tools::rl::algorithms::td3::loop::core::ConfigApproximatorsMLP
+	using ENVIRONMENT = TRLEnvironmentShape<T, TI, OBSERVATION_DIM, ACTION_DIM>;
+
+	struct TD3_PARAMETERS : rl_tools::rl::algorithms::td3::DefaultParameters<T, TI>
+	{
+		static constexpr TI ACTOR_BATCH_SIZE = TRAINING_BATCH_SIZE;
+		static constexpr TI CRITIC_BATCH_SIZE = TRAINING_BATCH_SIZE;
+	};
+
+	using TRAINING_ACTOR_INPUT_SHAPE = rl_tools::tensor::Shape<TI, TD3_PARAMETERS::SEQUENCE_LENGTH, TRAINING_BATCH_SIZE, OBSERVATION_DIM>;
+	using CRITIC_INPUT_SHAPE = rl_tools::tensor::Shape<TI, TD3_PARAMETERS::SEQUENCE_LENGTH, TRAINING_BATCH_SIZE, OBSERVATION_DIM + ACTION_DIM>;
+	using TRAINING_ACTOR_MLP = rl_tools::nn_models::mlp::BindConfiguration<ACTOR_CONFIG>;
+	using CRITIC_CONFIG = rl_tools::nn_models::mlp::Configuration<T, TI, 1, NUM_LAYERS, HIDDEN_DIM, ACTIVATION_FUNCTION, rl_tools::nn::activation_functions::ActivationFunction::IDENTITY>;
+	using CRITIC_MLP = rl_tools::nn_models::mlp::BindConfiguration<CRITIC_CONFIG>;
+
+	struct SAMPLING_PARAMETERS : rl_tools::nn::layers::td3_sampling::DefaultParameters<T>
+	{
+		static constexpr T STD = EXPLORATION_NOISE;
+	};
+	using SAMPLING = rl_tools::nn::layers::td3_sampling::BindConfiguration<rl_tools::nn::layers::td3_sampling::Configuration<T, TI, SAMPLING_PARAMETERS>>;
+
+	template <typename T_CONTENT, typename T_NEXT_MODULE = rl_tools::nn_models::sequential::OutputModule>
+	using Module = rl_tools::nn_models::sequential::Module<T_CONTENT, T_NEXT_MODULE>;
+
+	using TRAINING_CAPABILITY = rl_tools::nn::capability::Gradient<rl_tools::nn::parameters::Adam>;
+	using TARGET_CAPABILITY = rl_tools::nn::capability::Forward<>;
+	using TRAINING_ACTOR_TYPE = rl_tools::nn_models::sequential::Build<TRAINING_CAPABILITY, Module<TRAINING_ACTOR_MLP, Module<SAMPLING>>, TRAINING_ACTOR_INPUT_SHAPE>;
+	using TARGET_ACTOR_TYPE = rl_tools::nn_models::sequential::Build<TARGET_CAPABILITY, Module<TRAINING_ACTOR_MLP, Module<SAMPLING>>, TRAINING_ACTOR_INPUT_SHAPE>;
+	using CRITIC_TYPE = rl_tools::nn_models::sequential::Build<TRAINING_CAPABILITY, Module<CRITIC_MLP>, CRITIC_INPUT_SHAPE>;
+	using TARGET_CRITIC_TYPE = rl_tools::nn_models::sequential::Build<TARGET_CAPABILITY, Module<CRITIC_MLP>, CRITIC_INPUT_SHAPE>;
+	using OPTIMIZER = rl_tools::nn::optimizers::Adam<rl_tools::nn::optimizers::adam::Specification<T, TI, rl_tools::nn::optimizers::adam::DEFAULT_PARAMETERS_TENSORFLOW<T>>>;
+
+	using ACTOR_CRITIC_SPEC = rl_tools::rl::algorithms::td3::Specification<T, TI, ENVIRONMENT, TRAINING_ACTOR_TYPE, TARGET_ACTOR_TYPE, CRITIC_TYPE, TARGET_CRITIC_TYPE, OPTIMIZER, TD3_PARAMETERS>;
+	using ACTOR_CRITIC_TYPE = rl_tools::rl::algorithms::td3::ActorCritic<ACTOR_CRITIC_SPEC>;
+	using ACTOR_TRAINING_BUFFERS_TYPE = rl_tools::rl::algorithms::td3::ActorTrainingBuffers<rl_tools::rl::algorithms::td3::ActorTrainingBuffersSpecification<ACTOR_CRITIC_SPEC>>;
+	using CRITIC_TRAINING_BUFFERS_TYPE = rl_tools::rl::algorithms::td3::CriticTrainingBuffers<rl_tools::rl::algorithms::td3::CriticTrainingBuffersSpecification<ACTOR_CRITIC_SPEC>>;
+	using TRAINING_ACTOR_BUFFER_TYPE = typename TRAINING_ACTOR_TYPE::template Buffer<>;
+	using CRITIC_BUFFER_TYPE = typename CRITIC_TYPE::template Buffer<>;
+
+#if UERL_HALF_PRECISION_REPLAY_BUFFER
+	using REPLAY_BUFFER_STORAGE_T = rl_tools::numeric_types::bfloat16;
+#else
+	using REPLAY_BUFFER_STORAGE_T = T;
+#endif
+	// Without observation deduplication: AddTransition interleaves every agent's episodes in the one buffer, so a row's
+	// successor is rarely its next observation
+	using REPLAY_BUFFER_SPEC = rl_tools::rl::components::replay_buffer::Specification<T, TI, OBSERVATION_DIM, OBSERVATION_DIM, false, ACTION_DIM, REPLAY_BUFFER_CAPACITY, true, REPLAY_BUFFER_STORAGE_T>;
+	using REPLAY_BUFFER_TYPE = rl_tools::rl::components::ConcurrentReplayBuffer<REPLAY_BUFFER_SPEC>;
+	using BATCH_SPEC = rl_tools::rl::components::off_policy_runner::SequentialBatchSpecification<TRLTransitionSourceSpec<T, TI, ENVIRONMENT>, TD3_PARAMETERS::SEQUENCE_LENGTH, TRAINING_BATCH_SIZE>;
+	using BATCH_TYPE = rl_tools::rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>;
+	using SUM_TREE_TYPE = rl_tools::rl::components::SumTree<rl_tools::rl::components::replay_buffer::SumTreeSpecification<T, TI, REPLAY_BUFFER_CAPACITY>>;
+	using SAMPLED_ROWS_TYPE = rl_tools::Matrix<rl_tools::matrix::Specification<TI, TI, 1, TRAINING_BATCH_SIZE>>;
+	using SAMPLE_VALUES_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, rl_tools::tensor::Shape<TI, TD3_PARAMETERS::SEQUENCE_LENGTH, TRAINING_BATCH_SIZE, 1>>>;
+
+	explicit TRLAgentBackend(uint32 Seed)
+	{
+		Arena.Allocate([this]()
+		{
+			rl_tools::malloc(device, Actor);
+			rl_tools::malloc(device, ActorEvalBuffer);
+			rl_tools::malloc(device, InferenceInput);
+			rl_tools::malloc(device, InferenceOutput);
+			rl_tools::malloc(device, InferenceSingleInput);
+			rl_tools::malloc(device, InferenceSingleOutput);
+
+			rl_tools::malloc(device, ActorCritic);
+			rl_tools::malloc(device, ActorTrainingBuffers);
+			rl_tools::malloc(device, CriticTrainingBuffers[0]);
+			rl_tools::malloc(device, CriticTrainingBuffers[1]);
+			rl_tools::malloc(device, TrainingActorBuffers[0]);
+			rl_tools::malloc(device, TrainingActorBuffers[1]);
+			rl_tools::malloc(device, CriticBuffers[0]);
+			rl_tools::malloc(device, CriticBuffers[1]);
+			rl_tools::malloc(device, Batch);
+			rl_tools::malloc(device, Priorities);
+			rl_tools::malloc(device, SampledRows);
+			rl_tools::malloc(device, ImportanceWeights);
+			rl_tools::malloc(device, TDErrors[0]);
+			rl_tools::malloc(device, TDErrors[1]);
+
+			rl_tools::malloc(RolloutDevice, RolloutActor);
+			rl_tools::malloc(RolloutDevice, RolloutEvalBuffer);
+			rl_tools::malloc(RolloutDevice, RolloutInput);
+			rl_tools::malloc(RolloutDevice, RolloutOutput);
+		}, device, RolloutDevice);
+		rl_tools::set_all(RolloutDevice, RolloutInput, 0);
+		AllocateReplayBufferRows();
+
+		// Zero the input so padded rows of a partial chunk never carry NaNs from the allocation
+		rl_tools::set_all(device, InferenceInput, 0);
+
+		ForEachParameterMatrix(Actor, [this](auto& Parameters, int32 Block)
+		{
+			OwnedActorParameters[Block] = Parameters._data;
+		});
+
+		// Snapshots store the parameter blocks back to back in GetPolicyParameterBlocks order
+		int32 SnapshotFloats = 0;
+		ForEachParameterMatrix(RolloutActor, [this, &SnapshotFloats](auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			SnapshotBlockOffsets[Block] = SnapshotFloats;
+			SnapshotFloats += MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS;
+		});
+		for (FPolicySnapshot& Snapshot : PolicySnapshots)
+		{
+			Snapshot.Parameters.SetNumUninitialized(SnapshotFloats);
+		}
+
+		rng = rl_tools::random::default_engine(device.random, Seed);
+		RolloutRng = rl_tools::random::default_engine(RolloutDevice.random, Seed + 1);
+		ResetTraining();
+	}
+
+	virtual ~TRLAgentBackend() override
+	{
+		// Every container lives in Arena or ReplayBufferArena, which go in one free each; only a mapped replay buffer has
+		// to be let go of
+		if (ReplayBufferFile)
+		{
+			DetachReplayBufferFile();
+		}
+	}
+
+	virtual ERLAlgorithm GetAlgorithm() const override { return ERLAlgorithm::TD3; }
+
+	virtual int32 GetObservationDim() const override { return T_OBSERVATION_DIM; }
+	virtual int32 GetActionDim() const override { return T_ACTION_DIM; }
+	virtual int32 GetHiddenDim() const override { return T_HIDDEN_DIM; }
+
+	virtual void Evaluate(const float* Observation, float* OutAction) override
+	{
+		// Single observations go through a one-row input so we don't pay for a full INFERENCE_BATCH_SIZE forward pass
+		FMemory::Memcpy(rl_tools::data(InferenceSingleInput), Observation, OBSERVATION_DIM * sizeof(T));
+		rl_tools::evaluate(device, Actor, InferenceSingleInput, InferenceSingleOutput, ActorEvalBuffer, rng);
+		FMemory::Memcpy(OutAction, rl_tools::data(InferenceSingleOutput), ACTION_DIM * sizeof(T));
+	}
+
+	virtual void EvaluateBatch(const float* Observations, int32 NumRows, float* OutActions) override
+	{
+		for (int32 RowStart = 0; RowStart < NumRows; RowStart += INFERENCE_BATCH_SIZE)
+		{
+			const int32 ChunkRows = FMath::Min<int32>(INFERENCE_BATCH_SIZE, NumRows - RowStart);
+
+			// The network is compiled for INFERENCE_BATCH_SIZE rows. A partial chunk leaves stale rows in the tail of the
+			// input; they are evaluated row-independently and their outputs are simply not copied back.
+			FMemory::Memcpy(rl_tools::data(InferenceInput), Observations + RowStart * OBSERVATION_DIM, ChunkRows * OBSERVATION_DIM * sizeof(T));
+			rl_tools::evaluate(device, Actor, InferenceInput, InferenceOutput, ActorEvalBuffer, rng);
+			FMemory::Memcpy(OutActions + RowStart * ACTION_DIM, rl_tools::data(InferenceOutput), ChunkRows * ACTION_DIM * sizeof(T));
+		}
+	}
+
+	virtual void GetPolicyParameterBlocks(TArray<FRLPolicyParameterBlock>& OutBlocks) const override
+	{
+		OutBlocks.SetNum(NUM_PARAMETER_BLOCKS);
+		ForEachParameterMatrix(Actor, [&OutBlocks](const auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			OutBlocks[Block].Data = Parameters._data;
+			OutBlocks[Block].Rows = MATRIX_SPEC::ROWS;
+			OutBlocks[Block].Cols = MATRIX_SPEC::COLS;
+		});
+	}
+
+	virtual void BindPolicyParameters(TConstArrayView<const float*> BlockData) override
+	{
+		check(BlockData.Num() == NUM_PARAMETER_BLOCKS);
+
+		// Dense layer parameters are unpadded row-major matrices, so a block is exactly ROWS * COLS floats
+		auto CopyBlock = [&BlockData](auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			static_assert(MATRIX_SPEC::ROW_PITCH == MATRIX_SPEC::COLS, "Policy parameter blocks must be dense");
+			FMemory::Memcpy(Parameters._data, BlockData[Block], MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS * sizeof(T));
+		};
+		ForEachParameterMatrix(ActorCritic.actor.content, CopyBlock);
+		ForEachParameterMatrix(ActorCritic.actor_target.content, CopyBlock);
+
+		// Inference only reads its parameters, so it can run straight off read-only mapped pages
+		ForEachParameterMatrix(Actor, [&BlockData](auto& Parameters, int32 Block)
+		{
+			Parameters._data = const_cast<T*>(BlockData[Block]);
+		});
+		bParametersBound = true;
+	}
+
+	virtual void UnbindPolicyParameters() override
+	{
+		if (!bParametersBound)
+		{
+			return;
+		}
+
+		ForEachParameterMatrix(Actor, [this](auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			FMemory::Memcpy(OwnedActorParameters[Block], Parameters._data, MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS * sizeof(T));
+		});
+		RestoreOwnedParameters();
+	}
+
+	virtual int32 GetReplayBufferCapacity() const override { return REPLAY_BUFFER_CAPACITY; }
+	virtual int32 GetTrainingBatchSize() const override { return TRAINING_BATCH_SIZE; }
+
+	virtual int32 GetReplayBufferSize() const override
+	{
+		return rl_tools::size(device, ReplayBuffer);
+	}
+
+	virtual SIZE_T GetArenaSize() const override
+	{
+		return Arena.GetSize() + (ReplayBufferArena ? ReplayBufferArena->GetSize() : 0);
+	}
+
+	virtual int64 GetArenaAllocations() const override
+	{
+		return Arena.GetAllocations() + (ReplayBufferArena ? ReplayBufferArena->GetAllocations() : 0);
+	}
+
+	virtual void ResetTraining() override
+	{
+		rl_tools::init(device, ActorCritic, rng);
+		rl_tools::init(device, ReplayBuffer);
+		rl_tools::init(device, Priorities);
+		PrioritizedTickets = 0;
+		NumUpdates = 0;
+		SyncInferenceActor();
+
+		// Rollouts act uniformly again until the fresh actor has been trained and published
+		PublishedSnapshot.store(INDEX_NONE);
+	}
+
+	virtual bool OpenReplayBufferFile(const FString& FilePath) override
+	{
+		if (ReplayBufferFile && ReplayBufferFile->GetFilePath() == FilePath)
+		{
+			return true;
+		}
+
+		FRLReplayBufferFileLayout Layout;
+		Layout.ObservationDim = OBSERVATION_DIM;
+		Layout.ActionDim = ACTION_DIM;
+		Layout.RowElements = REPLAY_BUFFER_TYPE::DATA_COLS;
+		Layout.ElementSize = sizeof(REPLAY_BUFFER_STORAGE_T);
+		Layout.ScalarElements = REPLAY_BUFFER_TYPE::SEPARATE_SCALARS ? REPLAY_BUFFER_TYPE::SCALAR_COLS : 0;
+		Layout.SequenceSize = sizeof(TI);
+		Layout.Capacity = REPLAY_BUFFER_CAPACITY;
+
+		TUniquePtr<FRLReplayBufferFile> NewFile = MakeUnique<FRLReplayBufferFile>();
+		if (!NewFile->Open(FilePath, Layout))
+		{
+			return false;
+		}
+
+		if (ReplayBufferFile)
+		{
+			DetachReplayBufferFile();
+		}
+		ReplayBufferFile = MoveTemp(NewFile);
+
+		// The file's pages take the place of the in-memory rows and sequence numbers, which are freed; the views only
+		// need re-pointing
+		ReplayBufferArena.Reset();
+		ReplayBuffer.data._data = static_cast<REPLAY_BUFFER_STORAGE_T*>(ReplayBufferFile->GetRows());
+		if constexpr (REPLAY_BUFFER_TYPE::SEPARATE_SCALARS)
+		{
+			ReplayBuffer.scalars._data = static_cast<T*>(ReplayBufferFile->GetScalars());
+		}
+		ReplayBuffer.sequence = static_cast<std::atomic<TI>*>(ReplayBufferFile->GetSequences());
+		rl_tools::update_views(device, ReplayBuffer);
+		rl_tools::recover(device, ReplayBuffer);
+
+		// Every surviving row starts at the maximum priority again
+		rl_tools::init(device, Priorities);
+		PrioritizedTickets = 0;
+		return true;
+	}
+
+	virtual void CloseReplayBufferFile() override
+	{
+		if (!ReplayBufferFile)
+		{
+			return;
+		}
+		DetachReplayBufferFile();
+		AllocateReplayBufferRows();
+		rl_tools::init(device, ReplayBuffer);
+		rl_tools::init(device, Priorities);
+		PrioritizedTickets = 0;
+	}
+
+	virtual void FlushReplayBufferFile() override
+	{
+		if (ReplayBufferFile)
+		{
+			ReplayBufferFile->Flush();
+		}
+	}
+
+	virtual void SetTrainingParameters(float ActorLearningRate, float CriticLearningRate, float Gamma) override
+	{
+		ActorCritic.actor_optimizer.parameters.alpha = ActorLearningRate;
+		ActorCritic.critic_optimizers[0].parameters.alpha = CriticLearningRate;
+		ActorCritic.critic_optimizers[1].parameters.alpha = CriticLearningRate;
+		ActorCritic.gamma = Gamma;
+	}
+
+	virtual void SetParallelCriticTraining(bool bParallel) override
+	{
+		bParallelCriticTraining = bParallel;
+	}
+
+	virtual void SetPrioritizedReplay(bool bEnabled, float Alpha, float Beta, int32 BetaAnnealingUpdates) override
+	{
+		bPrioritizedReplay = bEnabled;
+		PriorityAlpha = Alpha;
+		PriorityBeta = Beta;
+		PriorityBetaAnnealingUpdates = BetaAnnealingUpdates;
+	}
+
+	virtual void SetPPOParameters(int32 Epochs, float GAELambda) override
+	{
+	}
+
+	virtual void SampleTrainingActions(const float* NormalizedObservations, int32 NumRows, float* OutActions, bool bUniform) override
+	{
+		if (bUniform)
+		{
+			for (int32 Index = 0; Index < NumRows * T_ACTION_DIM; ++Index)
+			{
+				OutActions[Index] = rl_tools::random::uniform_real_distribution(device.random, (T)-1, (T)1, rng);
+			}
+			return;
+		}
+
+		EvaluateBatch(NormalizedObservations, NumRows, OutActions);
+		for (int32 Index = 0; Index < NumRows * T_ACTION_DIM; ++Index)
+		{
+			const T Noise = rl_tools::random::normal_distribution::sample(device.random, (T)0, EXPLORATION_NOISE, rng);
+			OutActions[Index] = FMath::Clamp(OutActions[Index] + Noise, (T)-1, (T)1);
+		}
+	}
+
+	virtual void AddTransition(const float* Observation, const float* Action, float Reward, const float* NextObservation, bool bTerminated, bool bTruncated) override
+	{
+		// Replay buffer rows are [observation | action | reward | next observation | terminated | truncated], with reward
+		// and flags in a separate float matrix when the rest is half precision. The row is reserved and published through
+		// the buffer's sequence numbers, so writers never contend on a lock and gather_batch skips rows that are still
+		// being written.
+		const TI Ticket = rl_tools::add_begin(device, ReplayBuffer);
+		const TI Position = Ticket % REPLAY_BUFFER_CAPACITY;
+		StoreColumns(&rl_tools::get(ReplayBuffer.observations, Position, 0), Observation, OBSERVATION_DIM);
+		StoreColumns(&rl_tools::get(ReplayBuffer.actions, Position, 0), Action, ACTION_DIM);
+		StoreColumns(&rl_tools::get(ReplayBuffer.next_observations, Position, 0), NextObservation, OBSERVATION_DIM);
+		rl_tools::set(ReplayBuffer.rewards, Position, 0, Reward);
+		rl_tools::set(ReplayBuffer.terminated, Position, 0, bTerminated ? (T)1 : (T)0);
+		rl_tools::set(ReplayBuffer.truncated, Position, 0, bTruncated ? (T)1 : (T)0);
+		rl_tools::add_commit(device, ReplayBuffer, Ticket);
+	}
+
+	virtual bool Train(int32 InNumUpdates, const FRLNormalizationPlan& ObservationNormalization) override
+	{
+		// Reserved rows may still be in flight on the rollout thread; only published ones can be sampled
+		if (rl_tools::published_size(device, ReplayBuffer) < TRAINING_BATCH_SIZE)
+		{
+			return false;
+		}
+		if (bPrioritizedReplay)
+		{
+			AssignNewPriorities();
+			if (rl_tools::total(device, Priorities) <= 0)
+			{
+				return false;
+			}
+		}
+
+		bool bActorUpdated = false;
+		bool bGathered = true;
+		for (int32 Update = 0; Update < InNumUpdates; ++Update)
+		{
+			// One batch and one draw of target policy smoothing noise, shared by both critics and the actor
+			bGathered = bPrioritizedReplay
+				? rl_tools::gather_batch(device, ReplayBuffer, Priorities, Batch, SampledRows, ImportanceWeights, GetPriorityBeta(), rng)
+				: rl_tools::gather_batch(device, ReplayBuffer, Batch, rng);
+			if (!bGathered)
+			{
+				break;
+			}
+			NormalizeRLBatchObservations(Batch, ObservationNormalization);
+			auto TargetActionNoise = rl_tools::matrix_view(device, CriticTrainingBuffers[0].target_next_action_noise);
+			rl_tools::target_action_noise(device, ActorCritic, TargetActionNoise, rng);
+
+			if (NumUpdates % TD3_PARAMETERS::CRITIC_TRAINING_INTERVAL == 0)
+			{
+				TrainCritics();
+			}
+			if (NumUpdates % TD3_PARAMETERS::ACTOR_TRAINING_INTERVAL == 0)
+			{
+				rl_tools::train_actor(device, ActorCritic, Batch, ActorCritic.actor_optimizer, TrainingActorBuffers[0], CriticBuffers[0], ActorTrainingBuffers, rng);
+				bActorUpdated = true;
+			}
+			if (NumUpdates % TD3_PARAMETERS::CRITIC_TARGET_UPDATE_INTERVAL == 0)
+			{
+				rl_tools::update_critic_targets(device, ActorCritic);
+			}
+			if (NumUpdates % TD3_PARAMETERS::ACTOR_TARGET_UPDATE_INTERVAL == 0)
+			{
+				rl_tools::update_actor_target(device, ActorCritic);
+			}
+			++NumUpdates;
+		}
+
+		if (bActorUpdated)
+		{
+			if (bAsyncLearner)
+			{
+				PublishPolicySnapshot(ObservationNormalization);
+			}
+			else
+			{
+				SyncInferenceActor();
+			}
+		}
+		return bGathered;
+	}
+
+	virtual void SetAsyncLearner(bool bAsync) override
+	{
+		if (bAsyncLearner && !bAsync)
+		{
+			SyncInferenceActor();
+		}
+		bAsyncLearner = bAsync;
+	}
+
+	virtual bool PublishPolicySnapshot(const FRLNormalizationPlan& ObservationNormalization) override
+	{
+		const int32 Published = PublishedSnapshot.load();
+		const int32 Back = Published == INDEX_NONE ? 0 : 1 - Published;
+		if (PinnedSnapshot.load() == Back)
+		{
+			// The rollout thread has not moved on to the current snapshot yet; the next publish catches up
+			return false;
+		}
+
+		FPolicySnapshot& Snapshot = PolicySnapshots[Back];
+		ForEachParameterMatrix(ActorCritic.actor.content, [this, &Snapshot](const auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			static_assert(MATRIX_SPEC::ROW_PITCH == MATRIX_SPEC::COLS, "Policy parameter blocks must be dense");
+			FMemory::Memcpy(Snapshot.Parameters.GetData() + SnapshotBlockOffsets[Block], Parameters._data, MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS * sizeof(T));
+		});
+		// Same dimensions every time, so the plan's arrays are reused rather than reallocated
+		Snapshot.ObservationNormalization = ObservationNormalization;
+
+		PublishedSnapshot.store(Back);
+		return true;
+	}
+
+	virtual void SampleRolloutActions(const float* Observations, int32 NumRows, float* OutActions) override
+	{
+		const int32 Snapshot = PinPolicySnapshot();
+		if (Snapshot == INDEX_NONE)
+		{
+			for (int32 Index = 0; Index < NumRows * T_ACTION_DIM; ++Index)
+			{
+				OutActions[Index] = rl_tools::random::uniform_real_distribution(RolloutDevice.random, (T)-1, (T)1, RolloutRng);
+			}
+			return;
+		}
+
+		if (Snapshot != BoundRolloutSnapshot)
+		{
+			T* SnapshotParameters = PolicySnapshots[Snapshot].Parameters.GetData();
+			ForEachParameterMatrix(RolloutActor, [this, SnapshotParameters](auto& Parameters, int32 Block)
+			{
+				Parameters._data = SnapshotParameters + SnapshotBlockOffsets[Block];
+			});
+			BoundRolloutSnapshot = Snapshot;
+		}
+
+		const FRLNormalizationPlan& Normalization = PolicySnapshots[Snapshot].ObservationNormalization;
+		for (int32 RowStart = 0; RowStart < NumRows; RowStart += INFERENCE_BATCH_SIZE)
+		{
+			const int32 ChunkRows = FMath::Min<int32>(INFERENCE_BATCH_SIZE, NumRows - RowStart);
+			Normalization.Apply(MakeArrayView(Observations + RowStart * OBSERVATION_DIM, ChunkRows * OBSERVATION_DIM),
+				MakeArrayView(rl_tools::data(RolloutInput), ChunkRows * OBSERVATION_DIM));
+			rl_tools::evaluate(RolloutDevice, RolloutActor, RolloutInput, RolloutOutput, RolloutEvalBuffer, RolloutRng);
+
+			const T* ChunkActions = rl_tools::data(RolloutOutput);
+			float* ChunkOut = OutActions + RowStart * ACTION_DIM;
+			for (int32 Index = 0; Index < ChunkRows * T_ACTION_DIM; ++Index)
+			{
+				const T Noise = rl_tools::random::normal_distribution::sample(RolloutDevice.random, (T)0, EXPLORATION_NOISE, RolloutRng);
+				ChunkOut[Index] = FMath::Clamp(ChunkActions[Index] + Noise, (T)-1, (T)1);
+			}
+		}
+	}
+
+private:
+	// Storage of every container below but the replay buffer rows, for both devices
+	FRLAgentArena Arena;
+	DEVICE device;
+	RNG rng;
+
+	ACTOR_TYPE Actor;
+	ACTOR_BUFFER_TYPE ActorEvalBuffer;
+	INFERENCE_INPUT_TYPE InferenceInput;
+	INFERENCE_OUTPUT_TYPE InferenceOutput;
+	INFERENCE_SINGLE_INPUT_TYPE InferenceSingleInput;
+	INFERENCE_SINGLE_OUTPUT_TYPE InferenceSingleOutput;
+
+	ACTOR_CRITIC_TYPE ActorCritic;
+	ACTOR_TRAINING_BUFFERS_TYPE ActorTrainingBuffers;
+	// One per critic so their regressions can run concurrently; [0] also holds the target noise and shared targets
+	CRITIC_TRAINING_BUFFERS_TYPE CriticTrainingBuffers[2];
+	TRAINING_ACTOR_BUFFER_TYPE TrainingActorBuffers[2];
+	CRITIC_BUFFER_TYPE CriticBuffers[2];
+	REPLAY_BUFFER_TYPE ReplayBuffer;
+	BATCH_TYPE Batch;
+	// ReplayBuffer's rows, scalars and sequence numbers live in exactly one of these: a block of their own, or the
+	// mapping of a replay buffer file
+	TUniquePtr<FRLAgentArena> ReplayBufferArena;
+	TUniquePtr<FRLReplayBufferFile> ReplayBufferFile;
+	// The file stores the sequence numbers as plain TI
+	static_assert(sizeof(std::atomic<TI>) == sizeof(TI) && std::atomic<TI>::is_always_lock_free, "Replay buffer sequence numbers must be lock-free TI");
+
+	// Prioritized replay: one leaf per replay buffer row, assigned by the learner once the row is published. Tickets
+	// below PrioritizedTickets have their priority.
+	SUM_TREE_TYPE Priorities;
+	TI PrioritizedTickets = 0;
+	// Rows of the last prioritized batch, their importance weights and each critic's TD errors on them
+	SAMPLED_ROWS_TYPE SampledRows;
+	SAMPLE_VALUES_TYPE ImportanceWeights;
+	SAMPLE_VALUES_TYPE TDErrors[2];
+	bool bPrioritizedReplay = false;
+	T PriorityAlpha = 0.6;
+	T PriorityBeta = 0.4;
+	int32 PriorityBetaAnnealingUpdates = 100000;
+
+	// TD3 updates run since ResetTraining; drives the delayed actor and target updates
+	TI NumUpdates = 0;
+
+	// Rollout side of the actor/learner split, only touched by SampleRolloutActions
+	DEVICE RolloutDevice;
+	RNG RolloutRng;
+	ACTOR_TYPE RolloutActor;
+	ACTOR_BUFFER_TYPE RolloutEvalBuffer;
+	INFERENCE_INPUT_TYPE RolloutInput;
+	INFERENCE_OUTPUT_TYPE RolloutOutput;
+	int32 BoundRolloutSnapshot = INDEX_NONE;
+
+	struct FPolicySnapshot
+	{
+		// Actor parameter blocks back to back, starting at SnapshotBlockOffsets
+		TArray<T> Parameters;
+		FRLNormalizationPlan ObservationNormalization;
+	};
+	FPolicySnapshot PolicySnapshots[2];
+	int32 SnapshotBlockOffsets[NUM_PARAMETER_BLOCKS] = {};
+
+	// Index of the snapshot rollouts should use (written by the learner) and of the one the rollout thread reads
+	// (written by the rollout thread); INDEX_NONE for none
+	std::atomic<int32> PublishedSnapshot{INDEX_NONE};
+	std::atomic<int32> PinnedSnapshot{INDEX_NONE};
+
+	bool bAsyncLearner = false;
+
+	// The inference actor's own parameter storage, kept while it is bound to external blocks
+	T* OwnedActorParameters[NUM_PARAMETER_BLOCKS] = {};
+	bool bParametersBound = false;
+
+	bool bParallelCriticTraining = false;
+	// Device of the second critic's regression, so the two lanes of TrainCritics share no device or logger state
+	DEVICE CriticLaneDevice;
+
+	// Calls Function(ParameterMatrix, BlockIndex) for each dense parameter matrix of an actor MLP, in the order of
+	// GetPolicyParameterBlocks
+	template <typename NETWORK, typename FUNCTION>
+	static void ForEachParameterMatrix(NETWORK& Network, FUNCTION&& Function)
+	{
+		int32 Block = 0;
+		Function(Network.input_layer.weights.parameters, Block++);
+		Function(Network.input_layer.biases.parameters, Block++);
+		for (TI Layer = 0; Layer < ACTOR_TYPE::NUM_HIDDEN_LAYERS; ++Layer)
+		{
+			Function(Network.hidden_layers[Layer].weights.parameters, Block++);
+			Function(Network.hidden_layers[Layer].biases.parameters, Block++);
+		}
+		Function(Network.output_layer.weights.parameters, Block++);
+		Function(Network.output_layer.biases.parameters, Block++);
+	}
+
+	void RestoreOwnedParameters()
+	{
+		if (!bParametersBound)
+		{
+			return;
+		}
+
+		ForEachParameterMatrix(Actor, [this](auto& Parameters, int32 Block)
+		{
+			Parameters._data = OwnedActorParameters[Block];
+		});
+		bParametersBound = false;
+	}
+
+	void SyncInferenceActor()
+	{
+		// Bound parameters may be read-only; the copy below overwrites them anyway
+		RestoreOwnedParameters();
+
+		// Same MLP configuration, so only the weights are copied (the gradient and optimizer state stay behind)
+		rl_tools::copy(device, device, ActorCritic.actor.content, Actor);
+	}
+
+	// Rollout thread: pins the published snapshot so the learner leaves it alone. The index is re-read after pinning:
+	// if a publish slipped in between, the pin may have landed on the learner's back buffer and is moved on.
+	int32 PinPolicySnapshot()
+	{
+		int32 Snapshot = PublishedSnapshot.load();
+		for (;;)
+		{
+			PinnedSnapshot.store(Snapshot);
+			const int32 Current = PublishedSnapshot.load();
+			if (Current == Snapshot)
+			{
+				return Snapshot;
+			}
+			Snapshot = Current;
+		}
+	}
+
+	void TrainCritics()
+	{
+		// Both critics regress onto the same clipped double-Q targets, so they are computed once from the shared batch
+		// and noise. The two regressions touch disjoint critics, optimizers and buffers and can then run side by side.
+		rl_tools::critic_targets(device, ActorCritic, Batch, TrainingActorBuffers[0], CriticBuffers[0], CriticTrainingBuffers[0], rng);
+		rl_tools::copy(device, device, CriticTrainingBuffers[0].target_action_value, CriticTrainingBuffers[1].target_action_value);
+
+		// Dense critics draw nothing from the rng; each worker still gets its own copy so they never share state
+		RNG CriticRngs[2] = {rng, rng};
+		ParallelFor(2, [this, &CriticRngs](int32 CriticIndex)
+		{
+			DEVICE& LaneDevice = CriticIndex == 0 ? device : CriticLaneDevice;
+			auto& Critic = CriticIndex == 0 ? ActorCritic.critic_1 : ActorCritic.critic_2;
+			if (bPrioritizedReplay)
+			{
+				rl_tools::train_critic_on_targets(LaneDevice, ActorCritic, Critic, Batch, ActorCritic.critic_optimizers[CriticIndex], CriticBuffers[CriticIndex], CriticTrainingBuffers[CriticIndex], ImportanceWeights, TDErrors[CriticIndex], CriticRngs[CriticIndex]);
+			}
+			else
+			{
+				rl_tools::train_critic_on_targets(LaneDevice, ActorCritic, Critic, Batch, ActorCritic.critic_optimizers[CriticIndex], CriticBuffers[CriticIndex], CriticTrainingBuffers[CriticIndex], CriticRngs[CriticIndex]);
+			}
+		}, !bParallelCriticTraining);
+		rng = CriticRngs[0];
+
+		if (bPrioritizedReplay)
+		{
+			// Each sampled row is reprioritized by the mean absolute TD error of the two critics
+			for (TI BatchRow = 0; BatchRow < TRAINING_BATCH_SIZE; ++BatchRow)
+			{
+				const T TDError = (FMath::Abs(rl_tools::get(device, TDErrors[0], 0, BatchRow, 0)) + FMath::Abs(rl_tools::get(device, TDErrors[1], 0, BatchRow, 0))) / 2;
+				rl_tools::update_priority(device, Priorities, rl_tools::get(SampledRows, 0, BatchRow), TDError, PriorityAlpha, PRIORITY_EPSILON);
+			}
+		}
+	}
+
+	// Copies Num floats into replay buffer storage, rounding them when it is half precision
+	static void StoreColumns(REPLAY_BUFFER_STORAGE_T* Target, const T* Source, int32 Num)
+	{
+		if constexpr (std::is_same_v<REPLAY_BUFFER_STORAGE_T, T>)
+		{
+			FMemory::Memcpy(Target, Source, Num * sizeof(T));
+		}
+		else
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				Target[Index] = REPLAY_BUFFER_STORAGE_T(Source[Index]);
+			}
+		}
+	}
+
+	// Gives ReplayBuffer in-memory rows again. They are not initialized.
+	void AllocateReplayBufferRows()
+	{
+		// A device of its own, so device keeps drawing from Arena
+		DEVICE StorageDevice;
+		ReplayBufferArena = MakeUnique<FRLAgentArena>();
+		ReplayBufferArena->Allocate([this, &StorageDevice]()
+		{
+			rl_tools::malloc(StorageDevice, ReplayBuffer);
+		}, StorageDevice);
+	}
+
+	// Flushes and unmaps the replay buffer file, leaving ReplayBuffer without storage until it is pointed somewhere again
+	void DetachReplayBufferFile()
+	{
+		ReplayBufferFile.Reset();
+		ReplayBuffer.data._data = nullptr;
+		ReplayBuffer.scalars._data = nullptr;
+		ReplayBuffer.sequence = nullptr;
+	}
+
+	// Gives every row published since the last call the maximum priority seen so far. Rows a concurrent writer still
+	// holds stop the scan and are picked up by the next call; rows that were overwritten since are skipped.
+	void AssignNewPriorities()
+	{
+		const TI ReservedTickets = ReplayBuffer.next_ticket.load(std::memory_order_acquire);
+		TI Ticket = FMath::Max(PrioritizedTickets, ReservedTickets > REPLAY_BUFFER_CAPACITY ? ReservedTickets - REPLAY_BUFFER_CAPACITY : (TI)0);
+		for (; Ticket < ReservedTickets && rl_tools::published(device, ReplayBuffer, Ticket); ++Ticket)
+		{
+			rl_tools::set_priority(device, Priorities, Ticket % REPLAY_BUFFER_CAPACITY, Priorities.max_priority);
+		}
+		PrioritizedTickets = Ticket;
+	}
+
+	T GetPriorityBeta() const
+	{
+		if (PriorityBetaAnnealingUpdates <= 0)
+		{
+			return 1;
+		}
+		const T Progress = FMath::Min((T)NumUpdates / PriorityBetaAnnealingUpdates, (T)1);
+		return PriorityBeta + ((T)1 - PriorityBeta) * Progress;
+	}
+};
+
+/**
+ * Registry of pre-instantiated agent backends keyed by (Algorithm, ObservationDim, ActionDim, HiddenDim).
+ *
+ * Each algorithm registers its default grid from its own translation unit (see RLAgentBackendGrid.h); SAC and PPO cover
+ * fewer shapes than TD3. A shape outside of them can be added from any translation unit of this module with
+ * UERL_REGISTER_AGENT_BACKEND(Obs, Act, Hidden) for TD3,
+ * UERL_REGISTER_SAC_AGENT_BACKEND(Obs, Act, Hidden) (RLSACAgentBackend.h) for SAC or
+ * UERL_REGISTER_PPO_AGENT_BACKEND(Obs, Act, Hidden) (RLPPOAgentBackend.h) for PPO.
+ */
+class FRLAgentBackendRegistry
+{
+public:
+	using FFactory = IRLAgentBackend* (*)(uint32 Seed);
+
+	static FRLAgentBackendRegistry& Get();
+
+	void Register(ERLAlgorithm Algorithm, int32 ObservationDim, int32 ActionDim, int32 HiddenDim, FFactory Factory);
+
+	bool IsSupported(ERLAlgorithm Algorithm, int32 ObservationDim, int32 ActionDim, int32 HiddenDim) const;
+
+	// Returns a new backend owned by the caller, or nullptr if the shape was not registered for the algorithm
+	IRLAgentBackend* Create(ERLAlgorithm Algorithm, int32 ObservationDim, int32 ActionDim, int32 HiddenDim, uint32 Seed = 0) const;
+
+	// Human-readable list of the shapes registered for an algorithm, used for error messages
+	FString DescribeRegisteredShapes(ERLAlgorithm Algorithm) const;
+
+private:
+	FRLAgentBackendRegistry();
+
+	static uint64 MakeKey(ERLAlgorithm Algorithm, int32 ObservationDim, int32 ActionDim, int32 HiddenDim)
+	{
+		return (uint64(Algorithm) << 48) | (uint64(uint16(ObservationDim)) << 32) | (uint64(uint16(ActionDim)) << 16) | uint64(uint16(HiddenDim));
+	}
+
+	TMap<uint64, FFactory> Factories;
+};
+
+template <int32 OBSERVATION_DIM, int32 ACTION_DIM, int32 HIDDEN_DIM>
+IRLAgentBackend* CreateRLAgentBackend(uint32 Seed)
+{
+	return new TRLAgentBackend<OBSERVATION_DIM, ACTION_DIM, HIDDEN_DIM>(Seed);
+}
+
+#define UERL_REGISTER_AGENT_BACKEND(ObservationDim, ActionDim, HiddenDim) \
+	static const bool PREPROCESSOR_JOIN(GUERLAgentBackendRegistered_, __LINE__) = \
+		(FRLAgentBackendRegistry::Get().Register(ERLAlgorithm::TD3, ObservationDim, ActionDim, HiddenDim, &CreateRLAgentBackend<ObservationDim, ActionDim, HiddenDim>), true);
@@ -0,0 +1,45 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "RLAgentBackend.h"
+#include "Templates/IntegerSequence.h"
+
+/**
+ * Registration of the pre-instantiated backend shapes. Every entry of a grid is a full template instantiation of the
+ * algorithm's networks, so each algorithm registers its grid from its own translation unit
+ * (RLAgentBackendRegistry.cpp, RLSACAgentBackendRegistry.cpp, RLPPOAgentBackendRegistry.cpp) to keep any single one of
+ * them from compiling every shape of every algorithm.
+ */
+namespace UERLAgentBackendGrid
+{
+	template <template <int32, int32, int32> class BACKEND, int32 OBSERVATION_DIM, int32 ACTION_DIM, int32 HIDDEN_DIM>
+	IRLAgentBackend* CreateBackend(uint32 Seed)
+	{
+		return new BACKEND<OBSERVATION_DIM, ACTION_DIM, HIDDEN_DIM>(Seed);
+	}
+
+	template <template <int32, int32, int32> class BACKEND, int32 ACTION_DIM, int32 HIDDEN_DIM, int32... OBSERVATION_DIMS>
+	void RegisterObservationDims(FRLAgentBackendRegistry& Registry, ERLAlgorithm Algorithm, TIntegerSequence<int32, OBSERVATION_DIMS...>)
+	{
+		(Registry.Register(Algorithm, OBSERVATION_DIMS, ACTION_DIM, HIDDEN_DIM, &CreateBackend<BACKEND, OBSERVATION_DIMS, ACTION_DIM, HIDDEN_DIM>), ...);
+	}
+
+	template <template <int32, int32, int32> class BACKEND, typename OBSERVATION_DIMS, int32 HIDDEN_DIM, int32... ACTION_DIMS>
+	void RegisterActionDims(FRLAgentBackendRegistry& Registry, ERLAlgorithm Algorithm, TIntegerSequence<int32, ACTION_DIMS...>)
+	{
+		(RegisterObservationDims<BACKEND, ACTION_DIMS, HIDDEN_DIM>(Registry, Algorithm, OBSERVATION_DIMS{}), ...);
+	}
+
+	// Registers BACKEND for every combination of the three dimension lists
+	template <template <int32, int32, int32> class BACKEND, typename OBSERVATION_DIMS, typename ACTION_DIMS, int32... HIDDEN_DIMS>
+	void RegisterGrid(FRLAgentBackendRegistry& Registry, ERLAlgorithm Algorithm, TIntegerSequence<int32, HIDDEN_DIMS...>)
+	{
+		(RegisterActionDims<BACKEND, OBSERVATION_DIMS, HIDDEN_DIMS>(Registry, Algorithm, ACTION_DIMS{}), ...);
+	}
+
+	// Defined in the algorithm's registry translation unit, called from the registry constructor
+	void RegisterTD3Backends(FRLAgentBackendRegistry& Registry);
+	void RegisterSACBackends(FRLAgentBackendRegistry& Registry);
+	void RegisterPPOBackends(FRLAgentBackendRegistry& Registry);
+}
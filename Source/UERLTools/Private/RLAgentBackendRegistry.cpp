@@ -0,0 +1,85 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#include "RLAgentBackendGrid.h"
+#include "UObject/Class.h"
+
+// Module-wide log categories
+#include "UERLLog.h"
+
+namespace UERLAgentBackendGrid
+{
+	// TD3 grid. SAC and PPO register a smaller one of their own (RLSACAgentBackendRegistry.cpp,
+	// RLPPOAgentBackendRegistry.cpp); this list trades plugin compile time for the set of environments that work without
+	// touching C++.
+	using FTD3ObservationDims = TIntegerSequence<int32, 1, 2, 3, 4, 5, 6, 8, 10, 12, 16, 24, 32>;
+	using FTD3ActionDims = TIntegerSequence<int32, 1, 2, 3, 4, 6, 8>;
+	using FTD3HiddenDims = TIntegerSequence<int32, 64, 128>;
+
+	void RegisterTD3Backends(FRLAgentBackendRegistry& Registry)
+	{
+		RegisterGrid<TRLAgentBackend, FTD3ObservationDims, FTD3ActionDims>(Registry, ERLAlgorithm::TD3, FTD3HiddenDims{});
+	}
+}
+
+FRLAgentBackendRegistry& FRLAgentBackendRegistry::Get()
+{
+	// Function-local static so UERL_REGISTER_AGENT_BACKEND can run from other translation units' static initializers
+	static FRLAgentBackendRegistry Registry;
+	return Registry;
+}
+
+FRLAgentBackendRegistry::FRLAgentBackendRegistry()
+{
+	UERLAgentBackendGrid::RegisterTD3Backends(*this);
+	UERLAgentBackendGrid::RegisterSACBackends(*this);
+	UERLAgentBackendGrid::RegisterPPOBackends(*this);
+}
+
+void FRLAgentBackendRegistry::Register(ERLAlgorithm Algorithm, int32 ObservationDim, int32 ActionDim, int32 HiddenDim, FFactory Factory)
+{
+	check(ObservationDim > 0 && ObservationDim <= MAX_uint16);
+	check(ActionDim > 0 && ActionDim <= MAX_uint16);
+	check(HiddenDim > 0 && HiddenDim <= MAX_uint16);
+	Factories.Add(MakeKey(Algorithm, ObservationDim, ActionDim, HiddenDim), Factory);
+}
+
+bool FRLAgentBackendRegistry::IsSupported(ERLAlgorithm Algorithm, int32 ObservationDim, int32 ActionDim, int32 HiddenDim) const
+{
+	// Same range Register enforces: MakeKey packs each dim into 16 bits, so a larger one would alias a registered shape
+	if (ObservationDim <= 0 || ObservationDim > MAX_uint16
+		|| ActionDim <= 0 || ActionDim > MAX_uint16
+		|| HiddenDim <= 0 || HiddenDim > MAX_uint16)
+	{
+		return false;
+	}
+	return Factories.Contains(MakeKey(Algorithm, ObservationDim, ActionDim, HiddenDim));
+}
+
+IRLAgentBackend* FRLAgentBackendRegistry::Create(ERLAlgorithm Algorithm, int32 ObservationDim, int32 ActionDim, int32 HiddenDim, uint32 Seed) const
+{
+	if (!IsSupported(Algorithm, ObservationDim, ActionDim, HiddenDim))
+	{
+		UERL_ERROR( TEXT("FRLAgentBackendRegistry::Create() - No %s backend registered for Obs: %d, Act: %d, Hidden: %d"),
+			*UEnum::GetDisplayValueAsText(Algorithm).ToString(), ObservationDim, ActionDim, HiddenDim);
+		return nullptr;
+	}
+	return Factories.FindChecked(MakeKey(Algorithm, ObservationDim, ActionDim, HiddenDim))(Seed);
+}
+
+FString FRLAgentBackendRegistry::DescribeRegisteredShapes(ERLAlgorithm Algorithm) const
+{
+	TArray<uint64> Keys;
+	Factories.GetKeys(Keys);
+	Keys.Sort();
+
+	TArray<FString> Shapes;
+	Shapes.Reserve(Keys.Num());
+	for (uint64 Key : Keys)
+	{
+		if ((Key >> 48) == uint64(Algorithm))
+		{
+			Shapes.Add(FString::Printf(TEXT("(%d, %d, %d)"), int32((Key >> 32) & 0xFFFF), int32((Key >> 16) & 0xFFFF), int32(Key & 0xFFFF)));
+		}
+	}
+	return FString::Join(Shapes, TEXT(", "));
+}
@@ -2,9 +2,15 @@
 
 #include "RLAgentManager.h"
 #include "Engine/World.h"
+#include "Engine/GameViewportClient.h"
 #include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/UniquePtr.h"
 #include <exception> // Required for std::exception
 
+#include "RLAgentBackend.h"
+
 // Module-wide log categories
 #include "UERLLog.h"
 
@@ -13,13 +19,13 @@ URLAgentManager::URLAgentManager()
 	// Initialize state
 	bIsInitialized = false;
 	bTrainingPaused = false;
-	EpisodeStepCount = 0;
-	EpisodeReward = 0.0f;
+	bDisabledWorldRendering = false;
 	EnvironmentComponent = nullptr;
-	ActorNetwork = nullptr;
-	CriticNetwork = nullptr;
-	EnvironmentAdapterInstance = nullptr;
-	RltContext = nullptr;
+	Backend = nullptr;
+	ObservationDim = 0;
+	ActionDim = 0;
+	PendingUpdates = 0.0f;
+	StepsSinceUpdate = 0;
 
 	// Initialize training status
 	TrainingStatus.bIsTraining = false;
@@ -28,73 +34,13 @@ URLAgentManager::URLAgentManager()
 	TrainingStatus.AverageReward = 0.0f;
 	TrainingStatus.LastEpisodeReward = 0.0f;
 	TrainingStatus.ReplayBufferSize = 0;
+	LearnerStatus = TrainingStatus;
+	PublishedStatus = TrainingStatus;
 }
 
 bool URLAgentManager::InitializeAgent(URLEnvironmentComponent* InEnvironmentComponent, const FLocalRLTrainingConfig& InTrainingConfig)
 {
-    if (!InEnvironmentComponent)
-    {
-        UERL_ERROR( TEXT("URLAgentManager::InitializeAgent() - Environment component is null"));
-        return false;
-    }
-
-    // Store references early for ValidateEnvironment if it needs them
-    EnvironmentComponent = InEnvironmentComponent; 
-    TrainingConfig = InTrainingConfig;
-
-    if (!ValidateEnvironment()) // ValidateEnvironment might use EnvironmentComponent
-    {
-        UERL_ERROR( TEXT("URLAgentManager::InitializeAgent() - Environment validation failed"));
-        return false;
-    }
-
-    CleanupNetworks(); // Call this before new allocations
-
-    try
-    {
-        TI ObservationDim = EnvironmentComponent->GetObservationDim();
-        TI ActionDim = EnvironmentComponent->GetActionDim();
-
-        UERL_LOG( TEXT("URLAgentManager::InitializeAgent() - Runtime Obs Dim: %d, Action Dim: %d"), ObservationDim, ActionDim);
-        UERL_LOG( TEXT("URLAgentManager::InitializeAgent() - Spec    Obs Dim: %d, Action Dim: %d"), UERLAgentEnvironmentSpec::OBSERVATION_DIM, UERLAgentEnvironmentSpec::ACTION_DIM);
-
-        if (ObservationDim != UERLAgentEnvironmentSpec::OBSERVATION_DIM || ActionDim != UERLAgentEnvironmentSpec::ACTION_DIM)
-        {
-            UERL_ERROR( TEXT("URLAgentManager::InitializeAgent() - Environment dimensions (Obs: %d, Act: %d) do not match UERLAgentEnvironmentSpec dimensions (Obs: %d, Act: %d). Please update UERLAgentEnvironmentSpec in RLAgentManager.h or check environment component configuration."),
-                ObservationDim, ActionDim, UERLAgentEnvironmentSpec::OBSERVATION_DIM, UERLAgentEnvironmentSpec::ACTION_DIM);
-            return false;
-        }
-
-        EnvironmentAdapterInstance = new ENVIRONMENT_ADAPTER_TYPE(device, EnvironmentComponent, TrainingConfig.ObservationNormalizationParams, TrainingConfig.ActionNormalizationParams);
-        UERL_LOG( TEXT("URLAgentManager::InitializeAgent() - UEEnvironmentAdapter instantiated successfully."));
-
-        // ... (placeholder for actual network initialization) ...
-        // For example, if ActorNetwork and CriticNetwork were to be initialized here:
-        // ActorNetwork = new ActorNetworkType();
-        // CriticNetwork = new CriticNetworkType();
-        // rl_tools::malloc(device, *ActorNetwork);
-        // rl_tools::malloc(device, *CriticNetwork);
-        // rl_tools::init_weights(device, *ActorNetwork, device.random_float_cpu);
-        // rl_tools::init_weights(device, *CriticNetwork, device.random_float_cpu);
-
-        bIsInitialized = true;
-        UERL_LOG( TEXT("URLAgentManager::InitializeAgent() - Agent initialized successfully"));
-        return true;
-    }
-    catch (const std::exception& e)
-    {
-        UERL_ERROR( TEXT("URLAgentManager::InitializeAgent() - Standard exception during initialization: %s"), ANSI_TO_TCHAR(e.what()));
-        CleanupNetworks();
-        bIsInitialized = false;
-        return false;
-    }
-    catch (...)
-    {
-        UERL_ERROR( TEXT("URLAgentManager::InitializeAgent() - Unknown exception during initialization"));
-        CleanupNetworks();
-        bIsInitialized = false;
-        return false;
-    }
+    return InitializeAgentLogic(InEnvironmentComponent, InTrainingConfig, AgentName);
 }
 
 bool URLAgentManager::StartTraining()
@@ -111,16 +57,51 @@ bool URLAgentManager::StartTraining()
 		return true;
 	}
 
-	// Reset training state
-	TrainingStatus.bIsTraining = true;
-	TrainingStatus.CurrentStep = 0;
-	TrainingStatus.CurrentEpisode = 0;
-	bTrainingPaused = false;
+	// Headless environments leave their owners alone from the first reset on
+	if (TrainingConfig.bHeadlessTraining)
+	{
+		SetHeadlessEnvironments(true);
+	}
 
-	// Reset environment
-	CurrentObservation = EnvironmentComponent->Reset();
+	// Reset environments
+	if (!TrainingEnvironments.Reset())
+	{
+		UERL_ERROR( TEXT("URLAgentManager::StartTraining() - Failed to reset training environments"));
+		SetHeadlessEnvironments(false);
+		return false;
+	}
 
-	UERL_LOG( TEXT("URLAgentManager::StartTraining() - Training started"));
+	// Picks up normalization params edited on TrainingConfig since initialization; running statistics resume from
+	// wherever they were (fresh, or loaded with a policy)
+	ObservationStatistics.Unfreeze();
+	BuildNormalizationPlans();
+	ConfigureBackendTraining();
+
+	// Reset training state. The replay buffer and networks carry over, so a restarted run skips the warmup it already did.
+	// No learner runs yet, so the learner's status is set up here and published before anything reads it.
+	LearnerStatus.bIsTraining = true;
+	LearnerStatus.CurrentStep = 0;
+	LearnerStatus.CurrentEpisode = 0;
+	bTrainingPaused = false;
+	EpisodeStepCounts.Init(0, TrainingEnvironments.Num());
+	EpisodeReturns.Init(0.0f, TrainingEnvironments.Num());
+	EpisodeReturnStatistics.Reset(TrainingConfig.EpisodeStatisticsWindow);
+	EpisodeLengthStatistics.Reset(TrainingConfig.EpisodeStatisticsWindow);
+	UpdateTrainingStatus();
+	PendingUpdates = 0.0f;
+	StepsSinceUpdate = 0;
+	LearnerStatus.ReplayBufferSize = Backend ? Backend->GetReplayBufferSize() : 0;
+	PublishTrainingStatus();
+	TrainingStatus = LearnerStatus;
+	bTrainingActive.store(true);
+
+	if (TrainingConfig.bHeadlessTraining)
+	{
+		HeadlessTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &URLAgentManager::TickHeadlessTraining));
+	}
+
+	UERL_LOG( TEXT("URLAgentManager::StartTraining() - Training started on %d environment(s)%s"), TrainingEnvironments.Num(),
+		TrainingConfig.bHeadlessTraining ? TEXT(", headless") : TEXT(""));
 	return true;
 }
 
@@ -147,7 +128,27 @@ void URLAgentManager::StopTraining()
 	if (TrainingStatus.bIsTraining)
 	{
 		TrainingStatus.bIsTraining = false;
+		bTrainingActive.store(false);
 		bTrainingPaused = false;
+		SyncTrainingStatus();
+
+		// Safe from inside TickHeadlessTraining, which stops once the step that reached MaxTrainingSteps returns
+		RemoveHeadlessTicker();
+		SetHeadlessEnvironments(false);
+
+		// A later run, or a later process, resumes from the transitions collected so far
+		if (Backend)
+		{
+			Backend->FlushReplayBufferFile();
+		}
+
+		// Inference and SavePolicy from here on use the final statistics
+		if (TrainingConfig.bUseRunningObservationNormalization)
+		{
+			ObservationStatistics.Freeze();
+			ObservationStatistics.ToParams(TrainingConfig.ObservationNormalizationParams);
+			BuildNormalizationPlans();
+		}
 		UERL_LOG( TEXT("URLAgentManager::StopTraining() - Training stopped"));
 		
 		OnTrainingFinished.Broadcast(true);
@@ -161,55 +162,310 @@ bool URLAgentManager::StepTraining(int32 NumSteps)
 		return false;
 	}
 
+	// The game thread is the learner here, so it reads the learner's status directly and syncs TrainingStatus once
 	for (int32 i = 0; i < NumSteps; ++i)
 	{
 		if (!PerformTrainingStep())
 		{
+			SyncTrainingStatus();
 			return false;
 		}
 
 		// Check if we've reached max training steps
-		if (TrainingStatus.CurrentStep >= TrainingConfig.MaxTrainingSteps)
+		if (LearnerStatus.CurrentStep >= TrainingConfig.MaxTrainingSteps)
 		{
 			StopTraining();
 			break;
 		}
 	}
 
+	SyncTrainingStatus();
 	return true;
 }
 
-TArray<float> URLAgentManager::GetAction(const TArray<float>& Observation)
+void URLAgentManager::SetHeadlessEnvironments(bool bHeadless)
+{
+	if (EnvironmentComponent)
+	{
+		EnvironmentComponent->SetHeadless(bHeadless);
+	}
+	for (URLEnvironmentComponent* Environment : ParallelEnvironments)
+	{
+		if (Environment)
+		{
+			Environment->SetHeadless(bHeadless);
+		}
+	}
+
+	// Nothing is drawn while training runs ahead of the frames; -nullrhi builds have no viewport to switch
+	UWorld* World = EnvironmentComponent ? EnvironmentComponent->GetWorld() : nullptr;
+	UGameViewportClient* Viewport = World ? World->GetGameViewport() : nullptr;
+	if (bHeadless && Viewport && !Viewport->bDisableWorldRendering)
+	{
+		Viewport->bDisableWorldRendering = true;
+		bDisabledWorldRendering = true;
+	}
+	else if (!bHeadless && bDisabledWorldRendering)
+	{
+		if (Viewport)
+		{
+			Viewport->bDisableWorldRendering = false;
+		}
+		bDisabledWorldRendering = false;
+	}
+}
+
+bool URLAgentManager::TickHeadlessTraining(float DeltaTime)
+{
+	if (!TrainingStatus.bIsTraining)
+	{
+		HeadlessTickerHandle.Reset();
+		return false;
+	}
+
+	if (bTrainingPaused)
+	{
+		return true;
+	}
+
+	// One step at a time against the clock: a step costs far more than reading it, and the budget is overshot by at
+	// most one step (a network update for off-policy backends, a whole rollout's updates for PPO)
+	const double Deadline = FPlatformTime::Seconds() + TrainingConfig.HeadlessFrameBudgetMs * 0.001;
+	const int32 MaxSteps = FMath::Max(TrainingConfig.HeadlessMaxStepsPerFrame, 1);
+	for (int32 i = 0; i < MaxSteps; ++i)
+	{
+		if (!StepTraining(1) || !TrainingStatus.bIsTraining || FPlatformTime::Seconds() >= Deadline)
+		{
+			break;
+		}
+	}
+
+	return TrainingStatus.bIsTraining;
+}
+
+void URLAgentManager::RemoveHeadlessTicker()
+{
+	if (HeadlessTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(HeadlessTickerHandle);
+		HeadlessTickerHandle.Reset();
+	}
+}
+
+bool URLAgentManager::SetParallelEnvironments(const TArray<URLEnvironmentComponent*>& InParallelEnvironments)
 {
 	if (!bIsInitialized)
+	{
+		UERL_ERROR( TEXT("URLAgentManager::SetParallelEnvironments() - Agent not initialized"));
+		return false;
+	}
+
+	if (TrainingStatus.bIsTraining)
+	{
+		UERL_ERROR( TEXT("URLAgentManager::SetParallelEnvironments() - Cannot change environments while training"));
+		return false;
+	}
+
+	ParallelEnvironments.Reset(InParallelEnvironments.Num());
+	for (URLEnvironmentComponent* Environment : InParallelEnvironments)
+	{
+		if (Environment && Environment != EnvironmentComponent)
+		{
+			ParallelEnvironments.AddUnique(Environment);
+		}
+	}
+
+	if (!BindTrainingEnvironments())
+	{
+		// Fall back to the agent's own environment
+		ParallelEnvironments.Reset();
+		BindTrainingEnvironments();
+		return false;
+	}
+	return true;
+}
+
+bool URLAgentManager::BindTrainingEnvironments()
+{
+	TArray<URLEnvironmentComponent*> Environments;
+	Environments.Reserve(1 + ParallelEnvironments.Num());
+	Environments.Add(EnvironmentComponent);
+	Environments.Append(ParallelEnvironments);
+
+	if (!TrainingEnvironments.Bind(Environments))
+	{
+		UERL_ERROR( TEXT("URLAgentManager::BindTrainingEnvironments() - Failed to bind %d training environment(s)"), Environments.Num());
+		return false;
+	}
+
+	// Action and normalized observation batches for every environment, allocated once here rather than per step
+	CurrentAction.SetNumUninitialized(TrainingEnvironments.Num() * ActionDim);
+	EnvironmentActions.SetNumUninitialized(TrainingEnvironments.Num() * ActionDim);
+	NormalizedObservations.SetNumUninitialized(TrainingEnvironments.Num() * ObservationDim, /*bAllowShrinking=*/ false);
+	UERL_LOG( TEXT("URLAgentManager::BindTrainingEnvironments() - Training on %d environment(s)"), TrainingEnvironments.Num());
+	return true;
+}
+
+void URLAgentManager::BuildNormalizationPlans()
+{
+	// Running statistics take over from the configured params once they have seen enough data
+	const bool bUseRunningStatistics = TrainingConfig.bUseRunningObservationNormalization && !ObservationStatistics.IsFrozen()
+		&& ObservationStatistics.ToParams(RunningObservationParams);
+	ObservationNormalization.Build(bUseRunningStatistics ? RunningObservationParams : TrainingConfig.ObservationNormalizationParams,
+		ObservationDim, FRLNormalizationPlan::EDirection::Normalize);
+	ActionDenormalization.Build(TrainingConfig.ActionNormalizationParams, ActionDim, FRLNormalizationPlan::EDirection::Denormalize);
+	PublishObservationNormalization();
+
+	// The learner thread must not allocate, so its single-row buffer is sized up front
+	TrainerObservation.SetNumUninitialized(ObservationDim);
+}
+
+void URLAgentManager::UpdateObservationStatistics(TConstArrayView<float> Observations)
+{
+	if (!TrainingConfig.bUseRunningObservationNormalization || ObservationStatistics.IsFrozen())
+	{
+		return;
+	}
+
+	if (ObservationStatistics.Update(Observations) && ObservationStatistics.ToParams(RunningObservationParams))
+	{
+		ObservationNormalization.Build(RunningObservationParams, ObservationDim, FRLNormalizationPlan::EDirection::Normalize);
+		PublishObservationNormalization();
+	}
+}
+
+void URLAgentManager::PublishObservationNormalization()
+{
+	const int32 Back = 1 - PublishedInferenceNormalization.load();
+	if (PinnedInferenceNormalization.load() == Back)
+	{
+		return;
+	}
+
+	// Same dimensions every time, so the plan's arrays are reused rather than reallocated
+	InferenceObservationNormalization[Back] = ObservationNormalization;
+	PublishedInferenceNormalization.store(Back);
+}
+
+bool URLAgentManager::MergeObservationStatistics(const FRLRunningNormalizer& WorkerStatistics)
+{
+	if (!TrainingConfig.bUseRunningObservationNormalization || ObservationStatistics.IsFrozen())
+	{
+		return false;
+	}
+
+	if (!ObservationStatistics.Merge(WorkerStatistics))
+	{
+		return false;
+	}
+
+	// Only the observation plan depends on the statistics; the action plan may be in use on the game thread
+	if (ObservationStatistics.ToParams(RunningObservationParams))
+	{
+		ObservationNormalization.Build(RunningObservationParams, ObservationDim, FRLNormalizationPlan::EDirection::Normalize);
+		PublishObservationNormalization();
+	}
+	return true;
+}
+
+TConstArrayView<float> URLAgentManager::NormalizeObservations(TConstArrayView<float> Observations, TArray<float>& Scratch)
+{
+	// Pins the published plan so the learner leaves it alone. The index is re-read after pinning: if a publish slipped
+	// in between, the pin may have landed on the learner's back buffer and is moved on.
+	int32 Published = PublishedInferenceNormalization.load();
+	for (;;)
+	{
+		PinnedInferenceNormalization.store(Published);
+		const int32 Current = PublishedInferenceNormalization.load();
+		if (Current == Published)
+		{
+			break;
+		}
+		Published = Current;
+	}
+
+	const FRLNormalizationPlan& Normalization = InferenceObservationNormalization[Published];
+	TConstArrayView<float> Normalized = Observations;
+	if (!Normalization.IsIdentity())
+	{
+		Scratch.SetNumUninitialized(Observations.Num(), /*bAllowShrinking=*/ false);
+		const TArrayView<float> Destination = MakeArrayView(Scratch.GetData(), Observations.Num());
+		Normalization.Apply(Observations, Destination);
+		Normalized = Destination;
+	}
+	PinnedInferenceNormalization.store(INDEX_NONE);
+	return Normalized;
+}
+
+TArray<float> URLAgentManager::GetAction(const TArray<float>& Observation)
+{
+	if (!bIsInitialized || !Backend)
 	{
 		UERL_ERROR( TEXT("URLAgentManager::GetAction() - Agent not initialized"));
 		return TArray<float>();
 	}
 
 	// Validate observation
-	if (Observation.Num() != EnvironmentComponent->GetObservationDim())
+	if (Observation.Num() != ObservationDim)
 	{
 		UERL_ERROR( TEXT("URLAgentManager::GetAction() - Invalid observation dimension"));
 		return TArray<float>();
 	}
 
-	// For now, return random actions as placeholder
-	// In a full implementation, this would use the trained policy
 	TArray<float> Action;
-	Action.SetNum(EnvironmentComponent->GetActionDim());
-	
-	for (int32 i = 0; i < Action.Num(); ++i)
+	Action.SetNumUninitialized(ActionDim);
+	Backend->Evaluate(NormalizeObservations(Observation, NormalizedObservations).GetData(), Action.GetData());
+	ActionDenormalization.ApplyInPlace(Action);
+	return Action;
+}
+
+bool URLAgentManager::GetActionsBatched(const TArray<float>& Observations, int32 NumObservations, TArray<float>& OutActions)
+{
+	if (!bIsInitialized || !Backend)
 	{
-		Action[i] = FMath::RandRange(-1.0f, 1.0f);
+		UERL_ERROR( TEXT("URLAgentManager::GetActionsBatched() - Agent not initialized"));
+		return false;
 	}
 
-	return Action;
+	if (NumObservations < 0 || Observations.Num() != NumObservations * ObservationDim)
+	{
+		UERL_ERROR( TEXT("URLAgentManager::GetActionsBatched() - Expected %d observations of dimension %d, got %d floats"),
+			NumObservations, ObservationDim, Observations.Num());
+		return false;
+	}
+
+	// Only reallocates when the caller's array is too small; callers that keep OutActions around hit no allocation
+	OutActions.SetNumUninitialized(NumObservations * ActionDim, /*bAllowShrinking=*/ false);
+	Backend->EvaluateBatch(NormalizeObservations(Observations, NormalizedObservations).GetData(), NumObservations, OutActions.GetData());
+	ActionDenormalization.ApplyInPlace(MakeArrayView(OutActions.GetData(), NumObservations * ActionDim));
+	return true;
+}
+
+bool URLAgentManager::CreateBackend()
+{
+	const FRLAgentBackendRegistry& Registry = FRLAgentBackendRegistry::Get();
+	const FString AlgorithmName = UEnum::GetDisplayValueAsText(TrainingConfig.Algorithm).ToString();
+	if (!Registry.IsSupported(TrainingConfig.Algorithm, ObservationDim, ActionDim, TrainingConfig.HiddenDim))
+	{
+		UERL_ERROR( TEXT("URLAgentManager::CreateBackend() - No %s agent backend for Obs: %d, Act: %d, Hidden: %d. Registered (Obs, Act, Hidden): %s"),
+			*AlgorithmName, ObservationDim, ActionDim, TrainingConfig.HiddenDim, *Registry.DescribeRegisteredShapes(TrainingConfig.Algorithm));
+		return false;
+	}
+
+	Backend = Registry.Create(TrainingConfig.Algorithm, ObservationDim, ActionDim, TrainingConfig.HiddenDim);
+	if (!Backend)
+	{
+		return false;
+	}
+
+	UERL_LOG( TEXT("URLAgentManager::CreateBackend() - %s backend created (Obs: %d, Act: %d, Hidden: %d, Arena: %.1f MB)"), *AlgorithmName, ObservationDim, ActionDim,
+		TrainingConfig.HiddenDim, Backend->GetArenaSize() / (1024.0 * 1024.0));
+	return true;
 }
 
 bool URLAgentManager::LoadPolicy(const FString& FilePath)
 {
-	if (!bIsInitialized)
+	if (!bIsInitialized || !Backend)
 	{
 		UERL_ERROR( TEXT("URLAgentManager::LoadPolicy() - Agent not initialized"));
 		OnPolicyLoaded.Broadcast(false);
@@ -224,53 +480,143 @@ bool URLAgentManager::LoadPolicy(const FString& FilePath)
 		return false;
 	}
 
-	// Placeholder for actual policy loading
-	UERL_LOG( TEXT("URLAgentManager::LoadPolicy() - Policy loading not yet implemented"));
+	FRLPolicyFile Policy;
+	if (!Policy.Open(FilePath))
+	{
+		OnPolicyLoaded.Broadcast(false);
+		return false;
+	}
+	if (Policy.GetObservationDim() != ObservationDim || Policy.GetActionDim() != ActionDim || Policy.GetHiddenDim() != Backend->GetHiddenDim())
+	{
+		UERL_ERROR( TEXT("URLAgentManager::LoadPolicy() - Policy shape (Obs: %d, Act: %d, Hidden: %d) does not match the agent (Obs: %d, Act: %d, Hidden: %d)"),
+			Policy.GetObservationDim(), Policy.GetActionDim(), Policy.GetHiddenDim(), ObservationDim, ActionDim, Backend->GetHiddenDim());
+		OnPolicyLoaded.Broadcast(false);
+		return false;
+	}
+
+	TArray<FRLPolicyParameterBlock> ExpectedBlocks;
+	Backend->GetPolicyParameterBlocks(ExpectedBlocks);
+	if (Policy.GetNumParameterBlocks() != ExpectedBlocks.Num())
+	{
+		UERL_ERROR( TEXT("URLAgentManager::LoadPolicy() - Policy has %d parameter blocks, the network has %d"), Policy.GetNumParameterBlocks(), ExpectedBlocks.Num());
+		OnPolicyLoaded.Broadcast(false);
+		return false;
+	}
+
+	TArray<const float*, TInlineAllocator<16>> BlockData;
+	for (int32 Index = 0; Index < ExpectedBlocks.Num(); ++Index)
+	{
+		const FRLPolicyParameterBlock Block = Policy.GetParameterBlock(Index);
+		if (Block.Rows != ExpectedBlocks[Index].Rows || Block.Cols != ExpectedBlocks[Index].Cols)
+		{
+			UERL_ERROR( TEXT("URLAgentManager::LoadPolicy() - Parameter block %d is %dx%d, the network expects %dx%d"),
+				Index, Block.Rows, Block.Cols, ExpectedBlocks[Index].Rows, ExpectedBlocks[Index].Cols);
+			OnPolicyLoaded.Broadcast(false);
+			return false;
+		}
+		BlockData.Add(Block.Data);
+	}
+
+	FRLRunningNormalizer LoadedStatistics;
+	if (!Policy.ReadObservationStatistics(LoadedStatistics))
+	{
+		UERL_ERROR( TEXT("URLAgentManager::LoadPolicy() - Corrupt observation statistics in %s"), *FilePath);
+		OnPolicyLoaded.Broadcast(false);
+		return false;
+	}
+
+	// The actor runs straight off the file's pages; the previous policy's mapping is released only once nothing points into it
+	Backend->BindPolicyParameters(BlockData);
+	LoadedPolicy = MoveTemp(Policy);
+
+	// Loaded statistics are used frozen for inference; StartTraining continues updating them
+	ObservationStatistics = MoveTemp(LoadedStatistics);
+	LoadedPolicy.ReadNormalizationParams(TrainingConfig.ObservationNormalizationParams, TrainingConfig.ActionNormalizationParams);
+	TrainingConfig.bUseRunningObservationNormalization = LoadedPolicy.UsesRunningObservationNormalization();
+	BuildNormalizationPlans();
+
+	UERL_LOG( TEXT("URLAgentManager::LoadPolicy() - Loaded %s (%d parameter blocks, %lld observation samples%s)"), *FilePath,
+		BlockData.Num(), ObservationStatistics.GetCount(), LoadedPolicy.IsMemoryMapped() ? TEXT(", memory-mapped") : TEXT(""));
 	OnPolicyLoaded.Broadcast(true);
 	return true;
 }
 
 bool URLAgentManager::SavePolicy(const FString& FilePath)
 {
-	if (!bIsInitialized)
+	if (!bIsInitialized || !Backend)
 	{
 		UERL_ERROR( TEXT("URLAgentManager::SavePolicy() - Agent not initialized"));
 		OnPolicySaved.Broadcast(false);
 		return false;
 	}
 
-	// Placeholder for actual policy saving
-	UERL_LOG( TEXT("URLAgentManager::SavePolicy() - Policy saving not yet implemented"));
-	OnPolicySaved.Broadcast(true);
-	return true;
+	FRLPolicyFileContents Contents;
+	Contents.ObservationDim = ObservationDim;
+	Contents.ActionDim = ActionDim;
+	Contents.HiddenDim = Backend->GetHiddenDim();
+	Backend->GetPolicyParameterBlocks(Contents.ParameterBlocks);
+
+	// The params stored are the ones inference uses right now (see BuildNormalizationPlans); statistics are loaded frozen
+	Contents.ObservationStatistics = &ObservationStatistics;
+	Contents.bUseRunningObservationNormalization = TrainingConfig.bUseRunningObservationNormalization;
+	const bool bUseRunningStatistics = TrainingConfig.bUseRunningObservationNormalization && !ObservationStatistics.IsFrozen()
+		&& ObservationStatistics.ToParams(Contents.ObservationNormalizationParams);
+	if (!bUseRunningStatistics)
+	{
+		Contents.ObservationNormalizationParams = TrainingConfig.ObservationNormalizationParams;
+	}
+	Contents.ActionNormalizationParams = TrainingConfig.ActionNormalizationParams;
+
+	const bool bSuccess = FRLPolicyFile::Save(FilePath, Contents);
+	if (bSuccess)
+	{
+		UERL_LOG( TEXT("URLAgentManager::SavePolicy() - Saved %s (%d parameter blocks)"), *FilePath, Contents.ParameterBlocks.Num());
+	}
+	OnPolicySaved.Broadcast(bSuccess);
+	return bSuccess;
 }
 
 void URLAgentManager::UpdateTrainingStatus()
 {
-	// Update average reward
-	if (EpisodeRewards.Num() > 0)
+	LearnerStatus.EpisodeReturn = EpisodeReturnStatistics.GetSummary();
+	LearnerStatus.EpisodeLength = EpisodeLengthStatistics.GetSummary();
+	LearnerStatus.AverageReward = LearnerStatus.EpisodeReturn.Mean;
+}
+
+void URLAgentManager::PublishTrainingStatus()
+{
+	FScopeLock Lock(&PublishedStatusLock);
+	PublishedStatus = LearnerStatus;
+}
+
+void URLAgentManager::SyncTrainingStatus()
+{
+	// bIsTraining belongs to the game thread and is kept
+	const bool bIsTraining = TrainingStatus.bIsTraining;
 	{
-		float Sum = 0.0f;
-		for (float Reward : EpisodeRewards)
-		{
-			Sum += Reward;
-		}
-		TrainingStatus.AverageReward = Sum / EpisodeRewards.Num();
+		FScopeLock Lock(&PublishedStatusLock);
+		TrainingStatus = PublishedStatus;
 	}
+	TrainingStatus.bIsTraining = bIsTraining;
+}
 
-	// Keep only last 100 episodes for average calculation
-	if (EpisodeRewards.Num() > 100)
+FRLTrainingStatus URLAgentManager::GetTrainingStatus() const
+{
+	FRLTrainingStatus Status;
 	{
-		EpisodeRewards.RemoveAt(0);
+		FScopeLock Lock(&PublishedStatusLock);
+		Status = PublishedStatus;
 	}
+	Status.bIsTraining = TrainingStatus.bIsTraining;
+	return Status;
 }
 
 void URLAgentManager::LogTrainingProgress()
 {
-	if (TrainingStatus.CurrentStep % 1000 == 0)
+	if (LearnerStatus.CurrentStep % 1000 == 0)
 	{
 		UERL_LOG( TEXT("Training Step: %d, Episode: %d, Avg Reward: %.2f"), 
-			TrainingStatus.CurrentStep, TrainingStatus.CurrentEpisode, TrainingStatus.AverageReward);
+			LearnerStatus.CurrentStep, LearnerStatus.CurrentEpisode, LearnerStatus.AverageReward);
 	}
 }
 
@@ -286,8 +632,10 @@ bool URLAgentManager::ValidateEnvironment() const
 		return false;
 	}
 
+	return true;
 }
-bool URLAgentManager::InitializeAgentLogic(URLEnvironmentComponent* InEnvironmentComponent, const FLocalRLTrainingConfig& InTrainingConfig, rl_tools::devices::DefaultCPU::CONTEXT_TYPE* InRltContext, FName InAgentName)
+
+bool URLAgentManager::InitializeAgentLogic(URLEnvironmentComponent* InEnvironmentComponent, const FLocalRLTrainingConfig& InTrainingConfig, FName InAgentName)
 {
     if (!InEnvironmentComponent)
     {
@@ -295,22 +643,15 @@ bool URLAgentManager::InitializeAgentLogic(URLEnvironmentComponent* InEnvironmen
         return false;
     }
 
-    if (!InRltContext)
-    {
-        UERL_ERROR(TEXT("URLAgentManager::InitializeAgentLogic() - RL tools context is null"));
-        return false;
-    }
-
     // Store references
     EnvironmentComponent = InEnvironmentComponent;
     TrainingConfig = InTrainingConfig;
-    RltContext = InRltContext;
     AgentName = InAgentName;
 
     // Log initialization
-    UERL_LOG(TEXT("URLAgentManager::InitializeAgentLogic() - Initializing agent '%s' with RL tools context"), *AgentName.ToString());
+    UERL_LOG(TEXT("URLAgentManager::InitializeAgentLogic() - Initializing agent '%s'"), *AgentName.ToString());
 
-    // Validate environment dimensions match our expectations
+    // Validate environment dimensions
     if (!ValidateEnvironment())
     {
         UERL_ERROR(TEXT("URLAgentManager::InitializeAgentLogic() - Environment validation failed"));
@@ -322,22 +663,27 @@ bool URLAgentManager::InitializeAgentLogic(URLEnvironmentComponent* InEnvironmen
 
     try
     {
-        // Create environment adapter
-        EnvironmentAdapterInstance = new ENVIRONMENT_ADAPTER_TYPE(device, EnvironmentComponent, 
-            TrainingConfig.ObservationNormalizationParams, 
-            TrainingConfig.ActionNormalizationParams);
+        ObservationDim = EnvironmentComponent->GetObservationDim();
+        ActionDim = EnvironmentComponent->GetActionDim();
+        ObservationStatistics.Reset(ObservationDim);
+        BuildNormalizationPlans();
 
-        if (!EnvironmentAdapterInstance)
+        // Pick the pre-instantiated backend matching the environment; allocates the actor and its inference buffers up front
+        if (!CreateBackend())
         {
-            UERL_ERROR(TEXT("URLAgentManager::InitializeAgentLogic() - Failed to create environment adapter"));
+            UERL_ERROR(TEXT("URLAgentManager::InitializeAgentLogic() - Failed to create agent backend"));
+            CleanupNetworks();
             return false;
         }
+        ConfigureBackendTraining();
 
-        // Initialize networks and other RL components here
-        // This is a placeholder for actual network initialization
-        // ActorNetwork = new ActorNetworkType();
-        // rl_tools::malloc(device, *ActorNetwork);
-        // rl_tools::init_weights(device, *ActorNetwork, device.random_float_cpu);
+        // A (re)initialized agent starts out on its own environment; SetParallelEnvironments adds more afterwards
+        ParallelEnvironments.Reset();
+        if (!BindTrainingEnvironments())
+        {
+            CleanupNetworks();
+            return false;
+        }
 
         bIsInitialized = true;
         UERL_LOG(TEXT("URLAgentManager::InitializeAgentLogic() - Agent '%s' initialized successfully"), *AgentName.ToString());
@@ -380,15 +726,24 @@ void URLAgentManager::ShutdownAgent()
     // Reset state
     bIsInitialized = false;
     bTrainingPaused = false;
-    EpisodeStepCount = 0;
-    EpisodeReward = 0.0f;
+    EpisodeStepCounts.Reset();
+    EpisodeReturns.Reset();
+    PendingUpdates = 0.0f;
+    StepsSinceUpdate = 0;
+    ObservationStatistics.Reset(0);
+    ObservationNormalization.Reset();
+    ActionDenormalization.Reset();
+    PublishObservationNormalization();
+    TrainingEnvironments.Unbind();
+    ParallelEnvironments.Reset();
     EnvironmentComponent = nullptr;
-    RltContext = nullptr;
     AgentName = NAME_None;
+    LearnerStatus = FRLTrainingStatus();
+    PublishTrainingStatus();
     TrainingStatus = FRLTrainingStatus();
 }
 
-void URLAgentManager::~URLAgentManager()
+URLAgentManager::~URLAgentManager()
 {
     ShutdownAgent();
     UERL_LOG(TEXT("URLAgentManager destroyed."));
@@ -396,129 +751,368 @@ void URLAgentManager::~URLAgentManager()
 
 void URLAgentManager::CleanupNetworks()
 {
-    UERL_LOG(TEXT("URLAgentManager::CleanupNetworks() - Cleaning up networks and adapter..."));
+    UERL_LOG(TEXT("URLAgentManager::CleanupNetworks() - Cleaning up networks..."));
 
-    // Free network resources if they exist
-    if (ActorNetwork)
+    // The backend frees all of its rl_tools containers in its destructor
+    if (Backend)
     {
         try
         {
-            rl_tools::free(device, *ActorNetwork);
+            delete Backend;
         }
         catch (...)
         {
-            UERL_WARNING(TEXT("URLAgentManager::CleanupNetworks() - Exception while freeing actor network"));
+            UERL_WARNING(TEXT("URLAgentManager::CleanupNetworks() - Exception while freeing agent backend"));
         }
-        delete ActorNetwork;
-        ActorNetwork = nullptr;
+        Backend = nullptr;
     }
 
-    if (CriticNetwork)
+    // Unmapped only after the backend that may point into it is gone
+    LoadedPolicy.Close();
+
+    bIsInitialized = false;
+}
+
+// Implementation of PerformTrainingStep
+bool URLAgentManager::PerformTrainingStep()
+{
+    if (!bIsInitialized || !EnvironmentComponent || !Backend)
     {
-        try
+        UERL_ERROR(TEXT("URLAgentManager::PerformTrainingStep() - Agent not properly initialized"));
+        return false;
+    }
+
+    try
+    {
+        // One batched exploration pass for every training environment, into the persistent action batch (no per-step allocation)
+        const int32 NumEnvironments = TrainingEnvironments.Num();
+        CurrentAction.SetNumUninitialized(NumEnvironments * ActionDim, /*bAllowShrinking=*/ false);
+        UpdateObservationStatistics(TrainingEnvironments.GetObservations());
+        Backend->SampleTrainingActions(NormalizeObservations(TrainingEnvironments.GetObservations(), NormalizedObservations).GetData(),
+            NumEnvironments, CurrentAction.GetData(), IsWarmingUp());
+
+        // The replay buffer keeps the policy-space actions; the environments get them denormalized
+        TConstArrayView<float> StepActions = CurrentAction;
+        if (!ActionDenormalization.IsIdentity())
         {
-            rl_tools::free(device, *CriticNetwork);
+            EnvironmentActions.SetNumUninitialized(CurrentAction.Num(), /*bAllowShrinking=*/ false);
+            ActionDenormalization.Apply(CurrentAction, EnvironmentActions);
+            StepActions = EnvironmentActions;
         }
-        catch (...)
+
+        // Scatter the actions, step every environment and gather the transitions
+        if (!TrainingEnvironments.Step(StepActions))
         {
-            UERL_WARNING(TEXT("URLAgentManager::CleanupNetworks() - Exception while freeing critic network"));
+            return false;
         }
-        delete CriticNetwork;
-        CriticNetwork = nullptr;
-    }
 
-    // Free environment adapter
-    if (EnvironmentAdapterInstance)
+        // Store experience in replay buffer, raw observations so the batch is normalized with the statistics of the update
+        const TConstArrayView<float> Observations = TrainingEnvironments.GetObservations();
+        const TConstArrayView<float> NextObservations = TrainingEnvironments.GetNextObservations();
+        for (int32 EnvironmentIndex = 0; EnvironmentIndex < NumEnvironments; ++EnvironmentIndex)
+        {
+            CollectExperience(Observations.Slice(EnvironmentIndex * ObservationDim, ObservationDim),
+                TConstArrayView<float>(CurrentAction).Slice(EnvironmentIndex * ActionDim, ActionDim),
+                TrainingEnvironments.GetRewards()[EnvironmentIndex],
+                NextObservations.Slice(EnvironmentIndex * ObservationDim, ObservationDim),
+                TrainingEnvironments.IsTerminated(EnvironmentIndex), TrainingEnvironments.IsTruncated(EnvironmentIndex));
+            RecordTransition(TrainingEnvironments.GetRewards()[EnvironmentIndex], TrainingEnvironments.IsEpisodeFinished(EnvironmentIndex), EnvironmentIndex);
+        }
+        UpdateNetworks();
+
+        // Reset environments for next episode
+        return TrainingEnvironments.AdvanceEpisodes();
+    }
+    catch (const std::exception& e)
     {
-        delete EnvironmentAdapterInstance;
-        EnvironmentAdapterInstance = nullptr;
+        UERL_ERROR(TEXT("URLAgentManager::PerformTrainingStep() - Exception: %s"), ANSI_TO_TCHAR(e.what()));
+        return false;
+    }
+    catch (...)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::PerformTrainingStep() - Unknown exception"));
+        return false;
     }
-
-    bIsInitialized = false;
 }
 
-// Implementation of PerformTrainingStep
-bool URLAgentManager::PerformTrainingStep()
+bool URLAgentManager::ResetEnvironment(TArrayView<float> OutObservation)
 {
     if (!bIsInitialized || !EnvironmentComponent)
     {
-        UERL_ERROR(TEXT("URLAgentManager::PerformTrainingStep() - Agent not properly initialized"));
+        UERL_ERROR(TEXT("URLAgentManager::ResetEnvironment() - Agent not properly initialized"));
         return false;
     }
 
     try
     {
-        // Get action from current policy
-        TArray<float> Action = GetAction(CurrentObservation);
-
-        // Step environment
-        EnvironmentComponent->Step(Action);
-
-        // Get next observation and reward
-        TArray<float> NextObservation = EnvironmentComponent->GetObservation();
-        float Reward = EnvironmentComponent->CalculateReward();
+        return EnvironmentComponent->ResetInto(OutObservation);
+    }
+    catch (const std::exception& e)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::ResetEnvironment() - Exception: %s"), ANSI_TO_TCHAR(e.what()));
+        return false;
+    }
+    catch (...)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::ResetEnvironment() - Unknown exception"));
+        return false;
+    }
+}
 
-        // Store experience in replay buffer
-        // TODO: Implement experience storage when replay buffer is set up
+bool URLAgentManager::StepEnvironment(TArrayView<const float> Action, TArrayView<float> OutObservation, float& OutReward, bool& bOutTerminated, bool& bOutTruncated)
+{
+    if (!bIsInitialized || !EnvironmentComponent)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::StepEnvironment() - Agent not properly initialized"));
+        return false;
+    }
 
-        // Update training status
-        TrainingStatus.CurrentStep++;
-        EpisodeStepCount++;
-        EpisodeReward += Reward;
+    if (Action.Num() != ActionDim || OutObservation.Num() != ObservationDim)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::StepEnvironment() - Invalid action or observation dimension"));
+        return false;
+    }
 
-        // Check if episode is done
-        bool bIsDone = EnvironmentComponent->IsDone();
-        if (bIsDone || EpisodeStepCount >= TrainingConfig.MaxEpisodeSteps)
-        {
-            // Log episode completion
-            TrainingStatus.LastEpisodeReward = EpisodeReward;
-            TrainingStatus.CurrentEpisode++;
-            
-            // Reset episode-specific counters
-            EpisodeStepCount = 0;
-            EpisodeReward = 0.0f;
-
-            // Reset environment for next episode
-            CurrentObservation = EnvironmentComponent->Reset();
-        }
-        else
+    try
+    {
+        // The environment reads the action and writes the next observation in place
+        if (!EnvironmentComponent->StepInto(Action, OutObservation))
         {
-            // Update current observation for next step
-            CurrentObservation = NextObservation;
+            return false;
         }
+        OutReward = EnvironmentComponent->GetLastReward();
+        bOutTerminated = EnvironmentComponent->bIsTerminated;
+        bOutTruncated = EnvironmentComponent->bIsTruncated;
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::StepEnvironment() - Exception: %s"), ANSI_TO_TCHAR(e.what()));
+        return false;
+    }
+    catch (...)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::StepEnvironment() - Unknown exception"));
+        return false;
+    }
+}
 
-        // Update training status
-        UpdateTrainingStatus();
-        LogTrainingProgress();
+bool URLAgentManager::ComputeRolloutAction(TArrayView<const float> Observation, TArrayView<float> OutPolicyAction, TArrayView<float> OutAction)
+{
+    if (!Backend)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::ComputeRolloutAction() - Agent not properly initialized"));
+        return false;
+    }
+
+    if (Observation.Num() != ObservationDim || OutPolicyAction.Num() != ActionDim || OutAction.Num() != ActionDim)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::ComputeRolloutAction() - Invalid observation or action dimension"));
+        return false;
+    }
 
+    try
+    {
+        // The snapshot carries the observation normalization it was trained with, so nothing the learner rebuilds is read here
+        Backend->SampleRolloutActions(Observation.GetData(), 1, OutPolicyAction.GetData());
+        ActionDenormalization.Apply(OutPolicyAction, OutAction);
         return true;
     }
     catch (const std::exception& e)
     {
-        UERL_ERROR(TEXT("URLAgentManager::PerformTrainingStep() - Exception: %s"), ANSI_TO_TCHAR(e.what()));
+        UERL_ERROR(TEXT("URLAgentManager::ComputeRolloutAction() - Exception: %s"), ANSI_TO_TCHAR(e.what()));
         return false;
     }
     catch (...)
     {
-        UERL_ERROR(TEXT("URLAgentManager::PerformTrainingStep() - Unknown exception"));
+        UERL_ERROR(TEXT("URLAgentManager::ComputeRolloutAction() - Unknown exception"));
         return false;
     }
 }
 
-void URLAgentManager::CollectExperience()
+void URLAgentManager::BeginTrainingEpisode(TArrayView<const float> Observation)
+{
+    if (Observation.Num() != ObservationDim)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::BeginTrainingEpisode() - Invalid observation dimension"));
+        return;
+    }
+
+    UpdateObservationStatistics(Observation);
+    FMemory::Memcpy(TrainerObservation.GetData(), Observation.GetData(), ObservationDim * sizeof(float));
+}
+
+void URLAgentManager::RecordTransition(float Reward, bool bEpisodeFinished, int32 EnvironmentIndex)
+{
+    if (!EpisodeReturns.IsValidIndex(EnvironmentIndex))
+    {
+        UERL_ERROR(TEXT("URLAgentManager::RecordTransition() - Invalid environment index %d"), EnvironmentIndex);
+        return;
+    }
+
+    // Update training status
+    LearnerStatus.CurrentStep++;
+    EpisodeStepCounts[EnvironmentIndex]++;
+    EpisodeReturns[EnvironmentIndex] += Reward;
+
+    if (bEpisodeFinished)
+    {
+        // Log episode completion
+        LearnerStatus.LastEpisodeReward = EpisodeReturns[EnvironmentIndex];
+        LearnerStatus.CurrentEpisode++;
+        EpisodeReturnStatistics.Add(EpisodeReturns[EnvironmentIndex]);
+        EpisodeLengthStatistics.Add(static_cast<float>(EpisodeStepCounts[EnvironmentIndex]));
+        UpdateTrainingStatus();
+
+        // Reset episode-specific counters
+        EpisodeStepCounts[EnvironmentIndex] = 0;
+        EpisodeReturns[EnvironmentIndex] = 0.0f;
+    }
+
+    PublishTrainingStatus();
+    LogTrainingProgress();
+}
+
+void URLAgentManager::StoreTrainingTransition(TArrayView<const float> PolicyAction, TArrayView<const float> NextObservation, float Reward, bool bTerminated, bool bTruncated)
 {
-    // This method is a placeholder for collecting experience in the replay buffer
-    // Implementation will be added when the replay buffer is properly set up
-    
-    // For now, we'll just log that this method was called
-    UERL_VERBOSE(TEXT("URLAgentManager::CollectExperience() - Collecting experience"));
+    if (!Backend || PolicyAction.Num() != ActionDim || NextObservation.Num() != ObservationDim)
+    {
+        UERL_ERROR(TEXT("URLAgentManager::StoreTrainingTransition() - Agent not initialized or invalid action or observation dimension"));
+        return;
+    }
+
+    CollectExperience(TrainerObservation, PolicyAction, Reward, NextObservation, bTerminated, bTruncated);
+    UpdateNetworks();
+
+    // The last observation of an episode is never acted on; the next episode starts with BeginTrainingEpisode
+    if (!bTerminated && !bTruncated)
+    {
+        BeginTrainingEpisode(NextObservation);
+    }
+}
+
+void URLAgentManager::SetAsyncLearner(bool bAsync)
+{
+    if (!Backend)
+    {
+        return;
+    }
+
+    Backend->SetAsyncLearner(bAsync);
+
+    // The async task steps the environment from here on; it stays headless until training stops
+    if (bAsync)
+    {
+        RemoveHeadlessTicker();
+    }
+
+    // A run that resumes past its warmup acts on the current actor right away instead of waiting for the first update
+    if (bAsync && !IsWarmingUp())
+    {
+        Backend->PublishPolicySnapshot(ObservationNormalization);
+    }
+}
+
+void URLAgentManager::CollectExperience(TConstArrayView<float> Observation, TConstArrayView<float> PolicyAction, float Reward, TConstArrayView<float> NextObservation, bool bTerminated, bool bTruncated)
+{
+    Backend->AddTransition(Observation.GetData(), PolicyAction.GetData(), Reward, NextObservation.GetData(), bTerminated, bTruncated);
+    LearnerStatus.ReplayBufferSize = Backend->GetReplayBufferSize();
+
+    // Warmup transitions do not earn updates, so the first updates do not all land on the step that ends the warmup.
+    // On-policy backends train on whole rollouts and owe no per-transition updates.
+    if (!IsOnPolicy() && !IsWarmingUp())
+    {
+        PendingUpdates += FMath::Max(TrainingConfig.UpdateToDataRatio, 0.0f);
+    }
 }
 
 void URLAgentManager::UpdateNetworks()
 {
-    // This method is a placeholder for updating the neural networks
-    // Implementation will be added when the training loop is properly set up
-    
-    // For now, we'll just log that this method was called
-    UERL_VERBOSE(TEXT("URLAgentManager::UpdateNetworks() - Updating networks"));
+    if (IsOnPolicy())
+    {
+        // Trains once the rollout is full and starts the next one; a no-op on every other step
+        if (Backend->Train(1, ObservationNormalization))
+        {
+            UERL_VERBOSE(TEXT("URLAgentManager::UpdateNetworks() - Trained on a rollout of %d transitions"), Backend->GetReplayBufferCapacity());
+        }
+        return;
+    }
+
+    if (IsWarmingUp() || ++StepsSinceUpdate < FMath::Max(TrainingConfig.TrainingInterval, 1))
+    {
+        return;
+    }
+    StepsSinceUpdate = 0;
+
+    const int32 NumUpdates = FMath::FloorToInt(PendingUpdates);
+    if (NumUpdates > 0)
+    {
+        PendingUpdates -= NumUpdates;
+        Backend->Train(NumUpdates, ObservationNormalization);
+        UERL_VERBOSE(TEXT("URLAgentManager::UpdateNetworks() - Ran %d update(s)"), NumUpdates);
+    }
+}
+
+void URLAgentManager::ConfigureBackendTraining()
+{
+    if (!Backend)
+    {
+        return;
+    }
+
+    Backend->SetTrainingParameters(TrainingConfig.ActorLearningRate, TrainingConfig.CriticLearningRate, TrainingConfig.Gamma);
+    Backend->SetParallelCriticTraining(TrainingConfig.bParallelCriticTraining);
+    Backend->SetPrioritizedReplay(TrainingConfig.bPrioritizedReplay, TrainingConfig.PrioritizedReplayAlpha,
+        TrainingConfig.PrioritizedReplayBeta, TrainingConfig.PrioritizedReplayBetaAnnealingUpdates);
+    Backend->SetPPOParameters(TrainingConfig.PPOEpochs, TrainingConfig.GAELambda);
+
+    if (TrainingConfig.BatchSize != Backend->GetTrainingBatchSize())
+    {
+        UERL_WARNING(TEXT("URLAgentManager::ConfigureBackendTraining() - BatchSize %d is not supported, training on batches of %d"),
+            TrainingConfig.BatchSize, Backend->GetTrainingBatchSize());
+    }
+
+    if (IsOnPolicy())
+    {
+        if (!TrainingConfig.ReplayBufferFilePath.IsEmpty() || TrainingConfig.bPrioritizedReplay)
+        {
+            UERL_WARNING(TEXT("URLAgentManager::ConfigureBackendTraining() - PPO has no replay buffer, ignoring ReplayBufferFilePath and bPrioritizedReplay"));
+        }
+        UERL_LOG(TEXT("URLAgentManager::ConfigureBackendTraining() - PPO trains every %d transitions for %d epoch(s)"),
+            Backend->GetReplayBufferCapacity(), FMath::Max(TrainingConfig.PPOEpochs, 1));
+        return;
+    }
+
+    if (TrainingConfig.ReplayBufferFilePath.IsEmpty())
+    {
+        Backend->CloseReplayBufferFile();
+    }
+    else if (!Backend->OpenReplayBufferFile(TrainingConfig.ReplayBufferFilePath))
+    {
+        UERL_WARNING(TEXT("URLAgentManager::ConfigureBackendTraining() - Cannot use %s as replay buffer, keeping it in memory"),
+            *TrainingConfig.ReplayBufferFilePath);
+    }
+
+    if (TrainingConfig.ReplayBufferCapacity != Backend->GetReplayBufferCapacity())
+    {
+        UERL_WARNING(TEXT("URLAgentManager::ConfigureBackendTraining() - ReplayBufferCapacity %d is not supported, the replay buffer holds %d transitions"),
+            TrainingConfig.ReplayBufferCapacity, Backend->GetReplayBufferCapacity());
+    }
+}
+
+bool URLAgentManager::IsOnPolicy() const
+{
+    return Backend && Backend->GetAlgorithm() == ERLAlgorithm::PPO;
+}
+
+bool URLAgentManager::IsWarmingUp() const
+{
+    if (IsOnPolicy())
+    {
+        return false;
+    }
+
+    // Clamped so that warmup always ends: the buffer never holds more than its capacity
+    const int32 WarmupTransitions = FMath::Clamp(TrainingConfig.WarmupSteps, Backend->GetTrainingBatchSize(), Backend->GetReplayBufferCapacity());
+    return Backend->GetReplayBufferSize() < WarmupTransitions;
 }
@@ -3,22 +3,55 @@
 #include "RLAsyncTrainingTask.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
 
 // Module-wide log categories
 #include "UERLLog.h"
 
 // FRLAsyncTrainingTask Implementation
 
-FRLAsyncTrainingTask::FRLAsyncTrainingTask(URLAgentManager* InAgentManager, int32 InMaxSteps, int32 InProgressUpdateInterval)
+namespace
+{
+	// Upper bound for a worker wait, so a stop request or an externally stopped agent is noticed even without a trigger
+	constexpr uint32 WorkerWaitTimeoutMs = 10;
+}
+
+FRLAsyncTrainingTask::FRLAsyncTrainingTask(URLAgentManager* InAgentManager, int32 InMaxSteps, int32 InProgressUpdateInterval, int32 InRingCapacity)
 	: AgentManager(InAgentManager)
 	, MaxSteps(InMaxSteps)
 	, ProgressUpdateInterval(InProgressUpdateInterval)
+	, StepRing(InRingCapacity, InAgentManager ? InAgentManager->GetActionDim() + InAgentManager->GetObservationDim() : 0)
+	, WorkEvent(FPlatformProcess::GetSynchEventFromPool(false))
+	, bNeedsEpisodeStart(true)
 	, bShouldStop(false)
 	, bIsComplete(false)
 	, bWasSuccessful(false)
 	, CurrentStep(0)
 	, AverageReward(0.0f)
 {
+	if (InAgentManager)
+	{
+		RolloutObservation.SetNumZeroed(InAgentManager->GetObservationDim());
+		RolloutAction.SetNumZeroed(InAgentManager->GetActionDim());
+	}
+}
+
+FRLAsyncTrainingTask::~FRLAsyncTrainingTask()
+{
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+}
+
+void FRLAsyncTrainingTask::Stop()
+{
+	bShouldStop = true;
+	WorkEvent->Trigger();
+}
+
+void FRLAsyncTrainingTask::WaitForWork()
+{
+	WorkEvent->Wait(WorkerWaitTimeoutMs);
 }
 
 void FRLAsyncTrainingTask::DoWork()
@@ -32,28 +65,44 @@ void FRLAsyncTrainingTask::DoWork()
 
 	UERL_LOG( TEXT("FRLAsyncTrainingTask::DoWork - Starting async training"));
 
+	const int32 ObservationDim = AgentManager->GetObservationDim();
+	const int32 ActionDim = AgentManager->GetActionDim();
+	const int32 StepLimit = FMath::Min(MaxSteps, AgentManager->TrainingConfig.MaxTrainingSteps);
+
 	try
 	{
-		while (ShouldContinue() && CurrentStep < MaxSteps)
+		while (ShouldContinue() && CurrentStep < StepLimit)
 		{
-			// Perform training step
-			bool bStepSuccess = AgentManager->StepTraining(1);
-			if (!bStepSuccess)
+			const FRLTransitionSlotHeader* Record = StepRing.BeginRead();
+			if (!Record)
 			{
-				UERL_ERROR( TEXT("FRLAsyncTrainingTask::DoWork - Training step failed"));
-				break;
+				WaitForWork();
+				continue;
 			}
 
-			// Update progress
-			FRLTrainingStatus Status = AgentManager->GetTrainingStatus();
-			CurrentStep = Status.CurrentStep;
-			AverageReward = Status.AverageReward;
+			const float* RecordData = FRLTransitionRing::GetData(Record);
+			const TConstArrayView<float> Observation = MakeArrayView(RecordData + ActionDim, ObservationDim);
+			if ((Record->Flags & FRLTransitionSlotHeader::EpisodeStart) != 0)
+			{
+				AgentManager->BeginTrainingEpisode(Observation);
+			}
+			else
+			{
+				// Stores the transition and runs the updates it is owed; new actor weights reach the game thread as a snapshot
+				AgentManager->StoreTrainingTransition(MakeArrayView(RecordData, ActionDim), Observation, Record->Reward,
+					(Record->Flags & FRLTransitionSlotHeader::Terminated) != 0, (Record->Flags & FRLTransitionSlotHeader::Truncated) != 0);
+				AgentManager->RecordTransition(Record->Reward, Record->IsEpisodeFinished());
 
-			// Small delay to prevent overwhelming the system
-			FPlatformProcess::Sleep(0.001f); // 1ms
+				// Update progress
+				const FRLTrainingStatus& Status = AgentManager->GetLearnerTrainingStatus();
+				CurrentStep = Status.CurrentStep;
+				AverageReward = Status.AverageReward;
+			}
+
+			StepRing.CommitRead();
 		}
 
-		bWasSuccessful = !bShouldStop && (CurrentStep >= MaxSteps || !AgentManager->IsTraining());
+		bWasSuccessful = !bShouldStop && (CurrentStep >= StepLimit || !AgentManager->IsTrainingActive());
 	}
 	catch (...)
 	{
@@ -66,15 +115,99 @@ void FRLAsyncTrainingTask::DoWork()
 		bWasSuccessful ? TEXT("True") : TEXT("False"), CurrentStep);
 }
 
+int32 FRLAsyncTrainingTask::PumpEnvironment(int32 MaxEnvironmentSteps)
+{
+	if (!AgentManager)
+	{
+		return 0;
+	}
+
+	const int32 ObservationDim = RolloutObservation.Num();
+	const int32 ActionDim = RolloutAction.Num();
+	int32 StepsTaken = 0;
+
+	while (StepsTaken < MaxEnvironmentSteps && !bIsComplete && !bShouldStop)
+	{
+		FRLTransitionSlotHeader* Record = StepRing.BeginWrite();
+		if (!Record)
+		{
+			// Backpressure: the learner has not consumed the previous records yet
+			break;
+		}
+
+		float* RecordData = FRLTransitionRing::GetData(Record);
+		const TArrayView<float> PolicyAction = MakeArrayView(RecordData, ActionDim);
+		const TArrayView<float> Observation = MakeArrayView(RecordData + ActionDim, ObservationDim);
+
+		if (bNeedsEpisodeStart)
+		{
+			// Also taken on the first pump, so the learner starts from a freshly reset environment
+			Record->Reward = 0.0f;
+			Record->Flags = FRLTransitionSlotHeader::EpisodeStart;
+			if (!AgentManager->ResetEnvironment(Observation))
+			{
+				UERL_ERROR( TEXT("FRLAsyncTrainingTask::PumpEnvironment - Environment reset failed"));
+				Stop();
+				break;
+			}
+			FMemory::Memcpy(RolloutObservation.GetData(), Observation.GetData(), ObservationDim * sizeof(float));
+			StepRing.CommitWrite();
+			WorkEvent->Trigger();
+			bNeedsEpisodeStart = false;
+			continue;
+		}
+
+		// The policy-space action goes straight into the record; the environment gets it denormalized
+		if (!AgentManager->ComputeRolloutAction(RolloutObservation, PolicyAction, RolloutAction))
+		{
+			UERL_ERROR( TEXT("FRLAsyncTrainingTask::PumpEnvironment - Computing the rollout action failed"));
+			Stop();
+			break;
+		}
+
+		bool bTerminated = false;
+		bool bTruncated = false;
+		if (!AgentManager->StepEnvironment(RolloutAction, Observation, Record->Reward, bTerminated, bTruncated))
+		{
+			UERL_ERROR( TEXT("FRLAsyncTrainingTask::PumpEnvironment - Environment step failed"));
+			Stop();
+			break;
+		}
+		Record->Flags = (bTerminated ? FRLTransitionSlotHeader::Terminated : FRLTransitionSlotHeader::None)
+			| (bTruncated ? FRLTransitionSlotHeader::Truncated : FRLTransitionSlotHeader::None);
+		FMemory::Memcpy(RolloutObservation.GetData(), Observation.GetData(), ObservationDim * sizeof(float));
+
+		StepRing.CommitWrite();
+		WorkEvent->Trigger();
+
+		bNeedsEpisodeStart = bTerminated || bTruncated;
+		++StepsTaken;
+	}
+
+	return StepsTaken;
+}
+
 // URLAsyncTrainingTask Implementation
 
 URLAsyncTrainingTask::URLAsyncTrainingTask()
-	: LastReportedStep(0)
+	: EnvironmentStepsPerTick(64)
+	, LastReportedStep(0)
 	, LastReportedReward(0.0f)
 {
 }
 
-bool URLAsyncTrainingTask::StartAsyncTraining(URLAgentManager* AgentManager, int32 MaxSteps, int32 ProgressUpdateInterval)
+void URLAsyncTrainingTask::BeginDestroy()
+{
+	// The worker holds a raw pointer to the agent manager and must not outlive this object
+	if (AsyncTask.IsValid())
+	{
+		StopAsyncTraining();
+	}
+
+	Super::BeginDestroy();
+}
+
+bool URLAsyncTrainingTask::StartAsyncTraining(URLAgentManager* AgentManager, int32 MaxSteps, int32 ProgressUpdateInterval, int32 InEnvironmentStepsPerTick)
 {
 	if (!AgentManager)
 	{
@@ -88,6 +221,15 @@ bool URLAsyncTrainingTask::StartAsyncTraining(URLAgentManager* AgentManager, int
 		return false;
 	}
 
+	// The learner thread trains on transitions the game thread collected with an older policy snapshot, which an
+	// on-policy algorithm cannot use; of the off-policy backends only TD3 publishes snapshots
+	if (AgentManager->GetAlgorithm() != ERLAlgorithm::TD3)
+	{
+		UERL_ERROR( TEXT("URLAsyncTrainingTask::StartAsyncTraining - %s agents cannot train asynchronously, use StepTraining instead"),
+			*UEnum::GetDisplayValueAsText(AgentManager->GetAlgorithm()).ToString());
+		return false;
+	}
+
 	// Stop any existing task
 	StopAsyncTraining();
 
@@ -98,10 +240,19 @@ bool URLAsyncTrainingTask::StartAsyncTraining(URLAgentManager* AgentManager, int
 		return false;
 	}
 
+	TrainedAgent = AgentManager;
+	EnvironmentStepsPerTick = FMath::Max(1, InEnvironmentStepsPerTick);
+
+	// From here on the game thread acts on published actor snapshots and the worker owns the networks
+	AgentManager->SetAsyncLearner(true);
+
 	// Create and start async task
 	AsyncTask = MakeShared<FAsyncTask<FRLAsyncTrainingTask>>(AgentManager, MaxSteps, ProgressUpdateInterval);
 	AsyncTask->StartBackgroundTask();
 
+	// The environment is stepped on the game thread every frame; the worker only consumes its step records
+	PumpTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &URLAsyncTrainingTask::PumpEnvironment));
+
 	// Start progress timer
 	if (UWorld* World = GetWorld())
 	{
@@ -120,12 +271,21 @@ bool URLAsyncTrainingTask::StartAsyncTraining(URLAgentManager* AgentManager, int
 
 void URLAsyncTrainingTask::StopAsyncTraining()
 {
+	// Stop stepping the environment first so the worker is not fed while it shuts down
+	RemovePumpTicker();
+
 	// Stop the async task
 	if (AsyncTask.IsValid())
 	{
 		AsyncTask->GetTask().Stop();
 		AsyncTask->EnsureCompletion();
 		AsyncTask.Reset();
+
+		// The learner is gone; inference picks up the trained actor
+		if (URLAgentManager* AgentManager = TrainedAgent.Get())
+		{
+			AgentManager->SetAsyncLearner(false);
+		}
 	}
 
 	// Clear progress timer
@@ -171,6 +331,13 @@ void URLAsyncTrainingTask::CheckProgress()
 	// Check if task is complete
 	if (Task.IsComplete())
 	{
+		// The worker never touches UObject state that broadcasts; finish the agent's training run here on the game thread
+		if (URLAgentManager* AgentManager = TrainedAgent.Get())
+		{
+			AgentManager->SetAsyncLearner(false);
+			AgentManager->StopTraining();
+		}
+
 		// Fire completion event
 		OnComplete.Broadcast(Task.WasSuccessful());
 		
@@ -179,6 +346,12 @@ void URLAsyncTrainingTask::CheckProgress()
 		return;
 	}
 
+	// TrainingStatus follows the learner's published status while it runs
+	if (URLAgentManager* AgentManager = TrainedAgent.Get())
+	{
+		AgentManager->SyncTrainingStatus();
+	}
+
 	// Check for progress updates
 	int32 CurrentStep = Task.GetCurrentStep();
 	float AverageReward = Task.GetAverageReward();
@@ -192,8 +365,31 @@ void URLAsyncTrainingTask::CheckProgress()
 	}
 }
 
+bool URLAsyncTrainingTask::PumpEnvironment(float DeltaTime)
+{
+	if (!AsyncTask.IsValid())
+	{
+		PumpTickerHandle.Reset();
+		return false;
+	}
+
+	AsyncTask->GetTask().PumpEnvironment(EnvironmentStepsPerTick);
+	return true;
+}
+
+void URLAsyncTrainingTask::RemovePumpTicker()
+{
+	if (PumpTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PumpTickerHandle);
+		PumpTickerHandle.Reset();
+	}
+}
+
 void URLAsyncTrainingTask::CleanupTask()
 {
+	RemovePumpTicker();
+
 	// Clear timer
 	if (UWorld* World = GetWorld())
 	{
@@ -259,4 +259,10 @@ void URLBlueprintFunctionLibrary::LogTrainingStatus(const FRLTrainingStatus& Sta
 	UERL_LOG( TEXT("  Average Reward: %.3f"), Status.AverageReward);
 	UERL_LOG( TEXT("  Last Episode Reward: %.3f"), Status.LastEpisodeReward);
 	UERL_LOG( TEXT("  Replay Buffer Size: %d"), Status.ReplayBufferSize);
+	UERL_LOG( TEXT("  Episode Return (last %d): mean %.3f, std %.3f, min %.3f, max %.3f, P50 %.3f, P90 %.3f, P99 %.3f"),
+		Status.EpisodeReturn.Count, Status.EpisodeReturn.Mean, Status.EpisodeReturn.StdDev, Status.EpisodeReturn.Min,
+		Status.EpisodeReturn.Max, Status.EpisodeReturn.P50, Status.EpisodeReturn.P90, Status.EpisodeReturn.P99);
+	UERL_LOG( TEXT("  Episode Length (last %d): mean %.1f, P50 %.1f, P90 %.1f, P99 %.1f"),
+		Status.EpisodeLength.Count, Status.EpisodeLength.Mean, Status.EpisodeLength.P50, Status.EpisodeLength.P90,
+		Status.EpisodeLength.P99);
 }
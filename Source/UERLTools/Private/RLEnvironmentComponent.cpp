@@ -1,6 +1,8 @@
 // Copyright 2025 NGUYEN PHI HUNG
 
 #include "RLEnvironmentComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
 
 // Module-wide log categories
 #include "UERLLog.h"
@@ -14,6 +16,8 @@ URLEnvironmentComponent::URLEnvironmentComponent()
 	bIsTerminated = false;
 	bIsTruncated = false;
 	LastReward = 0.0f;
+	bHeadless = false;
+	bOwnerWasHidden = false;
 }
 
 void URLEnvironmentComponent::BeginPlay()
@@ -29,6 +33,44 @@ void URLEnvironmentComponent::TickComponent(float DeltaTime, ELevelTick TickType
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 }
 
+void URLEnvironmentComponent::SetHeadless(bool bInHeadless)
+{
+	if (bHeadless == bInHeadless)
+	{
+		return;
+	}
+	bHeadless = bInHeadless;
+
+	// Nothing of the owner needs drawing while the simulation runs ahead of the frames
+	if (AActor* Owner = GetOwner())
+	{
+		if (bHeadless)
+		{
+			bOwnerWasHidden = Owner->IsHidden();
+			Owner->SetActorHiddenInGame(true);
+		}
+		else
+		{
+			Owner->SetActorHiddenInGame(bOwnerWasHidden);
+		}
+	}
+
+	if (!bHeadless)
+	{
+		SyncSceneState();
+	}
+}
+
+float URLEnvironmentComponent::GetStepDeltaSeconds() const
+{
+	if (bHeadless)
+	{
+		return FixedDeltaSeconds;
+	}
+	const UWorld* World = GetWorld();
+	return World ? World->GetDeltaSeconds() : 0.016f; // Default to ~60 FPS
+}
+
 TArray<float> URLEnvironmentComponent::Reset()
 {
 	CurrentStep = 0;
@@ -55,24 +97,60 @@ TArray<float> URLEnvironmentComponent::Reset()
 
 void URLEnvironmentComponent::Step(const TArray<float>& Action)
 {
+	// Step writes into the cached observation; only resizes if a previous Reset produced a mismatched one
+	if (LastObservation.Num() != EnvironmentConfig.ObservationDim)
+	{
+		LastObservation.SetNumZeroed(EnvironmentConfig.ObservationDim);
+	}
+	StepInto(Action, LastObservation);
+}
+
+bool URLEnvironmentComponent::ResetInto(TArrayView<float> OutObservation)
+{
+	if (OutObservation.Num() != EnvironmentConfig.ObservationDim)
+	{
+		UERL_ERROR( TEXT("URLEnvironmentComponent::ResetInto - Observation buffer holds %d values, expected %d"), OutObservation.Num(), EnvironmentConfig.ObservationDim);
+		return false;
+	}
+
+	// Reset may be overridden in Blueprint-facing subclasses; it runs once per episode, so its TArray is acceptable here
+	const TArray<float> InitialObservation = Reset();
+	const int32 NumCopied = FMath::Min(InitialObservation.Num(), OutObservation.Num());
+	FMemory::Memcpy(OutObservation.GetData(), InitialObservation.GetData(), NumCopied * sizeof(float));
+	if (NumCopied < OutObservation.Num())
+	{
+		FMemory::Memzero(OutObservation.GetData() + NumCopied, (OutObservation.Num() - NumCopied) * sizeof(float));
+	}
+	return true;
+}
+
+bool URLEnvironmentComponent::StepInto(TConstArrayView<float> Action, TArrayView<float> OutObservation)
+{
+	const int32 ObservationDim = EnvironmentConfig.ObservationDim;
+	if (OutObservation.Num() != ObservationDim)
+	{
+		UERL_ERROR( TEXT("URLEnvironmentComponent::StepInto - Observation buffer holds %d values, expected %d"), OutObservation.Num(), ObservationDim);
+		return false;
+	}
+
 	if (bIsTerminated || bIsTruncated)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("URLEnvironmentComponent::Step called on a finished episode. Please call Reset() first."));
+		if (OutObservation.GetData() != LastObservation.GetData())
+		{
+			FMemory::Memcpy(OutObservation.GetData(), LastObservation.GetData(), FMath::Min(LastObservation.Num(), ObservationDim) * sizeof(float));
+		}
 		OnEnvironmentStep.Broadcast(LastObservation, LastReward, bIsTerminated, bIsTruncated);
-		return;
+		return false;
 	}
 
-	// Call Blueprint implementation if available
-	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(URLEnvironmentComponent, BP_OnStep)))
-	{
-		BP_OnStep(Action);
-	}
+	ApplyAction(Action);
 
 	// Update step count
 	CurrentStep++;
 
 	// Get new observation
-	LastObservation = GetObservation();
+	WriteObservation(OutObservation);
 
 	// Calculate reward
 	LastReward = CalculateReward();
@@ -88,16 +166,43 @@ void URLEnvironmentComponent::Step(const TArray<float>& Action)
 		bIsTruncated = false;
 	}
 
-	// Validate observation dimension
-	if (LastObservation.Num() != EnvironmentConfig.ObservationDim)
+	// Keep the cached observation in sync for GetLastObservation and the step event (no reallocation once sized)
+	if (OutObservation.GetData() != LastObservation.GetData())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("URLEnvironmentComponent::Step - Observation dimension mismatch. Expected %d, Got %d. Resizing and padding/truncating."), 
-			EnvironmentConfig.ObservationDim, LastObservation.Num());
-		LastObservation.SetNumZeroed(EnvironmentConfig.ObservationDim);
+		LastObservation.SetNumUninitialized(ObservationDim, /*bAllowShrinking=*/ false);
+		FMemory::Memcpy(LastObservation.GetData(), OutObservation.GetData(), ObservationDim * sizeof(float));
 	}
 
 	// Broadcast step event
 	OnEnvironmentStep.Broadcast(LastObservation, LastReward, bIsTerminated, bIsTruncated);
+	return true;
+}
+
+void URLEnvironmentComponent::ApplyAction(TConstArrayView<float> Action)
+{
+	// Call Blueprint implementation if available
+	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(URLEnvironmentComponent, BP_OnStep)))
+	{
+		BlueprintAction.SetNumUninitialized(Action.Num(), /*bAllowShrinking=*/ false);
+		FMemory::Memcpy(BlueprintAction.GetData(), Action.GetData(), Action.Num() * sizeof(float));
+		BP_OnStep(BlueprintAction);
+	}
+}
+
+void URLEnvironmentComponent::WriteObservation(TArrayView<float> OutObservation)
+{
+	// Blueprint and GetObservation-only subclasses hand back a TArray; copy it into the caller's buffer
+	const TArray<float> Observation = GetObservation();
+
+	// Validate observation dimension
+	if (Observation.Num() != OutObservation.Num())
+	{
+		UERL_WARNING(TEXT("URLEnvironmentComponent::WriteObservation - Observation dimension mismatch. Expected %d, Got %d. Padding/truncating."),
+			OutObservation.Num(), Observation.Num());
+	}
+	const int32 NumCopied = FMath::Min(Observation.Num(), OutObservation.Num());
+	FMemory::Memcpy(OutObservation.GetData(), Observation.GetData(), NumCopied * sizeof(float));
+	FMemory::Memzero(OutObservation.GetData() + NumCopied, (OutObservation.Num() - NumCopied) * sizeof(float));
 }
 
 TArray<float> URLEnvironmentComponent::GetObservation()
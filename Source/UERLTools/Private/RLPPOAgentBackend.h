@@ -0,0 +1,497 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+// The rl_tools PPO headers are included by RLAgentBackend.h, in the order their overloads need
+#include "RLAgentBackend.h"
+
+/**
+ * PPO backend for one (observation, action, hidden) shape, following rl_tools' PPO loop (rl/algorithms/ppo/loop/core)
+ * with the environments stepped by URLAgentManager instead of an rl_tools on-policy runner.
+ * All rl_tools containers are allocated in the constructor, out of one FRLAgentArena block; sampling, AddTransition and
+ * Train allocate no rl_tools container.
+ *
+ * The "replay buffer" of the interface is the rollout: ROLLOUT_SIZE rows filled by SampleTrainingActions (observation,
+ * sampled action and its log-probability) and AddTransition (reward and flags), in the order of a batched step over
+ * all training environments. Row r belongs to environment r % NumLanes, the batch size SampleTrainingActions is called
+ * with. Once the rollout is full, Train evaluates the critic on all rows, estimates the advantages of every environment
+ * in one pass over the steps and runs PPOEpochs epochs of TRAINING_BATCH_SIZE minibatches; the rollout then starts over.
+ * The environments keep running across rollouts: a rollout that ends mid-episode bootstraps from the critic's value
+ * of each environment's last next observation.
+ *
+ * The actor is rl_tools' MLP with a learned, state-independent log std. Its mean goes through the same TANH MLP as
+ * TRLAgentBackend's actor, so the inference actor, policy files and Evaluate are the same for both algorithms.
+ *
+ * PPO runs synchronously only: the async learner interface is implemented as plain sampling without snapshots and
+ * URLAsyncTrainingTask refuses PPO agents.
+ */
+template <int32 T_OBSERVATION_DIM, int32 T_ACTION_DIM, int32 T_HIDDEN_DIM>
+class TRLPPOAgentBackend final : public IRLAgentBackend
+{
+public:
+	using DEVICE = rl_tools::devices::DefaultCPU;
+	using T = float;
+	using TI = typename DEVICE::index_t;
+	using RNG = decltype(rl_tools::random::default_engine(typename DEVICE::SPEC::RANDOM{}));
+
+	static constexpr TI OBSERVATION_DIM = T_OBSERVATION_DIM;
+	static constexpr TI ACTION_DIM = T_ACTION_DIM;
+	static constexpr TI HIDDEN_DIM = T_HIDDEN_DIM;
+	static constexpr TI NUM_LAYERS = 3; // rl_tools counts the input and output layers towards the total
+	static constexpr int32 NUM_PARAMETER_BLOCKS = 2 * NUM_LAYERS; // Weights and biases per layer
+	static constexpr auto ACTIVATION_FUNCTION = rl_tools::nn::activation_functions::ActivationFunction::RELU;
+
+	// Inference and critic bootstrapping run in chunks of this many rows, as in TRLAgentBackend
+	static constexpr TI INFERENCE_BATCH_SIZE = 64;
+
+	// Rows per rollout and per minibatch are template parameters of the rl_tools containers; the matching
+	// FLocalRLTrainingConfig fields (ReplayBufferCapacity, BatchSize) are reported and ignored
+	static constexpr TI ROLLOUT_SIZE = 2048;
+	static constexpr TI TRAINING_BATCH_SIZE = 256;
+
+	using ACTOR_CONFIG = rl_tools::nn_models::mlp::Configuration<T, TI, ACTION_DIM, NUM_LAYERS, HIDDEN_DIM, ACTIVATION_FUNCTION, rl_tools::nn::activation_functions::TANH>;
+	using ACTOR_CAPABILITY = rl_tools::nn::capability::Forward<>;
+	using ACTOR_INPUT_SHAPE = rl_tools::tensor::Shape<TI, 1, INFERENCE_BATCH_SIZE, OBSERVATION_DIM>;
+	using ACTOR_TYPE = rl_tools::nn_models::mlp::NeuralNetwork<ACTOR_CONFIG, ACTOR_CAPABILITY, ACTOR_INPUT_SHAPE>;
+	using ACTOR_BUFFER_TYPE = typename ACTOR_TYPE::template Buffer<>;
+	using ACTOR_SINGLE_INPUT_SHAPE = rl_tools::tensor::Shape<TI, 1, 1, OBSERVATION_DIM>;
+	using INFERENCE_INPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, ACTOR_INPUT_SHAPE>>;
+	using INFERENCE_OUTPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, typename ACTOR_TYPE::OUTPUT_SHAPE>>;
+	using INFERENCE_SINGLE_INPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, ACTOR_SINGLE_INPUT_SHAPE>>;
+	using INFERENCE_SINGLE_OUTPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, typename ACTOR_TYPE::template OUTPUT_SHAPE_FACTORY<ACTOR_SINGLE_INPUT_SHAPE>>>;
+
+	// PPO networks, mirroring rl_tools::rl::algorithms::ppo::loop::core::ConfigApproximatorsSequential without the
+	// standardization layer (URLAgentManager normalizes observations itself)
+	using ENVIRONMENT = TRLEnvironmentShape<T, TI, OBSERVATION_DIM, ACTION_DIM>;
+
+	// Train runs the epochs itself so their number can be set at runtime; each train() call is one epoch
+	struct PPO_PARAMETERS : rl_tools::rl::algorithms::ppo::DefaultParameters<T, TI, TRAINING_BATCH_SIZE>
+	{
+		static constexpr TI N_EPOCHS = 1;
+	};
+
+	template <typename T_CONTENT, typename T_NEXT_MODULE = rl_tools::nn_models::sequential::OutputModule>
+	using Module = rl_tools::nn_models::sequential::Module<T_CONTENT, T_NEXT_MODULE>;
+
+	using TRAINING_INPUT_SHAPE = rl_tools::tensor::Shape<TI, 1, TRAINING_BATCH_SIZE, OBSERVATION_DIM>;
+	using TRAINING_ACTOR_MLP = rl_tools::nn_models::mlp_unconditional_stddev::BindConfiguration<ACTOR_CONFIG>;
+	using CRITIC_CONFIG = rl_tools::nn_models::mlp::Configuration<T, TI, 1, NUM_LAYERS, HIDDEN_DIM, ACTIVATION_FUNCTION, rl_tools::nn::activation_functions::ActivationFunction::IDENTITY>;
+	using CRITIC_MLP = rl_tools::nn_models::mlp::BindConfiguration<CRITIC_CONFIG>;
+
+	using TRAINING_CAPABILITY = rl_tools::nn::capability::Gradient<rl_tools::nn::parameters::Adam>;
+	using TRAINING_ACTOR_TYPE = rl_tools::nn_models::sequential::Build<TRAINING_CAPABILITY, Module<TRAINING_ACTOR_MLP>, TRAINING_INPUT_SHAPE>;
+	using CRITIC_TYPE = rl_tools::nn_models::sequential::Build<TRAINING_CAPABILITY, Module<CRITIC_MLP>, TRAINING_INPUT_SHAPE>;
+	using OPTIMIZER = rl_tools::nn::optimizers::Adam<rl_tools::nn::optimizers::adam::Specification<T, TI, rl_tools::nn::optimizers::adam::DEFAULT_PARAMETERS_TENSORFLOW<T>>>;
+
+	using PPO_SPEC = rl_tools::rl::algorithms::ppo::Specification<T, TI, ENVIRONMENT, TRAINING_ACTOR_TYPE, CRITIC_TYPE, PPO_PARAMETERS>;
+	using PPO_TYPE = rl_tools::rl::algorithms::PPO<PPO_SPEC>;
+	using PPO_BUFFERS_TYPE = rl_tools::rl::algorithms::ppo::Buffers<rl_tools::rl::algorithms::ppo::BufferSpecification<PPO_SPEC>>;
+	using TRAINING_ACTOR_BUFFER_TYPE = typename TRAINING_ACTOR_TYPE::template Buffer<>;
+	using CRITIC_BUFFER_TYPE = typename CRITIC_TYPE::template Buffer<>;
+	// The critic is also evaluated on the whole rollout at once and on chunks of bootstrap observations
+	using CRITIC_ROLLOUT_BUFFER_TYPE = typename CRITIC_TYPE::template CHANGE_BATCH_SIZE<TI, ROLLOUT_SIZE>::template Buffer<>;
+	using CRITIC_CHUNK_BUFFER_TYPE = typename CRITIC_TYPE::template CHANGE_BATCH_SIZE<TI, INFERENCE_BATCH_SIZE>::template Buffer<>;
+	using CRITIC_CHUNK_OUTPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, rl_tools::tensor::Shape<TI, 1, INFERENCE_BATCH_SIZE, 1>>>;
+
+	// One "environment" of ROLLOUT_SIZE steps: rows are kept in the order they were collected and the lanes are
+	// untangled by the interleaved advantage estimate
+	using ROLLOUT_SPEC = rl_tools::rl::components::on_policy_runner::Specification<T, TI, ENVIRONMENT, 1>;
+	using ROLLOUT_TYPE = rl_tools::rl::components::on_policy_runner::Dataset<rl_tools::rl::components::on_policy_runner::DatasetSpecification<ROLLOUT_SPEC, ROLLOUT_SIZE>>;
+	using LANE_VALUES_TYPE = rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, 1, ROLLOUT_SIZE>>;
+	using BOOTSTRAP_OBSERVATIONS_TYPE = rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, ROLLOUT_SIZE, OBSERVATION_DIM>>;
+
+	explicit TRLPPOAgentBackend(uint32 Seed)
+	{
+		Arena.Allocate([this]()
+		{
+			rl_tools::malloc(device, Actor);
+			rl_tools::malloc(device, ActorEvalBuffer);
+			rl_tools::malloc(device, InferenceInput);
+			rl_tools::malloc(device, InferenceOutput);
+			rl_tools::malloc(device, InferenceSingleInput);
+			rl_tools::malloc(device, InferenceSingleOutput);
+
+			rl_tools::malloc(device, PPO);
+			rl_tools::malloc(device, PPOBuffers);
+			rl_tools::malloc(device, TrainingActorBuffer);
+			rl_tools::malloc(device, CriticBuffer);
+			rl_tools::malloc(device, CriticRolloutBuffer);
+			rl_tools::malloc(device, CriticChunkBuffer);
+			rl_tools::malloc(device, CriticChunkOutput);
+			rl_tools::malloc(device, Rollout);
+			rl_tools::malloc(device, LaneValues);
+			rl_tools::malloc(device, LaneAdvantages);
+			rl_tools::malloc(device, BootstrapObservations);
+		}, device);
+
+		// Zero the inputs so padded rows of a partial chunk never carry NaNs from the allocation
+		rl_tools::set_all(device, InferenceInput, 0);
+		rl_tools::set_all(device, BootstrapObservations, 0);
+
+		ForEachParameterMatrix(Actor, [this](auto& Parameters, int32 Block)
+		{
+			OwnedActorParameters[Block] = Parameters._data;
+		});
+
+		rng = rl_tools::random::default_engine(device.random, Seed);
+		ResetTraining();
+	}
+
+	virtual ERLAlgorithm GetAlgorithm() const override { return ERLAlgorithm::PPO; }
+
+	virtual int32 GetObservationDim() const override { return T_OBSERVATION_DIM; }
+	virtual int32 GetActionDim() const override { return T_ACTION_DIM; }
+	virtual int32 GetHiddenDim() const override { return T_HIDDEN_DIM; }
+
+	virtual void Evaluate(const float* Observation, float* OutAction) override
+	{
+		FMemory::Memcpy(rl_tools::data(InferenceSingleInput), Observation, OBSERVATION_DIM * sizeof(T));
+		rl_tools::evaluate(device, Actor, InferenceSingleInput, InferenceSingleOutput, ActorEvalBuffer, rng);
+		FMemory::Memcpy(OutAction, rl_tools::data(InferenceSingleOutput), ACTION_DIM * sizeof(T));
+	}
+
+	virtual void EvaluateBatch(const float* Observations, int32 NumRows, float* OutActions) override
+	{
+		for (int32 RowStart = 0; RowStart < NumRows; RowStart += INFERENCE_BATCH_SIZE)
+		{
+			const int32 ChunkRows = FMath::Min<int32>(INFERENCE_BATCH_SIZE, NumRows - RowStart);
+			FMemory::Memcpy(rl_tools::data(InferenceInput), Observations + RowStart * OBSERVATION_DIM, ChunkRows * OBSERVATION_DIM * sizeof(T));
+			rl_tools::evaluate(device, Actor, InferenceInput, InferenceOutput, ActorEvalBuffer, rng);
+			FMemory::Memcpy(OutActions + RowStart * ACTION_DIM, rl_tools::data(InferenceOutput), ChunkRows * ACTION_DIM * sizeof(T));
+		}
+	}
+
+	virtual void GetPolicyParameterBlocks(TArray<FRLPolicyParameterBlock>& OutBlocks) const override
+	{
+		OutBlocks.SetNum(NUM_PARAMETER_BLOCKS);
+		ForEachParameterMatrix(Actor, [&OutBlocks](const auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			OutBlocks[Block].Data = Parameters._data;
+			OutBlocks[Block].Rows = MATRIX_SPEC::ROWS;
+			OutBlocks[Block].Cols = MATRIX_SPEC::COLS;
+		});
+	}
+
+	virtual void BindPolicyParameters(TConstArrayView<const float*> BlockData) override
+	{
+		check(BlockData.Num() == NUM_PARAMETER_BLOCKS);
+
+		// The trained actor's mean network has the inference actor's blocks; its log std keeps its current value
+		ForEachParameterMatrix(PPO.actor.content, [&BlockData](auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			static_assert(MATRIX_SPEC::ROW_PITCH == MATRIX_SPEC::COLS, "Policy parameter blocks must be dense");
+			FMemory::Memcpy(Parameters._data, BlockData[Block], MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS * sizeof(T));
+		});
+
+		ForEachParameterMatrix(Actor, [&BlockData](auto& Parameters, int32 Block)
+		{
+			Parameters._data = const_cast<T*>(BlockData[Block]);
+		});
+		bParametersBound = true;
+	}
+
+	virtual void UnbindPolicyParameters() override
+	{
+		if (!bParametersBound)
+		{
+			return;
+		}
+
+		ForEachParameterMatrix(Actor, [this](auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			FMemory::Memcpy(OwnedActorParameters[Block], Parameters._data, MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS * sizeof(T));
+		});
+		RestoreOwnedParameters();
+	}
+
+	virtual int32 GetReplayBufferCapacity() const override { return ROLLOUT_SIZE; }
+	virtual int32 GetTrainingBatchSize() const override { return TRAINING_BATCH_SIZE; }
+
+	virtual int32 GetReplayBufferSize() const override
+	{
+		return RolloutRows;
+	}
+
+	virtual SIZE_T GetArenaSize() const override { return Arena.GetSize(); }
+	virtual int64 GetArenaAllocations() const override { return Arena.GetAllocations(); }
+
+	virtual void ResetTraining() override
+	{
+		rl_tools::init(device, PPO, ActorOptimizer, CriticOptimizer, rng);
+		RolloutRows = 0;
+		NumLanes = 0;
+		SyncInferenceActor();
+	}
+
+	// The rollout is consumed by every Train call, there is nothing to keep in a file
+	virtual bool OpenReplayBufferFile(const FString& FilePath) override
+	{
+		return false;
+	}
+
+	virtual void CloseReplayBufferFile() override
+	{
+	}
+
+	virtual void FlushReplayBufferFile() override
+	{
+	}
+
+	virtual void SetTrainingParameters(float ActorLearningRate, float CriticLearningRate, float Gamma) override
+	{
+		ActorOptimizer.parameters.alpha = ActorLearningRate;
+		CriticOptimizer.parameters.alpha = CriticLearningRate;
+		Discount = Gamma;
+	}
+
+	virtual void SetParallelCriticTraining(bool bParallel) override
+	{
+	}
+
+	virtual void SetPrioritizedReplay(bool bEnabled, float Alpha, float Beta, int32 BetaAnnealingUpdates) override
+	{
+	}
+
+	virtual void SetPPOParameters(int32 Epochs, float GAELambda) override
+	{
+		NumEpochs = FMath::Max(Epochs, 1);
+		Lambda = FMath::Clamp(GAELambda, 0.0f, 1.0f);
+	}
+
+	virtual void SampleTrainingActions(const float* NormalizedObservations, int32 NumRows, float* OutActions, bool bUniform) override
+	{
+		// There is no warmup; every action is drawn from the current policy so its log-probability is known
+		if (NumRows != NumLanes)
+		{
+			if (RolloutRows > 0)
+			{
+				UERL_WARNING( TEXT("TRLPPOAgentBackend::SampleTrainingActions - Environment count changed from %d to %d, discarding %d rollout rows"),
+					NumLanes, NumRows, RolloutRows);
+			}
+			RolloutRows = 0;
+			NumLanes = NumRows;
+		}
+		else if (RolloutRows % NumLanes != 0)
+		{
+			UERL_WARNING( TEXT("TRLPPOAgentBackend::SampleTrainingActions - Previous step stored %d of %d transitions, discarding %d rollout rows"),
+				RolloutRows % NumLanes, NumLanes, RolloutRows);
+			RolloutRows = 0;
+		}
+
+		EvaluateBatch(NormalizedObservations, NumRows, OutActions);
+
+		auto& LogStd = rl_tools::get_last_layer(PPO.actor).log_std.parameters;
+		T ActionStd[ACTION_DIM];
+		for (TI Action = 0; Action < ACTION_DIM; ++Action)
+		{
+			ActionStd[Action] = FMath::Exp(rl_tools::get(LogStd, 0, Action));
+		}
+
+		// Rows past the end of the rollout are acted on but not stored; their transitions are dropped by AddTransition
+		const int32 StoredRows = FMath::Clamp<int32>(ROLLOUT_SIZE - RolloutRows, 0, NumRows);
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			float* Actions = OutActions + Row * T_ACTION_DIM;
+			if (Row < StoredRows)
+			{
+				const TI Position = RolloutRows + Row;
+				FMemory::Memcpy(&rl_tools::get(Rollout.observations, Position, 0), NormalizedObservations + Row * OBSERVATION_DIM, OBSERVATION_DIM * sizeof(T));
+				T LogProbability = 0;
+				for (TI Action = 0; Action < ACTION_DIM; ++Action)
+				{
+					const T Mean = Actions[Action];
+					const T Sample = rl_tools::random::normal_distribution::sample(device.random, Mean, ActionStd[Action], rng);
+					LogProbability += rl_tools::random::normal_distribution::log_prob(device.random, Mean, rl_tools::get(LogStd, 0, Action), Sample);
+					rl_tools::set(Rollout.actions_mean, Position, Action, Mean);
+					rl_tools::set(Rollout.actions, Position, Action, Sample);
+					Actions[Action] = FMath::Clamp(Sample, (T)-1, (T)1);
+				}
+				rl_tools::set(Rollout.action_log_probs, Position, 0, LogProbability);
+			}
+			else
+			{
+				for (TI Action = 0; Action < ACTION_DIM; ++Action)
+				{
+					const T Sample = rl_tools::random::normal_distribution::sample(device.random, Actions[Action], ActionStd[Action], rng);
+					Actions[Action] = FMath::Clamp(Sample, (T)-1, (T)1);
+				}
+			}
+		}
+	}
+
+	virtual void AddTransition(const float* Observation, const float* Action, float Reward, const float* NextObservation, bool bTerminated, bool bTruncated) override
+	{
+		// Observation and action were stored when the action was sampled (normalized, and before clamping)
+		if (NumLanes == 0 || RolloutRows >= ROLLOUT_SIZE)
+		{
+			return;
+		}
+
+		const TI Position = RolloutRows;
+		rl_tools::set(Rollout.rewards, Position, 0, Reward);
+		rl_tools::set(Rollout.terminated, Position, 0, bTerminated ? (T)1 : (T)0);
+		// rl_tools' advantage estimate expects a termination to also end the trajectory
+		rl_tools::set(Rollout.truncated, Position, 0, bTerminated || bTruncated ? (T)1 : (T)0);
+
+		// Raw, normalized by Train with the plan of the update like TD3's batches
+		FMemory::Memcpy(&rl_tools::get(BootstrapObservations, Position % NumLanes, 0), NextObservation, OBSERVATION_DIM * sizeof(T));
+		++RolloutRows;
+	}
+
+	virtual bool Train(int32 InNumUpdates, const FRLNormalizationPlan& ObservationNormalization) override
+	{
+		if (RolloutRows < ROLLOUT_SIZE)
+		{
+			return false;
+		}
+
+		// Values of every row, then of each environment's last next observation, feed the advantage estimate
+		auto Observations = rl_tools::unsqueeze(device, rl_tools::to_tensor(device, Rollout.observations));
+		auto Values = rl_tools::unsqueeze(device, rl_tools::to_tensor(device, Rollout.values));
+		rl_tools::evaluate(device, PPO.critic, Observations, Values, CriticRolloutBuffer, rng);
+		const TI Lanes = FMath::Min<TI>(NumLanes, ROLLOUT_SIZE);
+		EvaluateBootstrapValues(Lanes, ObservationNormalization);
+		rl_tools::estimate_generalized_advantages(device, Rollout, LaneValues, LaneAdvantages, RolloutRows, Lanes, Discount, Lambda, PPO_PARAMETERS{});
+
+		for (int32 Epoch = 0; Epoch < NumEpochs; ++Epoch)
+		{
+			rl_tools::train(device, PPO, Rollout, ActorOptimizer, CriticOptimizer, PPOBuffers, TrainingActorBuffer, CriticBuffer, rng);
+		}
+
+		SyncInferenceActor();
+		RolloutRows = 0;
+		return true;
+	}
+
+	virtual void SetAsyncLearner(bool bAsync) override
+	{
+	}
+
+	virtual bool PublishPolicySnapshot(const FRLNormalizationPlan& ObservationNormalization) override
+	{
+		return false;
+	}
+
+	virtual void SampleRolloutActions(const float* Observations, int32 NumRows, float* OutActions) override
+	{
+		// Never called: PPO agents are not trained asynchronously. Acts uniformly like a TD3 learner without a snapshot.
+		for (int32 Index = 0; Index < NumRows * T_ACTION_DIM; ++Index)
+		{
+			OutActions[Index] = rl_tools::random::uniform_real_distribution(device.random, (T)-1, (T)1, rng);
+		}
+	}
+
+private:
+	// Storage of every container below
+	FRLAgentArena Arena;
+	DEVICE device;
+	RNG rng;
+
+	ACTOR_TYPE Actor;
+	ACTOR_BUFFER_TYPE ActorEvalBuffer;
+	INFERENCE_INPUT_TYPE InferenceInput;
+	INFERENCE_OUTPUT_TYPE InferenceOutput;
+	INFERENCE_SINGLE_INPUT_TYPE InferenceSingleInput;
+	INFERENCE_SINGLE_OUTPUT_TYPE InferenceSingleOutput;
+
+	PPO_TYPE PPO;
+	OPTIMIZER ActorOptimizer;
+	OPTIMIZER CriticOptimizer;
+	PPO_BUFFERS_TYPE PPOBuffers;
+	TRAINING_ACTOR_BUFFER_TYPE TrainingActorBuffer;
+	CRITIC_BUFFER_TYPE CriticBuffer;
+	CRITIC_ROLLOUT_BUFFER_TYPE CriticRolloutBuffer;
+	CRITIC_CHUNK_BUFFER_TYPE CriticChunkBuffer;
+	CRITIC_CHUNK_OUTPUT_TYPE CriticChunkOutput;
+
+	ROLLOUT_TYPE Rollout;
+	// Per environment: the value after its last row (bootstrap, then the recurrence of the advantage estimate), the
+	// running advantage and the raw next observation of its last row
+	LANE_VALUES_TYPE LaneValues;
+	LANE_VALUES_TYPE LaneAdvantages;
+	BOOTSTRAP_OBSERVATIONS_TYPE BootstrapObservations;
+	// Rows filled so far and the number of environments the rollout interleaves
+	TI RolloutRows = 0;
+	int32 NumLanes = 0;
+
+	T Discount = PPO_PARAMETERS::GAMMA;
+	T Lambda = PPO_PARAMETERS::LAMBDA;
+	int32 NumEpochs = 10;
+
+	// The inference actor's own parameter storage, kept while it is bound to external blocks
+	T* OwnedActorParameters[NUM_PARAMETER_BLOCKS] = {};
+	bool bParametersBound = false;
+
+	// Calls Function(ParameterMatrix, BlockIndex) for each dense parameter matrix of an actor MLP, in the order of
+	// GetPolicyParameterBlocks
+	template <typename NETWORK, typename FUNCTION>
+	static void ForEachParameterMatrix(NETWORK& Network, FUNCTION&& Function)
+	{
+		int32 Block = 0;
+		Function(Network.input_layer.weights.parameters, Block++);
+		Function(Network.input_layer.biases.parameters, Block++);
+		for (TI Layer = 0; Layer < ACTOR_TYPE::NUM_HIDDEN_LAYERS; ++Layer)
+		{
+			Function(Network.hidden_layers[Layer].weights.parameters, Block++);
+			Function(Network.hidden_layers[Layer].biases.parameters, Block++);
+		}
+		Function(Network.output_layer.weights.parameters, Block++);
+		Function(Network.output_layer.biases.parameters, Block++);
+	}
+
+	void RestoreOwnedParameters()
+	{
+		if (!bParametersBound)
+		{
+			return;
+		}
+
+		ForEachParameterMatrix(Actor, [this](auto& Parameters, int32 Block)
+		{
+			Parameters._data = OwnedActorParameters[Block];
+		});
+		bParametersBound = false;
+	}
+
+	void SyncInferenceActor()
+	{
+		// Bound parameters may be read-only; the copy below overwrites them anyway
+		RestoreOwnedParameters();
+
+		// The mean network has the inference actor's configuration; the log std only matters while sampling
+		ForEachParameterMatrix(PPO.actor.content, [this](const auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			FMemory::Memcpy(OwnedActorParameters[Block], Parameters._data, MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS * sizeof(T));
+		});
+	}
+
+	// Fills LaneValues with the critic's values of the environments' last next observations
+	void EvaluateBootstrapValues(TI Lanes, const FRLNormalizationPlan& ObservationNormalization)
+	{
+		for (TI LaneStart = 0; LaneStart < Lanes; LaneStart += INFERENCE_BATCH_SIZE)
+		{
+			const TI ChunkRows = FMath::Min<TI>(INFERENCE_BATCH_SIZE, Lanes - LaneStart);
+			ObservationNormalization.Apply(MakeArrayView(&rl_tools::get(BootstrapObservations, LaneStart, 0), ChunkRows * OBSERVATION_DIM),
+				MakeArrayView(rl_tools::data(InferenceInput), ChunkRows * OBSERVATION_DIM));
+			rl_tools::evaluate(device, PPO.critic, InferenceInput, CriticChunkOutput, CriticChunkBuffer, rng);
+			for (TI Lane = 0; Lane < ChunkRows; ++Lane)
+			{
+				rl_tools::set(LaneValues, 0, LaneStart + Lane, rl_tools::get(device, CriticChunkOutput, 0, Lane, 0));
+			}
+		}
+	}
+};
+
+template <int32 OBSERVATION_DIM, int32 ACTION_DIM, int32 HIDDEN_DIM>
+IRLAgentBackend* CreateRLPPOAgentBackend(uint32 Seed)
+{
+	return new TRLPPOAgentBackend<OBSERVATION_DIM, ACTION_DIM, HIDDEN_DIM>(Seed);
+}
+
+#define UERL_REGISTER_PPO_AGENT_BACKEND(ObservationDim, ActionDim, HiddenDim) \
+	static const bool PREPROCESSOR_JOIN(GUERLPPOAgentBackendRegistered_, __LINE__) = \
+		(FRLAgentBackendRegistry::Get().Register(ERLAlgorithm::PPO, ObservationDim, ActionDim, HiddenDim, &CreateRLPPOAgentBackend<ObservationDim, ActionDim, HiddenDim>), true);
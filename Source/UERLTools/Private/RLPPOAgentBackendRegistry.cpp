@@ -0,0 +1,18 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#include "RLAgentBackendGrid.h"
+#include "RLPPOAgentBackend.h"
+
+namespace UERLAgentBackendGrid
+{
+	// PPO networks are heavier to instantiate than TD3's, so the default grid covers the common shapes only. Anything
+	// else can be added with UERL_REGISTER_PPO_AGENT_BACKEND.
+	using FPPOObservationDims = TIntegerSequence<int32, 2, 3, 4, 6, 8, 12, 16, 32>;
+	using FPPOActionDims = TIntegerSequence<int32, 1, 2, 3, 4>;
+	using FPPOHiddenDims = TIntegerSequence<int32, 64, 128>;
+
+	void RegisterPPOBackends(FRLAgentBackendRegistry& Registry)
+	{
+		RegisterGrid<TRLPPOAgentBackend, FPPOObservationDims, FPPOActionDims>(Registry, ERLAlgorithm::PPO, FPPOHiddenDims{});
+	}
+}
@@ -0,0 +1,378 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#include "RLPolicyFile.h"
+#include "RLRunningNormalizer.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+
+// Module-wide log categories
+#include "UERLLog.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Policy files are little-endian images of the structs below");
+
+namespace
+{
+	enum EPolicyFileFlags : uint32
+	{
+		PolicyFileFlag_ObservationNormalization = 1 << 0,
+		PolicyFileFlag_ActionNormalization = 1 << 1,
+		PolicyFileFlag_RunningObservationNormalization = 1 << 2,
+	};
+
+	struct FPolicyFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 Checksum;
+		uint32 Flags;
+		int32 ObservationDim;
+		int32 ActionDim;
+		int32 HiddenDim;
+		int32 NumBlocks;
+		int64 FileSize;
+		int64 NormalizationOffset;
+		int64 StatisticsCount;
+		uint32 HeaderSize;
+		uint32 Reserved;
+	};
+	static_assert(sizeof(FPolicyFileHeader) == 64, "The policy file header is 64 bytes");
+
+	struct FPolicyFileBlock
+	{
+		int32 Rows;
+		int32 Cols;
+		int64 Offset;
+	};
+	static_assert(sizeof(FPolicyFileBlock) == 16, "Policy file block entries are 16 bytes");
+
+	// Statistics Mean and M2, then observation and action Mean/StdDev
+	int64 GetNormalizationSize(int32 ObservationDim, int32 ActionDim)
+	{
+		return 2 * sizeof(double) * ObservationDim + 2 * sizeof(float) * (ObservationDim + ActionDim);
+	}
+
+	// Writes Dim values with FRLNormalizationPlan's rules: a single value broadcasts, missing entries use Default
+	void WriteExpanded(float* Out, const TArray<float>& Values, int32 Dim, float Default)
+	{
+		for (int32 Feature = 0; Feature < Dim; ++Feature)
+		{
+			Out[Feature] = Values.Num() == 1 ? Values[0] : (Feature < Values.Num() ? Values[Feature] : Default);
+		}
+	}
+
+	const FPolicyFileHeader& GetFileHeader(const uint8* Data)
+	{
+		return *reinterpret_cast<const FPolicyFileHeader*>(Data);
+	}
+
+	const FPolicyFileBlock* GetFileBlocks(const uint8* Data)
+	{
+		return reinterpret_cast<const FPolicyFileBlock*>(Data + sizeof(FPolicyFileHeader));
+	}
+
+	// CRC32 of the whole file with the header's Checksum field taken as zero, so flags, dims and offsets are covered too
+	uint32 ComputeChecksum(const uint8* Data, int64 Size)
+	{
+		FPolicyFileHeader Header = GetFileHeader(Data);
+		Header.Checksum = 0;
+		const uint32 HeaderChecksum = FCrc::MemCrc32(&Header, sizeof(FPolicyFileHeader));
+		return FCrc::MemCrc32(Data + sizeof(FPolicyFileHeader), static_cast<int32>(Size - sizeof(FPolicyFileHeader)), HeaderChecksum);
+	}
+}
+
+bool FRLPolicyFile::Save(const FString& FilePath, const FRLPolicyFileContents& Contents)
+{
+	const int32 ObservationDim = Contents.ObservationDim;
+	const int32 ActionDim = Contents.ActionDim;
+	const int32 NumBlocks = Contents.ParameterBlocks.Num();
+
+	// Lay out the file first so it is written with a single allocation
+	const int64 NormalizationOffset = sizeof(FPolicyFileHeader) + sizeof(FPolicyFileBlock) * NumBlocks;
+	int64 FileSize = NormalizationOffset + GetNormalizationSize(ObservationDim, ActionDim);
+
+	TArray<FPolicyFileBlock, TInlineAllocator<16>> Blocks;
+	Blocks.SetNumUninitialized(NumBlocks);
+	for (int32 Index = 0; Index < NumBlocks; ++Index)
+	{
+		const FRLPolicyParameterBlock& Source = Contents.ParameterBlocks[Index];
+		if (!Source.Data || Source.Rows <= 0 || Source.Cols <= 0)
+		{
+			UERL_ERROR( TEXT("FRLPolicyFile::Save - Parameter block %d is empty"), Index);
+			return false;
+		}
+		FileSize = Align(FileSize, BlockAlignment);
+		Blocks[Index].Rows = Source.Rows;
+		Blocks[Index].Cols = Source.Cols;
+		Blocks[Index].Offset = FileSize;
+		FileSize += sizeof(float) * int64(Source.Rows) * Source.Cols;
+	}
+	if (FileSize > MAX_int32)
+	{
+		UERL_ERROR( TEXT("FRLPolicyFile::Save - Policy of %lld bytes is too large"), FileSize);
+		return false;
+	}
+
+	TArray<uint8> Buffer;
+	Buffer.SetNumZeroed(FileSize);
+	uint8* Data = Buffer.GetData();
+
+	FPolicyFileHeader& Header = *reinterpret_cast<FPolicyFileHeader*>(Data);
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.ObservationDim = ObservationDim;
+	Header.ActionDim = ActionDim;
+	Header.HiddenDim = Contents.HiddenDim;
+	Header.NumBlocks = NumBlocks;
+	Header.FileSize = FileSize;
+	Header.NormalizationOffset = NormalizationOffset;
+	Header.HeaderSize = sizeof(FPolicyFileHeader);
+	Header.Flags = (Contents.ObservationNormalizationParams.bIsEnabled ? PolicyFileFlag_ObservationNormalization : 0)
+		| (Contents.ActionNormalizationParams.bIsEnabled ? PolicyFileFlag_ActionNormalization : 0)
+		| (Contents.bUseRunningObservationNormalization ? PolicyFileFlag_RunningObservationNormalization : 0);
+
+	FMemory::Memcpy(Data + sizeof(FPolicyFileHeader), Blocks.GetData(), sizeof(FPolicyFileBlock) * NumBlocks);
+
+	double* StatisticsMean = reinterpret_cast<double*>(Data + NormalizationOffset);
+	double* StatisticsM2 = StatisticsMean + ObservationDim;
+	const FRLRunningNormalizer* Statistics = Contents.ObservationStatistics;
+	if (Statistics && Statistics->GetDim() == ObservationDim)
+	{
+		Header.StatisticsCount = Statistics->GetCount();
+		FMemory::Memcpy(StatisticsMean, Statistics->GetMean().GetData(), sizeof(double) * ObservationDim);
+		FMemory::Memcpy(StatisticsM2, Statistics->GetM2().GetData(), sizeof(double) * ObservationDim);
+	}
+
+	float* ObservationMean = reinterpret_cast<float*>(StatisticsM2 + ObservationDim);
+	float* ObservationStdDev = ObservationMean + ObservationDim;
+	float* ActionMean = ObservationStdDev + ObservationDim;
+	float* ActionStdDev = ActionMean + ActionDim;
+	WriteExpanded(ObservationMean, Contents.ObservationNormalizationParams.Mean, ObservationDim, 0.0f);
+	WriteExpanded(ObservationStdDev, Contents.ObservationNormalizationParams.StdDev, ObservationDim, 1.0f);
+	WriteExpanded(ActionMean, Contents.ActionNormalizationParams.Mean, ActionDim, 0.0f);
+	WriteExpanded(ActionStdDev, Contents.ActionNormalizationParams.StdDev, ActionDim, 1.0f);
+
+	for (int32 Index = 0; Index < NumBlocks; ++Index)
+	{
+		const FRLPolicyParameterBlock& Source = Contents.ParameterBlocks[Index];
+		FMemory::Memcpy(Data + Blocks[Index].Offset, Source.Data, sizeof(float) * Source.Rows * Source.Cols);
+	}
+
+	Header.Checksum = ComputeChecksum(Data, FileSize);
+
+	if (!FFileHelper::SaveArrayToFile(Buffer, *FilePath))
+	{
+		UERL_ERROR( TEXT("FRLPolicyFile::Save - Failed to write %s"), *FilePath);
+		return false;
+	}
+	return true;
+}
+
+FRLPolicyFile::FRLPolicyFile()
+	: Data(nullptr)
+	, Size(0)
+{
+}
+
+FRLPolicyFile::~FRLPolicyFile()
+{
+	Close();
+}
+
+FRLPolicyFile::FRLPolicyFile(FRLPolicyFile&& Other)
+	: FRLPolicyFile()
+{
+	*this = MoveTemp(Other);
+}
+
+FRLPolicyFile& FRLPolicyFile::operator=(FRLPolicyFile&& Other)
+{
+	if (this != &Other)
+	{
+		Close();
+		MappedHandle = MoveTemp(Other.MappedHandle);
+		MappedRegion = MoveTemp(Other.MappedRegion);
+		FileData = MoveTemp(Other.FileData);
+		Data = Other.Data;
+		Size = Other.Size;
+		Other.Data = nullptr;
+		Other.Size = 0;
+	}
+	return *this;
+}
+
+bool FRLPolicyFile::Open(const FString& FilePath)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	MappedHandle.Reset(PlatformFile.OpenMapped(*FilePath));
+	if (MappedHandle)
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	}
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Some platforms cannot map files; the same layout works from an in-memory copy
+		MappedHandle.Reset();
+		if (!FFileHelper::LoadFileToArray(FileData, *FilePath))
+		{
+			UERL_ERROR( TEXT("FRLPolicyFile::Open - Cannot read %s"), *FilePath);
+			return false;
+		}
+		Data = FileData.GetData();
+		Size = FileData.Num();
+	}
+
+	if (!Validate(FilePath))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void FRLPolicyFile::Close()
+{
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	FileData.Empty();
+	Data = nullptr;
+	Size = 0;
+}
+
+bool FRLPolicyFile::Validate(const FString& FilePath) const
+{
+	if (Size < static_cast<int64>(sizeof(FPolicyFileHeader)))
+	{
+		UERL_ERROR( TEXT("FRLPolicyFile::Open - Not a policy file: %s"), *FilePath);
+		return false;
+	}
+
+	const FPolicyFileHeader& Header = GetFileHeader(Data);
+	if (Header.Magic != Magic || Header.HeaderSize != sizeof(FPolicyFileHeader))
+	{
+		UERL_ERROR( TEXT("FRLPolicyFile::Open - Not a policy file: %s"), *FilePath);
+		return false;
+	}
+	if (Header.Version != Version)
+	{
+		UERL_ERROR( TEXT("FRLPolicyFile::Open - Unsupported policy file version %u (expected %u): %s"), Header.Version, Version, *FilePath);
+		return false;
+	}
+	if (Header.FileSize != Size || Size > MAX_int32)
+	{
+		UERL_ERROR( TEXT("FRLPolicyFile::Open - Truncated or oversized policy file (%lld bytes, header says %lld): %s"), Size, Header.FileSize, *FilePath);
+		return false;
+	}
+
+	// The checksum covers the header too, so a corrupted header is caught even when its layout still looks valid
+	const uint32 Checksum = ComputeChecksum(Data, Size);
+	if (Checksum != Header.Checksum)
+	{
+		UERL_ERROR( TEXT("FRLPolicyFile::Open - Checksum mismatch (%08x, expected %08x): %s"), Checksum, Header.Checksum, *FilePath);
+		return false;
+	}
+
+	// Every section has to lie inside the file before anything points into it
+	const int64 BlockTableEnd = sizeof(FPolicyFileHeader) + sizeof(FPolicyFileBlock) * int64(Header.NumBlocks);
+	if (Header.ObservationDim <= 0 || Header.ActionDim <= 0 || Header.NumBlocks <= 0 || BlockTableEnd > Size
+		|| Header.NormalizationOffset < BlockTableEnd || Header.NormalizationOffset % alignof(double) != 0
+		|| Header.NormalizationOffset + GetNormalizationSize(Header.ObservationDim, Header.ActionDim) > Size)
+	{
+		UERL_ERROR( TEXT("FRLPolicyFile::Open - Corrupt policy file layout: %s"), *FilePath);
+		return false;
+	}
+
+	const FPolicyFileBlock* Blocks = GetFileBlocks(Data);
+	for (int32 Index = 0; Index < Header.NumBlocks; ++Index)
+	{
+		const FPolicyFileBlock& Block = Blocks[Index];
+		if (Block.Rows <= 0 || Block.Cols <= 0 || Block.Offset % BlockAlignment != 0 || Block.Offset < BlockTableEnd
+			|| Block.Offset + sizeof(float) * int64(Block.Rows) * Block.Cols > Size)
+		{
+			UERL_ERROR( TEXT("FRLPolicyFile::Open - Corrupt parameter block %d in %s"), Index, *FilePath);
+			return false;
+		}
+	}
+	return true;
+}
+
+int32 FRLPolicyFile::GetObservationDim() const
+{
+	return Data ? GetFileHeader(Data).ObservationDim : 0;
+}
+
+int32 FRLPolicyFile::GetActionDim() const
+{
+	return Data ? GetFileHeader(Data).ActionDim : 0;
+}
+
+int32 FRLPolicyFile::GetHiddenDim() const
+{
+	return Data ? GetFileHeader(Data).HiddenDim : 0;
+}
+
+bool FRLPolicyFile::UsesRunningObservationNormalization() const
+{
+	return Data && (GetFileHeader(Data).Flags & PolicyFileFlag_RunningObservationNormalization) != 0;
+}
+
+int32 FRLPolicyFile::GetNumParameterBlocks() const
+{
+	return Data ? GetFileHeader(Data).NumBlocks : 0;
+}
+
+FRLPolicyParameterBlock FRLPolicyFile::GetParameterBlock(int32 Index) const
+{
+	FRLPolicyParameterBlock Result;
+	if (Index >= 0 && Index < GetNumParameterBlocks())
+	{
+		const FPolicyFileBlock& Block = GetFileBlocks(Data)[Index];
+		Result.Data = reinterpret_cast<const float*>(Data + Block.Offset);
+		Result.Rows = Block.Rows;
+		Result.Cols = Block.Cols;
+	}
+	return Result;
+}
+
+bool FRLPolicyFile::ReadObservationStatistics(FRLRunningNormalizer& OutStatistics) const
+{
+	if (!Data)
+	{
+		return false;
+	}
+
+	const FPolicyFileHeader& Header = GetFileHeader(Data);
+	const double* StatisticsMean = reinterpret_cast<const double*>(Data + Header.NormalizationOffset);
+	return OutStatistics.Restore(Header.ObservationDim, Header.StatisticsCount,
+		MakeArrayView(StatisticsMean, Header.ObservationDim), MakeArrayView(StatisticsMean + Header.ObservationDim, Header.ObservationDim));
+}
+
+void FRLPolicyFile::ReadNormalizationParams(FRLNormalizationParams& OutObservationParams, FRLNormalizationParams& OutActionParams) const
+{
+	if (!Data)
+	{
+		return;
+	}
+
+	const FPolicyFileHeader& Header = GetFileHeader(Data);
+	const float* ObservationMean = reinterpret_cast<const float*>(Data + Header.NormalizationOffset + 2 * sizeof(double) * Header.ObservationDim);
+	const float* ObservationStdDev = ObservationMean + Header.ObservationDim;
+	const float* ActionMean = ObservationStdDev + Header.ObservationDim;
+	const float* ActionStdDev = ActionMean + Header.ActionDim;
+
+	OutObservationParams.bIsEnabled = (Header.Flags & PolicyFileFlag_ObservationNormalization) != 0;
+	OutObservationParams.Mean = TArray<float>(ObservationMean, Header.ObservationDim);
+	OutObservationParams.StdDev = TArray<float>(ObservationStdDev, Header.ObservationDim);
+	OutActionParams.bIsEnabled = (Header.Flags & PolicyFileFlag_ActionNormalization) != 0;
+	OutActionParams.Mean = TArray<float>(ActionMean, Header.ActionDim);
+	OutActionParams.StdDev = TArray<float>(ActionStdDev, Header.ActionDim);
+}
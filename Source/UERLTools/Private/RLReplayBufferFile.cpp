@@ -0,0 +1,297 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#include "RLReplayBufferFile.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include "Windows/WindowsHWrapper.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_UNIX || PLATFORM_MAC
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Module-wide log categories
+#include "UERLLog.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Replay buffer files are little-endian images of the structs below");
+
+namespace
+{
+	struct FReplayBufferFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int32 ObservationDim;
+		int32 ActionDim;
+		int32 RowElements;
+		int32 ElementSize;
+		int32 ScalarElements;
+		int32 SequenceSize;
+		int64 Capacity;
+		int64 SequenceOffset;
+		int64 RowsOffset;
+		int64 ScalarsOffset;
+	};
+	static_assert(sizeof(FReplayBufferFileHeader) == 64, "The replay buffer file header is 64 bytes");
+
+	FReplayBufferFileHeader MakeFileHeader(const FRLReplayBufferFileLayout& Layout)
+	{
+		FReplayBufferFileHeader Header = {};
+		Header.Magic = FRLReplayBufferFile::Magic;
+		Header.Version = FRLReplayBufferFile::Version;
+		Header.ObservationDim = Layout.ObservationDim;
+		Header.ActionDim = Layout.ActionDim;
+		Header.RowElements = Layout.RowElements;
+		Header.ElementSize = Layout.ElementSize;
+		Header.ScalarElements = Layout.ScalarElements;
+		Header.SequenceSize = Layout.SequenceSize;
+		Header.Capacity = Layout.Capacity;
+		Header.SequenceOffset = Align(int64(sizeof(FReplayBufferFileHeader)), FRLReplayBufferFile::PageAlignment);
+		Header.RowsOffset = Align(Header.SequenceOffset + Layout.SequenceSize * Layout.Capacity, FRLReplayBufferFile::PageAlignment);
+		Header.ScalarsOffset = Align(Header.RowsOffset + int64(Layout.RowElements) * Layout.ElementSize * Layout.Capacity, FRLReplayBufferFile::PageAlignment);
+		return Header;
+	}
+
+	int64 GetFileSize(const FReplayBufferFileHeader& Header)
+	{
+		return Header.ScalarsOffset + int64(Header.ScalarElements) * sizeof(float) * Header.Capacity;
+	}
+}
+
+FRLReplayBufferFile::FRLReplayBufferFile()
+	: Data(nullptr)
+	, Size(0)
+#if PLATFORM_WINDOWS
+	, FileHandle(nullptr)
+	, MappingHandle(nullptr)
+#else
+	, FileDescriptor(-1)
+#endif
+{
+}
+
+FRLReplayBufferFile::~FRLReplayBufferFile()
+{
+	Close();
+}
+
+bool FRLReplayBufferFile::Open(const FString& FilePath, const FRLReplayBufferFileLayout& Layout)
+{
+	Close();
+
+	if (Layout.ObservationDim <= 0 || Layout.ActionDim <= 0 || Layout.RowElements <= 0 || Layout.ElementSize <= 0
+		|| Layout.ScalarElements < 0 || Layout.SequenceSize <= 0 || Layout.Capacity <= 0)
+	{
+		UERL_ERROR( TEXT("FRLReplayBufferFile::Open - Invalid layout for %s"), *FilePath);
+		return false;
+	}
+
+	const FReplayBufferFileHeader Expected = MakeFileHeader(Layout);
+	const int64 FileSize = GetFileSize(Expected);
+	const FString FullPath = FPaths::ConvertRelativePathToFull(FilePath);
+	const int64 ExistingSize = IFileManager::Get().FileSize(*FullPath);
+	const bool bExisting = ExistingSize >= 0;
+	if (bExisting && ExistingSize != FileSize)
+	{
+		UERL_ERROR( TEXT("FRLReplayBufferFile::Open - %s has %lld bytes, this buffer needs %lld"), *FullPath, ExistingSize, FileSize);
+		return false;
+	}
+	if (!bExisting)
+	{
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(FullPath), true);
+	}
+
+	if (!Map(FullPath, FileSize))
+	{
+		return false;
+	}
+
+	FReplayBufferFileHeader& Header = *reinterpret_cast<FReplayBufferFileHeader*>(Data);
+	if (!bExisting)
+	{
+		// The rest of a new file reads as zeros: no row has a sequence number, so none is published
+		Header = Expected;
+		Flush();
+	}
+	else if (FMemory::Memcmp(&Header, &Expected, sizeof(FReplayBufferFileHeader)) != 0)
+	{
+		UERL_ERROR( TEXT("FRLReplayBufferFile::Open - %s is not a replay buffer file of this layout (%d observations, %d actions, %lld rows)"),
+			*FullPath, Layout.ObservationDim, Layout.ActionDim, Layout.Capacity);
+		Close();
+		return false;
+	}
+
+	OpenFilePath = FilePath;
+	UERL_LOG( TEXT("FRLReplayBufferFile::Open - %s %s (%lld rows, %lld MB)"), bExisting ? TEXT("Reopened") : TEXT("Created"),
+		*FullPath, Layout.Capacity, FileSize >> 20);
+	return true;
+}
+
+void FRLReplayBufferFile::Close()
+{
+	if (Data)
+	{
+		Flush();
+	}
+	Unmap();
+	OpenFilePath.Reset();
+}
+
+void* FRLReplayBufferFile::GetSequences() const
+{
+	check(Data);
+	return Data + reinterpret_cast<const FReplayBufferFileHeader*>(Data)->SequenceOffset;
+}
+
+void* FRLReplayBufferFile::GetRows() const
+{
+	check(Data);
+	return Data + reinterpret_cast<const FReplayBufferFileHeader*>(Data)->RowsOffset;
+}
+
+void* FRLReplayBufferFile::GetScalars() const
+{
+	check(Data);
+	return Data + reinterpret_cast<const FReplayBufferFileHeader*>(Data)->ScalarsOffset;
+}
+
+#if PLATFORM_WINDOWS
+
+bool FRLReplayBufferFile::Map(const FString& FilePath, int64 FileSize)
+{
+	HANDLE File = CreateFileW(*FilePath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (File == INVALID_HANDLE_VALUE)
+	{
+		UERL_ERROR( TEXT("FRLReplayBufferFile::Open - Cannot open %s (error %u)"), *FilePath, GetLastError());
+		return false;
+	}
+	FileHandle = File;
+
+	// Mapping a file larger than it is grows it; the new range reads as zeros
+	HANDLE Mapping = CreateFileMappingW(File, nullptr, PAGE_READWRITE, DWORD(uint64(FileSize) >> 32), DWORD(uint64(FileSize) & 0xFFFFFFFF), nullptr);
+	if (!Mapping)
+	{
+		UERL_ERROR( TEXT("FRLReplayBufferFile::Open - Cannot map %s (error %u)"), *FilePath, GetLastError());
+		Unmap();
+		return false;
+	}
+	MappingHandle = Mapping;
+
+	Data = static_cast<uint8*>(MapViewOfFile(Mapping, FILE_MAP_ALL_ACCESS, 0, 0, SIZE_T(FileSize)));
+	if (!Data)
+	{
+		UERL_ERROR( TEXT("FRLReplayBufferFile::Open - Cannot map a view of %s (error %u)"), *FilePath, GetLastError());
+		Unmap();
+		return false;
+	}
+	Size = FileSize;
+	return true;
+}
+
+void FRLReplayBufferFile::Unmap()
+{
+	if (Data)
+	{
+		UnmapViewOfFile(Data);
+		Data = nullptr;
+		Size = 0;
+	}
+	if (MappingHandle)
+	{
+		CloseHandle(MappingHandle);
+		MappingHandle = nullptr;
+	}
+	if (FileHandle)
+	{
+		CloseHandle(FileHandle);
+		FileHandle = nullptr;
+	}
+}
+
+void FRLReplayBufferFile::Flush()
+{
+	if (Data)
+	{
+		FlushViewOfFile(Data, SIZE_T(Size));
+		FlushFileBuffers(FileHandle);
+	}
+}
+
+#elif PLATFORM_UNIX || PLATFORM_MAC
+
+bool FRLReplayBufferFile::Map(const FString& FilePath, int64 FileSize)
+{
+	FileDescriptor = open(TCHAR_TO_UTF8(*FilePath), O_RDWR | O_CREAT, 0644);
+	if (FileDescriptor < 0)
+	{
+		UERL_ERROR( TEXT("FRLReplayBufferFile::Open - Cannot open %s (errno %d)"), *FilePath, errno);
+		return false;
+	}
+	// Grows a new file sparsely; the new range reads as zeros
+	if (ftruncate(FileDescriptor, FileSize) != 0)
+	{
+		UERL_ERROR( TEXT("FRLReplayBufferFile::Open - Cannot size %s to %lld bytes (errno %d)"), *FilePath, FileSize, errno);
+		Unmap();
+		return false;
+	}
+
+	void* Mapping = mmap(nullptr, size_t(FileSize), PROT_READ | PROT_WRITE, MAP_SHARED, FileDescriptor, 0);
+	if (Mapping == MAP_FAILED)
+	{
+		UERL_ERROR( TEXT("FRLReplayBufferFile::Open - Cannot map %s (errno %d)"), *FilePath, errno);
+		Unmap();
+		return false;
+	}
+	// Sampling touches rows at random; read-ahead would only pull in rows nobody asked for
+	madvise(Mapping, size_t(FileSize), MADV_RANDOM);
+	Data = static_cast<uint8*>(Mapping);
+	Size = FileSize;
+	return true;
+}
+
+void FRLReplayBufferFile::Unmap()
+{
+	if (Data)
+	{
+		munmap(Data, size_t(Size));
+		Data = nullptr;
+		Size = 0;
+	}
+	if (FileDescriptor >= 0)
+	{
+		close(FileDescriptor);
+		FileDescriptor = -1;
+	}
+}
+
+void FRLReplayBufferFile::Flush()
+{
+	if (Data)
+	{
+		msync(Data, size_t(Size), MS_SYNC);
+	}
+}
+
+#else
+
+bool FRLReplayBufferFile::Map(const FString& FilePath, int64 FileSize)
+{
+	UERL_ERROR( TEXT("FRLReplayBufferFile::Open - Writable file mappings are not supported on this platform"));
+	return false;
+}
+
+void FRLReplayBufferFile::Unmap()
+{
+}
+
+void FRLReplayBufferFile::Flush()
+{
+}
+
+#endif
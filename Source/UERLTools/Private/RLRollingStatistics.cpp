@@ -0,0 +1,116 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#include "RLRollingStatistics.h"
+#include "Algo/BinarySearch.h"
+
+FRLRollingStatistics::FRLRollingStatistics(int32 InCapacity)
+{
+	Reset(InCapacity);
+}
+
+void FRLRollingStatistics::Reset(int32 InCapacity)
+{
+	Capacity = FMath::Max(InCapacity, 1);
+	Count = 0;
+	Head = 0;
+	Mean = 0.0;
+	M2 = 0.0;
+	Ring.SetNumZeroed(Capacity);
+	Sorted.SetNumZeroed(Capacity);
+}
+
+void FRLRollingStatistics::Add(float Value)
+{
+	if (Count < Capacity)
+	{
+		++Count;
+		const double Delta = Value - Mean;
+		Mean += Delta / Count;
+		M2 += Delta * (Value - Mean);
+	}
+	else
+	{
+		// Replace the oldest value: the mean moves by the difference, M2 by both values' deviations
+		const float Oldest = Ring[Head];
+		const double OldMean = Mean;
+		Mean += (static_cast<double>(Value) - Oldest) / Count;
+		M2 += (static_cast<double>(Value) - Oldest) * (Value - Mean + Oldest - OldMean);
+		RemoveSorted(Oldest);
+	}
+
+	Ring[Head] = Value;
+	InsertSorted(Value);
+	Head = (Head + 1) % Capacity;
+
+	if (Head == 0 && Count == Capacity)
+	{
+		RecomputeMoments();
+	}
+}
+
+float FRLRollingStatistics::GetPercentile(float Fraction) const
+{
+	if (Count == 0)
+	{
+		return 0.0f;
+	}
+
+	const float Rank = FMath::Clamp(Fraction, 0.0f, 1.0f) * (Count - 1);
+	const int32 Lower = FMath::FloorToInt(Rank);
+	const int32 Upper = FMath::Min(Lower + 1, Count - 1);
+	return FMath::Lerp(Sorted[Lower], Sorted[Upper], Rank - Lower);
+}
+
+FRLStatisticsSummary FRLRollingStatistics::GetSummary() const
+{
+	FRLStatisticsSummary Summary;
+	Summary.Count = Count;
+	if (Count == 0)
+	{
+		return Summary;
+	}
+
+	Summary.Mean = static_cast<float>(Mean);
+	Summary.StdDev = static_cast<float>(FMath::Sqrt(GetVariance()));
+	Summary.Min = Sorted[0];
+	Summary.Max = Sorted[Count - 1];
+	Summary.P50 = GetPercentile(0.5f);
+	Summary.P90 = GetPercentile(0.9f);
+	Summary.P99 = GetPercentile(0.99f);
+	return Summary;
+}
+
+void FRLRollingStatistics::RemoveSorted(float Value)
+{
+	// Called with the window full, before the new value takes the slot; the value is always present
+	float* Values = Sorted.GetData();
+	const int32 Index = Algo::LowerBound(MakeArrayView(Values, Count), Value);
+	FMemory::Memmove(Values + Index, Values + Index + 1, (Count - 1 - Index) * sizeof(float));
+}
+
+void FRLRollingStatistics::InsertSorted(float Value)
+{
+	// Sorted holds Count - 1 values here: one was just added to the count or removed by RemoveSorted
+	const int32 Used = Count - 1;
+	float* Values = Sorted.GetData();
+	const int32 Index = Algo::UpperBound(MakeArrayView(Values, Used), Value);
+	FMemory::Memmove(Values + Index + 1, Values + Index, (Used - Index) * sizeof(float));
+	Values[Index] = Value;
+}
+
+void FRLRollingStatistics::RecomputeMoments()
+{
+	double Sum = 0.0;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		Sum += Ring[Index];
+	}
+	Mean = Sum / Count;
+
+	M2 = 0.0;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const double Delta = Ring[Index] - Mean;
+		M2 += Delta * Delta;
+	}
+}
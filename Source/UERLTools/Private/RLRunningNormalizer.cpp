@@ -0,0 +1,178 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#include "RLRunningNormalizer.h"
+
+// Module-wide log categories
+#include "UERLLog.h"
+
+FRLRunningNormalizer::FRLRunningNormalizer()
+	: Dim(0)
+	, Count(0)
+	, bIsFrozen(false)
+{
+}
+
+void FRLRunningNormalizer::Reset(int32 InDim)
+{
+	Dim = FMath::Max(InDim, 0);
+	Count = 0;
+	bIsFrozen = false;
+	Mean.SetNumZeroed(Dim);
+	M2.SetNumZeroed(Dim);
+	BatchMean.SetNumZeroed(Dim);
+	BatchM2.SetNumZeroed(Dim);
+}
+
+void FRLRunningNormalizer::MergeMoments(int64 OtherCount, const double* OtherMean, const double* OtherM2)
+{
+	if (OtherCount <= 0)
+	{
+		return;
+	}
+
+	const double CountA = static_cast<double>(Count);
+	const double CountB = static_cast<double>(OtherCount);
+	const double Total = CountA + CountB;
+	const double WeightB = CountB / Total;
+	const double CrossWeight = CountA * CountB / Total;
+
+	for (int32 Feature = 0; Feature < Dim; ++Feature)
+	{
+		const double Delta = OtherMean[Feature] - Mean[Feature];
+		Mean[Feature] += Delta * WeightB;
+		M2[Feature] += OtherM2[Feature] + Delta * Delta * CrossWeight;
+	}
+	Count += OtherCount;
+}
+
+bool FRLRunningNormalizer::Update(TConstArrayView<float> Rows)
+{
+	if (bIsFrozen)
+	{
+		return true;
+	}
+
+	if (Dim == 0 || Rows.Num() % Dim != 0)
+	{
+		UERL_ERROR( TEXT("FRLRunningNormalizer::Update - Expected rows of %d floats, got %d floats"), Dim, Rows.Num());
+		return false;
+	}
+
+	const int32 NumRows = Rows.Num() / Dim;
+	if (NumRows == 0)
+	{
+		return true;
+	}
+
+	// Two passes over the batch give its exact mean and M2, which are then merged like another worker's statistics
+	double* RESTRICT OutMean = BatchMean.GetData();
+	double* RESTRICT OutM2 = BatchM2.GetData();
+	const float* Data = Rows.GetData();
+
+	for (int32 Feature = 0; Feature < Dim; ++Feature)
+	{
+		OutMean[Feature] = 0.0;
+		OutM2[Feature] = 0.0;
+	}
+	for (int32 Row = 0; Row < NumRows; ++Row)
+	{
+		const float* RowData = Data + Row * Dim;
+		for (int32 Feature = 0; Feature < Dim; ++Feature)
+		{
+			OutMean[Feature] += RowData[Feature];
+		}
+	}
+	const double InvNumRows = 1.0 / NumRows;
+	for (int32 Feature = 0; Feature < Dim; ++Feature)
+	{
+		OutMean[Feature] *= InvNumRows;
+	}
+	for (int32 Row = 0; Row < NumRows; ++Row)
+	{
+		const float* RowData = Data + Row * Dim;
+		for (int32 Feature = 0; Feature < Dim; ++Feature)
+		{
+			const double Deviation = RowData[Feature] - OutMean[Feature];
+			OutM2[Feature] += Deviation * Deviation;
+		}
+	}
+
+	MergeMoments(NumRows, OutMean, OutM2);
+	return true;
+}
+
+bool FRLRunningNormalizer::Merge(const FRLRunningNormalizer& Other)
+{
+	if (bIsFrozen)
+	{
+		return true;
+	}
+
+	if (Other.Dim != Dim)
+	{
+		UERL_ERROR( TEXT("FRLRunningNormalizer::Merge - Dimension mismatch (%d vs %d)"), Dim, Other.Dim);
+		return false;
+	}
+
+	MergeMoments(Other.Count, Other.Mean.GetData(), Other.M2.GetData());
+	return true;
+}
+
+bool FRLRunningNormalizer::ToParams(FRLNormalizationParams& Params, float Epsilon) const
+{
+	if (Count < 2)
+	{
+		return false;
+	}
+
+	// Reuses the params' allocations, so refreshing a plan every step does not allocate
+	Params.bIsEnabled = true;
+	Params.Mean.SetNumUninitialized(Dim, /*bAllowShrinking=*/ false);
+	Params.StdDev.SetNumUninitialized(Dim, /*bAllowShrinking=*/ false);
+
+	const double InvCount = 1.0 / static_cast<double>(Count);
+	for (int32 Feature = 0; Feature < Dim; ++Feature)
+	{
+		Params.Mean[Feature] = static_cast<float>(Mean[Feature]);
+		Params.StdDev[Feature] = static_cast<float>(FMath::Sqrt(M2[Feature] * InvCount + Epsilon));
+	}
+	return true;
+}
+
+bool FRLRunningNormalizer::Restore(int32 InDim, int64 InCount, TConstArrayView<double> InMean, TConstArrayView<double> InM2)
+{
+	if (InDim < 0 || InCount < 0 || InMean.Num() != InDim || InM2.Num() != InDim)
+	{
+		UERL_ERROR( TEXT("FRLRunningNormalizer::Restore - Invalid statistics (Dim: %d, Count: %lld, Mean: %d, M2: %d)"), InDim, InCount, InMean.Num(), InM2.Num());
+		return false;
+	}
+
+	Reset(InDim);
+	Count = InCount;
+	FMemory::Memcpy(Mean.GetData(), InMean.GetData(), sizeof(double) * Dim);
+	FMemory::Memcpy(M2.GetData(), InM2.GetData(), sizeof(double) * Dim);
+	bIsFrozen = true;
+	return true;
+}
+
+FArchive& operator<<(FArchive& Ar, FRLRunningNormalizer& Normalizer)
+{
+	Ar << Normalizer.Dim;
+	Ar << Normalizer.Count;
+	Ar << Normalizer.bIsFrozen;
+	Ar << Normalizer.Mean;
+	Ar << Normalizer.M2;
+
+	if (Ar.IsLoading())
+	{
+		if (Normalizer.Dim < 0 || Normalizer.Mean.Num() != Normalizer.Dim || Normalizer.M2.Num() != Normalizer.Dim)
+		{
+			Ar.SetError();
+			Normalizer.Reset(0);
+			return Ar;
+		}
+		Normalizer.BatchMean.SetNumZeroed(Normalizer.Dim);
+		Normalizer.BatchM2.SetNumZeroed(Normalizer.Dim);
+	}
+	return Ar;
+}
@@ -0,0 +1,587 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+// The rl_tools SAC headers are included by RLAgentBackend.h, in the order their overloads need
+#include "RLAgentBackend.h"
+#include "UERLLog.h"
+
+// Train the twin critics and the actor of each SAC update on one batch (rl_tools' SHARED_BATCH, on by default). With
+// it off, each critic and the actor draw their own batch and the critics are always trained one after the other.
+#ifndef UERL_SAC_SHARED_BATCH
+#define UERL_SAC_SHARED_BATCH 1
+#endif
+
+/**
+ * SAC backend for one (observation, action, hidden) shape, following rl_tools' SAC loop (rl/algorithms/sac/loop/core)
+ * with the environments stepped by URLAgentManager instead of an rl_tools off-policy runner.
+ *
+ * The networks and algorithm parameters are the loop's (ConfigApproximatorsMLP: an MLP actor emitting a mean and log
+ * std per action followed by rl_tools' sample-and-squash layer, twin MLP critics and their Polyak targets), with the
+ * entropy temperature tuned automatically towards -ActionDim. Of the loop's state, everything an update touches (actor
+ * critic, optimizers, training buffers, batches and action noise) is allocated once in the constructor, out of one
+ * FRLAgentArena block; the off-policy runner and its environments are replaced by the same concurrent replay buffer
+ * TRLAgentBackend uses, so sampling, AddTransition and Train allocate no rl_tools container.
+ *
+ * The deterministic policy is tanh of the actor's mean, which is an MLP of TRLAgentBackend's inference actor
+ * configuration: its parameter blocks are the mean rows of the trained actor's, so the inference actor, policy files
+ * and Evaluate are the same for all algorithms. Exploration samples tanh(mean + std * noise) from a Forward copy of
+ * the whole trained MLP.
+ *
+ * Prioritized replay, replay buffer files and the async learner are TD3 only: asking SAC for one of them logs a warning
+ * and keeps the uniform, in-memory, synchronous default, and URLAsyncTrainingTask refuses SAC agents.
+ */
+template <int32 T_OBSERVATION_DIM, int32 T_ACTION_DIM, int32 T_HIDDEN_DIM>
+class TRLSACAgentBackend final : public IRLAgentBackend
+{
+public:
+	using DEVICE = rl_tools::devices::DefaultCPU;
+	using T = float;
+	using TI = typename DEVICE::index_t;
+	using RNG = decltype(rl_tools::random::default_engine(typename DEVICE::SPEC::RANDOM{}));
+
+	static constexpr TI OBSERVATION_DIM = T_OBSERVATION_DIM;
+	static constexpr TI ACTION_DIM = T_ACTION_DIM;
+	static constexpr TI HIDDEN_DIM = T_HIDDEN_DIM;
+	static constexpr TI NUM_LAYERS = 3; // rl_tools counts the input and output layers towards the total
+	static constexpr int32 NUM_PARAMETER_BLOCKS = 2 * NUM_LAYERS; // Weights and biases per layer
+	static constexpr auto ACTIVATION_FUNCTION = rl_tools::nn::activation_functions::ActivationFunction::RELU;
+
+	// Inference and exploration run in chunks of this many rows, as in TRLAgentBackend
+	static constexpr TI INFERENCE_BATCH_SIZE = 64;
+
+	// Replay buffer and batch sizes are template parameters of the rl_tools containers; the matching
+	// FLocalRLTrainingConfig fields are clamped to them
+	static constexpr TI REPLAY_BUFFER_CAPACITY = 100000;
+	static constexpr TI TRAINING_BATCH_SIZE = 256;
+
+	using ACTOR_CONFIG = rl_tools::nn_models::mlp::Configuration<T, TI, ACTION_DIM, NUM_LAYERS, HIDDEN_DIM, ACTIVATION_FUNCTION, rl_tools::nn::activation_functions::TANH>;
+	using ACTOR_CAPABILITY = rl_tools::nn::capability::Forward<>;
+	using ACTOR_INPUT_SHAPE = rl_tools::tensor::Shape<TI, 1, INFERENCE_BATCH_SIZE, OBSERVATION_DIM>;
+	using ACTOR_TYPE = rl_tools::nn_models::mlp::NeuralNetwork<ACTOR_CONFIG, ACTOR_CAPABILITY, ACTOR_INPUT_SHAPE>;
+	using ACTOR_BUFFER_TYPE = typename ACTOR_TYPE::template Buffer<>;
+	using ACTOR_SINGLE_INPUT_SHAPE = rl_tools::tensor::Shape<TI, 1, 1, OBSERVATION_DIM>;
+	using INFERENCE_INPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, ACTOR_INPUT_SHAPE>>;
+	using INFERENCE_OUTPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, typename ACTOR_TYPE::OUTPUT_SHAPE>>;
+	using INFERENCE_SINGLE_INPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, ACTOR_SINGLE_INPUT_SHAPE>>;
+	using INFERENCE_SINGLE_OUTPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, typename ACTOR_TYPE::template OUTPUT_SHAPE_FACTORY<ACTOR_SINGLE_INPUT_SHAPE>>>;
+
+	using ENVIRONMENT = TRLEnvironmentShape<T, TI, OBSERVATION_DIM, ACTION_DIM>;
+
+	struct ALGORITHM_PARAMETERS : rl_tools::rl::algorithms::sac::DefaultParameters<T, TI, ACTION_DIM>
+	{
+		static constexpr TI ACTOR_BATCH_SIZE = TRAINING_BATCH_SIZE;
+		static constexpr TI CRITIC_BATCH_SIZE = TRAINING_BATCH_SIZE;
+		// Replay buffer rows are single steps, every one of them the final step of its sequence
+		static constexpr bool MASK_NON_TERMINAL = false;
+	};
+
+	// The part of rl_tools::rl::algorithms::sac::loop::core::DefaultParameters that its MLP approximators and step read
+	struct CORE_PARAMETERS
+	{
+		using SAC_PARAMETERS = ALGORITHM_PARAMETERS;
+		static constexpr TI ACTOR_HIDDEN_DIM = HIDDEN_DIM;
+		static constexpr TI ACTOR_NUM_LAYERS = NUM_LAYERS;
+		static constexpr auto ACTOR_ACTIVATION_FUNCTION = ACTIVATION_FUNCTION;
+		static constexpr TI CRITIC_HIDDEN_DIM = HIDDEN_DIM;
+		static constexpr TI CRITIC_NUM_LAYERS = NUM_LAYERS;
+		static constexpr auto CRITIC_ACTIVATION_FUNCTION = ACTIVATION_FUNCTION;
+		static constexpr bool SHARED_BATCH = UERL_SAC_SHARED_BATCH;
+		using INITIALIZER = rl_tools::nn::layers::dense::DefaultInitializer<T, TI>;
+		using ACTOR_OPTIMIZER_PARAMETERS = rl_tools::nn::optimizers::adam::DEFAULT_PARAMETERS_TENSORFLOW<T>;
+		using CRITIC_OPTIMIZER_PARAMETERS = rl_tools::nn::optimizers::adam::DEFAULT_PARAMETERS_TENSORFLOW<T>;
+		using ALPHA_OPTIMIZER_PARAMETERS = rl_tools::nn::optimizers::adam::DEFAULT_PARAMETERS_TENSORFLOW<T>;
+	};
+
+	using NN = rl_tools::rl::algorithms::sac::loop::core::ConfigApproximatorsMLP<T, TI, ENVIRONMENT, CORE_PARAMETERS>;
+	using ACTOR_CRITIC_SPEC = rl_tools::rl::algorithms::sac::Specification<T, TI, ENVIRONMENT, typename NN::ACTOR_TYPE, typename NN::CRITIC_TYPE, typename NN::CRITIC_TARGET_TYPE, rl_tools::nn::parameters::Adam, typename NN::ACTOR_OPTIMIZER, typename NN::CRITIC_OPTIMIZER, typename NN::ALPHA_OPTIMIZER, ALGORITHM_PARAMETERS>;
+	using ACTOR_CRITIC_TYPE = rl_tools::rl::algorithms::sac::ActorCritic<ACTOR_CRITIC_SPEC>;
+	using ACTOR_TRAINING_BUFFERS_TYPE = rl_tools::rl::algorithms::sac::ActorTrainingBuffers<rl_tools::rl::algorithms::sac::ActorTrainingBuffersSpecification<ACTOR_CRITIC_SPEC, true>>;
+	using CRITIC_TRAINING_BUFFERS_TYPE = rl_tools::rl::algorithms::sac::CriticTrainingBuffers<rl_tools::rl::algorithms::sac::CriticTrainingBuffersSpecification<ACTOR_CRITIC_SPEC, true>>;
+	using TRAINING_ACTOR_BUFFER_TYPE = typename NN::ACTOR_TYPE::template Buffer<>;
+	using CRITIC_BUFFER_TYPE = typename NN::CRITIC_TYPE::template Buffer<>;
+	using ACTION_NOISE_TYPE = rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, ALGORITHM_PARAMETERS::SEQUENCE_LENGTH * TRAINING_BATCH_SIZE, ACTION_DIM>>;
+
+	// The trained actor's MLP (mean and log std of every action) at the inference batch size
+	using EXPLORATION_ACTOR_TYPE = rl_tools::nn_models::mlp::NeuralNetwork<typename NN::template Actor<ACTOR_CAPABILITY>::MLP_CONFIG, ACTOR_CAPABILITY, ACTOR_INPUT_SHAPE>;
+	using EXPLORATION_BUFFER_TYPE = typename EXPLORATION_ACTOR_TYPE::template Buffer<>;
+	using EXPLORATION_OUTPUT_TYPE = rl_tools::Tensor<rl_tools::tensor::Specification<T, TI, typename EXPLORATION_ACTOR_TYPE::OUTPUT_SHAPE>>;
+
+#if UERL_HALF_PRECISION_REPLAY_BUFFER
+	using REPLAY_BUFFER_STORAGE_T = rl_tools::numeric_types::bfloat16;
+#else
+	using REPLAY_BUFFER_STORAGE_T = T;
+#endif
+	using REPLAY_BUFFER_SPEC = rl_tools::rl::components::replay_buffer::Specification<T, TI, OBSERVATION_DIM, OBSERVATION_DIM, false, ACTION_DIM, REPLAY_BUFFER_CAPACITY, true, REPLAY_BUFFER_STORAGE_T>;
+	using REPLAY_BUFFER_TYPE = rl_tools::rl::components::ConcurrentReplayBuffer<REPLAY_BUFFER_SPEC>;
+	using BATCH_SPEC = rl_tools::rl::components::off_policy_runner::SequentialBatchSpecification<TRLTransitionSourceSpec<T, TI, ENVIRONMENT>, ALGORITHM_PARAMETERS::SEQUENCE_LENGTH, TRAINING_BATCH_SIZE>;
+	using BATCH_TYPE = rl_tools::rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC>;
+
+	explicit TRLSACAgentBackend(uint32 Seed)
+	{
+		Arena.Allocate([this]()
+		{
+			rl_tools::malloc(device, Actor);
+			rl_tools::malloc(device, ActorEvalBuffer);
+			rl_tools::malloc(device, InferenceInput);
+			rl_tools::malloc(device, InferenceOutput);
+			rl_tools::malloc(device, InferenceSingleInput);
+			rl_tools::malloc(device, InferenceSingleOutput);
+			rl_tools::malloc(device, ExplorationActor);
+			rl_tools::malloc(device, ExplorationEvalBuffer);
+			rl_tools::malloc(device, ExplorationOutput);
+
+			rl_tools::malloc(device, ActorCritic);
+			rl_tools::malloc(device, ActorTrainingBuffers);
+			rl_tools::malloc(device, CriticTrainingBuffers[0]);
+			rl_tools::malloc(device, CriticTrainingBuffers[1]);
+			rl_tools::malloc(device, TrainingActorBuffers[0]);
+			rl_tools::malloc(device, TrainingActorBuffers[1]);
+			rl_tools::malloc(device, CriticBuffers[0]);
+			rl_tools::malloc(device, CriticBuffers[1]);
+			rl_tools::malloc(device, ActionNoiseCritic);
+			rl_tools::malloc(device, ActionNoiseActor);
+			rl_tools::malloc(device, ReplayBuffer);
+			rl_tools::malloc(device, CriticBatch);
+			rl_tools::malloc(device, ActorBatch);
+		}, device);
+
+		// Zero the input so padded rows of a partial chunk never carry NaNs from the allocation
+		rl_tools::set_all(device, InferenceInput, 0);
+
+		ForEachParameterMatrix(Actor, [this](auto& Parameters, int32 Block)
+		{
+			OwnedActorParameters[Block] = Parameters._data;
+		});
+
+		rng = rl_tools::random::default_engine(device.random, Seed);
+		ResetTraining();
+	}
+
+	virtual ERLAlgorithm GetAlgorithm() const override { return ERLAlgorithm::SAC; }
+
+	virtual int32 GetObservationDim() const override { return T_OBSERVATION_DIM; }
+	virtual int32 GetActionDim() const override { return T_ACTION_DIM; }
+	virtual int32 GetHiddenDim() const override { return T_HIDDEN_DIM; }
+
+	virtual void Evaluate(const float* Observation, float* OutAction) override
+	{
+		FMemory::Memcpy(rl_tools::data(InferenceSingleInput), Observation, OBSERVATION_DIM * sizeof(T));
+		rl_tools::evaluate(device, Actor, InferenceSingleInput, InferenceSingleOutput, ActorEvalBuffer, rng);
+		FMemory::Memcpy(OutAction, rl_tools::data(InferenceSingleOutput), ACTION_DIM * sizeof(T));
+	}
+
+	virtual void EvaluateBatch(const float* Observations, int32 NumRows, float* OutActions) override
+	{
+		for (int32 RowStart = 0; RowStart < NumRows; RowStart += INFERENCE_BATCH_SIZE)
+		{
+			const int32 ChunkRows = FMath::Min<int32>(INFERENCE_BATCH_SIZE, NumRows - RowStart);
+			FMemory::Memcpy(rl_tools::data(InferenceInput), Observations + RowStart * OBSERVATION_DIM, ChunkRows * OBSERVATION_DIM * sizeof(T));
+			rl_tools::evaluate(device, Actor, InferenceInput, InferenceOutput, ActorEvalBuffer, rng);
+			FMemory::Memcpy(OutActions + RowStart * ACTION_DIM, rl_tools::data(InferenceOutput), ChunkRows * ACTION_DIM * sizeof(T));
+		}
+	}
+
+	virtual void GetPolicyParameterBlocks(TArray<FRLPolicyParameterBlock>& OutBlocks) const override
+	{
+		OutBlocks.SetNum(NUM_PARAMETER_BLOCKS);
+		ForEachParameterMatrix(Actor, [&OutBlocks](const auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			OutBlocks[Block].Data = Parameters._data;
+			OutBlocks[Block].Rows = MATRIX_SPEC::ROWS;
+			OutBlocks[Block].Cols = MATRIX_SPEC::COLS;
+		});
+	}
+
+	virtual void BindPolicyParameters(TConstArrayView<const float*> BlockData) override
+	{
+		check(BlockData.Num() == NUM_PARAMETER_BLOCKS);
+
+		// The blocks become the trained actor's mean rows; its log std rows keep their current values
+		T* TrainedBlocks[NUM_PARAMETER_BLOCKS];
+		GetTrainedActorBlocks(TrainedBlocks);
+		ForEachParameterMatrix(Actor, [&BlockData, &TrainedBlocks](const auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			FMemory::Memcpy(TrainedBlocks[Block], BlockData[Block], MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS * sizeof(T));
+		});
+		rl_tools::copy(device, device, ActorCritic.actor.content, ExplorationActor);
+
+		ForEachParameterMatrix(Actor, [&BlockData](auto& Parameters, int32 Block)
+		{
+			Parameters._data = const_cast<T*>(BlockData[Block]);
+		});
+		bParametersBound = true;
+	}
+
+	virtual void UnbindPolicyParameters() override
+	{
+		if (!bParametersBound)
+		{
+			return;
+		}
+
+		ForEachParameterMatrix(Actor, [this](auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			FMemory::Memcpy(OwnedActorParameters[Block], Parameters._data, MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS * sizeof(T));
+		});
+		RestoreOwnedParameters();
+	}
+
+	virtual int32 GetReplayBufferCapacity() const override { return REPLAY_BUFFER_CAPACITY; }
+	virtual int32 GetTrainingBatchSize() const override { return TRAINING_BATCH_SIZE; }
+
+	virtual int32 GetReplayBufferSize() const override
+	{
+		return rl_tools::size(device, ReplayBuffer);
+	}
+
+	virtual SIZE_T GetArenaSize() const override { return Arena.GetSize(); }
+	virtual int64 GetArenaAllocations() const override { return Arena.GetAllocations(); }
+
+	virtual void ResetTraining() override
+	{
+		// Also resets the entropy temperature to ALGORITHM_PARAMETERS::ALPHA
+		rl_tools::init(device, ActorCritic, rng);
+		rl_tools::init(device, ReplayBuffer);
+		NumUpdates = 0;
+		SyncInferenceActor();
+	}
+
+	virtual bool OpenReplayBufferFile(const FString& FilePath) override
+	{
+		UERL_WARNING(TEXT("TRLSACAgentBackend::OpenReplayBufferFile - SAC keeps its replay buffer in memory, ignoring %s"), *FilePath);
+		return false;
+	}
+
+	virtual void CloseReplayBufferFile() override
+	{
+	}
+
+	virtual void FlushReplayBufferFile() override
+	{
+	}
+
+	virtual void SetTrainingParameters(float ActorLearningRate, float CriticLearningRate, float Gamma) override
+	{
+		// The temperature keeps rl_tools' default learning rate
+		ActorCritic.actor_optimizer.parameters.alpha = ActorLearningRate;
+		ActorCritic.critic_optimizers[0].parameters.alpha = CriticLearningRate;
+		ActorCritic.critic_optimizers[1].parameters.alpha = CriticLearningRate;
+		ActorCritic.gamma = Gamma;
+	}
+
+	virtual void SetParallelCriticTraining(bool bParallel) override
+	{
+		bParallelCriticTraining = bParallel;
+	}
+
+	virtual void SetPrioritizedReplay(bool bEnabled, float Alpha, float Beta, int32 BetaAnnealingUpdates) override
+	{
+		if (bEnabled)
+		{
+			UERL_WARNING(TEXT("TRLSACAgentBackend::SetPrioritizedReplay - SAC samples its replay buffer uniformly, ignoring prioritized replay"));
+		}
+	}
+
+	virtual void SetPPOParameters(int32 Epochs, float GAELambda) override
+	{
+	}
+
+	virtual void SampleTrainingActions(const float* NormalizedObservations, int32 NumRows, float* OutActions, bool bUniform) override
+	{
+		if (bUniform)
+		{
+			for (int32 Index = 0; Index < NumRows * T_ACTION_DIM; ++Index)
+			{
+				OutActions[Index] = rl_tools::random::uniform_real_distribution(device.random, (T)-1, (T)1, rng);
+			}
+			return;
+		}
+
+		// What the sample-and-squash layer does in training, with the log std clamped to the same bounds
+		for (int32 RowStart = 0; RowStart < NumRows; RowStart += INFERENCE_BATCH_SIZE)
+		{
+			const int32 ChunkRows = FMath::Min<int32>(INFERENCE_BATCH_SIZE, NumRows - RowStart);
+			FMemory::Memcpy(rl_tools::data(InferenceInput), NormalizedObservations + RowStart * OBSERVATION_DIM, ChunkRows * OBSERVATION_DIM * sizeof(T));
+			rl_tools::evaluate(device, ExplorationActor, InferenceInput, ExplorationOutput, ExplorationEvalBuffer, rng);
+
+			const T* Distributions = rl_tools::data(ExplorationOutput);
+			for (int32 Row = 0; Row < ChunkRows; ++Row)
+			{
+				const T* Distribution = Distributions + Row * 2 * ACTION_DIM;
+				float* Actions = OutActions + (RowStart + Row) * ACTION_DIM;
+				for (TI Action = 0; Action < ACTION_DIM; ++Action)
+				{
+					const T LogStd = FMath::Clamp(Distribution[ACTION_DIM + Action], ALGORITHM_PARAMETERS::LOG_STD_LOWER_BOUND, ALGORITHM_PARAMETERS::LOG_STD_UPPER_BOUND);
+					const T Sample = rl_tools::random::normal_distribution::sample(device.random, Distribution[Action], rl_tools::math::exp(device.math, LogStd), rng);
+					Actions[Action] = rl_tools::math::tanh(device.math, Sample);
+				}
+			}
+		}
+	}
+
+	virtual void AddTransition(const float* Observation, const float* Action, float Reward, const float* NextObservation, bool bTerminated, bool bTruncated) override
+	{
+		// Same row layout and publication as TRLAgentBackend::AddTransition
+		const TI Ticket = rl_tools::add_begin(device, ReplayBuffer);
+		const TI Position = Ticket % REPLAY_BUFFER_CAPACITY;
+		StoreColumns(&rl_tools::get(ReplayBuffer.observations, Position, 0), Observation, OBSERVATION_DIM);
+		StoreColumns(&rl_tools::get(ReplayBuffer.actions, Position, 0), Action, ACTION_DIM);
+		StoreColumns(&rl_tools::get(ReplayBuffer.next_observations, Position, 0), NextObservation, OBSERVATION_DIM);
+		rl_tools::set(ReplayBuffer.rewards, Position, 0, Reward);
+		rl_tools::set(ReplayBuffer.terminated, Position, 0, bTerminated ? (T)1 : (T)0);
+		rl_tools::set(ReplayBuffer.truncated, Position, 0, bTruncated ? (T)1 : (T)0);
+		rl_tools::add_commit(device, ReplayBuffer, Ticket);
+	}
+
+	virtual bool Train(int32 InNumUpdates, const FRLNormalizationPlan& ObservationNormalization) override
+	{
+		if (rl_tools::published_size(device, ReplayBuffer) < TRAINING_BATCH_SIZE)
+		{
+			return false;
+		}
+
+		// One update is one rl_tools::step of the SAC loop past its warmup, without the environment step
+		bool bActorUpdated = false;
+		bool bGathered = true;
+		for (int32 Update = 0; Update < InNumUpdates && bGathered; ++Update)
+		{
+			const bool bTrainCritics = NumUpdates % ALGORITHM_PARAMETERS::CRITIC_TRAINING_INTERVAL == 0;
+			const bool bTrainActor = NumUpdates % ALGORITHM_PARAMETERS::ACTOR_TRAINING_INTERVAL == 0;
+			if (CORE_PARAMETERS::SHARED_BATCH && (bTrainCritics || bTrainActor))
+			{
+				if (!GatherBatch(CriticBatch, ObservationNormalization))
+				{
+					bGathered = false;
+					break;
+				}
+				rl_tools::randn(device, ActionNoiseCritic, rng);
+			}
+			if (bTrainCritics && !TrainCritics(ObservationNormalization))
+			{
+				bGathered = false;
+				break;
+			}
+			if (NumUpdates % ALGORITHM_PARAMETERS::CRITIC_TARGET_UPDATE_INTERVAL == 0)
+			{
+				rl_tools::update_critic_targets(device, ActorCritic);
+			}
+			if (bTrainActor)
+			{
+				// Also steps the entropy temperature towards ALGORITHM_PARAMETERS::TARGET_ENTROPY
+				rl_tools::randn(device, ActionNoiseActor, rng);
+				BATCH_TYPE& Batch = CORE_PARAMETERS::SHARED_BATCH ? CriticBatch : ActorBatch;
+				if (!CORE_PARAMETERS::SHARED_BATCH && !GatherBatch(Batch, ObservationNormalization))
+				{
+					bGathered = false;
+					break;
+				}
+				rl_tools::train_actor(device, ActorCritic, Batch, ActorCritic.actor_optimizer, TrainingActorBuffers[0], CriticBuffers[0], ActorTrainingBuffers, ActionNoiseActor, rng);
+				bActorUpdated = true;
+			}
+			++NumUpdates;
+		}
+
+		if (bActorUpdated)
+		{
+			SyncInferenceActor();
+		}
+		return bGathered;
+	}
+
+	virtual void SetAsyncLearner(bool bAsync) override
+	{
+		if (bAsync)
+		{
+			UERL_WARNING(TEXT("TRLSACAgentBackend::SetAsyncLearner - SAC is only trained synchronously, Train keeps running on the caller's thread"));
+		}
+	}
+
+	virtual bool PublishPolicySnapshot(const FRLNormalizationPlan& ObservationNormalization) override
+	{
+		return false;
+	}
+
+	virtual void SampleRolloutActions(const float* Observations, int32 NumRows, float* OutActions) override
+	{
+		// Never called: SAC agents are not trained asynchronously. Acts uniformly like a TD3 learner without a snapshot.
+		for (int32 Index = 0; Index < NumRows * T_ACTION_DIM; ++Index)
+		{
+			OutActions[Index] = rl_tools::random::uniform_real_distribution(device.random, (T)-1, (T)1, rng);
+		}
+	}
+
+private:
+	// Storage of every container below
+	FRLAgentArena Arena;
+	DEVICE device;
+	RNG rng;
+
+	ACTOR_TYPE Actor;
+	ACTOR_BUFFER_TYPE ActorEvalBuffer;
+	INFERENCE_INPUT_TYPE InferenceInput;
+	INFERENCE_OUTPUT_TYPE InferenceOutput;
+	INFERENCE_SINGLE_INPUT_TYPE InferenceSingleInput;
+	INFERENCE_SINGLE_OUTPUT_TYPE InferenceSingleOutput;
+	EXPLORATION_ACTOR_TYPE ExplorationActor;
+	EXPLORATION_BUFFER_TYPE ExplorationEvalBuffer;
+	EXPLORATION_OUTPUT_TYPE ExplorationOutput;
+
+	// The members of rl_tools::rl::algorithms::sac::loop::core::State that an update touches
+	ACTOR_CRITIC_TYPE ActorCritic;
+	ACTOR_TRAINING_BUFFERS_TYPE ActorTrainingBuffers;
+	// One per critic so their regressions can run concurrently; [0] also holds the shared targets
+	CRITIC_TRAINING_BUFFERS_TYPE CriticTrainingBuffers[2];
+	TRAINING_ACTOR_BUFFER_TYPE TrainingActorBuffers[2];
+	CRITIC_BUFFER_TYPE CriticBuffers[2];
+	ACTION_NOISE_TYPE ActionNoiseCritic;
+	ACTION_NOISE_TYPE ActionNoiseActor;
+	REPLAY_BUFFER_TYPE ReplayBuffer;
+	BATCH_TYPE CriticBatch;
+	// Only gathered without a shared batch
+	BATCH_TYPE ActorBatch;
+
+	// SAC updates run since ResetTraining; drives the critic, target and actor intervals
+	TI NumUpdates = 0;
+
+	bool bParallelCriticTraining = false;
+	// Device of the second critic's regression, so the two lanes of TrainCritics share no device or logger state
+	DEVICE CriticLaneDevice;
+
+	// The inference actor's own parameter storage, kept while it is bound to external blocks
+	T* OwnedActorParameters[NUM_PARAMETER_BLOCKS] = {};
+	bool bParametersBound = false;
+
+	// Calls Function(ParameterMatrix, BlockIndex) for each dense parameter matrix of an actor MLP, in the order of
+	// GetPolicyParameterBlocks
+	template <typename NETWORK, typename FUNCTION>
+	static void ForEachParameterMatrix(NETWORK& Network, FUNCTION&& Function)
+	{
+		int32 Block = 0;
+		Function(Network.input_layer.weights.parameters, Block++);
+		Function(Network.input_layer.biases.parameters, Block++);
+		for (TI Layer = 0; Layer < ACTOR_TYPE::NUM_HIDDEN_LAYERS; ++Layer)
+		{
+			Function(Network.hidden_layers[Layer].weights.parameters, Block++);
+			Function(Network.hidden_layers[Layer].biases.parameters, Block++);
+		}
+		Function(Network.output_layer.weights.parameters, Block++);
+		Function(Network.output_layer.biases.parameters, Block++);
+	}
+
+	// The trained actor's MLP blocks. Output weights are (output, input) row-major and the means are the first
+	// ACTION_DIM outputs, so each inference actor block is a prefix of the matching trained block.
+	void GetTrainedActorBlocks(T* (&OutBlocks)[NUM_PARAMETER_BLOCKS])
+	{
+		ForEachParameterMatrix(ActorCritic.actor.content, [&OutBlocks](auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			static_assert(MATRIX_SPEC::ROW_PITCH == MATRIX_SPEC::COLS, "Actor parameter blocks must be dense");
+			OutBlocks[Block] = Parameters._data;
+		});
+	}
+
+	void RestoreOwnedParameters()
+	{
+		if (!bParametersBound)
+		{
+			return;
+		}
+
+		ForEachParameterMatrix(Actor, [this](auto& Parameters, int32 Block)
+		{
+			Parameters._data = OwnedActorParameters[Block];
+		});
+		bParametersBound = false;
+	}
+
+	void SyncInferenceActor()
+	{
+		// Bound parameters may be read-only; the copy below overwrites them anyway
+		RestoreOwnedParameters();
+
+		T* TrainedBlocks[NUM_PARAMETER_BLOCKS];
+		GetTrainedActorBlocks(TrainedBlocks);
+		ForEachParameterMatrix(Actor, [this, &TrainedBlocks](const auto& Parameters, int32 Block)
+		{
+			using MATRIX_SPEC = typename std::decay_t<decltype(Parameters)>::SPEC;
+			FMemory::Memcpy(OwnedActorParameters[Block], TrainedBlocks[Block], MATRIX_SPEC::ROWS * MATRIX_SPEC::COLS * sizeof(T));
+		});
+		rl_tools::copy(device, device, ActorCritic.actor.content, ExplorationActor);
+	}
+
+	// Returns false if a batch of its own could not be gathered (without SHARED_BATCH)
+	bool TrainCritics(const FRLNormalizationPlan& ObservationNormalization)
+	{
+		if constexpr (CORE_PARAMETERS::SHARED_BATCH)
+		{
+			// Both critics regress onto the same soft double-Q targets, computed once from the shared batch and noise,
+			// as rl_tools' loop does with PARALLEL_CRITIC_TRAINING
+			rl_tools::critic_targets(device, ActorCritic, CriticBatch, TrainingActorBuffers[0], CriticBuffers[0], CriticTrainingBuffers[0], ActionNoiseCritic, rng);
+			rl_tools::copy(device, device, CriticTrainingBuffers[0].target_action_value, CriticTrainingBuffers[1].target_action_value);
+
+			RNG CriticRngs[2] = {rng, rng};
+			ParallelFor(2, [this, &CriticRngs](int32 CriticIndex)
+			{
+				DEVICE& LaneDevice = CriticIndex == 0 ? device : CriticLaneDevice;
+				auto& Critic = CriticIndex == 0 ? ActorCritic.critic_1 : ActorCritic.critic_2;
+				rl_tools::train_critic_on_targets(LaneDevice, ActorCritic, Critic, CriticBatch, ActorCritic.critic_optimizers[CriticIndex], CriticBuffers[CriticIndex], CriticTrainingBuffers[CriticIndex], CriticRngs[CriticIndex]);
+			}, !bParallelCriticTraining);
+			rng = CriticRngs[0];
+		}
+		else
+		{
+			for (int32 CriticIndex = 0; CriticIndex < 2; ++CriticIndex)
+			{
+				if (!GatherBatch(CriticBatch, ObservationNormalization))
+				{
+					return false;
+				}
+				rl_tools::randn(device, ActionNoiseCritic, rng);
+				auto& Critic = CriticIndex == 0 ? ActorCritic.critic_1 : ActorCritic.critic_2;
+				rl_tools::train_critic(device, ActorCritic, Critic, CriticBatch, ActorCritic.critic_optimizers[CriticIndex], TrainingActorBuffers[CriticIndex], CriticBuffers[CriticIndex], CriticTrainingBuffers[CriticIndex], ActionNoiseCritic, rng);
+			}
+		}
+		return true;
+	}
+
+	// Returns false if the replay buffer gave up on a sample (see rl_tools::gather_batch)
+	bool GatherBatch(BATCH_TYPE& Batch, const FRLNormalizationPlan& ObservationNormalization)
+	{
+		if (!rl_tools::gather_batch(device, ReplayBuffer, Batch, rng))
+		{
+			return false;
+		}
+		NormalizeRLBatchObservations(Batch, ObservationNormalization);
+		return true;
+	}
+
+	// Copies Num floats into replay buffer storage, rounding them when it is half precision
+	static void StoreColumns(REPLAY_BUFFER_STORAGE_T* Target, const T* Source, int32 Num)
+	{
+		if constexpr (std::is_same_v<REPLAY_BUFFER_STORAGE_T, T>)
+		{
+			FMemory::Memcpy(Target, Source, Num * sizeof(T));
+		}
+		else
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				Target[Index] = REPLAY_BUFFER_STORAGE_T(Source[Index]);
+			}
+		}
+	}
+};
+
+template <int32 OBSERVATION_DIM, int32 ACTION_DIM, int32 HIDDEN_DIM>
+IRLAgentBackend* CreateRLSACAgentBackend(uint32 Seed)
+{
+	return new TRLSACAgentBackend<OBSERVATION_DIM, ACTION_DIM, HIDDEN_DIM>(Seed);
+}
+
+#define UERL_REGISTER_SAC_AGENT_BACKEND(ObservationDim, ActionDim, HiddenDim) \
+	static const bool PREPROCESSOR_JOIN(GUERLSACAgentBackendRegistered_, __LINE__) = \
+		(FRLAgentBackendRegistry::Get().Register(ERLAlgorithm::SAC, ObservationDim, ActionDim, HiddenDim, &CreateRLSACAgentBackend<ObservationDim, ActionDim, HiddenDim>), true);
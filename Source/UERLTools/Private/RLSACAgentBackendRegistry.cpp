@@ -0,0 +1,18 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#include "RLAgentBackendGrid.h"
+#include "RLSACAgentBackend.h"
+
+namespace UERLAgentBackendGrid
+{
+	// SAC networks are heavier to instantiate than TD3's, so the default grid covers the common shapes only. Anything
+	// else can be added with UERL_REGISTER_SAC_AGENT_BACKEND.
+	using FSACObservationDims = TIntegerSequence<int32, 2, 3, 4, 6, 8, 12, 16, 32>;
+	using FSACActionDims = TIntegerSequence<int32, 1, 2, 3, 4>;
+	using FSACHiddenDims = TIntegerSequence<int32, 64, 128>;
+
+	void RegisterSACBackends(FRLAgentBackendRegistry& Registry)
+	{
+		RegisterGrid<TRLSACAgentBackend, FSACObservationDims, FSACActionDims>(Registry, ERLAlgorithm::SAC, FSACHiddenDims{});
+	}
+}
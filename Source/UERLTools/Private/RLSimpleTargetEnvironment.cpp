@@ -10,40 +10,22 @@
 URLSimpleTargetEnvironment::URLSimpleTargetEnvironment()
 {
 	// Set default environment configuration for target reaching task
-	EnvironmentConfig.ObservationDim = 8; // Agent pos (2), Agent vel (2), Target pos (2), Distance (1), Normalized distance (1)
-	EnvironmentConfig.ActionDim = 2; // Movement in X and Y
+	EnvironmentConfig.ObservationDim = FRLSimpleTargetSimulation::ObservationDim;
+	EnvironmentConfig.ActionDim = FRLSimpleTargetSimulation::ActionDim;
 	EnvironmentConfig.MaxEpisodeLength = 1000;
 	EnvironmentConfig.bContinuousActions = true;
 
 	// Initialize state
-	AgentPosition = FVector::ZeroVector;
-	AgentVelocity = FVector::ZeroVector;
-	TargetPosition = FVector(500.0f, 0.0f, 0.0f);
-	DistanceToTarget = 0.0f;
-	LastDistanceToTarget = 0.0f;
-	PreviousAgentPosition = FVector::ZeroVector;
+	SimulationState = {};
+	SimulationState.TargetX = 500.0f;
+	PreviousSimulationState = SimulationState;
+	MirrorSimulationState();
 }
 
 void URLSimpleTargetEnvironment::BeginPlay()
 {
+	// The base BeginPlay resets the environment, which places the target and the agent
 	Super::BeginPlay();
-	
-	// Initialize positions
-	if (bRandomizeTarget)
-	{
-		RandomizeTargetPosition();
-	}
-	
-	if (bRandomizeStartPosition)
-	{
-		RandomizeAgentPosition();
-	}
-	else
-	{
-		AgentPosition = FVector::ZeroVector;
-	}
-	
-	UpdateAgentState();
 }
 
 TArray<float> URLSimpleTargetEnvironment::Reset()
@@ -51,120 +33,61 @@ TArray<float> URLSimpleTargetEnvironment::Reset()
 	// Call parent reset
 	Super::Reset();
 
-	// Randomize positions if enabled
-	if (bRandomizeTarget)
-	{
-		RandomizeTargetPosition();
-	}
-	
-	if (bRandomizeStartPosition)
-	{
-		RandomizeAgentPosition();
-	}
-	else
-	{
-		AgentPosition = FVector::ZeroVector;
-	}
-
-	// Reset velocity
-	AgentVelocity = FVector::ZeroVector;
-	PreviousAgentPosition = AgentPosition;
+	// Randomize positions if enabled; a fixed target stays where it is
+	FRLSimpleTargetSimulation::SampleInitialState(GetSimulationParameters(), SimulationState,
+		[](float Min, float Max) { return FMath::FRandRange(Min, Max); });
+	PreviousSimulationState = SimulationState;
 
-	// Update state
-	UpdateAgentState();
-
-	// Move the actual pawn if it exists
-	if (APawn* OwnerPawn = Cast<APawn>(GetOwner()))
+	// Move the actual pawn if it exists; headless runs move it once when they end
+	if (!IsHeadless())
 	{
-		OwnerPawn->SetActorLocation(AgentPosition);
+		SyncSceneState();
 	}
 
 	return GetObservation();
 }
 
-void URLSimpleTargetEnvironment::Step(const TArray<float>& Action)
+void URLSimpleTargetEnvironment::ApplyAction(TConstArrayView<float> Action)
 {
 	// Validate action
-	if (Action.Num() != EnvironmentConfig.ActionDim)
+	if (Action.Num() != FRLSimpleTargetSimulation::ActionDim)
 	{
-		UERL_ERROR( TEXT("URLSimpleTargetEnvironment::Step - Invalid action dimension"));
+		UERL_ERROR( TEXT("URLSimpleTargetEnvironment::ApplyAction - Invalid action dimension"));
 		return;
 	}
 
-	// Store previous position
-	PreviousAgentPosition = AgentPosition;
-	LastDistanceToTarget = DistanceToTarget;
-
-	// Apply action (movement)
-	FVector MovementAction(Action[0], Action[1], 0.0f);
-	MovementAction = MovementAction.GetClampedToMaxSize(1.0f); // Clamp to unit circle
-	
-	// Calculate new position
-	float DeltaTime = GetWorld() ? GetWorld()->GetDeltaSeconds() : 0.016f; // Default to ~60 FPS
-	FVector Movement = MovementAction * MaxSpeed * DeltaTime;
-	AgentPosition += Movement;
-
-	// Clamp agent to arena
-	ClampAgentToArena();
-
-	// Update agent state
-	UpdateAgentState();
+	// Apply action (movement); the previous state is kept for the reward
+	PreviousSimulationState = SimulationState;
+	FRLSimpleTargetSimulation::Step(GetSimulationParameters(), PreviousSimulationState, Action.GetData(), SimulationState);
 
-	// Move the actual pawn if it exists
-	if (APawn* OwnerPawn = Cast<APawn>(GetOwner()))
+	// Move the actual pawn if it exists; headless runs move it once when they end
+	if (!IsHeadless())
 	{
-		OwnerPawn->SetActorLocation(AgentPosition);
+		SyncSceneState();
 	}
 
-	// Call parent step
-	Super::Step(Action);
+	// Give Blueprint subclasses their step event
+	Super::ApplyAction(Action);
 }
 
 TArray<float> URLSimpleTargetEnvironment::GetObservation()
 {
 	TArray<float> Observation;
-	Observation.SetNum(EnvironmentConfig.ObservationDim);
-
-	// Agent position (normalized to [-1, 1])
-	Observation[0] = AgentPosition.X / ArenaSize;
-	Observation[1] = AgentPosition.Y / ArenaSize;
-
-	// Agent velocity (normalized)
-	Observation[2] = FMath::Clamp(AgentVelocity.X / MaxSpeed, -1.0f, 1.0f);
-	Observation[3] = FMath::Clamp(AgentVelocity.Y / MaxSpeed, -1.0f, 1.0f);
-
-	// Target position (normalized to [-1, 1])
-	Observation[4] = TargetPosition.X / ArenaSize;
-	Observation[5] = TargetPosition.Y / ArenaSize;
-
-	// Distance to target (raw)
-	Observation[6] = DistanceToTarget;
-
-	// Normalized distance to target [0, 1]
-	float MaxPossibleDistance = ArenaSize * FMath::Sqrt(2.0f); // Diagonal of arena
-	Observation[7] = FMath::Clamp(DistanceToTarget / MaxPossibleDistance, 0.0f, 1.0f);
-
+	Observation.SetNumUninitialized(EnvironmentConfig.ObservationDim);
+	WriteObservation(Observation);
 	return Observation;
 }
 
-float URLSimpleTargetEnvironment::CalculateReward()
+void URLSimpleTargetEnvironment::WriteObservation(TArrayView<float> Observation)
 {
-	float Reward = 0.0f;
-
-	// Distance-based reward (closer is better)
-	float DistanceReward = (LastDistanceToTarget - DistanceToTarget) * RewardScale;
-	Reward += DistanceReward;
-
-	// Bonus for reaching target
-	if (IsAgentAtTarget())
-	{
-		Reward += 100.0f * RewardScale;
-	}
-
-	// Small penalty for each step to encourage efficiency
-	Reward -= 0.1f * RewardScale;
+	check(Observation.Num() == FRLSimpleTargetSimulation::ObservationDim);
+	FRLSimpleTargetSimulation::Observe(GetSimulationParameters(), SimulationState, Observation.GetData());
+}
 
-	return Reward;
+float URLSimpleTargetEnvironment::CalculateReward()
+{
+	// Progress towards the target, a bonus for reaching it and a small penalty for each step to encourage efficiency
+	return FRLSimpleTargetSimulation::Reward(GetSimulationParameters(), PreviousSimulationState, SimulationState);
 }
 
 bool URLSimpleTargetEnvironment::CheckTerminated()
@@ -181,38 +104,44 @@ bool URLSimpleTargetEnvironment::CheckTruncated()
 
 void URLSimpleTargetEnvironment::SetTargetPosition(const FVector& NewTargetPosition)
 {
-	TargetPosition = NewTargetPosition;
-	
 	// Clamp to arena
-	TargetPosition.X = FMath::Clamp(TargetPosition.X, -ArenaSize, ArenaSize);
-	TargetPosition.Y = FMath::Clamp(TargetPosition.Y, -ArenaSize, ArenaSize);
-	TargetPosition.Z = 0.0f;
-
-	UpdateAgentState();
+	SimulationState.TargetX = FMath::Clamp<float>(NewTargetPosition.X, -ArenaSize, ArenaSize);
+	SimulationState.TargetY = FMath::Clamp<float>(NewTargetPosition.Y, -ArenaSize, ArenaSize);
+	MirrorSimulationState();
 }
 
 void URLSimpleTargetEnvironment::RandomizeTargetPosition()
 {
-	TargetPosition = GetRandomPositionInArena();
-	UpdateAgentState();
+	const FVector Position = GetRandomPositionInArena();
+	SimulationState.TargetX = Position.X;
+	SimulationState.TargetY = Position.Y;
+	MirrorSimulationState();
 }
 
 void URLSimpleTargetEnvironment::RandomizeAgentPosition()
 {
-	AgentPosition = GetRandomPositionInArena();
-	
-	// Ensure agent doesn't start too close to target
-	while (FVector::Dist(AgentPosition, TargetPosition) < TargetRadius * 2.0f)
-	{
-		AgentPosition = GetRandomPositionInArena();
-	}
-	
-	UpdateAgentState();
+	// Ensure agent doesn't start too close to target: an episode start with the current target kept
+	FRLSimpleTargetParameters Parameters = GetSimulationParameters();
+	Parameters.bRandomizeTarget = false;
+	Parameters.bRandomizeStartPosition = true;
+	FRLSimpleTargetSimulation::SampleInitialState(Parameters, SimulationState,
+		[](float Min, float Max) { return FMath::FRandRange(Min, Max); });
+	MirrorSimulationState();
 }
 
 bool URLSimpleTargetEnvironment::IsAgentAtTarget() const
 {
-	return DistanceToTarget <= TargetRadius;
+	return FRLSimpleTargetSimulation::Terminated(GetSimulationParameters(), SimulationState);
+}
+
+void URLSimpleTargetEnvironment::SyncSceneState()
+{
+	MirrorSimulationState();
+
+	if (APawn* OwnerPawn = Cast<APawn>(GetOwner()))
+	{
+		OwnerPawn->SetActorLocation(AgentPosition);
+	}
 }
 
 FVector URLSimpleTargetEnvironment::GetRandomPositionInArena() const
@@ -222,22 +151,27 @@ FVector URLSimpleTargetEnvironment::GetRandomPositionInArena() const
 	return FVector(X, Y, 0.0f);
 }
 
-void URLSimpleTargetEnvironment::UpdateAgentState()
+FRLSimpleTargetParameters URLSimpleTargetEnvironment::GetSimulationParameters() const
 {
-	// Calculate velocity
-	float DeltaTime = GetWorld() ? GetWorld()->GetDeltaSeconds() : 0.016f;
-	if (DeltaTime > 0.0f)
-	{
-		AgentVelocity = (AgentPosition - PreviousAgentPosition) / DeltaTime;
-	}
-
-	// Calculate distance to target
-	DistanceToTarget = FVector::Dist(AgentPosition, TargetPosition);
+	FRLSimpleTargetParameters Parameters;
+	Parameters.ArenaSize = ArenaSize;
+	Parameters.TargetRadius = TargetRadius;
+	Parameters.MaxSpeed = MaxSpeed;
+	Parameters.RewardScale = RewardScale;
+	Parameters.DeltaSeconds = GetStepDeltaSeconds();
+	Parameters.bRandomizeTarget = bRandomizeTarget;
+	Parameters.bRandomizeStartPosition = bRandomizeStartPosition;
+	Parameters.TargetX = SimulationState.TargetX;
+	Parameters.TargetY = SimulationState.TargetY;
+	return Parameters;
 }
 
-void URLSimpleTargetEnvironment::ClampAgentToArena()
+void URLSimpleTargetEnvironment::MirrorSimulationState()
 {
-	AgentPosition.X = FMath::Clamp(AgentPosition.X, -ArenaSize, ArenaSize);
-	AgentPosition.Y = FMath::Clamp(AgentPosition.Y, -ArenaSize, ArenaSize);
-	AgentPosition.Z = 0.0f; // Keep on ground plane
+	// Kept on the ground plane
+	AgentPosition = FVector(SimulationState.AgentX, SimulationState.AgentY, 0.0f);
+	AgentVelocity = FVector(SimulationState.VelocityX, SimulationState.VelocityY, 0.0f);
+	TargetPosition = FVector(SimulationState.TargetX, SimulationState.TargetY, 0.0f);
+	DistanceToTarget = FRLSimpleTargetSimulation::Distance(SimulationState);
+	LastDistanceToTarget = FRLSimpleTargetSimulation::Distance(PreviousSimulationState);
 }
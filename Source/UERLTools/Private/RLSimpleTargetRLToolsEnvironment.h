@@ -0,0 +1,112 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RLSimpleTargetSimulation.h"
+
+// The target-reaching task as an rl_tools environment, laid out like rl_tools' pendulum and car environments: the
+// environment type carries the state, parameters and observation types, and free functions in namespace rl_tools
+// implement the environment API on top of FRLSimpleTargetSimulation. Include after rl_tools' operations (e.g.
+// rl_tools/operations/cpu_mux.h) and before the rl_tools components that step environments, like the pendulum
+// operations.
+THIRD_PARTY_INCLUDES_START
+#include "rl_tools/rl/environments/environments.h"
+THIRD_PARTY_INCLUDES_END
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::rl::environments::simple_target {
+    template <typename T_T, typename T_TI>
+    struct Specification{
+        using T = T_T;
+        using TI = T_TI;
+        static_assert(std::is_same_v<T, float>, "FRLSimpleTargetSimulation is single precision");
+    };
+
+    template <typename TI>
+    struct Observation{
+        static constexpr TI DIM = FRLSimpleTargetSimulation::ObservationDim;
+    };
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools::rl::environments{
+    template <typename T_SPEC>
+    struct SimpleTarget: Environment<typename T_SPEC::T, typename T_SPEC::TI>{
+        using SPEC = T_SPEC;
+        using T = typename SPEC::T;
+        using TI = typename SPEC::TI;
+        using State = FRLSimpleTargetState;
+        using Parameters = FRLSimpleTargetParameters;
+        using Observation = simple_target::Observation<TI>;
+        using ObservationPrivileged = Observation;
+        static constexpr TI N_AGENTS = 1; // single agent
+        static constexpr TI ACTION_DIM = FRLSimpleTargetSimulation::ActionDim;
+        static constexpr TI EPISODE_STEP_LIMIT = 1000;
+
+        // Handed to every episode by initial_parameters, e.g. copied from a URLSimpleTargetEnvironment's properties
+        Parameters parameters;
+    };
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
+
+RL_TOOLS_NAMESPACE_WRAPPER_START
+namespace rl_tools{
+    template<typename DEVICE, typename SPEC>
+    static void malloc(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env){ }
+    template<typename DEVICE, typename SPEC>
+    static void free(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env){ }
+    template<typename DEVICE, typename SPEC>
+    static void init(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env){ }
+    template<typename DEVICE, typename SPEC>
+    static void initial_parameters(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env, typename rl::environments::SimpleTarget<SPEC>::Parameters& parameters){
+        parameters = env.parameters;
+    }
+    template<typename DEVICE, typename SPEC, typename RNG>
+    static void sample_initial_parameters(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env, typename rl::environments::SimpleTarget<SPEC>::Parameters& parameters, RNG& rng){
+        initial_parameters(device, env, parameters);
+    }
+    template<typename DEVICE, typename SPEC>
+    static void initial_state(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env, typename rl::environments::SimpleTarget<SPEC>::Parameters& parameters, typename rl::environments::SimpleTarget<SPEC>::State& state){
+        typename rl::environments::SimpleTarget<SPEC>::Parameters fixed_parameters = parameters;
+        fixed_parameters.bRandomizeTarget = false;
+        fixed_parameters.bRandomizeStartPosition = false;
+        // the fixed target and the origin, nothing is drawn
+        FRLSimpleTargetSimulation::SampleInitialState(fixed_parameters, state, [](float, float){ return 0.0f; });
+    }
+    template<typename DEVICE, typename SPEC, typename RNG>
+    static void sample_initial_state(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env, typename rl::environments::SimpleTarget<SPEC>::Parameters& parameters, typename rl::environments::SimpleTarget<SPEC>::State& state, RNG& rng){
+        FRLSimpleTargetSimulation::SampleInitialState(parameters, state, [&rng](float min, float max){
+            return random::uniform_real_distribution(typename DEVICE::SPEC::RANDOM(), min, max, rng);
+        });
+    }
+    template<typename DEVICE, typename SPEC, typename ACTION_SPEC, typename RNG>
+    typename SPEC::T step(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env, typename rl::environments::SimpleTarget<SPEC>::Parameters& parameters, const typename rl::environments::SimpleTarget<SPEC>::State& state, const Matrix<ACTION_SPEC>& action, typename rl::environments::SimpleTarget<SPEC>::State& next_state, RNG& rng){
+        static_assert(ACTION_SPEC::ROWS == 1);
+        static_assert(ACTION_SPEC::COLS == FRLSimpleTargetSimulation::ActionDim);
+        const float movement[FRLSimpleTargetSimulation::ActionDim] = {get(action, 0, 0), get(action, 0, 1)};
+        FRLSimpleTargetSimulation::Step(parameters, state, movement, next_state);
+        return parameters.DeltaSeconds;
+    }
+    template<typename DEVICE, typename SPEC, typename ACTION_SPEC, typename RNG>
+    static typename SPEC::T reward(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env, typename rl::environments::SimpleTarget<SPEC>::Parameters& parameters, const typename rl::environments::SimpleTarget<SPEC>::State& state, const Matrix<ACTION_SPEC>& action, const typename rl::environments::SimpleTarget<SPEC>::State& next_state, RNG& rng){
+        return FRLSimpleTargetSimulation::Reward(parameters, state, next_state);
+    }
+    template<typename DEVICE, typename SPEC, typename OBS_TYPE_SPEC, typename OBS_SPEC, typename RNG>
+    static void observe(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env, const typename rl::environments::SimpleTarget<SPEC>::Parameters& parameters, const typename rl::environments::SimpleTarget<SPEC>::State& state, const typename rl::environments::simple_target::Observation<OBS_TYPE_SPEC>&, Matrix<OBS_SPEC>& observation, RNG& rng){
+        static_assert(OBS_SPEC::ROWS == 1);
+        static_assert(OBS_SPEC::COLS == FRLSimpleTargetSimulation::ObservationDim);
+        using TI = typename DEVICE::index_t;
+        float values[FRLSimpleTargetSimulation::ObservationDim];
+        FRLSimpleTargetSimulation::Observe(parameters, state, values);
+        for(TI i = 0; i < FRLSimpleTargetSimulation::ObservationDim; i++){
+            set(observation, 0, i, values[i]);
+        }
+    }
+    template<typename DEVICE, typename SPEC, typename RNG>
+    static bool terminated(DEVICE& device, const rl::environments::SimpleTarget<SPEC>& env, typename rl::environments::SimpleTarget<SPEC>::Parameters& parameters, const typename rl::environments::SimpleTarget<SPEC>::State state, RNG& rng){
+        return FRLSimpleTargetSimulation::Terminated(parameters, state);
+    }
+}
+RL_TOOLS_NAMESPACE_WRAPPER_END
@@ -2,7 +2,12 @@
 #include "RLConfigTypes.h" // Include for FRLNormalizationParams
 #include "Logging/LogMacros.h"
 #include "Math/UnrealMathUtility.h" // For FMath::Abs and KINDA_SMALL_NUMBER
+#include <type_traits>
+
+THIRD_PARTY_INCLUDES_START
 #include "rl_tools/containers/matrix/operations_generic.h"
+#include "rl_tools/devices/cpu_simd.h"
+THIRD_PARTY_INCLUDES_END
 
 // Fallback log category
 #ifndef LOG_UERLTOOLS
@@ -13,164 +18,145 @@
 
 namespace RLToolsConversionUtils
 {
-    template <typename T_MATRIX_SPEC>
-    bool UEArrayToRLMatrix(
-        const TArray<float>& UEArray,
-        rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix,
-        const FRLNormalizationParams& NormalizationParams)
-    {
-        constexpr auto ROWS = rl_tools::rows(RLMatrix);
-        constexpr auto COLS = rl_tools::cols(RLMatrix);
-        const int32 ExpectedNumElements = ROWS * COLS;
+    // Explicit template instantiations should be carefully managed or placed in a separate .cpp file
+    // if they are truly needed and this header is widely included. For now, commenting out.
+    // Example:
+    // using DEVICE = rl_tools::devices::DefaultCPU;
+    // using SPEC_1_10 = rl_tools::matrix::Specification<float, DEVICE::index_t, 1, 10>;
+    // template bool UEArrayToRLMatrix<SPEC_1_10>(const TArray<float>&, rl_tools::Matrix<SPEC_1_10>&, const FRLNormalizationParams&);
+    // template bool RLMatrixToUEArray<SPEC_1_10>(const rl_tools::Matrix<SPEC_1_10>&, TArray<float>&, const FRLNormalizationParams&);
 
-        if (UEArray.Num() != ExpectedNumElements)
-        {
-            UE_LOG(LOG_UERLTOOLS, Error, TEXT("UEArrayToRLMatrix: Dimension mismatch. UEArray has %d elements, RLMatrix expects %d."), UEArray.Num(), ExpectedNumElements);
-            return false;
-        }
+} // namespace RLToolsConversionUtils
 
-        for (int32 i = 0; i < ExpectedNumElements; ++i)
-        {
-            float ValueToSet = UEArray[i];
-
-            if (NormalizationParams.bIsEnabled)
-            {
-                float Mean = 0.0f;
-                if (NormalizationParams.Mean.Num() == 1)
-                {
-                    Mean = NormalizationParams.Mean[0];
-                }
-                else if (i < NormalizationParams.Mean.Num())
-                {
-                    Mean = NormalizationParams.Mean[i];
-                }
-                else if (NormalizationParams.Mean.Num() > 0) // Not empty, not 1, and index is out of bounds
-                {
-                     UE_LOG(LOG_UERLTOOLS, Warning, TEXT("UEArrayToRLMatrix: Normalization Mean array size (%d) is insufficient for element index %d (total elements %d). Using default mean 0."), NormalizationParams.Mean.Num(), i, ExpectedNumElements);
-                }
+namespace
+{
+    using FNormalizationVector = rl_tools::devices::cpu::simd::Vector<float>;
 
+    // Tiled scale/bias arrays span at least this many floats, so short rows still fill whole SIMD vectors
+    constexpr int32 NormalizationTileMinFloats = 64;
+}
 
-                float StdDev = 1.0f;
-                if (NormalizationParams.StdDev.Num() == 1)
-                {
-                    StdDev = NormalizationParams.StdDev[0];
-                }
-                else if (i < NormalizationParams.StdDev.Num())
-                {
-                    StdDev = NormalizationParams.StdDev[i];
-                }
-                else if (NormalizationParams.StdDev.Num() > 0) // Not empty, not 1, and index is out of bounds
-                {
-                     UE_LOG(LOG_UERLTOOLS, Warning, TEXT("UEArrayToRLMatrix: Normalization StdDev array size (%d) is insufficient for element index %d (total elements %d). Using default stddev 1."), NormalizationParams.StdDev.Num(), i, ExpectedNumElements);
-                }
+FRLNormalizationPlan::FRLNormalizationPlan()
+    : Dim(0)
+    , TileRows(0)
+    , bIsIdentity(true)
+{
+}
 
-                if (FMath::Abs(StdDev) < KINDA_SMALL_NUMBER)
-                {
-                    UE_LOG(LOG_UERLTOOLS, Warning, TEXT("UEArrayToRLMatrix: Normalization StdDev is near zero for element %d. Skipping normalization for this element."), i);
-                    // ValueToSet remains UEArray[i] if we skip normalization due to zero StdDev
-                }
-                else
-                {
-                    ValueToSet = (UEArray[i] - Mean) / StdDev;
-                }
-            }
+void FRLNormalizationPlan::Reset()
+{
+    Scale.Reset();
+    Bias.Reset();
+    Dim = 0;
+    TileRows = 0;
+    bIsIdentity = true;
+}
+
+void FRLNormalizationPlan::Build(const FRLNormalizationParams& Params, int32 InDim, EDirection Direction)
+{
+    Reset();
+    if (!Params.bIsEnabled || InDim <= 0)
+    {
+        Dim = FMath::Max(InDim, 0);
+        return;
+    }
 
-            if constexpr (ROWS == 1) {
-                 rl_tools::set(RLMatrix, 0, i, static_cast<typename T_MATRIX_SPEC::T>(ValueToSet));
-            }
-            else if constexpr (COLS == 1) {
-                 rl_tools::set(RLMatrix, i, 0, static_cast<typename T_MATRIX_SPEC::T>(ValueToSet));
-            }
-            else {
-                int32 Row = i / COLS;
-                int32 Col = i % COLS;
-                if (Row < ROWS && Col < COLS) {
-                     rl_tools::set(RLMatrix, Row, Col, static_cast<typename T_MATRIX_SPEC::T>(ValueToSet));
-                } else {
-                    UE_LOG(LOG_UERLTOOLS, Error, TEXT("UEArrayToRLMatrix: Index out of bounds during 2D mapping. This should not happen."));
-                    return false;
-                }
-            }
+    // Same broadcast/default rules and warnings as the per-element path, but paid once here
+    RLToolsConversionUtils::Detail::ValidateNormalizationParams(TEXT("FRLNormalizationPlan::Build"), Params, InDim);
+
+    const int32 InTileRows = FMath::DivideAndRoundUp(NormalizationTileMinFloats, InDim);
+    Scale.SetNumUninitialized(InDim * InTileRows);
+    Bias.SetNumUninitialized(InDim * InTileRows);
+
+    bool bAnyChange = false;
+    for (int32 Feature = 0; Feature < InDim; ++Feature)
+    {
+        const float Mean = RLToolsConversionUtils::Detail::NormalizationValue(Params.Mean, Feature, 0.0f);
+        const float StdDev = RLToolsConversionUtils::Detail::NormalizationValue(Params.StdDev, Feature, 1.0f);
+
+        float FeatureScale = 1.0f;
+        float FeatureBias = 0.0f;
+        if (Direction == EDirection::Denormalize)
+        {
+            FeatureScale = StdDev;
+            FeatureBias = Mean;
         }
-        return true;
+        else if (FMath::Abs(StdDev) >= KINDA_SMALL_NUMBER)
+        {
+            // Reciprocal taken once; a near-zero stddev leaves the feature unnormalized
+            FeatureScale = 1.0f / StdDev;
+            FeatureBias = -Mean * FeatureScale;
+        }
+
+        Scale[Feature] = FeatureScale;
+        Bias[Feature] = FeatureBias;
+        bAnyChange |= FeatureScale != 1.0f || FeatureBias != 0.0f;
     }
 
-    template <typename T_MATRIX_SPEC>
-    bool RLMatrixToUEArray(
-        const rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix,
-        TArray<float>& UEArray,
-        const FRLNormalizationParams& DenormalizationParams)
+    Dim = InDim;
+    if (!bAnyChange)
     {
-        constexpr auto ROWS = rl_tools::rows(RLMatrix);
-        constexpr auto COLS = rl_tools::cols(RLMatrix);
-        const int32 NumElements = ROWS * COLS;
+        // Mean 0 and stddev 1 everywhere: skip the kernel entirely
+        Scale.Reset();
+        Bias.Reset();
+        return;
+    }
 
-        UEArray.SetNumUninitialized(NumElements);
+    for (int32 Row = 1; Row < InTileRows; ++Row)
+    {
+        FMemory::Memcpy(Scale.GetData() + Row * InDim, Scale.GetData(), sizeof(float) * InDim);
+        FMemory::Memcpy(Bias.GetData() + Row * InDim, Bias.GetData(), sizeof(float) * InDim);
+    }
+    TileRows = InTileRows;
+    bIsIdentity = false;
+}
 
-        for (int32 i = 0; i < NumElements; ++i)
-        {
-            float ValueFromMatrix;
-            if constexpr (ROWS == 1) {
-                ValueFromMatrix = static_cast<float>(rl_tools::get(RLMatrix, 0, i));
-            }
-            else if constexpr (COLS == 1) {
-                ValueFromMatrix = static_cast<float>(rl_tools::get(RLMatrix, i, 0));
-            }
-            else {
-                int32 Row = i / COLS;
-                int32 Col = i % COLS;
-                ValueFromMatrix = static_cast<float>(rl_tools::get(RLMatrix, Row, Col));
-            }
+bool FRLNormalizationPlan::Apply(TConstArrayView<float> Source, TArrayView<float> Destination) const
+{
+    if (Source.Num() != Destination.Num() || (Dim > 0 && Source.Num() % Dim != 0))
+    {
+        UE_LOG(LOG_UERLTOOLS, Error, TEXT("FRLNormalizationPlan::Apply: Expected matching rows of %d floats, got %d source and %d destination floats."), Dim, Source.Num(), Destination.Num());
+        return false;
+    }
 
-            if (DenormalizationParams.bIsEnabled)
-            {
-                float Mean = 0.0f;
-                 if (DenormalizationParams.Mean.Num() == 1)
-                {
-                    Mean = DenormalizationParams.Mean[0];
-                }
-                else if (i < DenormalizationParams.Mean.Num())
-                {
-                    Mean = DenormalizationParams.Mean[i];
-                }
-                else if (DenormalizationParams.Mean.Num() > 0)
-                {
-                     UE_LOG(LOG_UERLTOOLS, Warning, TEXT("RLMatrixToUEArray: Denormalization Mean array size (%d) is insufficient for element index %d (total elements %d). Using default mean 0."), DenormalizationParams.Mean.Num(), i, NumElements);
-                }
+    const float* In = Source.GetData();
+    float* Out = Destination.GetData();
+    const int32 NumElements = Source.Num();
 
-                float StdDev = 1.0f;
-                if (DenormalizationParams.StdDev.Num() == 1)
-                {
-                    StdDev = DenormalizationParams.StdDev[0];
-                }
-                else if (i < DenormalizationParams.StdDev.Num())
-                {
-                    StdDev = DenormalizationParams.StdDev[i];
-                }
-                else if (DenormalizationParams.StdDev.Num() > 0)
-                {
-                     UE_LOG(LOG_UERLTOOLS, Warning, TEXT("RLMatrixToUEArray: Denormalization StdDev array size (%d) is insufficient for element index %d (total elements %d). Using default stddev 1."), DenormalizationParams.StdDev.Num(), i, NumElements);
-                }
-                
-                UEArray[i] = (ValueFromMatrix * StdDev) + Mean;
-            }
-            else
-            {
-                UEArray[i] = ValueFromMatrix;
-            }
+    if (bIsIdentity)
+    {
+        if (In != Out)
+        {
+            FMemory::Memmove(Out, In, sizeof(float) * NumElements);
         }
         return true;
     }
 
-    // Explicit template instantiations should be carefully managed or placed in a separate .cpp file
-    // if they are truly needed and this header is widely included. For now, commenting out.
-    // Example:
-    // using DEVICE = rl_tools::devices::DefaultCPU;
-    // using SPEC_1_10 = rl_tools::matrix::Specification<float, DEVICE::index_t, 1, 10>;
-    // template bool UEArrayToRLMatrix<SPEC_1_10>(const TArray<float>&, rl_tools::Matrix<SPEC_1_10>&, const FRLNormalizationParams&);
-    // template bool RLMatrixToUEArray<SPEC_1_10>(const rl_tools::Matrix<SPEC_1_10>&, TArray<float>&, const FRLNormalizationParams&);
+    // The tile holds whole rows, so every chunk starts at feature 0 and needs one fused multiply-add per element
+    const int32 TileFloats = Dim * TileRows;
+    const float* TileScale = Scale.GetData();
+    const float* TileBias = Bias.GetData();
+    for (int32 ChunkStart = 0; ChunkStart < NumElements; ChunkStart += TileFloats)
+    {
+        const int32 ChunkFloats = FMath::Min(TileFloats, NumElements - ChunkStart);
+        const float* ChunkIn = In + ChunkStart;
+        float* ChunkOut = Out + ChunkStart;
 
-} // namespace RLToolsConversionUtils
+        int32 i = 0;
+        for (; i + FNormalizationVector::WIDTH <= ChunkFloats; i += FNormalizationVector::WIDTH)
+        {
+            FNormalizationVector::store(ChunkOut + i, FNormalizationVector::fmadd(
+                FNormalizationVector::load(ChunkIn + i),
+                FNormalizationVector::load(TileScale + i),
+                FNormalizationVector::load(TileBias + i)));
+        }
+        for (; i < ChunkFloats; ++i)
+        {
+            ChunkOut[i] = ChunkIn[i] * TileScale[i] + TileBias[i];
+        }
+    }
+    return true;
+}
 
 #include "Logging/LogMacros.h"
 
@@ -198,8 +184,8 @@ namespace RLToolsConversionUtils
         // using TI = typename DEVICE::index_t;
         // rl_tools::devices::DefaultCPU device; // Temporary device instance
 
-        constexpr auto ROWS = rl_tools::rows(RLMatrix);
-        constexpr auto COLS = rl_tools::cols(RLMatrix);
+        constexpr auto ROWS = T_MATRIX_SPEC::ROWS;
+        constexpr auto COLS = T_MATRIX_SPEC::COLS;
         const int32 ExpectedNumElements = ROWS * COLS;
 
         if (UEArray.Num() != ExpectedNumElements)
@@ -256,8 +242,8 @@ namespace RLToolsConversionUtils
         // using TI = typename DEVICE::index_t;
         // rl_tools::devices::DefaultCPU device;
 
-        constexpr auto ROWS = rl_tools::rows(RLMatrix);
-        constexpr auto COLS = rl_tools::cols(RLMatrix);
+        constexpr auto ROWS = T_MATRIX_SPEC::ROWS;
+        constexpr auto COLS = T_MATRIX_SPEC::COLS;
         const int32 NumElements = ROWS * COLS;
 
         UEArray.SetNumUninitialized(NumElements); // Resize array
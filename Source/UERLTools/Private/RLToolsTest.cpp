@@ -3,6 +3,14 @@
 #include "RLToolsTest.h"
 #include "UERLLog.h"
 #include "Engine/Engine.h"
+#include "Templates/UniquePtr.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "RLPolicyFile.h"
+#include "RLRunningNormalizer.h"
+#include "RLNormalizationPlan.h"
+#include "RLToolsConversionUtils.h"
+#include "RLRollingStatistics.h"
 
 THIRD_PARTY_INCLUDES_START
 #include "rl_tools/operations/cpu_mux.h"
@@ -11,8 +19,15 @@ THIRD_PARTY_INCLUDES_START
 #include "rl_tools/nn_models/mlp/network.h"
 #include "rl_tools/nn/optimizers/adam/adam.h"
 #include "rl_tools/nn/loss_functions/mse/operations_generic.h"
+#include "rl_tools/rl/environments/pendulum/operations_cpu.h"
+#include "RLSimpleTargetRLToolsEnvironment.h"
+#include "rl_tools/nn_models/random_uniform/operations_generic.h"
+#include "rl_tools/rl/components/off_policy_runner/operations_cpu.h"
 THIRD_PARTY_INCLUDES_END
 
+// After the environment operations, which the runner operations it includes have to see
+#include "RLAgentBackend.h"
+
 #define TEST_ASSERT(condition, message) \
     if (!(condition)) { \
         UERL_RL_ERROR("Test failed: %s", TEXT_UTF8_TO_TCHAR(message)); \
@@ -23,6 +38,262 @@ THIRD_PARTY_INCLUDES_END
         return false; \
     }
 
+namespace RLToolsBenchmark
+{
+    using T = float;
+    using TI = typename rl_tools::devices::DefaultCPU::index_t;
+
+    constexpr TI NUM_THREADS = 4;
+    constexpr TI WARMUP_STEPS = 10;
+    constexpr TI BENCHMARK_STEPS = 2000;
+
+    template <bool PERSISTENT_THREAD_POOL>
+    struct FDeviceSpec : rl_tools::devices::cpu::Specification<rl_tools::devices::math::CPU, rl_tools::devices::random::CPU, rl_tools::devices::logging::CPU>
+    {
+        using EXECUTION_HINTS = rl_tools::rl::components::off_policy_runner::ExecutionHints<TI, NUM_THREADS, PERSISTENT_THREAD_POOL>;
+    };
+
+    template <TI N_ENVS>
+    struct FRunnerParameters : rl_tools::rl::components::off_policy_runner::ParametersDefault<T, TI>
+    {
+        static constexpr TI N_ENVIRONMENTS = N_ENVS;
+        static constexpr TI REPLAY_BUFFER_CAPACITY = 1000;
+    };
+
+    // Average wall time in microseconds of one prologue + epilogue over N_ENVS pendulum environments
+    template <bool PERSISTENT_THREAD_POOL, TI N_ENVS>
+    double TimeRunnerStep()
+    {
+        using DEVICE = rl_tools::devices::CPU<FDeviceSpec<PERSISTENT_THREAD_POOL>>;
+        using ENVIRONMENT = rl_tools::rl::environments::Pendulum<rl_tools::rl::environments::pendulum::Specification<T, TI>>;
+        using POLICY_SPEC = rl_tools::nn_models::random_uniform::Specification<T, TI, ENVIRONMENT::Observation::DIM, ENVIRONMENT::ACTION_DIM, rl_tools::nn_models::random_uniform::Range::MINUS_ONE_TO_ONE>;
+        using POLICY = rl_tools::nn_models::RandomUniform<POLICY_SPEC>;
+        using RUNNER_SPEC = rl_tools::rl::components::off_policy_runner::Specification<T, TI, ENVIRONMENT, rl_tools::utils::Tuple<TI, POLICY>, FRunnerParameters<N_ENVS>>;
+
+        DEVICE device;
+        auto rng = rl_tools::random::default_engine(typename DEVICE::SPEC::RANDOM{}, 42);
+        rl_tools::rl::components::OffPolicyRunner<RUNNER_SPEC> runner;
+        POLICY policy;
+        rl_tools::malloc(device, runner);
+        rl_tools::init(device, runner);
+
+        // the pool (and the per-env RNG streams) are created on the first step, keep that out of the measurement
+        for (TI step_i = 0; step_i < WARMUP_STEPS; step_i++)
+        {
+            rl_tools::rl::components::off_policy_runner::prologue(device, runner, rng);
+            rl_tools::rl::components::off_policy_runner::epilogue(device, runner, policy, rng);
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (TI step_i = 0; step_i < BENCHMARK_STEPS; step_i++)
+        {
+            rl_tools::rl::components::off_policy_runner::prologue(device, runner, rng);
+            rl_tools::rl::components::off_policy_runner::epilogue(device, runner, policy, rng);
+        }
+        const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+        rl_tools::free(device, runner);
+        return ElapsedSeconds * 1e6 / BENCHMARK_STEPS;
+    }
+
+    template <TI N_ENVS>
+    void LogRunnerStep()
+    {
+        const double PoolMicroseconds = TimeRunnerStep<true, N_ENVS>();
+        const double SpawnMicroseconds = TimeRunnerStep<false, N_ENVS>();
+        UERL_RL_LOG("OffPolicyRunner %2d envs: pool %8.2f us/step, spawn %8.2f us/step (%.1fx)", int32(N_ENVS), PoolMicroseconds, SpawnMicroseconds, SpawnMicroseconds / PoolMicroseconds);
+    }
+}
+
+// Contextual bandit of the backend tests: every step is terminal and pays -(action - target)^2 with target = 1.6 * observation[0],
+// so the critic only has to fit the reward and the actor should learn to output the target
+namespace RLToolsBandit
+{
+    using T = float;
+    using TI = typename rl_tools::devices::DefaultCPU::index_t;
+
+    constexpr int32 OBSERVATION_DIM = 3;
+    constexpr int32 ACTION_DIM = 1;
+    constexpr int32 EVALUATION_STEPS = 200;
+
+    T Target(const T* Observation)
+    {
+        return (T)1.6 * Observation[0];
+    }
+
+    template <typename DEVICE, typename RNG>
+    void SampleObservations(DEVICE& Device, RNG& Rng, T* Observations, int32 NumRows)
+    {
+        for (int32 Index = 0; Index < NumRows * OBSERVATION_DIM; ++Index)
+        {
+            Observations[Index] = rl_tools::random::uniform_real_distribution(Device.random, (T)-0.5, (T)0.5, Rng);
+        }
+    }
+
+    // A backend of Algorithm for the bandit's shape with the learning rates all backend tests train with, or null
+    TUniquePtr<IRLAgentBackend> CreateBackend(ERLAlgorithm Algorithm)
+    {
+        TUniquePtr<IRLAgentBackend> Backend(FRLAgentBackendRegistry::Get().Create(Algorithm, OBSERVATION_DIM, ACTION_DIM, 64, 1));
+        if (Backend.IsValid())
+        {
+            Backend->SetTrainingParameters(1e-3f, 1e-3f, 0.99f);
+        }
+        return Backend;
+    }
+
+    // Off-policy training of a TD3 or SAC backend: a uniform warmup, then one update per step, each of which must
+    // be accepted once the replay buffer holds a batch. Like URLAgentManager, the policy sees normalized observations
+    // while the replay buffer stores raw ones (here the bandit's observations denormalized with ObservationParams),
+    // which Train normalizes with the plan of ObservationParams.
+    template <typename DEVICE, typename RNG>
+    bool TrainOffPolicy(IRLAgentBackend& Backend, DEVICE& Device, RNG& Rng, const FRLNormalizationParams& ObservationParams = FRLNormalizationParams())
+    {
+        constexpr int32 WARMUP_STEPS = 500;
+        constexpr int32 TRAINING_STEPS = 2000;
+
+        FRLNormalizationPlan Normalization;
+        FRLNormalizationPlan Denormalization;
+        Normalization.Build(ObservationParams, OBSERVATION_DIM);
+        Denormalization.Build(ObservationParams, OBSERVATION_DIM, FRLNormalizationPlan::EDirection::Denormalize);
+        T Observation[OBSERVATION_DIM];
+        T NextObservation[OBSERVATION_DIM];
+        T RawObservation[OBSERVATION_DIM];
+        T RawNextObservation[OBSERVATION_DIM];
+        T Action[ACTION_DIM];
+
+        for (int32 Step = 0; Step < TRAINING_STEPS; ++Step)
+        {
+            SampleObservations(Device, Rng, Observation, 1);
+            SampleObservations(Device, Rng, NextObservation, 1);
+            Denormalization.Apply(MakeArrayView(Observation, OBSERVATION_DIM), MakeArrayView(RawObservation, OBSERVATION_DIM));
+            Denormalization.Apply(MakeArrayView(NextObservation, OBSERVATION_DIM), MakeArrayView(RawNextObservation, OBSERVATION_DIM));
+            Backend.SampleTrainingActions(Observation, 1, Action, Step < WARMUP_STEPS);
+            const T Error = Action[0] - Target(Observation);
+            Backend.AddTransition(RawObservation, Action, -Error * Error, RawNextObservation, true, false);
+            if (Step >= WARMUP_STEPS)
+            {
+                TEST_ASSERT(Backend.Train(1, Normalization), "Off-policy update refused with a full batch in the replay buffer");
+            }
+        }
+        TEST_ASSERT(Backend.GetReplayBufferSize() == TRAINING_STEPS, "Replay buffer did not store every transition");
+        return true;
+    }
+
+    // Mean squared error of the deterministic actions on fresh observations. An untrained actor is off by ~0.2 on average;
+    // a trained one by well under 0.01
+    template <typename DEVICE, typename RNG>
+    T EvaluateActor(IRLAgentBackend& Backend, DEVICE& Device, RNG& Rng)
+    {
+        T Observation[OBSERVATION_DIM];
+        T Action[ACTION_DIM];
+        T SquaredError = 0;
+        for (int32 Step = 0; Step < EVALUATION_STEPS; ++Step)
+        {
+            SampleObservations(Device, Rng, Observation, 1);
+            Backend.Evaluate(Observation, Action);
+            const T Error = Action[0] - Target(Observation);
+            SquaredError += Error * Error;
+        }
+        return SquaredError / EVALUATION_STEPS;
+    }
+}
+
+// Dense layer kernels of the plain CPU device (nn/layers/dense/operations_cpu.h) against the generic scalar loops they
+// replace. Naming DEVICE explicitly as the first template argument leaves only the generic overloads viable: the SIMD
+// ones take devices::CPU<DEV_SPEC>&, which cannot bind a DefaultCPU with DEV_SPEC = DefaultCPU.
+namespace RLToolsDenseKernel
+{
+    using DEVICE = rl_tools::devices::DefaultCPU;
+    using T = float;
+    using TI = typename DEVICE::index_t;
+
+    template <typename SPEC>
+    T MaxDifference(const rl_tools::Matrix<SPEC>& Actual, const rl_tools::Matrix<SPEC>& Expected)
+    {
+        // Relative above 1, so gradients summed over the batch get the same slack per term as single outputs
+        T Difference = 0;
+        for (TI Row = 0; Row < SPEC::ROWS; ++Row)
+        {
+            for (TI Col = 0; Col < SPEC::COLS; ++Col)
+            {
+                const T Reference = rl_tools::get(Expected, Row, Col);
+                Difference = FMath::Max(Difference, FMath::Abs(rl_tools::get(Actual, Row, Col) - Reference) / FMath::Max((T)1, FMath::Abs(Reference)));
+            }
+        }
+        return Difference;
+    }
+
+    // Runs evaluate, forward, backward_input, backward and backward_full of one layer shape through both
+    // implementations with the same parameters and inputs and returns the largest difference of any result
+    template <TI INPUT_DIM, TI OUTPUT_DIM, TI BATCH_SIZE, rl_tools::nn::activation_functions::ActivationFunction ACTIVATION>
+    T MaxKernelDifference(DEVICE& Device)
+    {
+        using CONFIG = rl_tools::nn::layers::dense::Configuration<T, TI, OUTPUT_DIM, ACTIVATION>;
+        using CAPABILITY = rl_tools::nn::capability::Gradient<rl_tools::nn::parameters::Gradient>;
+        using LAYER = rl_tools::nn::layers::dense::Layer<CONFIG, CAPABILITY, rl_tools::tensor::Shape<TI, BATCH_SIZE, INPUT_DIM>>;
+        using BACKWARD_LAYER = rl_tools::nn::layers::dense::LayerBackward<typename LAYER::SPEC>;
+        using INPUT = rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, BATCH_SIZE, INPUT_DIM>>;
+        using OUTPUT = rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, BATCH_SIZE, OUTPUT_DIM>>;
+
+        auto Rng = rl_tools::random::default_engine(Device.random, INPUT_DIM * 1000 + OUTPUT_DIM);
+        rl_tools::nn::layers::dense::Buffer Buffer;
+        LAYER Simd;
+        LAYER Generic;
+        INPUT Input, DInputSimd, DInputGeneric;
+        OUTPUT DOutput, OutputSimd, OutputGeneric;
+        rl_tools::malloc(Device, Simd);
+        rl_tools::malloc(Device, Generic);
+        rl_tools::malloc(Device, Input);
+        rl_tools::malloc(Device, DInputSimd);
+        rl_tools::malloc(Device, DInputGeneric);
+        rl_tools::malloc(Device, DOutput);
+        rl_tools::malloc(Device, OutputSimd);
+        rl_tools::malloc(Device, OutputGeneric);
+        rl_tools::init_weights(Device, Simd, Rng);
+        rl_tools::copy(Device, Device, Simd, Generic);
+        rl_tools::randn(Device, Input, Rng);
+        rl_tools::randn(Device, DOutput, Rng);
+
+        T Difference = 0;
+        rl_tools::evaluate(Device, Simd, Input, OutputSimd, Buffer, Rng);
+        rl_tools::evaluate<DEVICE>(Device, Generic, Input, OutputGeneric, Buffer, Rng);
+        Difference = FMath::Max(Difference, MaxDifference(OutputSimd, OutputGeneric));
+
+        rl_tools::forward(Device, static_cast<BACKWARD_LAYER&>(Simd), Input, OutputSimd, Buffer, Rng);
+        rl_tools::forward<DEVICE>(Device, static_cast<BACKWARD_LAYER&>(Generic), Input, OutputGeneric, Buffer, Rng);
+        Difference = FMath::Max(Difference, MaxDifference(OutputSimd, OutputGeneric));
+        Difference = FMath::Max(Difference, MaxDifference(Simd.pre_activations, Generic.pre_activations));
+
+        rl_tools::backward_input(Device, Simd, DOutput, DInputSimd, Buffer);
+        rl_tools::backward_input<DEVICE>(Device, Generic, DOutput, DInputGeneric, Buffer);
+        Difference = FMath::Max(Difference, MaxDifference(DInputSimd, DInputGeneric));
+
+        rl_tools::zero_gradient(Device, Simd);
+        rl_tools::zero_gradient(Device, Generic);
+        rl_tools::backward(Device, Simd, Input, DOutput, Buffer);
+        rl_tools::backward<DEVICE>(Device, Generic, Input, DOutput, Buffer);
+        Difference = FMath::Max(Difference, MaxDifference(Simd.weights.gradient, Generic.weights.gradient));
+        Difference = FMath::Max(Difference, MaxDifference(Simd.biases.gradient, Generic.biases.gradient));
+
+        // backward_full accumulates onto the gradients of the backward pass above
+        rl_tools::backward_full(Device, Simd, Input, DOutput, DInputSimd, Buffer);
+        rl_tools::backward_full<DEVICE>(Device, Generic, Input, DOutput, DInputGeneric, Buffer);
+        Difference = FMath::Max(Difference, MaxDifference(DInputSimd, DInputGeneric));
+        Difference = FMath::Max(Difference, MaxDifference(Simd.weights.gradient, Generic.weights.gradient));
+        Difference = FMath::Max(Difference, MaxDifference(Simd.biases.gradient, Generic.biases.gradient));
+
+        rl_tools::free(Device, Simd);
+        rl_tools::free(Device, Generic);
+        rl_tools::free(Device, Input);
+        rl_tools::free(Device, DInputSimd);
+        rl_tools::free(Device, DInputGeneric);
+        rl_tools::free(Device, DOutput);
+        rl_tools::free(Device, OutputSimd);
+        rl_tools::free(Device, OutputGeneric);
+        return Difference;
+    }
+}
+
 URLToolsTest::URLToolsTest()
 {
     // Seed the random number generator for consistent test results
@@ -37,8 +308,22 @@ bool URLToolsTest::TestRLToolsIntegration()
     // Run all test cases
     allTestsPassed &= TestMatrixOperations();
     allTestsPassed &= TestNeuralNetworkLayer();
+    allTestsPassed &= TestDenseKernels();
     allTestsPassed &= TestMLPNetwork();
     allTestsPassed &= TestOptimizer();
+    allTestsPassed &= TestRunningNormalizer();
+    allTestsPassed &= TestNormalizationPlan();
+    allTestsPassed &= TestRollingStatistics();
+    allTestsPassed &= TestConcurrentReplayBuffer();
+    allTestsPassed &= TestWholeBatchGather();
+    allTestsPassed &= TestDeduplicatedReplayBuffer();
+    allTestsPassed &= TestHalfPrecisionStorage();
+    allTestsPassed &= TestSumTree();
+    allTestsPassed &= TestReplayBufferFile();
+    allTestsPassed &= TestTD3Backend();
+    allTestsPassed &= TestSACBackend();
+    allTestsPassed &= TestPPOBackend();
+    allTestsPassed &= TestSimpleTargetEnvironment();
     
     // Final status
     if (allTestsPassed)
@@ -217,6 +502,38 @@ bool URLToolsTest::TestNeuralNetworkLayer()
     }
 }
 
+bool URLToolsTest::TestDenseKernels()
+{
+    using namespace RLToolsDenseKernel;
+    using rl_tools::nn::activation_functions::ActivationFunction;
+
+    try
+    {
+        // Shapes on both sides of the vector width and the 2x4 / 4x2 register blocks, so the column, row and batch tails
+        // of every kernel run, plus one shape made of whole blocks only
+        const T Differences[] = {
+            MaxKernelDifference<13, 7, 5, ActivationFunction::RELU>(device),
+            MaxKernelDifference<3, 1, 1, ActivationFunction::TANH>(device),
+            MaxKernelDifference<17, 33, 11, ActivationFunction::IDENTITY>(device),
+            MaxKernelDifference<9, 5, 3, ActivationFunction::FAST_TANH>(device),
+            MaxKernelDifference<64, 64, 32, ActivationFunction::RELU>(device),
+        };
+        for (const T Difference : Differences)
+        {
+            UERL_RL_LOG("Dense kernel test - Largest relative difference to the generic implementation: %g", Difference);
+            TEST_ASSERT(Difference < 1e-4f, "SIMD dense kernels differ from the generic implementation");
+        }
+
+        UERL_RL_LOG("Dense kernel test passed!");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_RL_ERROR("Dense kernel test failed: %s", e.what());
+        return false;
+    }
+}
+
 bool URLToolsTest::TestMLPNetwork()
 {
     using DEVICE = rl_tools::devices::DefaultCPU;
@@ -376,3 +693,1062 @@ bool URLToolsTest::TestOptimizer()
         return false;
     }
 }
+
+bool URLToolsTest::TestRunningNormalizer()
+{
+    using T = float;
+
+    try
+    {
+        // Split a dataset across two normalizers, the way two rollout workers would see it, merge them and compare with
+        // the mean and variance of the whole dataset computed directly
+        constexpr int32 DIM = 3;
+        constexpr int32 ROWS_A = 37;
+        constexpr int32 ROWS_B = 91;
+        constexpr int32 ROWS = ROWS_A + ROWS_B;
+
+        // Every feature gets its own offset and spread, so mixed-up features show
+        auto rng = rl_tools::random::default_engine(device.random, 11);
+        TArray<T> Rows;
+        Rows.SetNumUninitialized(ROWS * DIM);
+        for (int32 Index = 0; Index < Rows.Num(); ++Index)
+        {
+            const int32 Feature = Index % DIM;
+            Rows[Index] = (Feature + 1) * (T)100 + (Feature + 1) * rl_tools::random::uniform_real_distribution(device.random, (T)-1, (T)1, rng);
+        }
+
+        double ExpectedMean[DIM] = {};
+        double ExpectedVariance[DIM] = {};
+        for (int32 Row = 0; Row < ROWS; ++Row)
+        {
+            for (int32 Feature = 0; Feature < DIM; ++Feature)
+            {
+                ExpectedMean[Feature] += Rows[Row * DIM + Feature];
+            }
+        }
+        for (int32 Feature = 0; Feature < DIM; ++Feature)
+        {
+            ExpectedMean[Feature] /= ROWS;
+        }
+        for (int32 Row = 0; Row < ROWS; ++Row)
+        {
+            for (int32 Feature = 0; Feature < DIM; ++Feature)
+            {
+                ExpectedVariance[Feature] += FMath::Square(Rows[Row * DIM + Feature] - ExpectedMean[Feature]);
+            }
+        }
+        for (int32 Feature = 0; Feature < DIM; ++Feature)
+        {
+            ExpectedVariance[Feature] /= ROWS;
+        }
+
+        const TConstArrayView<T> AllRows(Rows);
+        FRLRunningNormalizer WorkerA;
+        FRLRunningNormalizer WorkerB;
+        WorkerA.Reset(DIM);
+        WorkerB.Reset(DIM);
+        FRLNormalizationParams Params;
+        TEST_ASSERT(WorkerA.Update(AllRows.Slice(0, DIM)) && !WorkerA.ToParams(Params), "Normalizer produced params from a single row");
+        // Worker A folds its share in uneven batches, worker B in one
+        TEST_ASSERT(WorkerA.Update(AllRows.Slice(DIM, 19 * DIM)), "Normalizer rejected a batch of whole rows");
+        TEST_ASSERT(WorkerA.Update(AllRows.Slice(20 * DIM, (ROWS_A - 20) * DIM)), "Normalizer rejected a batch of whole rows");
+        TEST_ASSERT(WorkerB.Update(AllRows.Slice(ROWS_A * DIM, ROWS_B * DIM)), "Normalizer rejected a batch of whole rows");
+        TEST_ASSERT(!WorkerB.Update(AllRows.Slice(0, DIM + 1)), "Normalizer accepted a partial row");
+        TEST_ASSERT(WorkerA.Merge(WorkerB), "Normalizers of the same dimension did not merge");
+        TEST_ASSERT(WorkerA.GetCount() == ROWS, "Merged normalizer lost rows");
+
+        TEST_ASSERT(WorkerA.ToParams(Params) && Params.bIsEnabled, "Merged normalizer produced no params");
+        for (int32 Feature = 0; Feature < DIM; ++Feature)
+        {
+            const double Variance = WorkerA.GetM2()[Feature] / WorkerA.GetCount();
+            TEST_ASSERT(FMath::Abs(WorkerA.GetMean()[Feature] - ExpectedMean[Feature]) < 1e-9 * ExpectedMean[Feature], "Merged mean differs from the whole dataset's");
+            TEST_ASSERT(FMath::Abs(Variance - ExpectedVariance[Feature]) < 1e-9 * ExpectedVariance[Feature], "Merged variance differs from the whole dataset's");
+            TEST_ASSERT(FMath::Abs(Params.Mean[Feature] - (T)ExpectedMean[Feature]) < 1e-4f, "Normalization mean differs from the dataset's");
+            TEST_ASSERT(FMath::Abs(Params.StdDev[Feature] - (T)FMath::Sqrt(ExpectedVariance[Feature] + 1e-8)) < 1e-5f, "Normalization stddev differs from the dataset's");
+        }
+
+        // Frozen statistics ignore new data and come back out of a policy file bit for bit, still frozen
+        WorkerA.Freeze();
+        TEST_ASSERT(WorkerA.Update(AllRows.Slice(0, 4 * DIM)) && WorkerA.Merge(WorkerB), "Frozen normalizer refused data instead of ignoring it");
+        TEST_ASSERT(WorkerA.GetCount() == ROWS, "Frozen normalizer still folded in data");
+
+        const T Weights[DIM] = {0.5f, -0.25f, 2.0f};
+        FRLPolicyFileContents Contents;
+        Contents.ObservationDim = DIM;
+        Contents.ActionDim = 1;
+        Contents.HiddenDim = 1;
+        Contents.ParameterBlocks.Add({Weights, 1, DIM});
+        Contents.ObservationStatistics = &WorkerA;
+        Contents.ObservationNormalizationParams = Params;
+        Contents.bUseRunningObservationNormalization = true;
+
+        const FString FilePath = FPaths::CreateTempFilename(*FPaths::ProjectSavedDir(), TEXT("RLToolsTest"), TEXT(".urlp"));
+        TEST_ASSERT(FRLPolicyFile::Save(FilePath, Contents), "Policy file with running statistics was not saved");
+        FRLRunningNormalizer Loaded;
+        FRLNormalizationParams LoadedParams;
+        bool bOpened = false;
+        bool bRestored = false;
+        {
+            FRLPolicyFile File;
+            bOpened = File.Open(FilePath);
+            bRestored = bOpened && File.UsesRunningObservationNormalization() && File.ReadObservationStatistics(Loaded);
+        }
+        IFileManager::Get().Delete(*FilePath);
+        TEST_ASSERT(bOpened, "Saved policy file did not open");
+        TEST_ASSERT(bRestored, "Running statistics did not come back out of the policy file");
+        TEST_ASSERT(Loaded.IsFrozen() && Loaded.GetDim() == DIM && Loaded.GetCount() == ROWS, "Restored normalizer is not the frozen one that was saved");
+        TEST_ASSERT(FMemory::Memcmp(Loaded.GetMean().GetData(), WorkerA.GetMean().GetData(), sizeof(double) * DIM) == 0
+            && FMemory::Memcmp(Loaded.GetM2().GetData(), WorkerA.GetM2().GetData(), sizeof(double) * DIM) == 0, "Restored statistics differ from the saved ones");
+        TEST_ASSERT(Loaded.ToParams(LoadedParams) && LoadedParams.Mean == Params.Mean && LoadedParams.StdDev == Params.StdDev, "Restored statistics produce other normalization params");
+
+        UERL_RL_LOG("Running normalizer test passed!");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_RL_ERROR("Running normalizer test failed: %s", e.what());
+        return false;
+    }
+}
+
+bool URLToolsTest::TestNormalizationPlan()
+{
+    using T = float;
+    using TI = rl_tools::devices::DefaultCPU::index_t;
+
+    try
+    {
+        // Reference: the per-element rule the plan replaces, (x - mean) / stddev with a near-zero stddev left alone
+        const auto Reference = [](T Value, T Mean, T StdDev)
+        {
+            return FMath::Abs(StdDev) < KINDA_SMALL_NUMBER ? Value : (Value - Mean) / StdDev;
+        };
+
+        // A single mean/stddev broadcasts to every feature
+        constexpr int32 BROADCAST_DIM = 6;
+        FRLNormalizationParams Params;
+        Params.bIsEnabled = true;
+        Params.Mean = {2.0f};
+        Params.StdDev = {4.0f};
+        FRLNormalizationPlan Plan;
+        Plan.Build(Params, BROADCAST_DIM);
+        TEST_ASSERT(!Plan.IsIdentity() && Plan.GetDim() == BROADCAST_DIM && Plan.GetScale().Num() == BROADCAST_DIM, "Broadcast plan has the wrong shape");
+        TArray<T> Row = {-3.0f, 0.0f, 1.0f, 2.0f, 5.5f, 10.0f};
+        TArray<T> Normalized;
+        Normalized.SetNumUninitialized(BROADCAST_DIM);
+        TEST_ASSERT(Plan.Apply(Row, Normalized), "Broadcast plan rejected a whole row");
+        for (int32 Feature = 0; Feature < BROADCAST_DIM; ++Feature)
+        {
+            TEST_ASSERT(FMath::Abs(Normalized[Feature] - Reference(Row[Feature], 2.0f, 4.0f)) < 1e-6f, "Scalar mean/stddev was not broadcast to every feature");
+        }
+
+        // Near-zero stddevs leave their feature untouched; missing entries fall back to mean 0 and stddev 1
+        constexpr int32 DIM = 5;
+        Params.Mean = {1.0f, -2.0f, 3.0f, 0.5f};
+        Params.StdDev = {2.0f, 0.0f, 1e-9f, 0.25f};
+        const T Means[DIM] = {1.0f, -2.0f, 3.0f, 0.5f, 0.0f};
+        const T StdDevs[DIM] = {2.0f, 0.0f, 1e-9f, 0.25f, 1.0f};
+        Plan.Build(Params, DIM);
+        TEST_ASSERT(Plan.GetScale()[1] == 1.0f && Plan.GetBias()[1] == 0.0f && Plan.GetScale()[2] == 1.0f && Plan.GetBias()[2] == 0.0f,
+            "Near-zero stddev was not clamped to the identity");
+
+        // Many rows of a Dim that is no multiple of the vector width: the tiled scale/bias has to stay aligned with
+        // the features across tile boundaries and the scalar tail
+        constexpr int32 ROWS = 50;
+        auto rng = rl_tools::random::default_engine(device.random, 5);
+        TArray<T> Rows;
+        Rows.SetNumUninitialized(ROWS * DIM);
+        for (T& Value : Rows)
+        {
+            Value = rl_tools::random::uniform_real_distribution(device.random, (T)-10, (T)10, rng);
+        }
+        TArray<T> Expected;
+        Expected.SetNumUninitialized(ROWS * DIM);
+        for (int32 Index = 0; Index < Expected.Num(); ++Index)
+        {
+            Expected[Index] = Reference(Rows[Index], Means[Index % DIM], StdDevs[Index % DIM]);
+        }
+
+        TArray<T> Block = Rows;
+        TEST_ASSERT(Plan.ApplyInPlace(Block), "Plan rejected a block of whole rows");
+        TEST_ASSERT(!Plan.Apply(TConstArrayView<T>(Rows).Slice(0, DIM + 1), TArrayView<T>(Block).Slice(0, DIM + 1)), "Plan accepted a partial row");
+        for (int32 Index = 0; Index < Block.Num(); ++Index)
+        {
+            TEST_ASSERT(FMath::Abs(Block[Index] - Expected[Index]) < 1e-4f, "Tiled plan differs from per-element normalization");
+        }
+
+        // The matrix overload walks the same rows; a row of two features vectors shows the plan tiles inside a row too
+        rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, ROWS / 2, 2 * DIM>> Matrix;
+        rl_tools::malloc(device, Matrix);
+        const bool bConverted = RLToolsConversionUtils::UEArrayToRLMatrix(TConstArrayView<T>(Rows), Matrix, Plan);
+        bool bMatches = true;
+        for (int32 Index = 0; Index < Expected.Num(); ++Index)
+        {
+            bMatches &= FMath::Abs(rl_tools::get(Matrix, Index / (2 * DIM), Index % (2 * DIM)) - Expected[Index]) < 1e-4f;
+        }
+
+        // Denormalizing undoes the normalization; the clamped features were never scaled, so they only get the mean added
+        FRLNormalizationParams DenormalizationParams = Params;
+        DenormalizationParams.StdDev = {2.0f, 1.0f, 1.0f, 0.25f};
+        FRLNormalizationPlan Denormalization;
+        Denormalization.Build(DenormalizationParams, DIM, FRLNormalizationPlan::EDirection::Denormalize);
+        TArray<T> RoundTrip;
+        RoundTrip.SetNumUninitialized(ROWS * DIM);
+        const bool bDenormalized = RLToolsConversionUtils::RLMatrixToUEArray(Matrix, TArrayView<T>(RoundTrip), Denormalization);
+        rl_tools::free(device, Matrix);
+        TEST_ASSERT(bConverted && bMatches, "Matrix conversion through the plan differs from per-element normalization");
+        TEST_ASSERT(bDenormalized, "Denormalization plan rejected the matrix");
+        for (int32 Index = 0; Index < RoundTrip.Num(); ++Index)
+        {
+            const int32 Feature = Index % DIM;
+            const T Original = Feature == 1 || Feature == 2 ? Rows[Index] + Means[Feature] : Rows[Index];
+            TEST_ASSERT(FMath::Abs(RoundTrip[Index] - Original) < 1e-4f, "Denormalization did not undo the normalization");
+        }
+
+        // Mean 0 and stddev 1 everywhere compiles to the identity, which copies
+        Params.Mean = {0.0f};
+        Params.StdDev = {1.0f};
+        Plan.Build(Params, DIM);
+        TEST_ASSERT(Plan.IsIdentity() && Plan.GetScale().Num() == 0, "Neutral params did not produce the identity plan");
+        TEST_ASSERT(Plan.Apply(Rows, Block) && Block == Rows, "Identity plan changed the values");
+
+        UERL_RL_LOG("Normalization plan test passed!");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_RL_ERROR("Normalization plan test failed: %s", e.what());
+        return false;
+    }
+}
+
+bool URLToolsTest::TestRollingStatistics()
+{
+    using T = float;
+
+    try
+    {
+        // Stream values through a small window for several laps and compare every summary with the window recomputed
+        // from the stream. Half-integer values repeat often, so the sorted copy has to evict the right one of equal values.
+        constexpr int32 CAPACITY = 7;
+        constexpr int32 NUM_VALUES = 10 * CAPACITY + 3;
+        const T Fractions[] = {0.0f, 0.1f, 0.5f, 0.9f, 0.99f, 1.0f};
+
+        auto rng = rl_tools::random::default_engine(device.random, 13);
+        FRLRollingStatistics Statistics(CAPACITY);
+        TEST_ASSERT(Statistics.GetSummary().Count == 0 && Statistics.GetPercentile(0.5f) == 0.0f, "Empty window has a summary");
+
+        TArray<T> Stream;
+        TArray<T> Window;
+        for (int32 Index = 0; Index < NUM_VALUES; ++Index)
+        {
+            const T Value = FMath::RoundToFloat(rl_tools::random::uniform_real_distribution(device.random, (T)-8, (T)8, rng)) * 0.5f;
+            Stream.Add(Value);
+            Statistics.Add(Value);
+
+            const int32 Count = FMath::Min(Stream.Num(), CAPACITY);
+            Window = TArray<T>(Stream.GetData() + Stream.Num() - Count, Count);
+            double ExpectedMean = 0;
+            for (const T WindowValue : Window)
+            {
+                ExpectedMean += WindowValue;
+            }
+            ExpectedMean /= Count;
+            double ExpectedVariance = 0;
+            for (const T WindowValue : Window)
+            {
+                ExpectedVariance += FMath::Square(WindowValue - ExpectedMean);
+            }
+            ExpectedVariance /= Count;
+            Window.Sort();
+
+            TEST_ASSERT(Statistics.Num() == Count, "Window does not hold the last Capacity values");
+            TEST_ASSERT(FMath::Abs(Statistics.GetMean() - ExpectedMean) < 1e-9, "Window mean drifted from the values it holds");
+            TEST_ASSERT(FMath::Abs(Statistics.GetVariance() - ExpectedVariance) < 1e-9, "Window variance drifted from the values it holds");
+
+            // Percentiles interpolate between neighbouring ranks of the sorted window, so they must match it exactly
+            for (const T Fraction : Fractions)
+            {
+                const T Rank = Fraction * (Count - 1);
+                const int32 Lower = FMath::FloorToInt(Rank);
+                const int32 Upper = FMath::Min(Lower + 1, Count - 1);
+                TEST_ASSERT(Statistics.GetPercentile(Fraction) == FMath::Lerp(Window[Lower], Window[Upper], Rank - Lower), "Percentile differs from the sorted window");
+            }
+            const FRLStatisticsSummary Summary = Statistics.GetSummary();
+            TEST_ASSERT(Summary.Min == Window[0] && Summary.Max == Window[Count - 1], "Min or max differs from the sorted window");
+        }
+
+        // Resizing empties the window
+        Statistics.Reset(3);
+        Statistics.Add(1.0f);
+        TEST_ASSERT(Statistics.GetCapacity() == 3 && Statistics.Num() == 1 && Statistics.GetMean() == 1.0 && Statistics.GetVariance() == 0.0, "Reset kept values of the old window");
+
+        UERL_RL_LOG("Rolling statistics test passed!");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_RL_ERROR("Rolling statistics test failed: %s", e.what());
+        return false;
+    }
+}
+
+bool URLToolsTest::TestConcurrentReplayBuffer()
+{
+    using T = float;
+    using TI = typename rl_tools::devices::DefaultCPU::index_t;
+    constexpr TI OBSERVATION_DIM = 2;
+    constexpr TI ACTION_DIM = 1;
+    constexpr TI CAPACITY = 16;
+    constexpr TI BATCH_SIZE = 4;
+    constexpr TI ROWS = 8;
+    using ENVIRONMENT = TRLEnvironmentShape<T, TI, OBSERVATION_DIM, ACTION_DIM>;
+    using REPLAY_BUFFER_SPEC = rl_tools::rl::components::replay_buffer::Specification<T, TI, OBSERVATION_DIM, OBSERVATION_DIM, false, ACTION_DIM, CAPACITY>;
+    using BATCH_SPEC = rl_tools::rl::components::off_policy_runner::SequentialBatchSpecification<TRLTransitionSourceSpec<T, TI, ENVIRONMENT>, 1, BATCH_SIZE>;
+
+    rl_tools::rl::components::ConcurrentReplayBuffer<REPLAY_BUFFER_SPEC> ReplayBuffer;
+    rl_tools::rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC> Batch;
+    rl_tools::malloc(device, ReplayBuffer);
+    rl_tools::malloc(device, Batch);
+    rl_tools::init(device, ReplayBuffer);
+    auto rng = rl_tools::random::default_engine(device.random, 3);
+
+    // Reserved but not yet written: counted by size(), invisible to readers, and a gather has to give up instead of
+    // spinning until the writer commits
+    TI Tickets[ROWS];
+    for (TI Row = 0; Row < ROWS; ++Row)
+    {
+        Tickets[Row] = rl_tools::add_begin(device, ReplayBuffer);
+    }
+    TEST_ASSERT(rl_tools::size(device, ReplayBuffer) == ROWS, "Reserved rows are not counted by size");
+    TEST_ASSERT(rl_tools::published_size(device, ReplayBuffer) == 0, "Reserved rows are counted as published");
+    TEST_ASSERT(!rl_tools::gather_batch(device, ReplayBuffer, Batch, 0, rng), "Single-sample gather returned a row that is still being written");
+    TEST_ASSERT(!rl_tools::gather_batch(device, ReplayBuffer, Batch, rng), "Batch gather returned rows that are still being written");
+
+    // Row r holds observation (r, -r), action r / 10 and reward r
+    for (TI Row = 0; Row < ROWS; ++Row)
+    {
+        rl_tools::set(ReplayBuffer.observations, Row, 0, (T)Row);
+        rl_tools::set(ReplayBuffer.observations, Row, 1, -(T)Row);
+        rl_tools::set(ReplayBuffer.actions, Row, 0, (T)Row / 10);
+        rl_tools::set(ReplayBuffer.next_observations, Row, 0, (T)Row + 1);
+        rl_tools::set(ReplayBuffer.next_observations, Row, 1, -(T)Row - 1);
+        rl_tools::set(ReplayBuffer.rewards, Row, 0, (T)Row);
+        rl_tools::set(ReplayBuffer.terminated, Row, 0, (T)0);
+        rl_tools::set(ReplayBuffer.truncated, Row, 0, (T)0);
+        if (Row != ROWS - 1)
+        {
+            rl_tools::add_commit(device, ReplayBuffer, Tickets[Row]);
+        }
+    }
+    TEST_ASSERT(rl_tools::published_size(device, ReplayBuffer) == ROWS - 1, "Published rows miscounted");
+
+    // One row is still in flight; gathers skip it and every gathered row is one of the published ones, intact
+    for (int32 Round = 0; Round < 20; ++Round)
+    {
+        TEST_ASSERT(rl_tools::gather_batch(device, ReplayBuffer, Batch, rng), "Batch gather gave up with published rows available");
+        for (TI BatchStep = 0; BatchStep < BATCH_SIZE; ++BatchStep)
+        {
+            const T Reward = rl_tools::get(device, Batch.rewards, 0, BatchStep, 0);
+            TEST_ASSERT(Reward >= 0 && Reward < ROWS - 1, "Gathered a row that was never published");
+            TEST_ASSERT(rl_tools::get(device, Batch.observations, 0, BatchStep, 0) == Reward
+                && rl_tools::get(device, Batch.observations, 0, BatchStep, 1) == -Reward
+                && rl_tools::get(device, Batch.actions, 0, BatchStep, 0) == Reward / 10
+                && rl_tools::get(device, Batch.next_observations, 0, BatchStep, 0) == Reward + 1, "Gathered row does not match its reward");
+        }
+    }
+    rl_tools::add_commit(device, ReplayBuffer, Tickets[ROWS - 1]);
+    TEST_ASSERT(rl_tools::published_size(device, ReplayBuffer) == ROWS, "Last row was not published");
+
+    rl_tools::free(device, Batch);
+    rl_tools::free(device, ReplayBuffer);
+    UERL_RL_LOG("Concurrent replay buffer test passed!");
+    return true;
+}
+
+bool URLToolsTest::TestWholeBatchGather()
+{
+    using T = float;
+    using TI = typename rl_tools::devices::DefaultCPU::index_t;
+    constexpr TI OBSERVATION_DIM = 5;
+    constexpr TI ACTION_DIM = 2;
+    constexpr TI CAPACITY = 1000;
+    constexpr TI ROWS = 700;
+    constexpr TI BATCH_SIZE = 32;
+    using ENVIRONMENT = TRLEnvironmentShape<T, TI, OBSERVATION_DIM, ACTION_DIM>;
+    using REPLAY_BUFFER_SPEC = rl_tools::rl::components::replay_buffer::Specification<T, TI, OBSERVATION_DIM, OBSERVATION_DIM, false, ACTION_DIM, CAPACITY>;
+    using BATCH_SPEC = rl_tools::rl::components::off_policy_runner::SequentialBatchSpecification<TRLTransitionSourceSpec<T, TI, ENVIRONMENT>, 1, BATCH_SIZE>;
+
+    rl_tools::rl::components::ConcurrentReplayBuffer<REPLAY_BUFFER_SPEC> ReplayBuffer;
+    rl_tools::rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC> SingleBatch;
+    rl_tools::rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC> WholeBatch;
+    rl_tools::malloc(device, ReplayBuffer);
+    rl_tools::malloc(device, SingleBatch);
+    rl_tools::malloc(device, WholeBatch);
+    rl_tools::init(device, ReplayBuffer);
+
+    // Row r holds r in every column but the flags, so a gathered sample names its row
+    for (TI Row = 0; Row < ROWS; ++Row)
+    {
+        const TI Ticket = rl_tools::add_begin(device, ReplayBuffer);
+        for (TI Index = 0; Index < OBSERVATION_DIM; ++Index)
+        {
+            rl_tools::set(ReplayBuffer.observations, Ticket, Index, (T)Row);
+            rl_tools::set(ReplayBuffer.next_observations, Ticket, Index, (T)Row);
+        }
+        for (TI Index = 0; Index < ACTION_DIM; ++Index)
+        {
+            rl_tools::set(ReplayBuffer.actions, Ticket, Index, (T)Row);
+        }
+        rl_tools::set(ReplayBuffer.rewards, Ticket, 0, (T)Row);
+        rl_tools::set(ReplayBuffer.terminated, Ticket, 0, (T)0);
+        rl_tools::set(ReplayBuffer.truncated, Ticket, 0, (T)(Row % 2));
+        rl_tools::add_commit(device, ReplayBuffer, Ticket);
+    }
+
+    // Both paths draw the same rows from the same seed: the single-sample one in draw order, the whole-batch one
+    // grouped by range of the buffer for locality. The grouping is a stable counting sort, so within a range the rows
+    // keep their draw order.
+    constexpr TI BUCKET_SIZE = (ROWS - 1) / BATCH_SIZE + 1;
+    for (int32 Round = 0; Round < 10; ++Round)
+    {
+        auto SingleRng = rl_tools::random::default_engine(device.random, 100 + Round);
+        auto WholeRng = SingleRng;
+        for (TI BatchStep = 0; BatchStep < BATCH_SIZE; ++BatchStep)
+        {
+            TEST_ASSERT(rl_tools::gather_batch(device, ReplayBuffer, SingleBatch, BatchStep, SingleRng), "Single-sample gather gave up on a published buffer");
+        }
+        TEST_ASSERT(rl_tools::gather_batch(device, ReplayBuffer, WholeBatch, WholeRng), "Whole-batch gather gave up on a published buffer");
+
+        TArray<TI> Expected;
+        for (TI Bucket = 0; Bucket < BATCH_SIZE; ++Bucket)
+        {
+            for (TI BatchStep = 0; BatchStep < BATCH_SIZE; ++BatchStep)
+            {
+                const TI Row = (TI)rl_tools::get(device, SingleBatch.rewards, 0, BatchStep, 0);
+                if (Row / BUCKET_SIZE == Bucket)
+                {
+                    Expected.Add(Row);
+                }
+            }
+        }
+        TEST_ASSERT(Expected.Num() == BATCH_SIZE, "Single-sample gather returned rows outside the buffer");
+        for (TI BatchStep = 0; BatchStep < BATCH_SIZE; ++BatchStep)
+        {
+            const T Row = (T)Expected[BatchStep];
+            TEST_ASSERT(rl_tools::get(device, WholeBatch.rewards, 0, BatchStep, 0) == Row, "Whole-batch gather did not return the drawn rows in order");
+            for (TI Index = 0; Index < OBSERVATION_DIM; ++Index)
+            {
+                TEST_ASSERT(rl_tools::get(device, WholeBatch.observations, 0, BatchStep, Index) == Row
+                    && rl_tools::get(device, WholeBatch.next_observations, 0, BatchStep, Index) == Row, "Whole-batch observations come from another row");
+            }
+            for (TI Index = 0; Index < ACTION_DIM; ++Index)
+            {
+                TEST_ASSERT(rl_tools::get(device, WholeBatch.actions, 0, BatchStep, Index) == Row, "Whole-batch actions come from another row");
+            }
+            TEST_ASSERT(rl_tools::get(device, WholeBatch.truncated, 0, BatchStep, 0) == (Expected[BatchStep] % 2 == 1), "Whole-batch flags come from another row");
+        }
+    }
+
+    rl_tools::free(device, WholeBatch);
+    rl_tools::free(device, SingleBatch);
+    rl_tools::free(device, ReplayBuffer);
+    UERL_RL_LOG("Whole-batch gather test passed!");
+    return true;
+}
+
+bool URLToolsTest::TestDeduplicatedReplayBuffer()
+{
+    using T = float;
+    using TI = typename rl_tools::devices::DefaultCPU::index_t;
+    constexpr TI OBSERVATION_DIM = 2;
+    constexpr TI ACTION_DIM = 1;
+    constexpr TI CAPACITY = 8;
+    constexpr TI BATCH_SIZE = 64;
+    using ENVIRONMENT = TRLEnvironmentShape<T, TI, OBSERVATION_DIM, ACTION_DIM>;
+    using REPLAY_BUFFER_SPEC = rl_tools::rl::components::replay_buffer::Specification<T, TI, OBSERVATION_DIM, OBSERVATION_DIM, false, ACTION_DIM, CAPACITY, true, T, true>;
+    using BATCH_SPEC = rl_tools::rl::components::off_policy_runner::SequentialBatchSpecification<TRLTransitionSourceSpec<T, TI, ENVIRONMENT>, 1, BATCH_SIZE>;
+
+    rl_tools::rl::components::ReplayBuffer<REPLAY_BUFFER_SPEC> ReplayBuffer;
+    rl_tools::rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC> Batch;
+    rl_tools::malloc(device, ReplayBuffer);
+    rl_tools::malloc(device, Batch);
+    rl_tools::init(device, ReplayBuffer);
+    auto rng = rl_tools::random::default_engine(device.random, 13);
+
+    // Step t of episode e observes (100 e + t, -100 e - t) and earns 100 e + t. The first and third episodes end with
+    // truncated set; the second is cut short by a reset nobody flagged. Four episodes of three steps plus their final
+    // observations overrun the eight rows, so the last row's next observation lands in the extra row.
+    rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, 1, OBSERVATION_DIM, false>> Observation;
+    rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, 1, OBSERVATION_DIM, false>> NextObservation;
+    rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, 1, ACTION_DIM, false>> Action;
+    const int32 State = 0;
+    for (int32 Episode = 0; Episode < 4; ++Episode)
+    {
+        for (int32 Step = 0; Step < 3; ++Step)
+        {
+            const T Value = (T)(100 * Episode + Step);
+            rl_tools::set(Observation, 0, 0, Value);
+            rl_tools::set(Observation, 0, 1, -Value);
+            rl_tools::set(NextObservation, 0, 0, Value + 1);
+            rl_tools::set(NextObservation, 0, 1, -Value - 1);
+            rl_tools::set(Action, 0, 0, Value / 1000);
+            const bool bTruncated = Step == 2 && Episode != 1;
+            rl_tools::add(device, ReplayBuffer, State, Observation, Observation, Action, Value, State, NextObservation, NextObservation, false, bTruncated);
+        }
+    }
+    TEST_ASSERT(ReplayBuffer.full, "Deduplicated replay buffer did not wrap around");
+
+    TSet<int32> Sampleable;
+    for (TI Row = 0; Row < CAPACITY; ++Row)
+    {
+        if (rl_tools::rl::components::replay_buffer::sampleable(device, ReplayBuffer, Row))
+        {
+            Sampleable.Add((int32)rl_tools::get(ReplayBuffer.observations, Row, 0));
+        }
+    }
+
+    // Every gathered transition reads its next observation from the following row, which must be the step after it, and
+    // only the last step of an episode is truncated; final-observation rows and the overwritten row are never drawn
+    TSet<int32> Gathered;
+    for (int32 Round = 0; Round < 10; ++Round)
+    {
+        for (TI BatchStep = 0; BatchStep < BATCH_SIZE; ++BatchStep)
+        {
+            rl_tools::gather_batch(device, ReplayBuffer, Batch, BatchStep, rng);
+            const T Value = rl_tools::get(device, Batch.observations, 0, BatchStep, 0);
+            TEST_ASSERT(rl_tools::get(device, Batch.observations, 0, BatchStep, 1) == -Value
+                && rl_tools::get(device, Batch.actions, 0, BatchStep, 0) == Value / 1000
+                && rl_tools::get(device, Batch.rewards, 0, BatchStep, 0) == Value, "Gathered a final-observation row as a transition");
+            TEST_ASSERT(rl_tools::get(device, Batch.next_observations, 0, BatchStep, 0) == Value + 1
+                && rl_tools::get(device, Batch.next_observations, 0, BatchStep, 1) == -Value - 1, "Deduplicated next observation is not the following step");
+            TEST_ASSERT(rl_tools::get(device, Batch.truncated, 0, BatchStep, 0) == ((int32)Value % 100 == 2), "Episode ends are not the truncated transitions");
+            Gathered.Add((int32)Value);
+        }
+    }
+    TEST_ASSERT(Sampleable.Num() == 6 && Gathered.Num() == Sampleable.Num() && Gathered.Includes(Sampleable), "Gathered transitions are not the sampleable rows");
+
+    rl_tools::free(device, Batch);
+    rl_tools::free(device, ReplayBuffer);
+    UERL_RL_LOG("Deduplicated replay buffer test passed!");
+    return true;
+}
+
+bool URLToolsTest::TestHalfPrecisionStorage()
+{
+    using T = float;
+    using TI = typename rl_tools::devices::DefaultCPU::index_t;
+    using rl_tools::numeric_types::bfloat16;
+    using rl_tools::numeric_types::float16;
+
+    // Round to nearest: within half a unit in the last place, 2^-8 relative for bfloat16's 8 significant bits and 2^-11
+    // for float16's 11, across the range replay buffer values live in
+    auto rng = rl_tools::random::default_engine(device.random, 11);
+    for (int32 Sample = 0; Sample < 10000; ++Sample)
+    {
+        const T Magnitude = FMath::Pow(10.0f, rl_tools::random::uniform_real_distribution(device.random, (T)-3, (T)4, rng));
+        const T Value = (Sample % 2 == 0 ? Magnitude : -Magnitude);
+        TEST_ASSERT(FMath::Abs((T)bfloat16(Value) - Value) <= FMath::Abs(Value) * 0.00390625f, "bfloat16 round trip is off by more than half an ulp");
+        TEST_ASSERT(FMath::Abs((T)float16(Value) - Value) <= FMath::Abs(Value) * 0.00048828125f, "float16 round trip is off by more than half an ulp");
+    }
+
+    // Representable values survive exactly; ties go to the even neighbour
+    const T Exact[] = {0.0f, 1.0f, -2.0f, 0.375f, -1024.0f};
+    for (const T Value : Exact)
+    {
+        TEST_ASSERT((T)bfloat16(Value) == Value && (T)float16(Value) == Value, "Representable value changed in a round trip");
+    }
+    TEST_ASSERT((T)bfloat16(1.0f + 1.0f / 256) == 1.0f && (T)bfloat16(1.0f + 3.0f / 256) == 1.0f + 1.0f / 64, "bfloat16 does not round ties to even");
+    TEST_ASSERT((T)float16(1.0f + 1.0f / 2048) == 1.0f && (T)float16(1.0f + 3.0f / 2048) == 1.0f + 1.0f / 512, "float16 does not round ties to even");
+
+    // float16's edges: the largest finite value, overflow to infinity, the smallest subnormal, underflow to zero, NaN
+    TEST_ASSERT((T)float16(65504.0f) == 65504.0f && (T)float16(-1e5f) == -std::numeric_limits<T>::infinity(), "float16 range ends are wrong");
+    TEST_ASSERT((T)float16(5.9604644775390625e-8f) == 5.9604644775390625e-8f && (T)float16(2e-8f) == 0.0f, "float16 subnormals are wrong");
+    TEST_ASSERT(FMath::IsNaN((T)float16(std::numeric_limits<T>::quiet_NaN())) && FMath::IsNaN((T)bfloat16(std::numeric_limits<T>::quiet_NaN())), "NaN did not survive a round trip");
+
+    // A bfloat16 replay buffer hands back exactly the rounded values, through the vectorized up-conversion of
+    // gather_batch and its scalar tail alike
+    constexpr TI OBSERVATION_DIM = 19;
+    constexpr TI ACTION_DIM = 3;
+    constexpr TI CAPACITY = 4;
+    using ENVIRONMENT = TRLEnvironmentShape<T, TI, OBSERVATION_DIM, ACTION_DIM>;
+    using REPLAY_BUFFER_SPEC = rl_tools::rl::components::replay_buffer::Specification<T, TI, OBSERVATION_DIM, OBSERVATION_DIM, false, ACTION_DIM, CAPACITY, true, bfloat16>;
+    using BATCH_SPEC = rl_tools::rl::components::off_policy_runner::SequentialBatchSpecification<TRLTransitionSourceSpec<T, TI, ENVIRONMENT>, 1, 1>;
+    rl_tools::rl::components::ConcurrentReplayBuffer<REPLAY_BUFFER_SPEC> ReplayBuffer;
+    rl_tools::rl::components::off_policy_runner::SequentialBatch<BATCH_SPEC> Batch;
+    rl_tools::malloc(device, ReplayBuffer);
+    rl_tools::malloc(device, Batch);
+    rl_tools::init(device, ReplayBuffer);
+
+    T Observation[OBSERVATION_DIM];
+    T Action[ACTION_DIM];
+    T NextObservation[OBSERVATION_DIM];
+    for (TI Index = 0; Index < OBSERVATION_DIM; ++Index)
+    {
+        Observation[Index] = rl_tools::random::normal_distribution::sample(device.random, (T)0, (T)10, rng);
+        NextObservation[Index] = rl_tools::random::normal_distribution::sample(device.random, (T)0, (T)10, rng);
+    }
+    for (TI Index = 0; Index < ACTION_DIM; ++Index)
+    {
+        Action[Index] = rl_tools::random::uniform_real_distribution(device.random, (T)-1, (T)1, rng);
+    }
+    for (TI Row = 0; Row < CAPACITY; ++Row)
+    {
+        const TI Ticket = rl_tools::add_begin(device, ReplayBuffer);
+        for (TI Index = 0; Index < OBSERVATION_DIM; ++Index)
+        {
+            rl_tools::set(ReplayBuffer.observations, Ticket, Index, bfloat16(Observation[Index]));
+            rl_tools::set(ReplayBuffer.next_observations, Ticket, Index, bfloat16(NextObservation[Index]));
+        }
+        for (TI Index = 0; Index < ACTION_DIM; ++Index)
+        {
+            rl_tools::set(ReplayBuffer.actions, Ticket, Index, bfloat16(Action[Index]));
+        }
+        // Reward and flags stay in single precision next to the half precision rows
+        rl_tools::set(ReplayBuffer.rewards, Ticket, 0, 0.1f);
+        rl_tools::set(ReplayBuffer.terminated, Ticket, 0, (T)0);
+        rl_tools::set(ReplayBuffer.truncated, Ticket, 0, (T)0);
+        rl_tools::add_commit(device, ReplayBuffer, Ticket);
+    }
+
+    TEST_ASSERT(rl_tools::gather_batch(device, ReplayBuffer, Batch, rng), "bfloat16 replay buffer gather gave up");
+    for (TI Index = 0; Index < OBSERVATION_DIM; ++Index)
+    {
+        TEST_ASSERT(rl_tools::get(device, Batch.observations, 0, 0, Index) == (T)bfloat16(Observation[Index])
+            && rl_tools::get(device, Batch.next_observations, 0, 0, Index) == (T)bfloat16(NextObservation[Index]), "Gathered observation is not the stored bfloat16 value");
+    }
+    for (TI Index = 0; Index < ACTION_DIM; ++Index)
+    {
+        TEST_ASSERT(rl_tools::get(device, Batch.actions, 0, 0, Index) == (T)bfloat16(Action[Index]), "Gathered action is not the stored bfloat16 value");
+    }
+    TEST_ASSERT(rl_tools::get(device, Batch.rewards, 0, 0, 0) == 0.1f, "Single precision reward was rounded");
+
+    rl_tools::free(device, Batch);
+    rl_tools::free(device, ReplayBuffer);
+    UERL_RL_LOG("Half precision storage test passed!");
+    return true;
+}
+
+bool URLToolsTest::TestSumTree()
+{
+    using T = float;
+    using TI = typename rl_tools::devices::DefaultCPU::index_t;
+    // Not a multiple of the fanout and deep enough for three levels, so padding and the inner levels are exercised
+    constexpr TI CAPACITY = 300;
+    constexpr int32 SAMPLES = 200000;
+    using TREE = rl_tools::rl::components::SumTree<rl_tools::rl::components::replay_buffer::SumTreeSpecification<T, TI, CAPACITY>>;
+    static_assert(TREE::LEVELS == 3);
+
+    TREE Tree;
+    rl_tools::malloc(device, Tree);
+    rl_tools::init(device, Tree);
+    auto rng = rl_tools::random::default_engine(device.random, 5);
+
+    // Every fifth leaf and the last block stay at zero; the rest cycle through 1-4, written twice so that updates have
+    // to replace the old sums rather than add to them
+    TArray<double> Priorities;
+    Priorities.SetNumZeroed(CAPACITY);
+    for (int32 Pass = 0; Pass < 2; ++Pass)
+    {
+        for (TI Leaf = 0; Leaf < CAPACITY; ++Leaf)
+        {
+            const T Priority = Leaf % 5 == 0 || Leaf >= CAPACITY - 16 ? (T)0 : (T)((Leaf + Pass) % 4 + 1);
+            rl_tools::set_priority(device, Tree, Leaf, Priority);
+            Priorities[Leaf] = Priority;
+        }
+    }
+    double Total = 0;
+    for (const double Priority : Priorities)
+    {
+        Total += Priority;
+    }
+    const T Root = rl_tools::total(device, Tree);
+    TEST_ASSERT(FMath::Abs(Root - Total) <= 1e-5 * Total, "Sum tree root is not the total of its priorities");
+
+    // Proportional sampling: every leaf is drawn about Priority / Total of the time, and a zero-priority leaf never is,
+    // not even for values at the very end of the range
+    TArray<int32> Counts;
+    Counts.SetNumZeroed(CAPACITY);
+    for (int32 Sample = 0; Sample < SAMPLES; ++Sample)
+    {
+        const T Value = rl_tools::random::uniform_real_distribution(device.random, (T)0, Root, rng);
+        Counts[rl_tools::sample(device, Tree, Value)]++;
+    }
+    Counts[rl_tools::sample(device, Tree, Root)]++;
+    Counts[rl_tools::sample(device, Tree, Root * (T)(1 - 1e-7))]++;
+    for (TI Leaf = 0; Leaf < CAPACITY; ++Leaf)
+    {
+        if (Priorities[Leaf] == 0)
+        {
+            TEST_ASSERT(Counts[Leaf] == 0, "Sum tree sampled a leaf of zero priority");
+            continue;
+        }
+        const double Expected = Priorities[Leaf] / Total;
+        const double Frequency = (double)Counts[Leaf] / SAMPLES;
+        // Six standard deviations of the binomial frequency
+        TEST_ASSERT(FMath::Abs(Frequency - Expected) < 6 * FMath::Sqrt(Expected * (1 - Expected) / SAMPLES), "Sum tree sampling frequency does not follow the priorities");
+    }
+
+    rl_tools::update_priority(device, Tree, 1, (T)-3, (T)1, (T)1);
+    TEST_ASSERT(rl_tools::get_priority(device, Tree, 1) == (T)4 && Tree.max_priority == (T)4, "TD error priority is not (|error| + epsilon)^alpha");
+
+    rl_tools::free(device, Tree);
+    UERL_RL_LOG("Sum tree test passed!");
+    return true;
+}
+
+bool URLToolsTest::TestReplayBufferFile()
+{
+    using T = float;
+    constexpr int32 OBSERVATION_DIM = 3;
+    constexpr int32 ACTION_DIM = 1;
+
+    TUniquePtr<IRLAgentBackend> Backend(FRLAgentBackendRegistry::Get().Create(ERLAlgorithm::TD3, OBSERVATION_DIM, ACTION_DIM, 64, 1));
+    TEST_ASSERT(Backend.IsValid(), "No TD3 backend registered for (3, 1, 64)");
+    const int32 Transitions = Backend->GetTrainingBatchSize() + 10;
+    const SIZE_T InMemorySize = Backend->GetArenaSize();
+    const FString FilePath = FPaths::CreateTempFilename(*FPaths::ProjectSavedDir(), TEXT("RLToolsTest"), TEXT(".urlr"));
+
+    // The file replaces the in-memory rows (at least two bytes per element) instead of adding to them
+    bool bOpened = Backend->OpenReplayBufferFile(FilePath);
+    const SIZE_T FileBackedSize = Backend->GetArenaSize();
+    T Observation[OBSERVATION_DIM] = {0.1f, 0.2f, 0.3f};
+    T Action[ACTION_DIM] = {0.5f};
+    for (int32 Step = 0; bOpened && Step < Transitions; ++Step)
+    {
+        Backend->AddTransition(Observation, Action, (T)Step, Observation, false, false);
+    }
+    const int32 WrittenSize = Backend->GetReplayBufferSize();
+    Backend->CloseReplayBufferFile();
+    const SIZE_T ClosedSize = Backend->GetArenaSize();
+    const int32 ClosedReplayBufferSize = Backend->GetReplayBufferSize();
+
+    // A backend reopening the file resumes from the transitions written to it
+    const bool bReopened = bOpened && Backend->OpenReplayBufferFile(FilePath);
+    const int32 ReopenedSize = Backend->GetReplayBufferSize();
+    const bool bTrained = bReopened && Backend->Train(1, FRLNormalizationPlan());
+    Backend->CloseReplayBufferFile();
+    IFileManager::Get().Delete(*FilePath);
+
+    TEST_ASSERT(bOpened, "Replay buffer file did not open");
+    TEST_ASSERT(FileBackedSize + (SIZE_T)Backend->GetReplayBufferCapacity() * (2 * OBSERVATION_DIM + ACTION_DIM) * 2 <= InMemorySize, "File-backed replay buffer kept its in-memory rows");
+    TEST_ASSERT(WrittenSize == Transitions, "File-backed replay buffer did not store every transition");
+    TEST_ASSERT(ClosedSize == InMemorySize && ClosedReplayBufferSize == 0, "Closing the file did not return to an empty in-memory replay buffer");
+    TEST_ASSERT(bReopened && ReopenedSize == Transitions, "Reopened replay buffer file lost transitions");
+    TEST_ASSERT(bTrained, "Training refused on a reopened replay buffer file");
+
+    UERL_RL_LOG("Replay buffer file test passed! (%llu bytes in memory, %llu with the file)", (uint64)InMemorySize, (uint64)FileBackedSize);
+    return true;
+}
+
+bool URLToolsTest::TestTD3Backend()
+{
+    using namespace RLToolsBandit;
+
+    try
+    {
+        TUniquePtr<IRLAgentBackend> Backend = CreateBackend(ERLAlgorithm::TD3);
+        TEST_ASSERT(Backend.IsValid(), "No TD3 backend registered for (3, 1, 64)");
+        TEST_ASSERT(Backend->GetAlgorithm() == ERLAlgorithm::TD3, "TD3 backend reports another algorithm");
+        // A dim past 16 bits must not alias the registered shape whose low bits it shares
+        TEST_ASSERT(!FRLAgentBackendRegistry::Get().IsSupported(ERLAlgorithm::TD3, OBSERVATION_DIM + 0x10000, ACTION_DIM, 64), "Registry matched an observation dim above its key range");
+        const int64 ArenaAllocations = Backend->GetArenaAllocations();
+        // The concurrent critic path shares its targets with the sequential one, so it must learn the bandit just as well
+        Backend->SetParallelCriticTraining(true);
+
+        auto rng = rl_tools::random::default_engine(device.random, 7);
+        if (!TrainOffPolicy(*Backend, device, rng))
+        {
+            return false;
+        }
+        // Every container comes out of the arena the constructor sized, so training must not have allocated another.
+        // This counts rl_tools containers only (a container that no longer fits the arena is counted as it falls back
+        // to the heap); other heap use, such as the task graph's for the parallel critics, is not tracked.
+        TEST_ASSERT(Backend->GetArenaAllocations() == ArenaAllocations, "TD3 training allocated rl_tools containers");
+        UERL_RL_LOG("TD3 backend test - Arena of %llu bytes", (uint64)Backend->GetArenaSize());
+
+        const T MeanSquaredError = EvaluateActor(*Backend, device, rng);
+        UERL_RL_LOG("TD3 backend test - Mean squared action error after training: %f", MeanSquaredError);
+        TEST_ASSERT(MeanSquaredError < (T)0.01, "TD3 actor did not learn the bandit target");
+
+        UERL_RL_LOG("TD3 backend test passed!");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_RL_ERROR("TD3 backend test failed: %s", e.what());
+        return false;
+    }
+}
+
+bool URLToolsTest::TestSACBackend()
+{
+    using namespace RLToolsBandit;
+
+    try
+    {
+        TUniquePtr<IRLAgentBackend> Backend = CreateBackend(ERLAlgorithm::SAC);
+        TEST_ASSERT(Backend.IsValid(), "No SAC backend registered for (3, 1, 64)");
+        TEST_ASSERT(Backend->GetAlgorithm() == ERLAlgorithm::SAC, "SAC backend reports another algorithm");
+        Backend->SetParallelCriticTraining(true);
+
+        // Observations far from zero mean and unit variance, which the batches must be normalized out of before every update
+        FRLNormalizationParams ObservationParams;
+        ObservationParams.bIsEnabled = true;
+        ObservationParams.Mean = {2.0f, -1.0f, 0.5f};
+        ObservationParams.StdDev = {4.0f, 0.5f, 2.0f};
+
+        auto rng = rl_tools::random::default_engine(device.random, 7);
+        if (!TrainOffPolicy(*Backend, device, rng, ObservationParams))
+        {
+            return false;
+        }
+
+        // The entropy bonus keeps the policy stochastic, but its mean has to land on the target
+        const T MeanSquaredError = EvaluateActor(*Backend, device, rng);
+        UERL_RL_LOG("SAC backend test - Mean squared action error after training: %f", MeanSquaredError);
+        TEST_ASSERT(MeanSquaredError < (T)0.01, "SAC actor did not learn the bandit target");
+
+        // Training actions are squashed samples around the deterministic one, spread by the learned std: a few tenths
+        // after this short run, with the temperature still heading towards an entropy of -1
+        constexpr int32 NUM_SAMPLES = 512;
+        T Observations[NUM_SAMPLES * OBSERVATION_DIM];
+        T Actions[NUM_SAMPLES * ACTION_DIM];
+        T MeanAction[ACTION_DIM];
+        SampleObservations(device, rng, Observations, 1);
+        for (int32 Row = 1; Row < NUM_SAMPLES; ++Row)
+        {
+            FMemory::Memcpy(Observations + Row * OBSERVATION_DIM, Observations, OBSERVATION_DIM * sizeof(T));
+        }
+        Backend->Evaluate(Observations, MeanAction);
+        Backend->SampleTrainingActions(Observations, NUM_SAMPLES, Actions, false);
+        T SampleMean = 0;
+        T SampleSquares = 0;
+        for (int32 Row = 0; Row < NUM_SAMPLES; ++Row)
+        {
+            SampleMean += Actions[Row * ACTION_DIM];
+            SampleSquares += Actions[Row * ACTION_DIM] * Actions[Row * ACTION_DIM];
+        }
+        SampleMean /= NUM_SAMPLES;
+        const T SampleStd = FMath::Sqrt(FMath::Max(SampleSquares / NUM_SAMPLES - SampleMean * SampleMean, (T)0));
+        UERL_RL_LOG("SAC backend test - Training actions %f +- %f around the deterministic %f", SampleMean, SampleStd, MeanAction[0]);
+        TEST_ASSERT(SampleStd > (T)0.02 && SampleStd < (T)0.5, "SAC training actions are not spread like the tuned entropy target");
+        TEST_ASSERT(FMath::Abs(SampleMean - MeanAction[0]) < (T)0.05, "SAC training actions are not centered on the deterministic action");
+
+        UERL_RL_LOG("SAC backend test passed!");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_RL_ERROR("SAC backend test failed: %s", e.what());
+        return false;
+    }
+}
+
+bool URLToolsTest::TestPPOBackend()
+{
+    using namespace RLToolsBandit;
+
+    try
+    {
+        // Generalized advantages of a rollout interleaving two lanes (row r is a step of lane r % 2), against values
+        // worked out by hand with gamma = 0.9 and lambda = 0.5:
+        //   row 4 (lane 0): td = -1 + 0.9 * 2 (bootstrap) - 0 = 0.8                      -> advantage 0.8
+        //   row 2 (lane 0): terminated, td = 2 - 0.5 = 1.5, the episode's tail is dropped -> advantage 1.5
+        //   row 0 (lane 0): td = 1 + 0.9 * 0.5 - 1 = 0.45                                 -> advantage 0.45 + 0.45 * 1.5 = 1.125
+        //   row 5 (lane 1): td = 3 + 0.9 * 4 (bootstrap) - 1 = 5.6                        -> advantage 5.6
+        //   row 3 (lane 1): truncated, the value after the time limit is unknown          -> advantage 0
+        //   row 1 (lane 1): td = 0 + 0.9 * 1.5 - 2 = -0.65                                -> advantage -0.65
+        {
+            constexpr TI NUM_ROWS = 6;
+            constexpr TI NUM_LANES = 2;
+            using ENVIRONMENT = TRLEnvironmentShape<T, TI, OBSERVATION_DIM, ACTION_DIM>;
+            using ROLLOUT_SPEC = rl_tools::rl::components::on_policy_runner::Specification<T, TI, ENVIRONMENT, 1>;
+            using PPO_PARAMETERS = rl_tools::rl::algorithms::ppo::DefaultParameters<T, TI, NUM_ROWS>;
+            rl_tools::rl::components::on_policy_runner::Dataset<rl_tools::rl::components::on_policy_runner::DatasetSpecification<ROLLOUT_SPEC, NUM_ROWS>> Rollout;
+            rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, 1, NUM_LANES>> LaneValues;
+            rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, 1, NUM_LANES>> LaneAdvantages;
+            rl_tools::malloc(device, Rollout);
+            rl_tools::malloc(device, LaneValues);
+            rl_tools::malloc(device, LaneAdvantages);
+
+            const T Values[NUM_ROWS] = {1.0f, 2.0f, 0.5f, 1.5f, 0.0f, 1.0f};
+            const T Rewards[NUM_ROWS] = {1.0f, 0.0f, 2.0f, 1.0f, -1.0f, 3.0f};
+            const T ExpectedAdvantages[NUM_ROWS] = {1.125f, -0.65f, 1.5f, 0.0f, 0.8f, 5.6f};
+            for (TI Row = 0; Row < NUM_ROWS; ++Row)
+            {
+                rl_tools::set(Rollout.values, Row, 0, Values[Row]);
+                rl_tools::set(Rollout.rewards, Row, 0, Rewards[Row]);
+                // A terminal step ends its episode with both flags set, a time limit with truncated only
+                rl_tools::set(Rollout.terminated, Row, 0, Row == 2 ? 1 : 0);
+                rl_tools::set(Rollout.truncated, Row, 0, Row == 2 || Row == 3 ? 1 : 0);
+            }
+            rl_tools::set(LaneValues, 0, 0, 2.0f);
+            rl_tools::set(LaneValues, 0, 1, 4.0f);
+
+            rl_tools::estimate_generalized_advantages(device, Rollout, LaneValues, LaneAdvantages, NUM_ROWS, NUM_LANES, (T)0.9, (T)0.5, PPO_PARAMETERS{});
+
+            bool bMatches = true;
+            for (TI Row = 0; Row < NUM_ROWS; ++Row)
+            {
+                bMatches &= FMath::Abs(rl_tools::get(Rollout.advantages, Row, 0) - ExpectedAdvantages[Row]) < 1e-5f;
+                bMatches &= FMath::Abs(rl_tools::get(Rollout.target_values, Row, 0) - (ExpectedAdvantages[Row] + Values[Row])) < 1e-5f;
+            }
+            rl_tools::free(device, Rollout);
+            rl_tools::free(device, LaneValues);
+            rl_tools::free(device, LaneAdvantages);
+            TEST_ASSERT(bMatches, "Interleaved generalized advantages differ from the hand-computed ones");
+        }
+
+        // The bandit, collected from several lanes at once so a rollout fills in a reasonable number of steps
+        constexpr int32 NUM_LANES = 16;
+        constexpr int32 TRAINING_STEPS = 3000;
+
+        TUniquePtr<IRLAgentBackend> Backend = CreateBackend(ERLAlgorithm::PPO);
+        TEST_ASSERT(Backend.IsValid(), "No PPO backend registered for (3, 1, 64)");
+        TEST_ASSERT(Backend->GetAlgorithm() == ERLAlgorithm::PPO, "PPO backend reports another algorithm");
+        Backend->SetPPOParameters(10, 0.95f);
+
+        const FRLNormalizationPlan IdentityPlan;
+        auto rng = rl_tools::random::default_engine(device.random, 7);
+        T Observations[NUM_LANES * OBSERVATION_DIM];
+        T NextObservations[NUM_LANES * OBSERVATION_DIM];
+        T Actions[NUM_LANES * ACTION_DIM];
+        int32 Updates = 0;
+
+        for (int32 Step = 0; Step < TRAINING_STEPS; ++Step)
+        {
+            SampleObservations(device, rng, Observations, NUM_LANES);
+            SampleObservations(device, rng, NextObservations, NUM_LANES);
+            Backend->SampleTrainingActions(Observations, NUM_LANES, Actions, false);
+            for (int32 Lane = 0; Lane < NUM_LANES; ++Lane)
+            {
+                const T Error = Actions[Lane * ACTION_DIM] - Target(Observations + Lane * OBSERVATION_DIM);
+                Backend->AddTransition(Observations + Lane * OBSERVATION_DIM, Actions + Lane * ACTION_DIM, -Error * Error,
+                    NextObservations + Lane * OBSERVATION_DIM, true, false);
+            }
+            // Refused until the rollout is full
+            Updates += Backend->Train(1, IdentityPlan) ? 1 : 0;
+        }
+        TEST_ASSERT(Updates > 0, "PPO never trained on a full rollout");
+
+        const T MeanSquaredError = EvaluateActor(*Backend, device, rng);
+        UERL_RL_LOG("PPO backend test - Mean squared action error after %d updates: %f", Updates, MeanSquaredError);
+        TEST_ASSERT(MeanSquaredError < (T)0.01, "PPO actor did not learn the bandit target");
+
+        UERL_RL_LOG("PPO backend test passed!");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_RL_ERROR("PPO backend test failed: %s", e.what());
+        return false;
+    }
+}
+
+bool URLToolsTest::TestSimpleTargetEnvironment()
+{
+    using T = float;
+    using TI = typename rl_tools::devices::DefaultCPU::index_t;
+    using ENVIRONMENT = rl_tools::rl::environments::SimpleTarget<rl_tools::rl::environments::simple_target::Specification<T, TI>>;
+
+    try
+    {
+        // Head straight for the target through the rl_tools environment API: every episode has to end at the target
+        // well within the step limit, and the kernels URLSimpleTargetEnvironment uses have to agree with the API
+        constexpr int32 EPISODES = 20;
+
+        ENVIRONMENT env;
+        ENVIRONMENT::Parameters parameters;
+        ENVIRONMENT::State state, next_state;
+        rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, 1, ENVIRONMENT::ACTION_DIM>> action;
+        rl_tools::Matrix<rl_tools::matrix::Specification<T, TI, 1, ENVIRONMENT::Observation::DIM>> observation;
+        rl_tools::malloc(device, env);
+        rl_tools::malloc(device, action);
+        rl_tools::malloc(device, observation);
+        rl_tools::init(device, env);
+        rl_tools::initial_parameters(device, env, parameters);
+        auto rng = rl_tools::random::default_engine(device.random, 3);
+
+        int32 TotalSteps = 0;
+        for (int32 Episode = 0; Episode < EPISODES; ++Episode)
+        {
+            rl_tools::sample_initial_state(device, env, parameters, state, rng);
+            bool bTerminated = false;
+            T Return = 0;
+            TI Step = 0;
+            for (; Step < ENVIRONMENT::EPISODE_STEP_LIMIT && !bTerminated; ++Step)
+            {
+                // Overshooting the unit circle on purpose, the environment clamps it
+                const T DeltaX = state.TargetX - state.AgentX;
+                const T DeltaY = state.TargetY - state.AgentY;
+                const T Scale = (T)2 / FMath::Max(FMath::Sqrt(DeltaX * DeltaX + DeltaY * DeltaY), (T)1e-3);
+                rl_tools::set(action, 0, 0, DeltaX * Scale);
+                rl_tools::set(action, 0, 1, DeltaY * Scale);
+
+                rl_tools::step(device, env, parameters, state, action, next_state, rng);
+                Return += rl_tools::reward(device, env, parameters, state, action, next_state, rng);
+                bTerminated = rl_tools::terminated(device, env, parameters, next_state, rng);
+
+                const T Speed = FMath::Sqrt(next_state.VelocityX * next_state.VelocityX + next_state.VelocityY * next_state.VelocityY);
+                TEST_ASSERT(Speed <= parameters.MaxSpeed * (T)1.001, "Simple target agent moved faster than MaxSpeed");
+                state = next_state;
+            }
+            TotalSteps += Step;
+
+            TEST_ASSERT(bTerminated, "Simple target agent heading for the target never reached it");
+            TEST_ASSERT(Return > (T)100 * parameters.RewardScale, "Simple target episode return misses the reaching bonus");
+
+            rl_tools::observe(device, env, parameters, state, ENVIRONMENT::Observation{}, observation, rng);
+            TEST_ASSERT(std::abs(rl_tools::get(observation, 0, 6) - FRLSimpleTargetSimulation::Distance(state)) < 1e-4f, "Simple target observation does not carry the distance");
+        }
+
+        // Throughput of the bare kernels, the ceiling for rolling the task out without the component
+        constexpr int32 KERNEL_STEPS = 1000000;
+        const float Movement[FRLSimpleTargetSimulation::ActionDim] = {0.6f, -0.8f};
+        T KernelReturn = 0;
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 Step = 0; Step < KERNEL_STEPS; ++Step)
+        {
+            FRLSimpleTargetSimulation::Step(parameters, state, Movement, next_state);
+            KernelReturn += FRLSimpleTargetSimulation::Reward(parameters, state, next_state);
+            state = next_state;
+        }
+        const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+        rl_tools::free(device, observation);
+        rl_tools::free(device, action);
+        rl_tools::free(device, env);
+
+        UERL_RL_LOG("Simple target environment test - %d episodes in %d steps, kernels at %.1f M steps/s (return %f)",
+            EPISODES, TotalSteps, KERNEL_STEPS / FMath::Max(ElapsedSeconds, 1e-9) * 1e-6, KernelReturn);
+        UERL_RL_LOG("Simple target environment test passed!");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_RL_ERROR("Simple target environment test failed: %s", e.what());
+        return false;
+    }
+}
+
+bool URLToolsTest::BenchmarkOffPolicyRunnerThreading()
+{
+    try
+    {
+        UERL_RL_LOG("Benchmarking OffPolicyRunner prologue/epilogue with %d threads", int32(RLToolsBenchmark::NUM_THREADS));
+        RLToolsBenchmark::LogRunnerStep<1>();
+        RLToolsBenchmark::LogRunnerStep<2>();
+        RLToolsBenchmark::LogRunnerStep<4>();
+        RLToolsBenchmark::LogRunnerStep<8>();
+        RLToolsBenchmark::LogRunnerStep<16>();
+        RLToolsBenchmark::LogRunnerStep<32>();
+        RLToolsBenchmark::LogRunnerStep<64>();
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        UERL_RL_ERROR("OffPolicyRunner benchmark failed: %s", e.what());
+        return false;
+    }
+}
@@ -0,0 +1,135 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#include "RLVectorizedEnvironment.h"
+#include "RLEnvironmentComponent.h"
+
+// Module-wide log categories
+#include "UERLLog.h"
+
+FRLVectorizedEnvironment::FRLVectorizedEnvironment()
+	: ObservationDim(0)
+	, ActionDim(0)
+{
+}
+
+bool FRLVectorizedEnvironment::Bind(const TArray<URLEnvironmentComponent*>& InEnvironments)
+{
+	Unbind();
+
+	if (InEnvironments.Num() == 0 || !InEnvironments[0])
+	{
+		UERL_ERROR( TEXT("FRLVectorizedEnvironment::Bind - No environment components given"));
+		return false;
+	}
+
+	const int32 InObservationDim = InEnvironments[0]->GetObservationDim();
+	const int32 InActionDim = InEnvironments[0]->GetActionDim();
+	for (int32 Index = 0; Index < InEnvironments.Num(); ++Index)
+	{
+		const URLEnvironmentComponent* Environment = InEnvironments[Index];
+		if (!Environment)
+		{
+			UERL_ERROR( TEXT("FRLVectorizedEnvironment::Bind - Environment %d is null"), Index);
+			return false;
+		}
+		if (Environment->GetObservationDim() != InObservationDim || Environment->GetActionDim() != InActionDim)
+		{
+			UERL_ERROR( TEXT("FRLVectorizedEnvironment::Bind - Environment %d has shape (Obs: %d, Act: %d), expected (Obs: %d, Act: %d)"),
+				Index, Environment->GetObservationDim(), Environment->GetActionDim(), InObservationDim, InActionDim);
+			return false;
+		}
+	}
+
+	Environments = InEnvironments;
+	ObservationDim = InObservationDim;
+	ActionDim = InActionDim;
+
+	const int32 NumEnvironments = Environments.Num();
+	Observations.SetNumZeroed(NumEnvironments * ObservationDim);
+	NextObservations.SetNumZeroed(NumEnvironments * ObservationDim);
+	Rewards.SetNumZeroed(NumEnvironments);
+	Terminated.SetNumZeroed(NumEnvironments);
+	Truncated.SetNumZeroed(NumEnvironments);
+	return true;
+}
+
+void FRLVectorizedEnvironment::Unbind()
+{
+	Environments.Reset();
+	ObservationDim = 0;
+	ActionDim = 0;
+	Observations.Reset();
+	NextObservations.Reset();
+	Rewards.Reset();
+	Terminated.Reset();
+	Truncated.Reset();
+}
+
+bool FRLVectorizedEnvironment::ResetSlot(int32 Index, float* OutObservation)
+{
+	return Environments[Index]->ResetInto(MakeArrayView(OutObservation, ObservationDim));
+}
+
+bool FRLVectorizedEnvironment::Reset()
+{
+	for (int32 Index = 0; Index < Environments.Num(); ++Index)
+	{
+		if (!ResetSlot(Index, Observations.GetData() + Index * ObservationDim))
+		{
+			return false;
+		}
+		Rewards[Index] = 0.0f;
+		Terminated[Index] = 0;
+		Truncated[Index] = 0;
+	}
+	return Environments.Num() > 0;
+}
+
+bool FRLVectorizedEnvironment::Step(TArrayView<const float> Actions)
+{
+	const int32 NumEnvironments = Environments.Num();
+	if (Actions.Num() != NumEnvironments * ActionDim)
+	{
+		UERL_ERROR( TEXT("FRLVectorizedEnvironment::Step - Expected %d action values (%d environments x %d), got %d"),
+			NumEnvironments * ActionDim, NumEnvironments, ActionDim, Actions.Num());
+		return false;
+	}
+
+	for (int32 Index = 0; Index < NumEnvironments; ++Index)
+	{
+		URLEnvironmentComponent* Environment = Environments[Index];
+
+		// Scatter and gather in place: the slot reads its action row and writes its observation row directly
+		if (!Environment->StepInto(
+			MakeArrayView(Actions.GetData() + Index * ActionDim, ActionDim),
+			MakeArrayView(NextObservations.GetData() + Index * ObservationDim, ObservationDim)))
+		{
+			UERL_ERROR( TEXT("FRLVectorizedEnvironment::Step - Environment %d failed to step"), Index);
+			return false;
+		}
+		Rewards[Index] = Environment->GetLastReward();
+		Terminated[Index] = Environment->bIsTerminated ? 1 : 0;
+		Truncated[Index] = Environment->bIsTruncated ? 1 : 0;
+	}
+	return true;
+}
+
+bool FRLVectorizedEnvironment::AdvanceEpisodes()
+{
+	// The next observations become the current ones without copying; only finished slots are overwritten
+	Swap(Observations, NextObservations);
+
+	for (int32 Index = 0; Index < Environments.Num(); ++Index)
+	{
+		if (IsEpisodeFinished(Index))
+		{
+			if (!ResetSlot(Index, Observations.GetData() + Index * ObservationDim))
+			{
+				return false;
+			}
+			Terminated[Index] = 0;
+			Truncated[Index] = 0;
+		}
+	}
+	return true;
+}
@@ -25,6 +25,7 @@ UERLTOOLS_API DECLARE_LOG_CATEGORY_EXTERN(LogUERLToolsURL, Log, All);
 #define UERL_LOG(Format, ...) UE_UERL_LOG(Log, Format, ##__VA_ARGS__)
 #define UERL_WARNING(Format, ...) UE_UERL_LOG(Warning, Format, ##__VA_ARGS__)
 #define UERL_ERROR(Format, ...) UE_UERL_LOG(Error, Format, ##__VA_ARGS__)
+#define UERL_VERBOSE(Format, ...) UE_UERL_LOG(Verbose, Format, ##__VA_ARGS__)
 
 // RL-specific logs
 #define UERL_RL_LOG(Format, ...) UE_UERL_RL_LOG(Log, Format, ##__VA_ARGS__)
@@ -2,6 +2,7 @@
 #include "RLEnvironmentComponent.h"
 #include "RLAgentManager.h"
 #include "RLTypes.h"
+#include "RLAgentBackend.h"
 #include "Logging/LogMacros.h"
 
 // Fallback log category
@@ -15,15 +16,7 @@ void URLAgentManagerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
     Super::Initialize(Collection);
     UE_LOG(LOG_UERLTOOLS, Log, TEXT("URLAgentManagerSubsystem Initializing..."));
-
-    // Initialize rl_tools global device context
-    rlt_context = (rl_tools::devices::DefaultCPU::CONTEXT_TYPE*)rl_tools::malloc(rlt_device, sizeof(rl_tools::devices::DefaultCPU::CONTEXT_TYPE));
-    if (!rlt_context) {
-        UE_LOG(LOG_UERLTOOLS, Fatal, TEXT("Failed to allocate rl_tools context!"));
-        return; // Early exit if context allocation fails
-    }
-    rl_tools::init(rlt_device, rlt_context);
-    UE_LOG(LOG_UERLTOOLS, Log, TEXT("URLAgentManagerSubsystem Initialized with rl_tools context."));
+    UE_LOG(LOG_UERLTOOLS, Log, TEXT("URLAgentManagerSubsystem Initialized."));
 }
 
 void URLAgentManagerSubsystem::Deinitialize()
@@ -43,15 +36,41 @@ void URLAgentManagerSubsystem::Deinitialize()
     }
     ActiveAgents.Empty();
 
-    // Deallocate rl_tools global device context
-    if (rlt_context)
+    Super::Deinitialize();
+}
+
+namespace
+{
+    // TODO: Drop once URLAgentManager takes FRLTrainingConfig directly (tech debt #2)
+    FLocalRLTrainingConfig ToLocalTrainingConfig(const FRLTrainingConfig& TrainingConfig)
     {
-        rl_tools::free(rlt_device, rlt_context);
-        rlt_context = nullptr;
-        UE_LOG(LOG_UERLTOOLS, Log, TEXT("rl_tools context freed."));
+        FLocalRLTrainingConfig LocalConfig;
+        LocalConfig.MaxTrainingSteps = TrainingConfig.TotalTimesteps;
+        LocalConfig.Algorithm = TrainingConfig.Algorithm;
+        LocalConfig.ActorLearningRate = TrainingConfig.LearningRate;
+        LocalConfig.CriticLearningRate = TrainingConfig.LearningRate;
+        LocalConfig.Gamma = TrainingConfig.DiscountFactor;
+        LocalConfig.BatchSize = TrainingConfig.BatchSize;
+        LocalConfig.ReplayBufferCapacity = TrainingConfig.ReplayBufferCapacity;
+        LocalConfig.UpdateToDataRatio = TrainingConfig.UpdateToDataRatio;
+        LocalConfig.bParallelCriticTraining = TrainingConfig.bParallelCriticTraining;
+        LocalConfig.bPrioritizedReplay = TrainingConfig.bPrioritizedReplay;
+        LocalConfig.PrioritizedReplayAlpha = TrainingConfig.PrioritizedReplayAlpha;
+        LocalConfig.PrioritizedReplayBeta = TrainingConfig.PrioritizedReplayBeta;
+        LocalConfig.PrioritizedReplayBetaAnnealingUpdates = TrainingConfig.PrioritizedReplayBetaAnnealingUpdates;
+        LocalConfig.ReplayBufferFilePath = TrainingConfig.ReplayBufferFilePath;
+        LocalConfig.PPOEpochs = TrainingConfig.PPOEpochs;
+        LocalConfig.GAELambda = TrainingConfig.GAELambda;
+        LocalConfig.HiddenDim = TrainingConfig.HiddenDim;
+        LocalConfig.ObservationNormalizationParams = TrainingConfig.ObservationNormalizationParams;
+        LocalConfig.ActionNormalizationParams = TrainingConfig.ActionNormalizationParams;
+        LocalConfig.bUseRunningObservationNormalization = TrainingConfig.bUseRunningObservationNormalization;
+        LocalConfig.EpisodeStatisticsWindow = TrainingConfig.EpisodeStatisticsWindow;
+        LocalConfig.bHeadlessTraining = TrainingConfig.bHeadlessTraining;
+        LocalConfig.HeadlessFrameBudgetMs = TrainingConfig.HeadlessFrameBudgetMs;
+        LocalConfig.HeadlessMaxStepsPerFrame = TrainingConfig.HeadlessMaxStepsPerFrame;
+        return LocalConfig;
     }
-
-    Super::Deinitialize();
 }
 
 bool URLAgentManagerSubsystem::CreateAgent(FName AgentName, URLEnvironmentComponent* EnvironmentComponent, const FRLTrainingConfig& TrainingConfig)
@@ -72,6 +91,18 @@ bool URLAgentManagerSubsystem::CreateAgent(FName AgentName, URLEnvironmentCompon
         return false;
     }
 
+    // Network dimensions are runtime data from the environment; make sure a pre-instantiated backend exists for them
+    const int32 ObservationDim = EnvironmentComponent->GetObservationDim();
+    const int32 ActionDim = EnvironmentComponent->GetActionDim();
+    const FRLAgentBackendRegistry& BackendRegistry = FRLAgentBackendRegistry::Get();
+    if (!BackendRegistry.IsSupported(TrainingConfig.Algorithm, ObservationDim, ActionDim, TrainingConfig.HiddenDim))
+    {
+        UE_LOG(LOG_UERLTOOLS, Error, TEXT("CreateAgent for agent '%s': No %s agent backend for Obs: %d, Act: %d, Hidden: %d. Registered (Obs, Act, Hidden): %s"),
+            *AgentName.ToString(), *UEnum::GetDisplayValueAsText(TrainingConfig.Algorithm).ToString(), ObservationDim, ActionDim, TrainingConfig.HiddenDim,
+            *BackendRegistry.DescribeRegisteredShapes(TrainingConfig.Algorithm));
+        return false;
+    }
+
     URLAgentManager* NewAgent = NewObject<URLAgentManager>(this); // 'this' is the subsystem, acting as outer
     if (!NewAgent)
     {
@@ -79,9 +110,9 @@ bool URLAgentManagerSubsystem::CreateAgent(FName AgentName, URLEnvironmentCompon
         return false;
     }
 
-    // The subsystem's rlt_context is passed to the agent. FLocalRLTrainingConfig is used temporarily.
+    // FLocalRLTrainingConfig is used temporarily.
     // TODO: Update FLocalRLTrainingConfig to FRLTrainingConfig once tech debt #2 is addressed.
-    if (NewAgent->InitializeAgentLogic(EnvironmentComponent, static_cast<FLocalRLTrainingConfig>(TrainingConfig), rlt_context, AgentName))
+    if (NewAgent->InitializeAgentLogic(EnvironmentComponent, ToLocalTrainingConfig(TrainingConfig), AgentName))
     {
         ActiveAgents.Add(AgentName, NewAgent);
         UE_LOG(LOG_UERLTOOLS, Log, TEXT("Agent '%s' created and initialized successfully."), *AgentName.ToString());
@@ -104,7 +135,6 @@ bool URLAgentManagerSubsystem::ConfigureAgent(FName AgentName, URLEnvironmentCom
     // That logic now belongs in URLAgentManager::InitializeAgentLogic
     return CreateAgent(AgentName, EnvironmentComponent, TrainingConfig);
 }
-}
 
 bool URLAgentManagerSubsystem::RemoveAgent(FName AgentName)
 {
@@ -127,6 +157,17 @@ bool URLAgentManagerSubsystem::RemoveAgent(FName AgentName)
     return false;
 }
 
+bool URLAgentManagerSubsystem::SetParallelEnvironments(FName AgentName, const TArray<URLEnvironmentComponent*>& ParallelEnvironments)
+{
+    URLAgentManager* Agent = ActiveAgents.FindRef(AgentName);
+    if (!Agent)
+    {
+        UE_LOG(LOG_UERLTOOLS, Error, TEXT("SetParallelEnvironments: Agent '%s' not found."), *AgentName.ToString());
+        return false;
+    }
+    return Agent->SetParallelEnvironments(ParallelEnvironments);
+}
+
 bool URLAgentManagerSubsystem::LoadPolicy(FName AgentName, const FString& FilePath)
 {
     URLAgentManager* Agent = ActiveAgents.FindRef(AgentName);
@@ -167,10 +208,9 @@ bool URLAgentManagerSubsystem::StartTraining(FName AgentName)
         UE_LOG(LOG_UERLTOOLS, Warning, TEXT("StartTraining: Agent '%s' is already training."), *AgentName.ToString());
         return false;
     }
-    AgentContext.bIsTraining = true;
     // TODO: Implement asynchronous training loop (FAsyncTask or FTSTicker)
     // This loop will call environment step, observe, rl_tools update, etc.
-    return true; // Placeholder
+    return Agent->StartTraining();
 }
 
 bool URLAgentManagerSubsystem::PauseTraining(FName AgentName)
@@ -230,14 +270,6 @@ TArray<float> URLAgentManagerSubsystem::GetAction(FName AgentName, const TArray<
     return Agent->GetAction(Observation);
 }
 
-void URLAgentManagerSubsystem::CleanupAgentResources(FRLAgentContext& AgentContext)
-{
-    UE_LOG(LOG_UERLTOOLS, Log, TEXT("Cleaning up resources for agent '%s'..."), *AgentContext.AgentName.ToString());
-    // CleanupAgentResources is no longer needed as URLAgentManager handles its own cleanup
-    // Resources are managed by URLAgentManager's ShutdownAgent method
-    UE_LOG(LOG_UERLTOOLS, Log, TEXT("Finished cleaning up resources for agent '%s'."), *AgentContext.AgentName.ToString());
-}
-
 bool URLAgentManagerSubsystem::GetAgentTrainingStatus(FName AgentName, bool& bIsCurrentlyTraining, int32& OutCurrentStep, float& OutLastReward)
 {
     bIsCurrentlyTraining = false;
@@ -259,4 +291,23 @@ bool URLAgentManagerSubsystem::GetAgentTrainingStatus(FName AgentName, bool& bIs
     return true;
 }
 
+bool URLAgentManagerSubsystem::GetAgentEpisodeStatistics(FName AgentName, FRLStatisticsSummary& OutEpisodeReturn, FRLStatisticsSummary& OutEpisodeLength)
+{
+    OutEpisodeReturn = FRLStatisticsSummary();
+    OutEpisodeLength = FRLStatisticsSummary();
+
+    URLAgentManager* Agent = ActiveAgents.FindRef(AgentName);
+    if (!Agent)
+    {
+        UE_LOG(LOG_UERLTOOLS, Error, TEXT("GetAgentEpisodeStatistics: Agent '%s' not found."), *AgentName.ToString());
+        return false;
+    }
+
+    // The published status: an async learner updates TrainingStatus while the summaries would be copied out of it
+    const FRLTrainingStatus Status = Agent->GetTrainingStatus();
+    OutEpisodeReturn = Status.EpisodeReturn;
+    OutEpisodeLength = Status.EpisodeLength;
+    return true;
+}
+
 // Implement other UFUNCTIONs as needed...
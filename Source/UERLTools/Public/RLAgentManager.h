@@ -5,22 +5,21 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Engine/Engine.h"
+#include "Containers/Ticker.h"
 #include "RLEnvironmentComponent.h"
 #include "RLConfigTypes.h" // Added for FRLNormalizationParams
-#include "UEEnvironmentAdapter.h" // Added for UEEnvironmentAdapter
-
-THIRD_PARTY_INCLUDES_START
-#include "rl_tools/operations/cpu_mux.h"
-#include "rl_tools/devices/cpu.h"
-#include "rl_tools/nn/layers/dense/layer.h"
-#include "rl_tools/nn_models/mlp/network.h"
-#include "rl_tools/rl/algorithms/td3/td3.h"
-#include "rl_tools/rl/components/off_policy_runner/off_policy_runner.h"
-#include "rl_tools/rl/components/replay_buffer/replay_buffer.h"
-THIRD_PARTY_INCLUDES_END
+#include "RLVectorizedEnvironment.h"
+#include "RLNormalizationPlan.h"
+#include "RLRunningNormalizer.h"
+#include "RLPolicyFile.h"
+#include "RLRollingStatistics.h"
+#include <atomic>
 
 #include "RLAgentManager.generated.h"
 
+// rl_tools networks live behind a type-erased backend (Private/RLAgentBackend.h) so this header stays free of rl_tools
+class IRLAgentBackend;
+
 // Forward declarations
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnTrainingStep, int32, Step, float, AverageReward);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTrainingFinished, bool, bSuccess);
@@ -39,6 +38,10 @@ struct UERLTOOLS_API FLocalRLTrainingConfig
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
 	int32 MaxTrainingSteps = 100000;
 
+	// Training algorithm, picks the backend family in FRLAgentBackendRegistry
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
+	ERLAlgorithm Algorithm = ERLAlgorithm::TD3;
+
 	// Learning rate for actor network
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
 	float ActorLearningRate = 0.0003f;
@@ -51,36 +54,91 @@ struct UERLTOOLS_API FLocalRLTrainingConfig
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
 	float Gamma = 0.99f;
 
-	// Batch size for training
+	// Batch size for training. All backends are compiled for 256; other values are reported and ignored.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
 	int32 BatchSize = 256;
 
-	// Replay buffer capacity
+	// Replay buffer capacity. The TD3 and SAC backends' buffers hold a compile-time 100000 transitions; other values are reported and ignored.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
-	int32 ReplayBufferCapacity = 1000000;
+	int32 ReplayBufferCapacity = 100000;
 
 	// Steps between training updates
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
 	int32 TrainingInterval = 1;
 
-	// Steps to collect before starting training
+	// Gradient updates per collected transition (update-to-data ratio). Updates owed by the steps of one
+	// TrainingInterval run together at its end; fractional ratios carry over.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training", meta = (ClampMin = "0.0"))
+	float UpdateToDataRatio = 1.0f;
+
+	// Run the two critic regressions of an update side by side (see FRLTrainingConfig::bParallelCriticTraining)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
+	bool bParallelCriticTraining = false;
+
+	// Prioritized experience replay (see FRLTrainingConfig::bPrioritizedReplay)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Prioritized Replay")
+	bool bPrioritizedReplay = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Prioritized Replay", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float PrioritizedReplayAlpha = 0.6f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Prioritized Replay", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float PrioritizedReplayBeta = 0.4f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Prioritized Replay", meta = (ClampMin = "0"))
+	int32 PrioritizedReplayBetaAnnealingUpdates = 100000;
+
+	// Memory-mapped replay buffer file (see FRLTrainingConfig::ReplayBufferFilePath)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
+	FString ReplayBufferFilePath;
+
+	// PPO: passes over each full rollout and the lambda of its advantage estimate (see FRLTrainingConfig::PPOEpochs)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|PPO", meta = (ClampMin = "1"))
+	int32 PPOEpochs = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|PPO", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float GAELambda = 0.95f;
+
+	// Transitions to collect with uniformly random actions before the policy acts and updates start (TD3 and SAC)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
 	int32 WarmupSteps = 10000;
 
+	// Hidden layer width of the actor/critic networks. Must be one of the sizes registered in FRLAgentBackendRegistry.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Network")
+	int32 HiddenDim = 64;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Normalization")
 	FRLNormalizationParams ObservationNormalizationParams;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Normalization")
 	FRLNormalizationParams ActionNormalizationParams;
 
-	FRLTrainingConfig()
+	// Learn observation statistics while training (see FRLTrainingConfig::bUseRunningObservationNormalization)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Normalization")
+	bool bUseRunningObservationNormalization = false;
+
+	// Finished episodes the return and length statistics of FRLTrainingStatus are taken over
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Statistics", meta = (ClampMin = "1"))
+	int32 EpisodeStatisticsWindow = 100;
+
+	// Step training every frame from a core ticker instead of StepTraining calls, with the training environments
+	// headless (fixed time step, owners hidden) and world rendering off (see FRLTrainingConfig::bHeadlessTraining)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Headless")
+	bool bHeadlessTraining = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Headless", meta = (ClampMin = "0.1"))
+	float HeadlessFrameBudgetMs = 12.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Headless", meta = (ClampMin = "1"))
+	int32 HeadlessMaxStepsPerFrame = 100000;
+
+	FLocalRLTrainingConfig()
 	{
 		MaxTrainingSteps = 100000;
 		ActorLearningRate = 0.0003f;
 		CriticLearningRate = 0.0003f;
 		Gamma = 0.99f;
 		BatchSize = 256;
-		ReplayBufferCapacity = 1000000;
 		TrainingInterval = 1;
 		WarmupSteps = 10000;
 	}
@@ -103,6 +161,7 @@ struct UERLTOOLS_API FRLTrainingStatus
 	UPROPERTY(BlueprintReadOnly, Category = "Training Status")
 	int32 CurrentEpisode = 0;
 
+	// Mean return over the episode statistics window, the same as EpisodeReturn.Mean
 	UPROPERTY(BlueprintReadOnly, Category = "Training Status")
 	float AverageReward = 0.0f;
 
@@ -111,6 +170,13 @@ struct UERLTOOLS_API FRLTrainingStatus
 
 	UPROPERTY(BlueprintReadOnly, Category = "Training Status")
 	int32 ReplayBufferSize = 0;
+
+	// Returns and lengths (steps) of the last FLocalRLTrainingConfig::EpisodeStatisticsWindow finished episodes
+	UPROPERTY(BlueprintReadOnly, Category = "Training Status")
+	FRLStatisticsSummary EpisodeReturn;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Training Status")
+	FRLStatisticsSummary EpisodeLength;
 };
 
 /**
@@ -127,14 +193,16 @@ public:
 
 	// Called by URLAgentManagerSubsystem to initialize the agent with its environment and config
 	// This is where rl_tools components will be allocated and initialized.
-	bool InitializeAgentLogic(URLEnvironmentComponent* InEnvironmentComponent, const FLocalRLTrainingConfig& InTrainingConfig, rl_tools::devices::DefaultCPU::CONTEXT_TYPE* InRltContext, FName InAgentName = NAME_None);
+	// The network shape (observation/action/hidden dims) is resolved at runtime from the environment component and config.
+	bool InitializeAgentLogic(URLEnvironmentComponent* InEnvironmentComponent, const FLocalRLTrainingConfig& InTrainingConfig, FName InAgentName = NAME_None);
 
 
 	// Training configuration
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
 	FLocalRLTrainingConfig TrainingConfig;
 
-	// Current training status
+	// Training status as of the last SyncTrainingStatus; StepTraining syncs it after its steps, URLAsyncTrainingTask on
+	// every progress check. GetTrainingStatus always returns the latest status the learner published.
 	UPROPERTY(BlueprintReadOnly, Category = "Training")
 	FRLTrainingStatus TrainingStatus;
 
@@ -171,11 +239,71 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Training")
 	bool StepTraining(int32 NumSteps = 1);
 
+	// Trains on the agent's environment plus the given copies of it (e.g. identical arenas in one level). Every
+	// training step then runs one batched policy pass for all of them. Must be called while not training.
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	bool SetParallelEnvironments(const TArray<URLEnvironmentComponent*>& InParallelEnvironments);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Training")
+	int32 GetNumTrainingEnvironments() const { return TrainingEnvironments.Num(); }
+
+	// A training step split into a rollout half and a learner half, so the two can run on different threads (see
+	// URLAsyncTrainingTask). The rollout half touches the environment component and runs on the game thread; it acts
+	// on the latest actor snapshot the learner published and never waits for the learner. The learner half owns the
+	// backend's replay buffer and networks and the training counters. These drive the agent's own environment only,
+	// parallel environments are stepped by StepTraining.
+
+	// Game thread: switches the backend to the actor/learner split before the learner starts, or back once it has
+	// stopped (the inference actor then picks up the trained weights)
+	void SetAsyncLearner(bool bAsync);
+
+	// Game thread: resets the environment and writes the first observation of the new episode
+	bool ResetEnvironment(TArrayView<float> OutObservation);
+
+	// Game thread: applies Action and writes the resulting observation, reward and episode end flags
+	bool StepEnvironment(TArrayView<const float> Action, TArrayView<float> OutObservation, float& OutReward, bool& bOutTerminated, bool& bOutTruncated);
+
+	// Game thread: exploration action for a raw observation from the published actor snapshot (uniform until the
+	// learner has published one). Writes the policy-space action the replay buffer keeps and its denormalized
+	// counterpart for the environment.
+	bool ComputeRolloutAction(TArrayView<const float> Observation, TArrayView<float> OutPolicyAction, TArrayView<float> OutAction);
+
+	// Learner thread: remembers the first observation of an episode as the start of the next transition
+	void BeginTrainingEpisode(TArrayView<const float> Observation);
+
+	// Learner thread: stores the transition from the remembered observation through PolicyAction to NextObservation in
+	// the replay buffer, runs the TD3 updates it is owed and remembers NextObservation for the next transition (off-policy only)
+	void StoreTrainingTransition(TArrayView<const float> PolicyAction, TArrayView<const float> NextObservation, float Reward, bool bTerminated, bool bTruncated);
+
+	// Learner thread: accounts one transition of the given training environment in the training status and publishes it
+	void RecordTransition(float Reward, bool bEpisodeFinished, int32 EnvironmentIndex = 0);
+
+	// Learner thread: the training status as the learner keeps it, ahead of the published one
+	const FRLTrainingStatus& GetLearnerTrainingStatus() const { return LearnerStatus; }
+
+	// Game thread: copies the latest published status into TrainingStatus
+	void SyncTrainingStatus();
+
+	// Any thread: true from StartTraining to StopTraining. The learner thread polls this instead of TrainingStatus.
+	bool IsTrainingActive() const { return bTrainingActive.load(std::memory_order_relaxed); }
+
+	// Running observation statistics (bUseRunningObservationNormalization). Rollout workers that keep their own
+	// FRLRunningNormalizer fold it in here; ignored once training has stopped and the statistics are frozen.
+	// While async training runs, the statistics belong to the learner thread like the rest of the learner half.
+	bool MergeObservationStatistics(const FRLRunningNormalizer& WorkerStatistics);
+	const FRLRunningNormalizer& GetObservationStatistics() const { return ObservationStatistics; }
+
 	// Inference functions
 	UFUNCTION(BlueprintCallable, Category = "Inference")
 	TArray<float> GetAction(const TArray<float>& Observation);
 
-	// Policy management
+	// Batched inference: Observations holds NumObservations rows of ObservationDim floats (row-major).
+	// OutActions is resized to NumObservations rows of ActionDim floats. Runs one forward pass per INFERENCE_BATCH_SIZE rows.
+	UFUNCTION(BlueprintCallable, Category = "Inference")
+	bool GetActionsBatched(const TArray<float>& Observations, int32 NumObservations, TArray<float>& OutActions);
+
+	// Policy management. A policy file holds the actor's parameters and the normalization it was trained with
+	// (see FRLPolicyFile); loading memory-maps it and runs inference directly from the mapped parameters.
 	UFUNCTION(BlueprintCallable, Category = "Policy")
 	bool LoadPolicy(const FString& FilePath);
 
@@ -184,7 +312,7 @@ public:
 
 	// Status and utility functions
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Training")
-	FRLTrainingStatus GetTrainingStatus() const { return TrainingStatus; }
+	FRLTrainingStatus GetTrainingStatus() const;
 
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Training")
 	bool IsTraining() const { return TrainingStatus.bIsTraining; }
@@ -192,6 +320,14 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Agent")
 	bool IsInitialized() const { return bIsInitialized; }
 
+	int32 GetObservationDim() const { return ObservationDim; }
+	int32 GetActionDim() const { return ActionDim; }
+
+	ERLAlgorithm GetAlgorithm() const { return TrainingConfig.Algorithm; }
+
+	// True if the backend learns from its own rollouts (PPO): no warmup, no replay buffer and no async learner
+	bool IsOnPolicy() const;
+
 	// Shuts down the agent and releases all resources
 	UFUNCTION(BlueprintCallable, Category = "Agent")
 	void ShutdownAgent();
@@ -199,154 +335,120 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Agent")
 	FName AgentName;
 
-protected:
-	// rl_tools types and constants
-	using DEVICE = rl_tools::devices::DefaultCPU;
-	using T = float;
-	using TI = typename DEVICE::index_t;
-
-	// Define Environment Specification for rl_tools types
-	struct UERLAgentEnvironmentSpec {
-		// Inherit T and TI from the outer scope (URLAgentManager protected section)
-
-		// PLACEHOLDER DIMENSIONS: These MUST be validated against the URLEnvironmentComponent instance at runtime.
-		// Adjust these to your most common environment configuration.
-		// These will be set dynamically in InitializeAgentLogic based on InEnvironmentComponent.
-
-		static constexpr TI OBSERVATION_DIM = 4; // Example placeholder
-		static constexpr TI ACTION_DIM = 2;    // Example placeholder
-
-		struct OBSERVATION_SPEC {
-			using T = UERLAgentEnvironmentSpec::T;
-			using TI = UERLAgentEnvironmentSpec::TI;
-			static constexpr TI DIM = UERLAgentEnvironmentSpec::OBSERVATION_DIM;
-			using SPEC = rl_tools::matrix::Specification<T, TI, 1, DIM>;
-			template <typename CONFIG> using Matrix = rl_tools::MatrixStatic<CONFIG>; // Assuming fixed size observations
-		};
-		struct ACTION_SPEC {
-			using T = UERLAgentEnvironmentSpec::T;
-			using TI = UERLAgentEnvironmentSpec::TI;
-			static constexpr TI DIM = UERLAgentEnvironmentSpec::ACTION_DIM;
-			using SPEC = rl_tools::matrix::Specification<T, TI, 1, DIM>;
-			template <typename CONFIG> using Matrix = rl_tools::MatrixStatic<CONFIG>; // Assuming fixed size actions
-		};
-		// Note: The UEEnvironmentAdapter itself defines its State struct internally.
-		// This UERLAgentEnvironmentSpec is primarily for configuring other rl_tools components
-		// that depend on environment properties like dimensions.
-	};
-
-	// rl_tools types and constants (continuation)
-	// T and TI are already defined above, no need to repeat here.
-
-	// Core rl_tools components for this agent instance
-	// These will be properly typed and allocated in InitializeAgentLogic
-	// Example types (actual types are complex templates):
-	// typename rl_tools::rl::algorithms::td3::ActorCritic<ACTOR_CRITIC_SPEC>::template Instance actor_critic;
-	// typename rl_tools::rl::components::off_policy_runner::Buffer<OFF_POLICY_RUNNER_SPEC>::template Instance replay_buffer;
-	// typename rl_tools::rl::components::replay_buffer::ReplayBuffer<REPLAY_BUFFER_SPEC>::template Instance replay_buffer_struct; // If using standalone replay buffer
-	// typename rl_tools::rl::algorithms::td3::Actor<ACTOR_SPEC>::template Instance actor_network;
-	// typename rl_tools::rl::algorithms::td3::Critic<CRITIC_SPEC>::template Instance critic_network_1;
-	// typename rl_tools::rl::algorithms::td3::Critic<CRITIC_SPEC>::template Instance critic_network_2;
-	// typename rl_tools::rl::algorithms::td3::Actor<ACTOR_SPEC>::template Instance target_actor_network;
-	// typename rl_tools::rl::algorithms::td3::Critic<CRITIC_SPEC>::template Instance target_critic_network_1;
-	// typename rl_tools::rl::algorithms::td3::Critic<CRITIC_SPEC>::template Instance target_critic_network_2;
-	// typename rl_tools::nn::optimizers::adam::Optimizer actor_optimizer;
-	// typename rl_tools::nn::optimizers::adam::Optimizer critic_optimizer;
-
-	// Pointers to allocated rl_tools buffers (managed by this class)
-	void* rlt_actor_critic_buffer = nullptr;
-	void* rlt_replay_buffer_buffer = nullptr; // For the OffPolicyRunner's buffer component
-	void* rlt_off_policy_runner_buffer = nullptr;
-
-	// Environment Adapter specific to this agent's URLEnvironmentComponent instance
-	// rl_tools::rl::environments::UEEnvironmentAdapter<UERLAgentEnvironmentSpec> RLEnvironmentAdapter;
-	// This would be tricky as UERLAgentEnvironmentSpec needs dynamic OBS_DIM/ACT_DIM.
-	// Instead, we'll store the dimensions and use them to initialize templated types locally in functions.
-	TI ObservationDim = 0;
-	TI ActionDim = 0;
-
-	// rl_tools device and context for this agent's operations
-	// This context might be shared from the subsystem or created per agent.
-	// For now, assume it's passed in or a new one is created if null.
-	DEVICE rlt_device_instance; // The device instance itself
-	rl_tools::devices::DefaultCPU::CONTEXT_TYPE* rlt_context_ptr = nullptr; // Pointer to the context
-
-	// Network architecture constants
-	static constexpr TI HIDDEN_DIM = 64;
-	static constexpr TI NUM_LAYERS = 2;
-	static constexpr auto ACTIVATION_FUNCTION = rl_tools::nn::activation_functions::ActivationFunction::RELU;
-
-	// Actor network type
-	// These specs depend on the environment's observation and action dimensions for input/output layers.
-	// However, rl_tools MLP structures are often defined by hidden layers, input/output are inferred or set at instantiation.
-	// For now, let's assume these are generic MLP structures.
-	using ACTOR_STRUCTURE_SPEC = rl_tools::nn_models::mlp::StructureSpecification<T, TI, UERLAgentEnvironmentSpec::OBSERVATION_DIM, UERLAgentEnvironmentSpec::ACTION_DIM, HIDDEN_DIM, NUM_LAYERS, ACTIVATION_FUNCTION, rl_tools::nn::activation_functions::TANH>; // Actor output usually tanh
-	using ACTOR_SPEC = rl_tools::nn_models::mlp::AdamSpecification<ACTOR_STRUCTURE_SPEC>;
-	using ACTOR_TYPE = rl_tools::nn_models::mlp::NeuralNetworkAdam<ACTOR_SPEC>;
-
-	// Critic network type (takes observation and action as input)
-	// The input dimension for the critic is ObservationDim + ActionDim.
-	// We'll need a custom StructureSpecification or handle this during instantiation if rl_tools doesn't directly support it in the generic MLP spec.
-	// For simplicity, we'll assume a critic structure that can be configured or adapted.
-	// This might require a more specific critic network structure definition later.
-	using CRITIC_STRUCTURE_SPEC = rl_tools::nn_models::mlp::StructureSpecification<T, TI, UERLAgentEnvironmentSpec::OBSERVATION_DIM + UERLAgentEnvironmentSpec::ACTION_DIM, 1, HIDDEN_DIM, NUM_LAYERS, ACTIVATION_FUNCTION, rl_tools::nn::activation_functions::IDENTITY>; // Critic output is Q-value
-	using CRITIC_SPEC = rl_tools::nn_models::mlp::AdamSpecification<CRITIC_STRUCTURE_SPEC>;
-	using CRITIC_TYPE = rl_tools::nn_models::mlp::NeuralNetworkAdam<CRITIC_SPEC>;
-
-	// TD3 Parameters
-	using TD3_PARAMETERS = rl_tools::rl::algorithms::td3::Parameters<T, TI>;
-
-	// Actor-Critic type
-	using ACTOR_CRITIC_SPEC = rl_tools::rl::algorithms::td3::Specification<T, TI, UERLAgentEnvironmentSpec, ACTOR_TYPE, CRITIC_TYPE, TD3_PARAMETERS>;
-	using ACTOR_CRITIC_TYPE = rl_tools::rl::algorithms::td3::ActorCritic<ACTOR_CRITIC_SPEC>;
-
-	// Replay Buffer
-	static constexpr TI REPLAY_BUFFER_CAPACITY = 100000; // Example capacity
-	using REPLAY_BUFFER_SPEC = rl_tools::rl::components::replay_buffer::Specification<T, TI, UERLAgentEnvironmentSpec::OBSERVATION_DIM, UERLAgentEnvironmentSpec::ACTION_DIM, REPLAY_BUFFER_CAPACITY>;
-	using REPLAY_BUFFER_TYPE = rl_tools::rl::components::ReplayBuffer<REPLAY_BUFFER_SPEC>;
-
-	// Off-Policy Runner
-	// The OffPolicyRunner needs the actual UEEnvironmentAdapter type, not just its spec.
-	// Let's define the adapter type first.
-	using ENVIRONMENT_ADAPTER_TYPE = UEEnvironmentAdapter<DEVICE, UERLAgentEnvironmentSpec>;
-	using OFF_POLICY_RUNNER_SPEC = rl_tools::rl::components::off_policy_runner::Specification<T, TI, ENVIRONMENT_ADAPTER_TYPE, REPLAY_BUFFER_TYPE::CAPACITY, typename ACTOR_CRITIC_TYPE::ParametersType::OFF_POLICY_RUNNER_PARAMETERS_TYPE>;
-    using OFF_POLICY_RUNNER_TYPE = rl_tools::rl::components::OffPolicyRunner<OFF_POLICY_RUNNER_SPEC>;
-
 private:
-    // rl_tools instances
-    // UEEnvironmentAdapter instance, managed by this class
-	ENVIRONMENT_ADAPTER_TYPE* EnvironmentAdapterInstance;
+	// rl_tools networks for the environment's shape, created through FRLAgentBackendRegistry
+	IRLAgentBackend* Backend;
+
+	// Policy file the backend's inference actor is bound to after LoadPolicy; kept open until the next load or shutdown
+	FRLPolicyFile LoadedPolicy;
 
-	DEVICE device; // The rl_tools device
+	// Runtime dimensions of the agent, taken from the environment component at initialization
+	int32 ObservationDim;
+	int32 ActionDim;
 
 	UPROPERTY()
 	URLEnvironmentComponent* EnvironmentComponent;
 
+	// Additional copies of EnvironmentComponent trained in lockstep with it
+	UPROPERTY()
+	TArray<URLEnvironmentComponent*> ParallelEnvironments;
+
+	// EnvironmentComponent followed by ParallelEnvironments, batched for StepTraining
+	FRLVectorizedEnvironment TrainingEnvironments;
+
 	// Initialization flag
 	bool bIsInitialized;
 
 	// Training state
 	bool bTrainingPaused;
-	int32 EpisodeStepCount;
-	float EpisodeReward;
-	TArray<float> EpisodeRewards;
 
-	// Current observation and action
-	TArray<float> CurrentObservation;
+	// Ticker stepping training while TrainingConfig.bHeadlessTraining is set, and whether world rendering was turned
+	// off for it
+	FTSTicker::FDelegateHandle HeadlessTickerHandle;
+	bool bDisabledWorldRendering;
+
+	// Learner: the status RecordTransition and CollectExperience update, published to PublishedStatus after every
+	// transition. The game thread only reads PublishedStatus, under PublishedStatusLock.
+	FRLTrainingStatus LearnerStatus;
+	FRLTrainingStatus PublishedStatus;
+	mutable FCriticalSection PublishedStatusLock;
+	std::atomic<bool> bTrainingActive{false};
+
+	// Learner: returns and lengths of the last EpisodeStatisticsWindow finished episodes, summarized into LearnerStatus
+	FRLRollingStatistics EpisodeReturnStatistics;
+	FRLRollingStatistics EpisodeLengthStatistics;
+
+	// Running episode length and return, one entry per training environment
+	TArray<int32> EpisodeStepCounts;
+	TArray<float> EpisodeReturns;
+
+	// Policy-space action batch for all training environments, [NumTrainingEnvironments, ActionDim], and the same
+	// batch denormalized for the environments (unused while ActionDenormalization is the identity)
 	TArray<float> CurrentAction;
+	TArray<float> EnvironmentActions;
+
+	// Learner thread: raw observation the next StoreTrainingTransition starts from
+	TArray<float> TrainerObservation;
+
+	// Off-policy updates owed to the stored transitions (UpdateToDataRatio each) and training steps since they last ran
+	float PendingUpdates;
+	int32 StepsSinceUpdate;
+
+	// TrainingConfig's normalization params compiled for the agent's dimensions; identity when disabled.
+	// Observations are normalized before every policy pass and the policy's actions denormalized after it.
+	// ObservationNormalization is the learner's and follows the running statistics; inference reads the published copy.
+	FRLNormalizationPlan ObservationNormalization;
+	FRLNormalizationPlan ActionDenormalization;
 
-	// Actor and Critic networks (will be allocated dynamically)
-	ACTOR_TYPE* ActorNetwork;
-	CRITIC_TYPE* CriticNetwork;
+	// ObservationNormalization as published for GetAction and GetActionsBatched, double-buffered like the backend's
+	// actor snapshots: the learner fills the plan the game thread has not pinned and swaps the published index
+	FRLNormalizationPlan InferenceObservationNormalization[2];
+	std::atomic<int32> PublishedInferenceNormalization{0};
+	std::atomic<int32> PinnedInferenceNormalization{INDEX_NONE};
+
+	// Normalized observations fed to the policy by inference and StepTraining. Async rollouts normalize inside the
+	// backend with the plan published alongside the actor snapshot.
+	TArray<float> NormalizedObservations;
+
+	// Running observation statistics and the params they were last compiled from (reused to avoid per-step allocation)
+	FRLRunningNormalizer ObservationStatistics;
+	FRLNormalizationParams RunningObservationParams;
 
 	// Helper functions
 	void UpdateTrainingStatus();
+	void PublishTrainingStatus();
 	void LogTrainingProgress();
 	bool ValidateEnvironment() const;
 	void CleanupNetworks();
+	bool CreateBackend();
+	bool BindTrainingEnvironments();
+	void BuildNormalizationPlans();
+
+	// Pushes TrainingConfig's learning rates and discount to the backend and reports settings it cannot honour
+	void ConfigureBackendTraining();
+
+	// True until the replay buffer holds WarmupSteps transitions (and at least one training batch); never for on-policy backends
+	bool IsWarmingUp() const;
+
+	// Folds observations the policy is about to act on into the running statistics and recompiles the observation plan
+	void UpdateObservationStatistics(TConstArrayView<float> Observations);
+
+	// Learner: copies ObservationNormalization into the inference plan the game thread has not pinned and publishes it.
+	// Skipped while the game thread still reads that plan; the next rebuild catches up.
+	void PublishObservationNormalization();
+
+	// Normalizes Observations with the published plan into Scratch and returns the view to feed the policy
+	// (Observations itself for an identity plan)
+	TConstArrayView<float> NormalizeObservations(TConstArrayView<float> Observations, TArray<float>& Scratch);
+
+	// Headless training: switches the training environments and world rendering, and steps training for up to
+	// HeadlessFrameBudgetMs every frame
+	void SetHeadlessEnvironments(bool bHeadless);
+	bool TickHeadlessTraining(float DeltaTime);
+	void RemoveHeadlessTicker();
 
 	// Training step implementation
 	bool PerformTrainingStep();
-	void CollectExperience();
+	void CollectExperience(TConstArrayView<float> Observation, TConstArrayView<float> PolicyAction, float Reward, TConstArrayView<float> NextObservation, bool bTerminated, bool bTruncated);
 	void UpdateNetworks();
 };
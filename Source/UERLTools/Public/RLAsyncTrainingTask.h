@@ -5,32 +5,48 @@
 #include "CoreMinimal.h"
 #include "Engine/Engine.h"
 #include "Async/AsyncWork.h"
+#include "Containers/Ticker.h"
 #include "RLAgentManager.h"
+#include "RLTransitionRing.h"
 #include "RLAsyncTrainingTask.generated.h"
 
 // Forward declarations
+class FEvent;
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnAsyncTrainingProgress, int32, Step, float, AverageReward);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAsyncTrainingComplete, bool, bSuccess);
 
 /**
- * Async task for running RL training in background
+ * Async task for running RL training in background, split into an actor and a learner.
+ *
+ * The environment is a UObject and is only ever stepped on the game thread (PumpEnvironment), which acts on a
+ * read-only snapshot of the actor that the learner publishes through the backend's double-buffered parameter block
+ * (IRLAgentBackend::SampleRolloutActions). The game thread never waits for the learner: it pushes step records
+ * (policy-space action, reward, episode flags, next observation) into a lock-free SPSC ring and moves on. The worker
+ * thread (DoWork) is the learner: it drains the ring into the replay buffer and runs the updates owed to each
+ * transition. A full ring stalls the producer instead of growing, which is what keeps UpdateToDataRatio honest, and
+ * the learner parks on an event while the ring is empty instead of polling.
  */
 class FRLAsyncTrainingTask : public FNonAbandonableTask
 {
 	friend class FAsyncTask<FRLAsyncTrainingTask>;
 
 public:
-	FRLAsyncTrainingTask(URLAgentManager* InAgentManager, int32 InMaxSteps, int32 InProgressUpdateInterval = 1000);
+	FRLAsyncTrainingTask(URLAgentManager* InAgentManager, int32 InMaxSteps, int32 InProgressUpdateInterval = 1000, int32 InRingCapacity = 256);
+	~FRLAsyncTrainingTask();
 
 	// Required by FNonAbandonableTask
 	void DoWork();
 	FORCEINLINE TStatId GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(FRLAsyncTrainingTask, STATGROUP_ThreadPoolAsyncTasks); }
 
+	// Game thread: acts on the latest actor snapshot, steps the environment and publishes the resulting step records.
+	// Takes at most MaxEnvironmentSteps steps, fewer if the learner has fallen a full ring behind. Returns the number of steps taken.
+	int32 PumpEnvironment(int32 MaxEnvironmentSteps);
+
 	// Check if task should continue
-	bool ShouldContinue() const { return !bShouldStop && AgentManager && AgentManager->IsTraining(); }
+	bool ShouldContinue() const { return !bShouldStop && AgentManager && AgentManager->IsTrainingActive(); }
 
 	// Stop the task
-	void Stop() { bShouldStop = true; }
+	void Stop();
 
 	// Get progress
 	int32 GetCurrentStep() const { return CurrentStep; }
@@ -39,10 +55,27 @@ public:
 	bool WasSuccessful() const { return bWasSuccessful; }
 
 private:
+	// Worker thread: blocks until the game thread published something or the timeout elapsed
+	void WaitForWork();
+
 	URLAgentManager* AgentManager;
 	int32 MaxSteps;
 	int32 ProgressUpdateInterval;
-	
+
+	// Game thread -> learner: step records, each slot holds [policy-space action | observation]. EpisodeStart records
+	// only carry the observation.
+	FRLTransitionRing StepRing;
+
+	// Triggered by the game thread after publishing a step record
+	FEvent* WorkEvent;
+
+	// Game thread: the next record to publish is the first observation of a new episode
+	bool bNeedsEpisodeStart;
+
+	// Game thread: observation the next action is computed for, and that action denormalized for the environment
+	TArray<float> RolloutObservation;
+	TArray<float> RolloutAction;
+
 	// Task state
 	volatile bool bShouldStop;
 	volatile bool bIsComplete;
@@ -70,8 +103,9 @@ public:
 	FOnAsyncTrainingComplete OnComplete;
 
 	// Start async training
+	// InEnvironmentStepsPerTick caps how many environment steps the game thread takes per frame
 	UFUNCTION(BlueprintCallable, Category = "Async Training", meta = (DisplayName = "Start Async Training"))
-	bool StartAsyncTraining(URLAgentManager* AgentManager, int32 MaxSteps = 10000, int32 ProgressUpdateInterval = 1000);
+	bool StartAsyncTraining(URLAgentManager* AgentManager, int32 MaxSteps = 10000, int32 ProgressUpdateInterval = 1000, int32 InEnvironmentStepsPerTick = 64);
 
 	// Stop async training
 	UFUNCTION(BlueprintCallable, Category = "Async Training", meta = (DisplayName = "Stop Async Training"))
@@ -84,17 +118,29 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Async Training", meta = (DisplayName = "Get Training Progress"))
 	void GetTrainingProgress(int32& CurrentStep, float& AverageReward, bool& bIsComplete) const;
 
+	virtual void BeginDestroy() override;
+
 protected:
 	// Tick function to check progress and fire events
 	UFUNCTION()
 	void CheckProgress();
 
+	// Core ticker callback that steps the environment on the game thread
+	bool PumpEnvironment(float DeltaTime);
+
 private:
 	// Async task
 	TSharedPtr<FAsyncTask<FRLAsyncTrainingTask>> AsyncTask;
 	
+	// Agent being trained; stopped on the game thread once the task completes
+	TWeakObjectPtr<URLAgentManager> TrainedAgent;
+
 	// Timer for progress updates
 	FTimerHandle ProgressTimerHandle;
+
+	// Ticker driving PumpEnvironment
+	FTSTicker::FDelegateHandle PumpTickerHandle;
+	int32 EnvironmentStepsPerTick;
 	
 	// Last reported values to avoid duplicate events
 	int32 LastReportedStep;
@@ -102,4 +148,5 @@ private:
 	
 	// Cleanup
 	void CleanupTask();
+	void RemovePumpTicker();
 };
@@ -5,6 +5,22 @@
 #include "CoreMinimal.h"
 #include "RLConfigTypes.generated.h"
 
+/**
+ * Training algorithm of an agent. Each one has its own set of pre-instantiated backends in FRLAgentBackendRegistry.
+ */
+UENUM(BlueprintType)
+enum class ERLAlgorithm : uint8
+{
+    /** Off-policy TD3 with a replay buffer. */
+    TD3 UMETA(DisplayName = "TD3"),
+
+    /** On-policy PPO: fixed-length rollouts across all training environments, GAE and minibatch epochs. */
+    PPO UMETA(DisplayName = "PPO"),
+
+    /** Off-policy SAC with a replay buffer and automatic entropy tuning. */
+    SAC UMETA(DisplayName = "SAC")
+};
+
 /**
  * Parameters for normalizing or denormalizing observation/action data.
  */
@@ -77,6 +77,10 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Environment State")
 	bool bIsTruncated;
 
+	// Simulated time one step advances while headless, independent of the frame rate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Environment|Headless", meta = (ClampMin = "0.0001"))
+	float FixedDeltaSeconds = 1.0f / 60.0f;
+
 	// Blueprint Events
 	UPROPERTY(BlueprintAssignable, Category = "Environment Events")
 	FOnEnvironmentReset OnEnvironmentReset;
@@ -103,6 +107,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Environment")
 	virtual bool CheckTruncated();
 
+	// Allocation-free counterparts of Reset/Step for native callers (training loops, batched environments).
+	// The observation is written straight into OutObservation, which must hold ObservationDim floats; the action is read
+	// in place. Step(const TArray&) goes through StepInto as well, so both paths behave identically.
+	bool ResetInto(TArrayView<float> OutObservation);
+	bool StepInto(TConstArrayView<float> Action, TArrayView<float> OutObservation);
+
 	// Utility functions
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Environment")
 	int32 GetObservationDim() const { return EnvironmentConfig.ObservationDim; }
@@ -116,6 +126,23 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Environment")
 	bool IsEpisodeFinished() const { return bIsTerminated || bIsTruncated; }
 
+	// Headless environments step with FixedDeltaSeconds instead of the world's frame time and leave the scene alone:
+	// the owner is hidden and not moved per step, and is brought up to date when headless mode ends. URLAgentManager
+	// switches its training environments to headless for FLocalRLTrainingConfig::bHeadlessTraining.
+	UFUNCTION(BlueprintCallable, Category = "Environment")
+	virtual void SetHeadless(bool bInHeadless);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Environment")
+	bool IsHeadless() const { return bHeadless; }
+
+	// Simulated time the next step advances: FixedDeltaSeconds while headless, the world's frame time otherwise
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Environment")
+	float GetStepDeltaSeconds() const;
+
+	// Observation and reward produced by the last Reset/Step, without re-running the Blueprint implementations
+	const TArray<float>& GetLastObservation() const { return LastObservation; }
+	float GetLastReward() const { return LastReward; }
+
 protected:
 	// Override these functions in Blueprint or derived classes for custom behavior
 	UFUNCTION(BlueprintImplementableEvent, Category = "Environment", meta = (DisplayName = "On Reset Implementation"))
@@ -136,6 +163,14 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category = "Environment", meta = (DisplayName = "Check Truncated Implementation"))
 	bool BP_CheckTruncated();
 
+	// Native hooks used by StepInto. C++ environments override these to skip the TArray round trip; the defaults
+	// forward to BP_OnStep and GetObservation.
+	virtual void ApplyAction(TConstArrayView<float> Action);
+	virtual void WriteObservation(TArrayView<float> OutObservation);
+
+	// Called when headless mode ends; scene-backed environments move their owner to the simulated state here
+	virtual void SyncSceneState() {}
+
 private:
 	// rl_tools device
 	//rl_tools::devices::DefaultCPU Device;
@@ -145,4 +180,12 @@ private:
 
 	// Last reward cache
 	float LastReward;
+
+	// Action staged for BP_OnStep, which needs a TArray
+	TArray<float> BlueprintAction;
+
+	bool bHeadless;
+
+	// Owner visibility before SetHeadless hid it, restored when headless mode ends
+	bool bOwnerWasHidden;
 };
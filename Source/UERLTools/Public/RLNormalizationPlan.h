@@ -0,0 +1,56 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RLConfigTypes.h"
+
+/**
+ * FRLNormalizationParams compiled into a fused per-feature scale and bias, so applying it is a single
+ * multiply-add per element:
+ *   Normalize:   y = x * (1 / StdDev) + (-Mean / StdDev)
+ *   Denormalize: y = x * StdDev + Mean
+ *
+ * Single-value Mean/StdDev are broadcast and missing entries fall back to 0/1 at build time, and a near-zero StdDev
+ * leaves the feature unnormalized, matching the per-element conversion path. Rebuild whenever the params change.
+ *
+ * Apply works on a single vector of Dim floats as well as on a row-major [N, Dim] block. The scale and bias arrays are
+ * stored tiled over several rows so the SIMD loop runs straight across row boundaries, even when Dim is smaller than
+ * the vector width. A disabled plan is the identity and costs nothing but a copy (or nothing when applied in place).
+ *
+ * Implemented next to the conversion functions in RLToolsConversionUtils.cpp; this header stays free of rl_tools.
+ */
+class UERLTOOLS_API FRLNormalizationPlan
+{
+public:
+    enum class EDirection : uint8
+    {
+        Normalize,
+        Denormalize,
+    };
+
+    FRLNormalizationPlan();
+
+    // Compiles Params for vectors of InDim features. A disabled Params yields the identity plan.
+    void Build(const FRLNormalizationParams& Params, int32 InDim, EDirection Direction = EDirection::Normalize);
+    void Reset();
+
+    int32 GetDim() const { return Dim; }
+    bool IsIdentity() const { return bIsIdentity; }
+
+    // Per-feature scale and bias (first Dim entries of the tiled arrays)
+    TConstArrayView<float> GetScale() const { return MakeArrayView(Scale.GetData(), bIsIdentity ? 0 : Dim); }
+    TConstArrayView<float> GetBias() const { return MakeArrayView(Bias.GetData(), bIsIdentity ? 0 : Dim); }
+
+    // Source holds one or more rows of Dim floats; Destination must have the same size and may alias Source
+    bool Apply(TConstArrayView<float> Source, TArrayView<float> Destination) const;
+    bool ApplyInPlace(TArrayView<float> Values) const { return Apply(Values, Values); }
+
+private:
+    // Scale and Bias repeated TileRows times
+    TArray<float> Scale;
+    TArray<float> Bias;
+    int32 Dim;
+    int32 TileRows;
+    bool bIsIdentity;
+};
@@ -0,0 +1,94 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "RLConfigTypes.h"
+
+class FRLRunningNormalizer;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// One row-major float matrix of a policy network (a dense layer's weights or biases)
+struct FRLPolicyParameterBlock
+{
+	const float* Data = nullptr;
+	int32 Rows = 0;
+	int32 Cols = 0;
+};
+
+// Everything FRLPolicyFile::Save writes. Blocks and statistics are read in place, not copied.
+struct FRLPolicyFileContents
+{
+	int32 ObservationDim = 0;
+	int32 ActionDim = 0;
+	int32 HiddenDim = 0;
+	TArray<FRLPolicyParameterBlock> ParameterBlocks;
+
+	// Running observation statistics (optional) and the normalization params inference uses
+	const FRLRunningNormalizer* ObservationStatistics = nullptr;
+	FRLNormalizationParams ObservationNormalizationParams;
+	FRLNormalizationParams ActionNormalizationParams;
+	bool bUseRunningObservationNormalization = false;
+};
+
+/**
+ * Binary policy file ("URLP", version 2): a flat little-endian image meant to be memory-mapped and used in place.
+ *
+ *   Header (64 bytes)   magic, version, CRC32 of the whole file (taken with this field zeroed), flags,
+ *                       observation/action/hidden dims, block count, file size, normalization section offset, running
+ *                       statistics sample count
+ *   Block table         Rows, Cols and file offset of each parameter block
+ *   Normalization       running statistics Mean and M2 (double, ObservationDim each), then observation Mean/StdDev and
+ *                       action Mean/StdDev (float, one entry per feature)
+ *   Parameter blocks    Rows x Cols row-major floats each, starting on a 64-byte boundary
+ *
+ * Open maps the file (or reads it whole where the platform cannot map files) and validates every offset and the
+ * checksum once; GetParameterBlock then hands out pointers straight into the mapping, valid until Close.
+ */
+class UERLTOOLS_API FRLPolicyFile
+{
+public:
+	static constexpr uint32 Magic = 0x504C5255;
+	static constexpr uint32 Version = 2;
+	static constexpr int64 BlockAlignment = 64;
+
+	static bool Save(const FString& FilePath, const FRLPolicyFileContents& Contents);
+
+	FRLPolicyFile();
+	~FRLPolicyFile();
+	FRLPolicyFile(FRLPolicyFile&& Other);
+	FRLPolicyFile& operator=(FRLPolicyFile&& Other);
+
+	bool Open(const FString& FilePath);
+	void Close();
+
+	bool IsOpen() const { return Data != nullptr; }
+	bool IsMemoryMapped() const { return MappedRegion.IsValid(); }
+
+	int32 GetObservationDim() const;
+	int32 GetActionDim() const;
+	int32 GetHiddenDim() const;
+	bool UsesRunningObservationNormalization() const;
+
+	int32 GetNumParameterBlocks() const;
+	FRLPolicyParameterBlock GetParameterBlock(int32 Index) const;
+
+	// Restores the saved running statistics, frozen. Returns false if they do not fit Statistics' use.
+	bool ReadObservationStatistics(FRLRunningNormalizer& OutStatistics) const;
+	void ReadNormalizationParams(FRLNormalizationParams& OutObservationParams, FRLNormalizationParams& OutActionParams) const;
+
+private:
+	// The region is released before the handle it was mapped from
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// File contents when mapping is unavailable
+	TArray<uint8> FileData;
+
+	const uint8* Data;
+	int64 Size;
+
+	bool Validate(const FString& FilePath) const;
+};
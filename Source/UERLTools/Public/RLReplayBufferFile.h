@@ -0,0 +1,80 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Row layout of a replay buffer file. Open creates a file with this layout or refuses one with another.
+struct FRLReplayBufferFileLayout
+{
+	int32 ObservationDim = 0;
+	int32 ActionDim = 0;
+	// Elements per row and bytes per element; rows are stored back to back, RowElements * ElementSize bytes each
+	int32 RowElements = 0;
+	int32 ElementSize = sizeof(float);
+	// Floats per row stored apart from the rows (reward and flags of a half precision buffer), 0 if there are none
+	int32 ScalarElements = 0;
+	// Bytes of each row's sequence number
+	int32 SequenceSize = 0;
+	int64 Capacity = 0;
+};
+
+/**
+ * Disk-backed replay buffer storage ("URLR", version 2): a little-endian image of a concurrent replay buffer that is
+ * mapped writable and used in place, so the buffer only keeps the pages around the write position and the sampled rows
+ * resident, and a restarted run finds every transition the previous one had published. The capacity is the backend's
+ * compile-time replay buffer capacity: the file stands in for the in-memory rows, it cannot hold more of them.
+ *
+ *   Header (64 bytes)   magic, version, observation/action dims, row elements and element size, scalar elements,
+ *                       sequence number size, capacity, sequence, rows and scalars offsets
+ *   Sequence numbers    one per row (the buffer's publication state), starting on a page boundary
+ *   Rows                Capacity x RowElements, starting on a page boundary
+ *   Scalars             Capacity x ScalarElements floats, starting on a page boundary (empty for full precision rows)
+ *
+ * Writers append rows in ticket order, so dirty pages are flushed to the file sequentially. The mapping is shared:
+ * whatever a crashed process had written is on disk once the OS writes the pages back; Flush forces it. The rows
+ * carry no checksum because they change continuously; the sequence numbers tell the reader which rows are complete.
+ */
+class UERLTOOLS_API FRLReplayBufferFile
+{
+public:
+	static constexpr uint32 Magic = 0x524C5255;
+	static constexpr uint32 Version = 2;
+	static constexpr int64 PageAlignment = 4096;
+
+	FRLReplayBufferFile();
+	~FRLReplayBufferFile();
+	FRLReplayBufferFile(const FRLReplayBufferFile&) = delete;
+	FRLReplayBufferFile& operator=(const FRLReplayBufferFile&) = delete;
+
+	// Maps FilePath, creating it zero-filled (no row published) if it does not exist. Returns false if an existing file
+	// has another layout or the platform cannot map files writable.
+	bool Open(const FString& FilePath, const FRLReplayBufferFileLayout& Layout);
+	void Close();
+
+	// Writes dirty pages back to the file and waits for them
+	void Flush();
+
+	bool IsOpen() const { return Data != nullptr; }
+	const FString& GetFilePath() const { return OpenFilePath; }
+
+	// Valid until Close
+	void* GetSequences() const;
+	void* GetRows() const;
+	void* GetScalars() const;
+
+private:
+	uint8* Data;
+	int64 Size;
+	FString OpenFilePath;
+
+#if PLATFORM_WINDOWS
+	void* FileHandle;
+	void* MappingHandle;
+#else
+	int32 FileDescriptor;
+#endif
+
+	bool Map(const FString& FilePath, int64 FileSize);
+	void Unmap();
+};
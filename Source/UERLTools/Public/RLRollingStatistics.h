@@ -0,0 +1,94 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "RLRollingStatistics.generated.h"
+
+/**
+ * Summary of the values in an FRLRollingStatistics window
+ */
+USTRUCT(BlueprintType)
+struct UERLTOOLS_API FRLStatisticsSummary
+{
+	GENERATED_BODY()
+
+	// Values in the window, at most its capacity
+	UPROPERTY(BlueprintReadOnly, Category = "Statistics")
+	int32 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Statistics")
+	float Mean = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Statistics")
+	float StdDev = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Statistics")
+	float Min = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Statistics")
+	float Max = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Statistics")
+	float P50 = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Statistics")
+	float P90 = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Statistics")
+	float P99 = 0.0f;
+};
+
+/**
+ * Statistics of the last Capacity values of a stream, e.g. the returns of the last 100 episodes.
+ *
+ * The window is a ring buffer, so adding a value never shifts it. Mean and variance follow the window incrementally
+ * (Welford's update, with the evicted value's contribution removed as the new one is added) and are recomputed from
+ * the ring once per lap so rounding cannot accumulate. A sorted copy of the window is kept alongside, updated by one
+ * binary search and one block move per value, and gives min, max and percentiles by indexing. All storage is
+ * allocated by Reset; GetSummary is O(1) whatever the capacity.
+ */
+class UERLTOOLS_API FRLRollingStatistics
+{
+public:
+	explicit FRLRollingStatistics(int32 InCapacity = 100);
+
+	// Empties the window and resizes it to InCapacity values (at least 1)
+	void Reset(int32 InCapacity);
+
+	// Empties the window, keeping its capacity
+	void Reset() { Reset(Capacity); }
+
+	void Add(float Value);
+
+	int32 GetCapacity() const { return Capacity; }
+	int32 Num() const { return Count; }
+
+	double GetMean() const { return Mean; }
+	// Population variance of the window
+	double GetVariance() const { return Count > 0 ? FMath::Max(M2, 0.0) / Count : 0.0; }
+
+	// Linear interpolation between the closest ranks, Fraction in [0, 1]; 0 for an empty window
+	float GetPercentile(float Fraction) const;
+
+	FRLStatisticsSummary GetSummary() const;
+
+private:
+	int32 Capacity;
+	int32 Count;
+	// Slot of Ring the next value goes to, which holds the oldest value once the window is full
+	int32 Head;
+
+	double Mean;
+	// Sum of squared deviations from Mean
+	double M2;
+
+	// Values in arrival order and, in its first Count entries, sorted
+	TArray<float> Ring;
+	TArray<float> Sorted;
+
+	void RemoveSorted(float Value);
+	void InsertSorted(float Value);
+	void RecomputeMoments();
+};
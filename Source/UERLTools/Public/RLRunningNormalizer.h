@@ -0,0 +1,67 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RLConfigTypes.h"
+
+/**
+ * Per-feature running mean and variance of a stream of observation rows.
+ *
+ * Batches are folded in with the parallel form of Welford's algorithm (Chan et al.): each batch's mean and sum of
+ * squared deviations are computed on their own and then merged with the running totals, in double precision. The same
+ * merge combines the statistics of independent rollout workers, so each worker can keep its own normalizer and Merge
+ * them into one without revisiting the data.
+ *
+ * A frozen normalizer ignores Update and Merge; that is the state it is saved and used for inference in.
+ * Rows are row-major [N, Dim] float blocks, the same layout FRLNormalizationPlan consumes.
+ */
+class UERLTOOLS_API FRLRunningNormalizer
+{
+public:
+	FRLRunningNormalizer();
+
+	// Clears the statistics for rows of InDim features and unfreezes
+	void Reset(int32 InDim);
+
+	// Folds Rows (N x Dim floats) into the statistics. Returns false on a size mismatch.
+	bool Update(TConstArrayView<float> Rows);
+
+	// Folds the statistics of another normalizer of the same dimension into this one
+	bool Merge(const FRLRunningNormalizer& Other);
+
+	void Freeze() { bIsFrozen = true; }
+	void Unfreeze() { bIsFrozen = false; }
+	bool IsFrozen() const { return bIsFrozen; }
+
+	int32 GetDim() const { return Dim; }
+	int64 GetCount() const { return Count; }
+
+	// Per-feature running mean and sum of squared deviations from it (Dim entries each)
+	TConstArrayView<double> GetMean() const { return Mean; }
+	TConstArrayView<double> GetM2() const { return M2; }
+
+	// Replaces the statistics with saved ones (InMean/InM2 of InDim entries) and freezes. Returns false on bad input.
+	bool Restore(int32 InDim, int64 InCount, TConstArrayView<double> InMean, TConstArrayView<double> InM2);
+
+	// Writes the current statistics as enabled normalization params; StdDev is sqrt(variance + Epsilon).
+	// Leaves Params untouched (and returns false) until at least two rows have been seen.
+	bool ToParams(FRLNormalizationParams& Params, float Epsilon = 1.e-8f) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FRLRunningNormalizer& Normalizer);
+
+private:
+	int32 Dim;
+	int64 Count;
+	bool bIsFrozen;
+
+	// Running mean and sum of squared deviations from it (M2), one entry per feature
+	TArray<double> Mean;
+	TArray<double> M2;
+
+	// Per-batch mean and M2, kept to avoid allocating in Update
+	TArray<double> BatchMean;
+	TArray<double> BatchM2;
+
+	void MergeMoments(int64 OtherCount, const double* OtherMean, const double* OtherM2);
+};
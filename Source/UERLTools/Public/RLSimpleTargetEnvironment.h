@@ -4,12 +4,16 @@
 
 #include "CoreMinimal.h"
 #include "RLEnvironmentComponent.h"
+#include "RLSimpleTargetSimulation.h"
 #include "Components/StaticMeshComponent.h"
 #include "RLSimpleTargetEnvironment.generated.h"
 
 /**
  * Simple target-reaching environment for demonstration
  * Agent (pawn) learns to reach a target location
+ *
+ * The task itself is FRLSimpleTargetSimulation stepping an FRLSimpleTargetState; this component feeds it the
+ * properties below and mirrors the state to the state properties and the owning pawn while the scene is visible.
  */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent), BlueprintType, Blueprintable)
 class UERLTOOLS_API URLSimpleTargetEnvironment : public URLEnvironmentComponent
@@ -42,7 +46,7 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Target Environment")
 	bool bRandomizeStartPosition = true;
 
-	// Current state
+	// Current state, mirrored from the simulation after every reset and step (only when headless mode ends while headless)
 	UPROPERTY(BlueprintReadOnly, Category = "Target Environment State")
 	FVector AgentPosition;
 
@@ -60,7 +64,6 @@ public:
 
 	// Override base environment functions
 	virtual TArray<float> Reset() override;
-	virtual void Step(const TArray<float>& Action) override;
 	virtual TArray<float> GetObservation() override;
 	virtual float CalculateReward() override;
 	virtual bool CheckTerminated() override;
@@ -80,12 +83,24 @@ public:
 	bool IsAgentAtTarget() const;
 
 protected:
+	// Native step hooks: movement is read from the action in place and the observation written straight into the caller's buffer
+	virtual void ApplyAction(TConstArrayView<float> Action) override;
+	virtual void WriteObservation(TArrayView<float> OutObservation) override;
+
+	// Mirrors the simulation state to the state properties and moves the owning pawn to AgentPosition
+	virtual void SyncSceneState() override;
+
 	// Helper functions
 	FVector GetRandomPositionInArena() const;
-	void UpdateAgentState();
-	void ClampAgentToArena();
+
+	// The properties above as simulation parameters, stepping GetStepDeltaSeconds
+	FRLSimpleTargetParameters GetSimulationParameters() const;
+
+	// Copies SimulationState into AgentPosition, AgentVelocity, TargetPosition and the distances
+	void MirrorSimulationState();
 
 private:
-	// Previous position for velocity calculation
-	FVector PreviousAgentPosition;
+	// State after the last reset or step, and before the last step for the reward
+	FRLSimpleTargetState SimulationState;
+	FRLSimpleTargetState PreviousSimulationState;
 };
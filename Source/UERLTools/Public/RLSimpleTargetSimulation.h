@@ -0,0 +1,160 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Parameters of the target-reaching task. URLSimpleTargetEnvironment fills them from its properties; rl_tools loops
+ * keep one copy per environment.
+ */
+struct FRLSimpleTargetParameters
+{
+	float ArenaSize = 1000.0f;
+	float TargetRadius = 50.0f;
+	float MaxSpeed = 500.0f;
+	float RewardScale = 1.0f;
+
+	// Simulated time one step advances
+	float DeltaSeconds = 1.0f / 60.0f;
+
+	bool bRandomizeTarget = true;
+	bool bRandomizeStartPosition = true;
+
+	// Target of every episode while bRandomizeTarget is off
+	float TargetX = 500.0f;
+	float TargetY = 0.0f;
+};
+
+/**
+ * Everything a target-reaching episode evolves: agent and target on the arena plane. Plain data, so batches of
+ * environments can live in flat arrays and be stepped on any thread.
+ */
+struct FRLSimpleTargetState
+{
+	static constexpr int32 DIM = 6;
+
+	float AgentX;
+	float AgentY;
+	float VelocityX;
+	float VelocityY;
+	float TargetX;
+	float TargetY;
+};
+
+static_assert(TIsPODType<FRLSimpleTargetState>::Value, "FRLSimpleTargetState must stay plain data");
+
+/**
+ * Dynamics, reward and termination of the target-reaching task as pure functions of the parameters and state.
+ *
+ * URLSimpleTargetEnvironment steps through these and only mirrors the result to its properties and pawn when the
+ * scene is visible. RLSimpleTargetRLToolsEnvironment.h exposes the same functions through the rl_tools environment
+ * API, so rl_tools loops can run the task without a UObject.
+ */
+struct FRLSimpleTargetSimulation
+{
+	static constexpr int32 ObservationDim = 8; // Agent pos (2), Agent vel (2), Target pos (2), Distance (1), Normalized distance (1)
+	static constexpr int32 ActionDim = 2; // Movement in X and Y
+
+	// Starts an episode: a random target unless it is fixed, then the agent at the origin or at a random position at
+	// least two target radii away from the target. Uniform(Min, Max) draws a uniform float.
+	template <typename FUniform>
+	static void SampleInitialState(const FRLSimpleTargetParameters& Parameters, FRLSimpleTargetState& OutState, FUniform&& Uniform)
+	{
+		const float Size = Parameters.ArenaSize;
+		OutState.TargetX = Parameters.bRandomizeTarget ? Uniform(-Size, Size) : Parameters.TargetX;
+		OutState.TargetY = Parameters.bRandomizeTarget ? Uniform(-Size, Size) : Parameters.TargetY;
+
+		OutState.AgentX = 0.0f;
+		OutState.AgentY = 0.0f;
+		if (Parameters.bRandomizeStartPosition)
+		{
+			// Bounded so an arena too small for the separation cannot stall the reset
+			for (int32 Attempt = 0; Attempt < 100; ++Attempt)
+			{
+				OutState.AgentX = Uniform(-Size, Size);
+				OutState.AgentY = Uniform(-Size, Size);
+				if (Distance(OutState) >= Parameters.TargetRadius * 2.0f)
+				{
+					break;
+				}
+			}
+		}
+
+		OutState.VelocityX = 0.0f;
+		OutState.VelocityY = 0.0f;
+	}
+
+	// Moves the agent by Action (ActionDim values, clamped to the unit circle) at MaxSpeed for DeltaSeconds and keeps
+	// it inside the arena. The velocity is the distance actually covered over DeltaSeconds.
+	static void Step(const FRLSimpleTargetParameters& Parameters, const FRLSimpleTargetState& State, const float* Action, FRLSimpleTargetState& OutNextState)
+	{
+		float MoveX = Action[0];
+		float MoveY = Action[1];
+		const float SquaredLength = MoveX * MoveX + MoveY * MoveY;
+		if (SquaredLength > 1.0f)
+		{
+			const float Scale = FMath::InvSqrt(SquaredLength);
+			MoveX *= Scale;
+			MoveY *= Scale;
+		}
+
+		const float Size = Parameters.ArenaSize;
+		const float Travel = Parameters.MaxSpeed * Parameters.DeltaSeconds;
+		OutNextState.AgentX = FMath::Clamp(State.AgentX + MoveX * Travel, -Size, Size);
+		OutNextState.AgentY = FMath::Clamp(State.AgentY + MoveY * Travel, -Size, Size);
+
+		if (Parameters.DeltaSeconds > 0.0f)
+		{
+			OutNextState.VelocityX = (OutNextState.AgentX - State.AgentX) / Parameters.DeltaSeconds;
+			OutNextState.VelocityY = (OutNextState.AgentY - State.AgentY) / Parameters.DeltaSeconds;
+		}
+		else
+		{
+			OutNextState.VelocityX = State.VelocityX;
+			OutNextState.VelocityY = State.VelocityY;
+		}
+
+		OutNextState.TargetX = State.TargetX;
+		OutNextState.TargetY = State.TargetY;
+	}
+
+	// Progress towards the target, a bonus for reaching it and a small penalty for every step, all times RewardScale
+	static float Reward(const FRLSimpleTargetParameters& Parameters, const FRLSimpleTargetState& State, const FRLSimpleTargetState& NextState)
+	{
+		float Total = Distance(State) - Distance(NextState);
+		if (Terminated(Parameters, NextState))
+		{
+			Total += 100.0f;
+		}
+		Total -= 0.1f;
+		return Total * Parameters.RewardScale;
+	}
+
+	// The episode ends once the agent is within TargetRadius of the target
+	static bool Terminated(const FRLSimpleTargetParameters& Parameters, const FRLSimpleTargetState& State)
+	{
+		return Distance(State) <= Parameters.TargetRadius;
+	}
+
+	// Writes ObservationDim values: positions normalized by the arena size, velocity by MaxSpeed, then the raw distance
+	// and the distance as a fraction of the arena diagonal
+	static void Observe(const FRLSimpleTargetParameters& Parameters, const FRLSimpleTargetState& State, float* OutObservation)
+	{
+		const float Size = Parameters.ArenaSize;
+		const float TargetDistance = Distance(State);
+		OutObservation[0] = State.AgentX / Size;
+		OutObservation[1] = State.AgentY / Size;
+		OutObservation[2] = FMath::Clamp(State.VelocityX / Parameters.MaxSpeed, -1.0f, 1.0f);
+		OutObservation[3] = FMath::Clamp(State.VelocityY / Parameters.MaxSpeed, -1.0f, 1.0f);
+		OutObservation[4] = State.TargetX / Size;
+		OutObservation[5] = State.TargetY / Size;
+		OutObservation[6] = TargetDistance;
+		OutObservation[7] = FMath::Clamp(TargetDistance / (Size * FMath::Sqrt(2.0f)), 0.0f, 1.0f);
+	}
+
+	static float Distance(const FRLSimpleTargetState& State)
+	{
+		return FMath::Sqrt(FMath::Square(State.TargetX - State.AgentX) + FMath::Square(State.TargetY - State.AgentY));
+	}
+};
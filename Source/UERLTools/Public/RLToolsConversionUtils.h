@@ -1,15 +1,138 @@
 #pragma once
 
 #include "CoreMinimal.h"
-// RL Tools includes for Matrix type
-#include "rl_tools/containers/matrix/matrix.h" // For rl_tools::Matrix and its operations
+#include "UERLLog.h"
+#include <type_traits>
+
+// The conversions are templates on the matrix type and defined below, so every user instantiates them itself and
+// needs the matrix operations
+THIRD_PARTY_INCLUDES_START
+#include "rl_tools/operations/cpu_mux.h"
+#include "rl_tools/containers/matrix/operations_generic.h"
+THIRD_PARTY_INCLUDES_END
 
 #include "RLConfigTypes.h" // For FRLNormalizationParams
+#include "RLNormalizationPlan.h"
 
 // struct FRLNormalizationParams; // No longer needed as it's included from RLConfigTypes.h
 
 namespace RLToolsConversionUtils
 {
+    namespace Detail
+    {
+        // Per-element mean/stddev lookup: a single value broadcasts, missing entries fall back to Default
+        FORCEINLINE float NormalizationValue(const TArray<float>& Values, int32 Index, float Default)
+        {
+            return Values.Num() == 1 ? Values[0] : (Index < Values.Num() ? Values[Index] : Default);
+        }
+
+        // Reports parameter problems once per call instead of once per element
+        inline void ValidateNormalizationParams(const TCHAR* Context, const FRLNormalizationParams& Params, int32 NumElements)
+        {
+            if (Params.Mean.Num() > 1 && Params.Mean.Num() < NumElements)
+            {
+                UE_LOG(LOG_UERLTOOLS, Warning, TEXT("%s: Normalization Mean array size (%d) is insufficient for %d elements. Using default mean 0 for the rest."), Context, Params.Mean.Num(), NumElements);
+            }
+            if (Params.StdDev.Num() > 1 && Params.StdDev.Num() < NumElements)
+            {
+                UE_LOG(LOG_UERLTOOLS, Warning, TEXT("%s: Normalization StdDev array size (%d) is insufficient for %d elements. Using default stddev 1 for the rest."), Context, Params.StdDev.Num(), NumElements);
+            }
+        }
+
+        // Row-major mapping of a flat index onto the matrix
+        template <typename T_MATRIX_SPEC>
+        FORCEINLINE void SetElement(rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix, int32 Index, float Value)
+        {
+            constexpr auto COLS = T_MATRIX_SPEC::COLS;
+            rl_tools::set(RLMatrix, Index / COLS, Index % COLS, static_cast<typename T_MATRIX_SPEC::T>(Value));
+        }
+
+        template <typename T_MATRIX_SPEC>
+        FORCEINLINE float GetElement(const rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix, int32 Index)
+        {
+            constexpr auto COLS = T_MATRIX_SPEC::COLS;
+            return static_cast<float>(rl_tools::get(RLMatrix, Index / COLS, Index % COLS));
+        }
+    }
+
+    /**
+     * Allocation-free variants: read the source from any contiguous float range (a TArray, an environment's observation
+     * row, a ring slot) and write the destination into caller-owned memory. The TArray overloads forward to these.
+     */
+    template <typename T_MATRIX_SPEC>
+    bool UEArrayToRLMatrix(
+        TConstArrayView<float> Source,
+        rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix,
+        const FRLNormalizationParams& NormalizationParams)
+    {
+        constexpr auto ROWS = T_MATRIX_SPEC::ROWS;
+        constexpr auto COLS = T_MATRIX_SPEC::COLS;
+        const int32 ExpectedNumElements = ROWS * COLS;
+
+        if (Source.Num() != ExpectedNumElements)
+        {
+            UE_LOG(LOG_UERLTOOLS, Error, TEXT("UEArrayToRLMatrix: Dimension mismatch. Source has %d elements, RLMatrix expects %d."), Source.Num(), ExpectedNumElements);
+            return false;
+        }
+
+        // Normalization is decided once per call, not per element
+        if (!NormalizationParams.bIsEnabled)
+        {
+            for (int32 i = 0; i < ExpectedNumElements; ++i)
+            {
+                Detail::SetElement(RLMatrix, i, Source[i]);
+            }
+            return true;
+        }
+
+        Detail::ValidateNormalizationParams(TEXT("UEArrayToRLMatrix"), NormalizationParams, ExpectedNumElements);
+        for (int32 i = 0; i < ExpectedNumElements; ++i)
+        {
+            const float Mean = Detail::NormalizationValue(NormalizationParams.Mean, i, 0.0f);
+            const float StdDev = Detail::NormalizationValue(NormalizationParams.StdDev, i, 1.0f);
+
+            // A near-zero stddev leaves the element unnormalized
+            const float Value = FMath::Abs(StdDev) < KINDA_SMALL_NUMBER ? Source[i] : (Source[i] - Mean) / StdDev;
+            Detail::SetElement(RLMatrix, i, Value);
+        }
+        return true;
+    }
+
+    template <typename T_MATRIX_SPEC>
+    bool RLMatrixToUEArray(
+        const rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix,
+        TArrayView<float> Destination,
+        const FRLNormalizationParams& DenormalizationParams)
+    {
+        constexpr auto ROWS = T_MATRIX_SPEC::ROWS;
+        constexpr auto COLS = T_MATRIX_SPEC::COLS;
+        const int32 NumElements = ROWS * COLS;
+
+        if (Destination.Num() != NumElements)
+        {
+            UE_LOG(LOG_UERLTOOLS, Error, TEXT("RLMatrixToUEArray: Dimension mismatch. Destination has %d elements, RLMatrix holds %d."), Destination.Num(), NumElements);
+            return false;
+        }
+
+        if (!DenormalizationParams.bIsEnabled)
+        {
+            for (int32 i = 0; i < NumElements; ++i)
+            {
+                Destination[i] = Detail::GetElement(RLMatrix, i);
+            }
+            return true;
+        }
+
+        Detail::ValidateNormalizationParams(TEXT("RLMatrixToUEArray"), DenormalizationParams, NumElements);
+        for (int32 i = 0; i < NumElements; ++i)
+        {
+            const float Mean = Detail::NormalizationValue(DenormalizationParams.Mean, i, 0.0f);
+            const float StdDev = Detail::NormalizationValue(DenormalizationParams.StdDev, i, 1.0f);
+            Destination[i] = (Detail::GetElement(RLMatrix, i) * StdDev) + Mean;
+        }
+        return true;
+    }
+
     /**
      * Converts a TArray<float> from Unreal Engine to an rl_tools::Matrix.
      *
@@ -24,8 +147,10 @@ namespace RLToolsConversionUtils
     bool UEArrayToRLMatrix(
         const TArray<float>& UEArray,
         rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix,
-        const FRLNormalizationParams& NormalizationParams
-    );
+        const FRLNormalizationParams& NormalizationParams)
+    {
+        return UEArrayToRLMatrix<T_MATRIX_SPEC>(MakeArrayView(UEArray), RLMatrix, NormalizationParams);
+    }
 
     /**
      * Converts an rl_tools::Matrix to a TArray<float> for Unreal Engine.
@@ -41,15 +166,87 @@ namespace RLToolsConversionUtils
     bool RLMatrixToUEArray(
         const rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix,
         TArray<float>& UEArray,
-        const FRLNormalizationParams& DenormalizationParams
-    );
-
-    // TODO: Add functions for normalization/denormalization if they are complex
-    // and not handled directly within the conversion functions.
-    // For example:
-    // template <typename T_MATRIX_SPEC>
-    // void NormalizeMatrix(rl_tools::Matrix<T_MATRIX_SPEC>& Matrix, const FRLNormalizationParams& Params);
-    //
-    // template <typename T_MATRIX_SPEC>
-    // void DenormalizeMatrix(rl_tools::Matrix<T_MATRIX_SPEC>& Matrix, const FRLNormalizationParams& Params);
+        const FRLNormalizationParams& DenormalizationParams)
+    {
+        // Reuses the caller's allocation when it is already large enough
+        UEArray.SetNumUninitialized(rl_tools::rows(RLMatrix) * rl_tools::cols(RLMatrix), /*bAllowShrinking=*/ false);
+        return RLMatrixToUEArray<T_MATRIX_SPEC>(RLMatrix, MakeArrayView(UEArray), DenormalizationParams);
+    }
+
+    /**
+     * Variants taking a prebuilt FRLNormalizationPlan instead of raw params. These are the ones to use per step:
+     * mean/stddev lookup, validation and the division are all paid once in FRLNormalizationPlan::Build.
+     * The plan's Dim must divide the matrix's column count.
+     */
+    template <typename T_MATRIX_SPEC>
+    bool UEArrayToRLMatrix(
+        TConstArrayView<float> Source,
+        rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix,
+        const FRLNormalizationPlan& NormalizationPlan)
+    {
+        constexpr int32 ROWS = T_MATRIX_SPEC::ROWS;
+        constexpr int32 COLS = T_MATRIX_SPEC::COLS;
+
+        if (Source.Num() != ROWS * COLS || (!NormalizationPlan.IsIdentity() && COLS % NormalizationPlan.GetDim() != 0))
+        {
+            UE_LOG(LOG_UERLTOOLS, Error, TEXT("UEArrayToRLMatrix: Dimension mismatch. Source has %d elements, RLMatrix is %dx%d, plan dim is %d."), Source.Num(), ROWS, COLS, NormalizationPlan.GetDim());
+            return false;
+        }
+
+        if constexpr (std::is_same_v<typename T_MATRIX_SPEC::T, float> && T_MATRIX_SPEC::COL_PITCH == 1)
+        {
+            // Float rows are contiguous: the plan writes straight into the matrix, one (possibly padded) row at a time
+            for (int32 Row = 0; Row < ROWS; ++Row)
+            {
+                NormalizationPlan.Apply(Source.Slice(Row * COLS, COLS), MakeArrayView(RLMatrix._data + Row * T_MATRIX_SPEC::ROW_PITCH, COLS));
+            }
+        }
+        else
+        {
+            const TConstArrayView<float> Scale = NormalizationPlan.GetScale();
+            const TConstArrayView<float> Bias = NormalizationPlan.GetBias();
+            for (int32 i = 0; i < ROWS * COLS; ++i)
+            {
+                const int32 Feature = Scale.Num() > 0 ? i % Scale.Num() : 0;
+                Detail::SetElement(RLMatrix, i, Scale.Num() > 0 ? Source[i] * Scale[Feature] + Bias[Feature] : Source[i]);
+            }
+        }
+        return true;
+    }
+
+    template <typename T_MATRIX_SPEC>
+    bool RLMatrixToUEArray(
+        const rl_tools::Matrix<T_MATRIX_SPEC>& RLMatrix,
+        TArrayView<float> Destination,
+        const FRLNormalizationPlan& DenormalizationPlan)
+    {
+        constexpr int32 ROWS = T_MATRIX_SPEC::ROWS;
+        constexpr int32 COLS = T_MATRIX_SPEC::COLS;
+
+        if (Destination.Num() != ROWS * COLS || (!DenormalizationPlan.IsIdentity() && COLS % DenormalizationPlan.GetDim() != 0))
+        {
+            UE_LOG(LOG_UERLTOOLS, Error, TEXT("RLMatrixToUEArray: Dimension mismatch. Destination has %d elements, RLMatrix is %dx%d, plan dim is %d."), Destination.Num(), ROWS, COLS, DenormalizationPlan.GetDim());
+            return false;
+        }
+
+        if constexpr (std::is_same_v<typename T_MATRIX_SPEC::T, float> && T_MATRIX_SPEC::COL_PITCH == 1)
+        {
+            for (int32 Row = 0; Row < ROWS; ++Row)
+            {
+                DenormalizationPlan.Apply(MakeArrayView(RLMatrix._data + Row * T_MATRIX_SPEC::ROW_PITCH, COLS), Destination.Slice(Row * COLS, COLS));
+            }
+        }
+        else
+        {
+            const TConstArrayView<float> Scale = DenormalizationPlan.GetScale();
+            const TConstArrayView<float> Bias = DenormalizationPlan.GetBias();
+            for (int32 i = 0; i < ROWS * COLS; ++i)
+            {
+                const float Value = Detail::GetElement(RLMatrix, i);
+                const int32 Feature = Scale.Num() > 0 ? i % Scale.Num() : 0;
+                Destination[i] = Scale.Num() > 0 ? Value * Scale[Feature] + Bias[Feature] : Value;
+            }
+        }
+        return true;
+    }
 }
@@ -30,6 +30,11 @@ public:
     UFUNCTION(BlueprintCallable, Category = "RLTools Test")
     bool TestRLToolsIntegration();
 
+    // Microbenchmark of the OffPolicyRunner prologue/epilogue: persistent device thread pool vs. spawning threads
+    // every step, for 1-64 pendulum environments. Results are written to the log; not part of TestRLToolsIntegration.
+    UFUNCTION(BlueprintCallable, Category = "RLTools Test")
+    bool BenchmarkOffPolicyRunnerThreading();
+
 private:
     // rl_tools device instance
     rl_tools::devices::DefaultCPU device;
@@ -37,6 +42,20 @@ private:
     // Individual test cases
     bool TestMatrixOperations();
     bool TestNeuralNetworkLayer();
+    bool TestDenseKernels();
     bool TestMLPNetwork();
     bool TestOptimizer();
+    bool TestRunningNormalizer();
+    bool TestNormalizationPlan();
+    bool TestRollingStatistics();
+    bool TestConcurrentReplayBuffer();
+    bool TestWholeBatchGather();
+    bool TestDeduplicatedReplayBuffer();
+    bool TestHalfPrecisionStorage();
+    bool TestSumTree();
+    bool TestReplayBufferFile();
+    bool TestTD3Backend();
+    bool TestSACBackend();
+    bool TestPPOBackend();
+    bool TestSimpleTargetEnvironment();
 };
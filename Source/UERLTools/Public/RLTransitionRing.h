@@ -0,0 +1,145 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * Header stored at the start of every ring slot
+ */
+struct FRLTransitionSlotHeader
+{
+	enum EFlags : uint32
+	{
+		None = 0,
+		// The step ended the episode because of a terminal state
+		Terminated = 1 << 0,
+		// The step ended the episode without a terminal state (time limit, external stop)
+		Truncated = 1 << 1,
+		// First observation of a new episode; carries no reward
+		EpisodeStart = 1 << 2,
+	};
+
+	float Reward = 0.0f;
+	uint32 Flags = None;
+
+	bool IsEpisodeFinished() const { return (Flags & (Terminated | Truncated)) != 0; }
+};
+
+/**
+ * Bounded single-producer/single-consumer ring of fixed-size float slots.
+ *
+ * Each slot holds an FRLTransitionSlotHeader followed by SlotWidth floats and is written in place, so pushing a
+ * transition neither allocates nor copies through an intermediate TArray. Head and tail live on separate cache lines
+ * and each side caches the other's index, so the atomics are only re-read when the ring looks full (producer) or
+ * empty (consumer). BeginWrite returning nullptr is the backpressure signal.
+ *
+ * Exactly one thread may call the producer functions and exactly one (other) thread the consumer functions.
+ */
+class FRLTransitionRing
+{
+public:
+	// InCapacity is rounded up to a power of two
+	FRLTransitionRing(int32 InCapacity, int32 InSlotWidth)
+		: Capacity(FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, 2)))
+		, Mask(Capacity - 1)
+		, SlotWidth(FMath::Max(InSlotWidth, 0))
+		// Whole cache lines per slot so the slot being written never shares a line with the one being read
+		, SlotStride(Align(sizeof(FRLTransitionSlotHeader) + sizeof(float) * SlotWidth, PLATFORM_CACHE_LINE_SIZE))
+	{
+		Storage = static_cast<uint8*>(FMemory::Malloc(SlotStride * Capacity, PLATFORM_CACHE_LINE_SIZE));
+		FMemory::Memzero(Storage, SlotStride * Capacity);
+	}
+
+	~FRLTransitionRing()
+	{
+		FMemory::Free(Storage);
+	}
+
+	FRLTransitionRing(const FRLTransitionRing&) = delete;
+	FRLTransitionRing& operator=(const FRLTransitionRing&) = delete;
+
+	int32 GetCapacity() const { return static_cast<int32>(Capacity); }
+	int32 GetSlotWidth() const { return SlotWidth; }
+
+	static float* GetData(FRLTransitionSlotHeader* Slot) { return reinterpret_cast<float*>(Slot + 1); }
+	static const float* GetData(const FRLTransitionSlotHeader* Slot) { return reinterpret_cast<const float*>(Slot + 1); }
+
+	// Producer: returns the next free slot, or nullptr if the consumer has not caught up yet
+	FRLTransitionSlotHeader* BeginWrite()
+	{
+		const uint32 Write = WriteIndex.load(std::memory_order_relaxed);
+		if (Write - CachedReadIndex == Capacity)
+		{
+			CachedReadIndex = ReadIndex.load(std::memory_order_acquire);
+			if (Write - CachedReadIndex == Capacity)
+			{
+				return nullptr;
+			}
+		}
+		return GetSlot(Write);
+	}
+
+	// Producer: publishes the slot returned by the last BeginWrite
+	void CommitWrite()
+	{
+		WriteIndex.store(WriteIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Consumer: returns the oldest published slot, or nullptr if the ring is empty
+	const FRLTransitionSlotHeader* BeginRead()
+	{
+		const uint32 Read = ReadIndex.load(std::memory_order_relaxed);
+		if (Read == CachedWriteIndex)
+		{
+			CachedWriteIndex = WriteIndex.load(std::memory_order_acquire);
+			if (Read == CachedWriteIndex)
+			{
+				return nullptr;
+			}
+		}
+		return GetSlot(Read);
+	}
+
+	// Consumer: hands the slot returned by the last BeginRead back to the producer
+	void CommitRead()
+	{
+		ReadIndex.store(ReadIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Approximate when called concurrently with either side
+	int32 Num() const
+	{
+		return static_cast<int32>(WriteIndex.load(std::memory_order_acquire) - ReadIndex.load(std::memory_order_acquire));
+	}
+
+	// Only valid while neither side is active
+	void Reset()
+	{
+		WriteIndex.store(0, std::memory_order_relaxed);
+		ReadIndex.store(0, std::memory_order_relaxed);
+		CachedReadIndex = 0;
+		CachedWriteIndex = 0;
+	}
+
+private:
+	FRLTransitionSlotHeader* GetSlot(uint32 Index) const
+	{
+		return reinterpret_cast<FRLTransitionSlotHeader*>(Storage + SlotStride * (Index & Mask));
+	}
+
+	const uint32 Capacity;
+	const uint32 Mask;
+	const int32 SlotWidth;
+	const SIZE_T SlotStride;
+	uint8* Storage = nullptr;
+
+	// Producer-owned
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> WriteIndex{0};
+	uint32 CachedReadIndex = 0;
+
+	// Consumer-owned
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> ReadIndex{0};
+	uint32 CachedWriteIndex = 0;
+};
@@ -41,14 +41,50 @@ struct UERLTOOLS_API FRLTrainingConfig
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
     float DiscountFactor = 0.99f;
 
-    /** Batch size for training updates. */
+    /** Batch size for training updates. The TD3, SAC and PPO backends train on batches of 256. */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
-    int32 BatchSize = 64;
+    int32 BatchSize = 256;
+
+    /** Transitions the replay buffer holds. The TD3 and SAC backends hold 100000; other values are reported and ignored. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
+    int32 ReplayBufferCapacity = 100000;
+
+    /** Gradient updates per collected environment step (update-to-data ratio). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training", meta = (ClampMin = "0.0"))
+    float UpdateToDataRatio = 1.0f;
+
+    /** Train the two critics of each update concurrently on two worker threads. Their shared targets are computed once. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
+    bool bParallelCriticTraining = false;
+
+    /** Sample transitions proportionally to their TD error (prioritized experience replay) instead of uniformly. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Prioritized Replay")
+    bool bPrioritizedReplay = false;
+
+    /** How strongly priorities skew sampling: 0 is uniform, 1 fully proportional to the TD error. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Prioritized Replay", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float PrioritizedReplayAlpha = 0.6f;
+
+    /** Initial importance-sampling exponent, annealed linearly to 1 over PrioritizedReplayBetaAnnealingUpdates updates. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Prioritized Replay", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float PrioritizedReplayBeta = 0.4f;
+
+    /** Gradient updates over which the importance-sampling exponent reaches 1. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Prioritized Replay", meta = (ClampMin = "0"))
+    int32 PrioritizedReplayBetaAnnealingUpdates = 100000;
+
+    /** Keep the replay buffer in this memory-mapped file instead of memory, resuming from its transitions after a restart. The file holds as many transitions as the in-memory buffer would. Empty to keep it in memory. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
+    FString ReplayBufferFilePath;
 
     /** Total number of timesteps to train for. */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
     int32 TotalTimesteps = 1000000;
 
+    /** Hidden layer width of the policy/value networks. Must be one of the sizes registered in FRLAgentBackendRegistry (64, 128 by default). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Network")
+    int32 HiddenDim = 64;
+
     /** Parameters for observation normalization. */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Normalization")
     FRLNormalizationParams ObservationNormalizationParams;
@@ -57,12 +93,46 @@ struct UERLTOOLS_API FRLTrainingConfig
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Normalization")
     FRLNormalizationParams ActionNormalizationParams;
 
-    // Add other algorithm-specific hyperparameters here, e.g.:
-    // For PPO:
-    // UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|PPO")
-    // float ClipRatio = 0.2f;
-    // UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|PPO")
-    // int32 PPOEpochs = 10;
+    /**
+     * Learn observation mean/stddev from the observations seen during training instead of using ObservationNormalizationParams.
+     * The statistics are frozen when training stops, written back into ObservationNormalizationParams and saved with the policy.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Normalization")
+    bool bUseRunningObservationNormalization = false;
+
+    /**
+     * Training algorithm. PPO ignores the replay buffer and prioritized replay settings, SAC ignores prioritized replay and
+     * the replay buffer file. Only TD3 supports async training.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
+    ERLAlgorithm Algorithm = ERLAlgorithm::TD3;
+
+    /** Passes over each collected rollout, in minibatches of BatchSize. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|PPO", meta = (ClampMin = "1"))
+    int32 PPOEpochs = 10;
+
+    /** Lambda of the generalized advantage estimate: 0 is the one-step TD error, 1 the Monte Carlo return. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|PPO", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float GAELambda = 0.95f;
+
+    /** Finished episodes the reported return and length statistics (mean, spread, percentiles) are taken over. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Statistics", meta = (ClampMin = "1"))
+    int32 EpisodeStatisticsWindow = 100;
+
+    /**
+     * Train without StepTraining calls: the agent steps itself every frame for up to HeadlessFrameBudgetMs of wall-clock
+     * time, its environments advance their fixed time step instead of the frame time and the world is not rendered.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Headless")
+    bool bHeadlessTraining = false;
+
+    /** Wall-clock time per frame spent on headless training steps. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Headless", meta = (ClampMin = "0.1"))
+    float HeadlessFrameBudgetMs = 12.0f;
+
+    /** Upper bound on headless training steps per frame, whatever the budget allows. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training|Headless", meta = (ClampMin = "1"))
+    int32 HeadlessMaxStepsPerFrame = 100000;
 
     FRLEnvironmentConfig EnvironmentConfig; // Associated environment configuration
 
@@ -0,0 +1,70 @@
+// Copyright 2025 NGUYEN PHI HUNG
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class URLEnvironmentComponent;
+
+/**
+ * Binds N identically shaped environment components (e.g. copies of the same arena in one level) into a single
+ * batched environment with N slots.
+ *
+ * Observations are gathered into one row-major [N, ObservationDim] buffer so a single batched policy forward pass
+ * serves every slot, and the [N, ActionDim] action batch is scattered back row by row. Slots read their action row
+ * and write their observation row in place (URLEnvironmentComponent::StepInto). All buffers are allocated in Bind.
+ *
+ * A step is split in two so the caller can record complete transitions before finished slots are reset:
+ *   Step(Actions)      -> GetNextObservations/GetRewards/IsTerminated/IsTruncated describe the transition
+ *   AdvanceEpisodes()  -> GetObservations holds the observations to act on next (reset ones for finished slots)
+ *
+ * Game thread only: every call ends up in the environment components.
+ */
+class UERLTOOLS_API FRLVectorizedEnvironment
+{
+public:
+	FRLVectorizedEnvironment();
+
+	// Binds the given components as slots 0..N-1. All of them must share the observation and action dimensions.
+	bool Bind(const TArray<URLEnvironmentComponent*>& InEnvironments);
+	void Unbind();
+
+	int32 Num() const { return Environments.Num(); }
+	int32 GetObservationDim() const { return ObservationDim; }
+	int32 GetActionDim() const { return ActionDim; }
+	URLEnvironmentComponent* GetEnvironment(int32 Index) const { return Environments[Index]; }
+
+	// Resets every slot and gathers the initial observations
+	bool Reset();
+
+	// Scatters one action row to each slot, steps all of them and gathers the resulting transitions
+	bool Step(TArrayView<const float> Actions);
+
+	// Moves every slot to the observation its next action is computed from, resetting the slots whose episode finished
+	bool AdvanceEpisodes();
+
+	// [N, ObservationDim], row-major: observations to compute the next actions from
+	TArrayView<const float> GetObservations() const { return Observations; }
+
+	// [N, ObservationDim], row-major: observations reached by the last Step (terminal ones for finished slots).
+	// Only valid between Step and AdvanceEpisodes.
+	TArrayView<const float> GetNextObservations() const { return NextObservations; }
+
+	TArrayView<const float> GetRewards() const { return Rewards; }
+	bool IsTerminated(int32 Index) const { return Terminated[Index] != 0; }
+	bool IsTruncated(int32 Index) const { return Truncated[Index] != 0; }
+	bool IsEpisodeFinished(int32 Index) const { return IsTerminated(Index) || IsTruncated(Index); }
+
+private:
+	bool ResetSlot(int32 Index, float* OutObservation);
+
+	TArray<URLEnvironmentComponent*> Environments;
+	int32 ObservationDim;
+	int32 ActionDim;
+
+	TArray<float> Observations;
+	TArray<float> NextObservations;
+	TArray<float> Rewards;
+	TArray<uint8> Terminated;
+	TArray<uint8> Truncated;
+};
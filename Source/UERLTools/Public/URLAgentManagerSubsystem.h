@@ -5,12 +5,9 @@ class URLEnvironmentComponent; // Assuming this is defined in RLEnvironmentCompo
 struct FRLTrainingConfig;     // Assuming this USTRUCT is defined, e.g., in RLTypes.h
 class URLAgentManager;        // Forward declaration for URLAgentManager
 
-THIRD_PARTY_INCLUDES_START
-#include <rl_tools/operations/cpu.h> // For rl_tools::devices::DefaultCPU, rl_tools::malloc, rl_tools::free, rl_tools::init
-THIRD_PARTY_INCLUDES_END
-
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "RLRollingStatistics.h"
 #include "URLAgentManagerSubsystem.generated.h"
 
 
@@ -51,6 +48,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "RLTools|Agent Management")
     bool RemoveAgent(FName AgentName);
 
+    // Adds identical copies of the agent's environment that are trained in lockstep with one batched policy pass
+    UFUNCTION(BlueprintCallable, Category = "RLTools|Agent Management")
+    bool SetParallelEnvironments(FName AgentName, const TArray<URLEnvironmentComponent*>& ParallelEnvironments);
+
     // Policy Management
     UFUNCTION(BlueprintCallable, Category = "RLTools|Policy Management")
     bool LoadPolicy(FName AgentName, const FString& FilePath);
@@ -76,8 +77,9 @@ public:
     UFUNCTION(BlueprintCallable, Category = "RLTools|Status")
     bool GetAgentTrainingStatus(FName AgentName, bool&bIsCurrentlyTraining, int32& OutCurrentStep, float& OutLastReward);
 
-    // UFUNCTION(BlueprintCallable, Category = "RLTools|Status")
-    // FRLAgentEpisodeStats GetAgentEpisodeStats(FName AgentName); // Placeholder for more detailed stats struct
+    // Return and length statistics over the agent's last EpisodeStatisticsWindow finished episodes
+    UFUNCTION(BlueprintCallable, Category = "RLTools|Status")
+    bool GetAgentEpisodeStatistics(FName AgentName, FRLStatisticsSummary& OutEpisodeReturn, FRLStatisticsSummary& OutEpisodeLength);
 
 public:
     // Blueprint Assignable Delegates for asynchronous operations
@@ -97,8 +99,5 @@ private:
     UPROPERTY() // Keep TMap private, expose via functions. URLAgentManager instances are UObjects and will be managed by GC if UPROPERTY.
     TMap<FName, URLAgentManager*> ActiveAgents;
 
-    // TODO: Add rl_tools global device context if needed
-    // rl_tools global device and context
-    rl_tools::devices::DefaultCPU rlt_device; // rl_tools device instance
-    rl_tools::devices::DefaultCPU::CONTEXT_TYPE* rlt_context = nullptr; // Pointer to the global rl_tools context for CPU operations
+    // rl_tools devices and networks are owned per agent by its backend (see FRLAgentBackendRegistry), so the subsystem holds no rl_tools state
 };